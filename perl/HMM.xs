@@ -377,6 +377,27 @@ CODE:
   sentence2tokdata(s, utf8);
   delete s;
 
+##------------------------------------------------------
+void
+tag_sentences(mootHMM *hmm, AV* sentsav, bool utf8=TRUE, bool trace=FALSE)
+PREINIT:
+  mootHMM::SentenceBatch batch;
+  I32 slen, si;
+  SV **sentavrv;
+CODE:
+  slen = av_len(sentsav);
+  for (si=0; si <= slen; si++) {
+    sentavrv = av_fetch(sentsav,si,0);
+    if (!sentavrv || !*sentavrv || !SvROK(*sentavrv)) continue;
+    batch.push_back( av2sentence((AV*)SvRV(*sentavrv), NULL, utf8) );
+  }
+  hmm->tag_batch(batch);
+  for (mootHMM::SentenceBatch::iterator bi=batch.begin(); bi != batch.end(); ++bi) {
+    if (trace) hmm->tag_dump_trace(**bi);
+    sentence2tokdata(*bi, utf8);
+    delete *bi;
+  }
+
 ##------------------------------------------------------
 void
 tag_io(mootHMM *hmm, TokenReader *reader, TokenWriter *writer)
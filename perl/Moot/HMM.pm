@@ -152,6 +152,7 @@ Moot::HMM - libmoot : HMM
           );
  
   $hmm->tag_sentence(\@sent,$utf8=1,$trace=0);  ##-- clobbers 'tag' key of each token hash
+  $hmm->tag_sentences([\@sent1,\@sent2,...],$utf8=1,$trace=0); ##-- batch-mode tag_sentence()
  
   $hmm->tag_io    ( $reader, $writer );         ##-- sentence-stream tagging
   $hmm->tag_stream( $reader, $writer );         ##-- token-stream tagging
@@ -38,6 +38,7 @@ sub load {
 sub from_array {
   my $lx = shift;
   $lx->insert($_) foreach (map {ref($_) && ref($_) eq 'ARRAY' ? @$_ : $_} @_);
+  $lx->freeze();
   return $lx;
 }
 
@@ -69,6 +70,7 @@ Moot::Waste::Lexicon - libmoot : WASTE tokenizer : simple word-list lexicon
   $lex->insert($str);			##-- insert a string
   $n    = $lex->size();			##-- get number of entries
   $bool = $lex->lookup($str);		##-- check for membership
+  $lex->freeze();			##-- compile for fast lookup (implied by load(); insert() undoes it)
 
   ##---------------------------------------------------------------------
   ## I/O
@@ -178,6 +178,12 @@ CODE:
 OUTPUT:
  RETVAL
 
+##--------------------------------------------------------------
+void
+freeze(wasteLexicon* lx)
+CODE:
+ lx->freeze();
+
 ##--------------------------------------------------------------
 bool
 _load_reader(wasteLexicon* lx, TokenReader *reader)
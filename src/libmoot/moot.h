@@ -44,6 +44,7 @@
 #include <mootHMM.h>          /*-- runtime tagging --*/
 #include <mootDynHMM.h>       /*-- runtime tagging, dynamic model --*/
 #include <mootEval.h>         /*-- tagger output evaluation --*/
+#include <mootHMMSweep.h>     /*-- cross-validation & parameter sweeps --*/
 
 //----------------------------------------------------------------------
 // Low-level utilties
@@ -141,7 +141,8 @@ namespace mootBinIO {
       }
       Size tmp;
       bool rc = loadItem<Size>(is,tmp);
-      x = tmp;
+      //-- preserve (size_t)-1 sentinels (e.g. TrieVector::NoNode)
+      x = (tmp == static_cast<Size>(-1) ? static_cast<size_t>(-1) : tmp);
       return rc;
     };
  
@@ -621,9 +622,12 @@ namespace mootBinIO {
     inline bool load(mootio::mistream *is, mootTaster &x) const
     {
       x.clear();
-      return (rules_item.load(is,x.rules)
-	      && string_item.load(is,x.nolabel)
-	      && uint_item.load(is,x.noid));
+      if (!(rules_item.load(is,x.rules)
+	    && string_item.load(is,x.nolabel)
+	    && uint_item.load(is,x.noid)))
+	return false;
+      x.compile();
+      return true;
     };
     inline bool save(mootio::mostream *os, const mootTaster &x) const
     {
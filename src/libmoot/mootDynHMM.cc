@@ -73,6 +73,14 @@ void mootDynHMM::tag_sentence(mootSentence &sentence)
   this->tag_hook_post(sentence);
 }
 
+//--------------------------------------------------------------
+void mootDynHMM::tag_batch(SentenceBatch &batch)
+{
+  for (SentenceBatch::iterator bi = batch.begin(); bi != batch.end(); ++bi) {
+    if (*bi) this->tag_sentence(**bi);
+  }
+}
+
 
 /*======================================================================
  * mootDynLexHMM
@@ -217,6 +217,13 @@ public:
    * Just wraps mootHMM::tag_sentence() in calls to tag_hook_pre() and tag_hook_post().
    */
   virtual void tag_sentence(mootSentence &sentence);
+
+  /**
+   * Top-level tagging interface: sentence batch.
+   * Calls virtual tag_sentence() for each element of \c batch, since
+   * tag_hook_pre() may alter lexical data between sentences.
+   */
+  virtual void tag_batch(SentenceBatch &batch);
   //@}
 };
 
@@ -272,7 +279,9 @@ public:
       newtag_id(0),
       Ftw_eps(0.5),
       tagids_size_orig(0)
-  {};
+  {
+    lexcache_max = 0; //-- lexical data may change for each sentence: don't cache
+  };
 
   virtual ~mootDynLexHMM(void) {};
 
@@ -26,6 +26,9 @@
  *   + moot PoS tagger : evaluator : guts
  *--------------------------------------------------------------------------*/
 
+#ifdef HAVE_CONFIG_H
+# include <mootConfig.h>
+#endif
 
 #include <mootEval.h>
 #include <mootToken.h>
@@ -97,4 +100,299 @@ string mootEval::status_string(void)
 }
 
 
+/*==========================================================================
+ * mootEvalStats
+ *==========================================================================*/
+
+/*--------------------------------------------------------------------------
+ * clear()
+ */
+void mootEvalStats::clear(void)
+{
+  ntokens = nsents = ntokmisses = nbestmisses = 0;
+  file1 = FileCounts();
+  file2 = FileCounts();
+  confusion.clear();
+  known   = Accuracy();
+  unknown = Accuracy();
+  flavors.clear();
+}
+
+/*--------------------------------------------------------------------------
+ * add(eval,tok1,tok2)
+ */
+int mootEvalStats::add(mootEval &eval, const mootToken &tok1, const mootToken &tok2)
+{
+  int  status  = eval.compareTokens(tok1,tok2);
+  bool correct = !(status & mootEval::MEF_BestMismatch);
+
+  ntokens++;
+  file1.nanls += tok1.analyses().size();
+  file2.nanls += tok2.analyses().size();
+
+  if (status & mootEval::MEF_TokMismatch) ntokmisses++;
+  if (!correct) nbestmisses++;
+
+  if (status & mootEval::MEF_EmptyClass1) {
+    file1.nempties++;
+    if (correct) file1.nsaves++;
+  }
+  else if (!correct) {
+    file1.nfumbles++;
+  }
+
+  if (status & mootEval::MEF_EmptyClass2) {
+    file2.nempties++;
+    if (correct) file2.nsaves++;
+  }
+  else if (!correct) {
+    file2.nfumbles++;
+  }
+
+  if (status & mootEval::MEF_ImpClass1)  file1.nimps++;
+  if (status & mootEval::MEF_ImpClass2)  file2.nimps++;
+  if (status & mootEval::MEF_XImpClass1) file1.nximps++;
+  if (status & mootEval::MEF_XImpClass2) file2.nximps++;
+
+  //-- breakdowns
+  confusion[tok1.besttag()][tok2.besttag()]++;
+  if (lexicon) {
+    if (lexicon->f_word(tok1.text()) > 0) known.add(correct);
+    else                                  unknown.add(correct);
+  }
+  if (taster) flavors[taster->flavor(tok1.text())].add(correct);
+
+  return status;
+}
+
+/*--------------------------------------------------------------------------
+ * write_tsv(os)
+ */
+bool mootEvalStats::write_tsv(mootio::mostream *os) const
+{
+  if (!os || !os->valid()) return false;
+
+  //-- counts
+  os->printf("count\ttokens\t%lu\n", static_cast<unsigned long>(ntokens));
+  os->printf("count\tsentences\t%lu\n", static_cast<unsigned long>(nsents));
+  os->printf("count\ttoken_mismatches\t%lu\n", static_cast<unsigned long>(ntokmisses));
+  os->printf("count\ttag_mismatches\t%lu\n", static_cast<unsigned long>(nbestmisses));
+
+  //-- accuracy: all, known, unknown
+  Accuracy all;
+  all.ntokens  = ntokens;
+  all.ncorrect = ntokens-nbestmisses;
+  os->printf("accuracy\tall\t%lu\t%lu\t%.6f\n",
+	     static_cast<unsigned long>(all.ntokens), static_cast<unsigned long>(all.ncorrect), all.accuracy());
+  if (lexicon) {
+    os->printf("accuracy\tknown\t%lu\t%lu\t%.6f\n",
+	       static_cast<unsigned long>(known.ntokens), static_cast<unsigned long>(known.ncorrect), known.accuracy());
+    os->printf("accuracy\tunknown\t%lu\t%lu\t%.6f\n",
+	       static_cast<unsigned long>(unknown.ntokens), static_cast<unsigned long>(unknown.ncorrect), unknown.accuracy());
+  }
+
+  //-- accuracy by flavor
+  for (FlavorMap::const_iterator fi = flavors.begin(); fi != flavors.end(); ++fi) {
+    os->printf("flavor\t%s\t%lu\t%lu\t%.6f\n",
+	       (fi->first.empty() ? "-" : fi->first.c_str()),
+	       static_cast<unsigned long>(fi->second.ntokens),
+	       static_cast<unsigned long>(fi->second.ncorrect),
+	       fi->second.accuracy());
+  }
+
+  //-- per-tag precision & recall: T-tag totals are row sums, E-tag totals column sums
+  std::map<mootTagString,size_t> ntrue, neval, ncorrect;
+  ConfusionMatrix::const_iterator ri;
+  ConfusionRow::const_iterator    ci;
+  for (ri = confusion.begin(); ri != confusion.end(); ++ri) {
+    for (ci = ri->second.begin(); ci != ri->second.end(); ++ci) {
+      ntrue[ri->first] += ci->second;
+      neval[ci->first] += ci->second;
+      if (ri->first == ci->first) ncorrect[ri->first] = ci->second;
+    }
+  }
+  for (ci = neval.begin(); ci != neval.end(); ++ci) ntrue[ci->first];  //-- include E-only tags
+  for (ci = ntrue.begin(); ci != ntrue.end(); ++ci) {
+    size_t nt = ci->second, ne = neval[ci->first], nc = ncorrect[ci->first];
+    double pr = ne ? static_cast<double>(nc)/static_cast<double>(ne) : 0.0;
+    double rc = nt ? static_cast<double>(nc)/static_cast<double>(nt) : 0.0;
+    os->printf("tag\t%s\t%lu\t%lu\t%lu\t%.6f\t%.6f\t%.6f\n",
+	       ci->first.c_str(),
+	       static_cast<unsigned long>(nt), static_cast<unsigned long>(ne), static_cast<unsigned long>(nc),
+	       pr, rc, (pr+rc > 0 ? 2.0*pr*rc/(pr+rc) : 0.0));
+  }
+
+  //-- confusion matrix (non-zero cells only)
+  for (ri = confusion.begin(); ri != confusion.end(); ++ri) {
+    for (ci = ri->second.begin(); ci != ri->second.end(); ++ci) {
+      os->printf("confusion\t%s\t%s\t%lu\n",
+		 ri->first.c_str(), ci->first.c_str(), static_cast<unsigned long>(ci->second));
+    }
+  }
+
+  return os->valid();
+}
+
+/*==========================================================================
+ * mootEvalPrefetch
+ *==========================================================================*/
+
+/*--------------------------------------------------------------------------
+ * constructor / destructor
+ */
+mootEvalPrefetch::mootEvalPrefetch(TokenReader *my_reader)
+  : reader(my_reader),
+    chunk_size(1024),
+    max_chunks(8),
+    threaded(false),
+    cur(NULL),
+    cur_pos(0),
+    cur_size(0),
+    item(NULL),
+    done(false),
+    stopping(false)
+{
+  eof_item.type = TokTypeEOF;
+#ifdef MOOT_PTHREADS_ENABLED
+  pthread_mutex_init(&mutex, NULL);
+  pthread_cond_init(&cond, NULL);
+#endif
+}
+
+mootEvalPrefetch::~mootEvalPrefetch(void)
+{
+  stop();
+#ifdef MOOT_PTHREADS_ENABLED
+  pthread_cond_destroy(&cond);
+  pthread_mutex_destroy(&mutex);
+#endif
+}
+
+/*--------------------------------------------------------------------------
+ * start(), stop()
+ */
+bool mootEvalPrefetch::start(bool use_thread)
+{
+  stop();
+  done     = false;
+  stopping = false;
+#ifdef MOOT_PTHREADS_ENABLED
+  //-- native readers may run here too: their shared scanner tables are locked per token
+  if (use_thread && reader && chunk_size > 0)
+    threaded = (pthread_create(&thread, NULL, _work_thread, this) == 0);
+#endif
+  return threaded;
+}
+
+void mootEvalPrefetch::stop(void)
+{
+#ifdef MOOT_PTHREADS_ENABLED
+  if (threaded) {
+    pthread_mutex_lock(&mutex);
+    stopping = true;
+    pthread_cond_broadcast(&cond);
+    pthread_mutex_unlock(&mutex);
+    pthread_join(thread, NULL);
+  }
+#endif
+  threaded = false;
+
+  if (cur) delete cur;
+  for (size_t i=0; i < full.size(); ++i) delete full[i];
+  for (size_t i=0; i < spare.size(); ++i) delete spare[i];
+  cur = NULL;
+  full.clear();
+  sizes.clear();
+  spare.clear();
+  cur_pos = cur_size = 0;
+  item = NULL;
+}
+
+/*--------------------------------------------------------------------------
+ * get_token()
+ */
+mootTokenType mootEvalPrefetch::get_token(void)
+{
+  if (!threaded) return reader ? reader->get_token() : TokTypeEOF;
+
+  if (!cur || cur_pos >= cur_size) {
+#ifdef MOOT_PTHREADS_ENABLED
+    pthread_mutex_lock(&mutex);
+    if (cur) spare.push_back(cur);
+    cur = NULL;
+    while (full.empty() && !done) pthread_cond_wait(&cond, &mutex);
+    if (!full.empty()) {
+      cur      = full.front();
+      cur_size = sizes.front();
+      cur_pos  = 0;
+      full.pop_front();
+      sizes.pop_front();
+      pthread_cond_broadcast(&cond);
+    }
+    pthread_mutex_unlock(&mutex);
+#endif
+    if (!cur) {
+      item = &eof_item;
+      return TokTypeEOF;
+    }
+  }
+  item = &(*cur)[cur_pos++];
+  return item->type;
+}
+
+/*--------------------------------------------------------------------------
+ * work()
+ */
+void mootEvalPrefetch::work(void)
+{
+#ifdef MOOT_PTHREADS_ENABLED
+  for (bool eof=false; !eof; ) {
+    //-- get an empty chunk
+    pthread_mutex_lock(&mutex);
+    while (!stopping && full.size() >= max_chunks) pthread_cond_wait(&cond, &mutex);
+    if (stopping) {
+      pthread_mutex_unlock(&mutex);
+      break;
+    }
+    Chunk *chunk;
+    if (spare.empty()) {
+      chunk = new Chunk(chunk_size);
+    } else {
+      chunk = spare.back();
+      spare.pop_back();
+    }
+    pthread_mutex_unlock(&mutex);
+
+    //-- fill it
+    if (chunk->size() < chunk_size) chunk->resize(chunk_size);
+    size_t n = 0;
+    while (n < chunk_size && !eof) {
+      Item &it = (*chunk)[n++];
+      it.type = reader->get_token();
+      const mootToken *tok = reader->token();
+      it.has_tok = (tok != NULL);
+      if (tok) it.tok = *tok;
+      it.line = reader->line_number();
+      eof = (it.type == TokTypeEOF);
+    }
+
+    //-- hand it over
+    pthread_mutex_lock(&mutex);
+    full.push_back(chunk);
+    sizes.push_back(n);
+    if (eof) done = true;
+    pthread_cond_broadcast(&cond);
+    pthread_mutex_unlock(&mutex);
+  }
+#endif
+}
+
+#ifdef MOOT_PTHREADS_ENABLED
+void *mootEvalPrefetch::_work_thread(void *data)
+{
+  reinterpret_cast<mootEvalPrefetch*>(data)->work();
+  return NULL;
+}
+#endif
+
 moot_END_NAMESPACE
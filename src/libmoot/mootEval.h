@@ -35,6 +35,13 @@
 #define _moot_EVAL_H
 
 #include <mootToken.h>
+#include <mootTokenIO.h>
+#include <mootLexfreqs.h>
+#include <mootFlavor.h>
+
+#ifdef MOOT_PTHREADS_ENABLED
+# include <pthread.h>
+#endif
 
 moot_BEGIN_NAMESPACE
 
@@ -147,6 +154,203 @@ public:
 };
 
 
+/*--------------------------------------------------------------------------
+ * mootEvalStats : accumulated evaluation statistics
+ *--------------------------------------------------------------------------*/
+
+/**
+ * \brief Accumulated statistics for a tagger evaluation.
+ * \details
+ * Collects the counts reported by the \c mooteval program together with
+ * a per-tag confusion matrix, accuracy for known and unknown tokens (with
+ * respect to \a lexicon), and accuracy per token flavor (with respect to
+ * \a taster).  The first token passed to add() is taken from the reference
+ * file (T-file), the second from the file being evaluated (E-file).
+ */
+class mootEvalStats {
+public:
+  /*----------------------------------------------------
+   * Embedded types
+   */
+  /** Type for a row of the confusion matrix: E-file tag -> count */
+  typedef std::map<mootTagString,size_t> ConfusionRow;
+
+  /** Type for the confusion matrix: T-file tag -> E-file tag -> count (sorted for reproducible output) */
+  typedef std::map<mootTagString,ConfusionRow> ConfusionMatrix;
+
+  /** \brief Token and correct-tag counts for a subset of tokens */
+  class Accuracy {
+  public:
+    size_t ntokens;   /**< number of tokens */
+    size_t ncorrect;  /**< number of tokens whose best tags matched */
+  public:
+    Accuracy(void) : ntokens(0), ncorrect(0) {};
+    inline void add(bool correct) { ++ntokens; if (correct) ++ncorrect; };
+    inline double accuracy(void) const
+    { return ntokens ? static_cast<double>(ncorrect)/static_cast<double>(ntokens) : 0.0; };
+  };
+
+  /** Type for per-flavor accuracy */
+  typedef std::map<mootFlavorStr,Accuracy> FlavorMap;
+
+  /** \brief Counts for one of the compared files (see \c mooteval(1) for definitions) */
+  class FileCounts {
+  public:
+    unsigned long nanls;  /**< total number of analyses */
+    size_t nempties;      /**< number of empty analysis sets */
+    size_t nimps;         /**< number of impossible analysis sets */
+    size_t nximps;        /**< number of cross-impossible analysis sets */
+    size_t nsaves;        /**< number of empty analysis sets with matching best tags */
+    size_t nfumbles;      /**< number of non-empty analysis sets with mismatched best tags */
+  public:
+    FileCounts(void) : nanls(0), nempties(0), nimps(0), nximps(0), nsaves(0), nfumbles(0) {};
+  };
+
+public:
+  /*----------------------------------------------------
+   * Data
+   */
+  size_t           ntokens;      /**< number of tokens compared */
+  size_t           nsents;       /**< number of sentences (counted by the caller) */
+  size_t           ntokmisses;   /**< number of token-text mismatches */
+  size_t           nbestmisses;  /**< number of best-tag mismatches */
+  FileCounts       file1;        /**< counts for the T-file */
+  FileCounts       file2;        /**< counts for the E-file */
+
+  ConfusionMatrix  confusion;    /**< per-tag confusion matrix */
+  Accuracy         known;        /**< accuracy for tokens known to \a lexicon */
+  Accuracy         unknown;      /**< accuracy for tokens unknown to \a lexicon */
+  FlavorMap        flavors;      /**< accuracy by flavor of T-file token text */
+
+  const mootLexfreqs *lexicon;   /**< if non-NULL, tokens with zero frequency count as unknown (not owned) */
+  const mootTaster   *taster;    /**< if non-NULL, per-flavor accuracy is collected (not owned) */
+
+public:
+  /*----------------------------------------------------
+   * Methods
+   */
+  /** Default constructor */
+  mootEvalStats(void) : lexicon(NULL), taster(NULL) { clear(); };
+
+  /** Reset all counts (but not \a lexicon or \a taster) */
+  void clear(void);
+
+  /**
+   * Compare \a tok1 (T-file) and \a tok2 (E-file) with \a eval and add the results;
+   * returns the evalStatus flags computed by eval.compareTokens().
+   */
+  int add(mootEval &eval, const mootToken &tok1, const mootToken &tok2);
+
+  /**
+   * Write statistics to \a os in a line-oriented, TAB-separated format.
+   * Each line begins with a record type: "count", "accuracy", "flavor",
+   * "tag" (per-tag precision, recall and F-score), or "confusion".
+   */
+  bool write_tsv(mootio::mostream *os) const;
+};
+
+
+/*--------------------------------------------------------------------------
+ * mootEvalPrefetch : threaded token input for evaluation
+ *--------------------------------------------------------------------------*/
+
+/**
+ * \brief Read-ahead wrapper for one input of a tagger evaluation.
+ * \details
+ * Offers the subset of the TokenReader interface used for token-wise
+ * comparison (get_token(), token(), line_number()).  If started in threaded
+ * mode, tokens are read by a background thread and handed over in chunks of
+ * \a chunk_size tokens, with at most \a max_chunks chunks waiting, so that
+ * both inputs of an evaluation are scanned in parallel with the comparison.
+ * Native-format readers share a scanner lock (see TokenReaderNative::get_token()),
+ * so their lexing is serialized, but still overlaps with the comparison.
+ * Otherwise (or without POSIX threads support) calls are passed through to
+ * the underlying reader.
+ */
+class mootEvalPrefetch {
+public:
+  /** \brief A single buffered token */
+  class Item {
+  public:
+    mootTokenType type;     /**< token type returned by TokenReader::get_token() */
+    bool          has_tok;  /**< false if TokenReader::token() returned NULL */
+    mootToken     tok;      /**< copy of TokenReader::token() */
+    size_t        line;     /**< value of TokenReader::line_number() */
+  public:
+    Item(void) : type(TokTypeUnknown), has_tok(false), line(0) {};
+  };
+
+  /** Type for a chunk of buffered tokens */
+  typedef vector<Item> Chunk;
+
+public:
+  TokenReader  *reader;      /**< underlying reader (not owned) */
+  size_t        chunk_size;  /**< number of tokens per chunk (default: 1024) */
+  size_t        max_chunks;  /**< maximum number of filled chunks waiting (default: 8) */
+
+protected:
+  bool                 threaded;  /**< true if a background thread is running */
+  Chunk               *cur;       /**< chunk currently being consumed (threaded mode) */
+  size_t               cur_pos;   /**< position of the next item in \a cur */
+  size_t               cur_size;  /**< number of items in \a cur */
+  const Item          *item;      /**< item returned by the last call to get_token() */
+  Item                 eof_item;  /**< item returned at end of input */
+  std::deque<Chunk*>   full;      /**< filled chunks (front is next) */
+  std::deque<size_t>   sizes;     /**< number of items in each chunk of \a full */
+  vector<Chunk*>       spare;     /**< empty chunks available for reuse */
+  bool                 done;      /**< true once the background thread has read EOF */
+  bool                 stopping;  /**< true if the background thread should exit */
+#ifdef MOOT_PTHREADS_ENABLED
+  pthread_t            thread;    /**< background reader thread */
+  pthread_mutex_t      mutex;     /**< guards \a full, \a sizes, \a spare, \a done, \a stopping */
+  pthread_cond_t       cond;      /**< signals chunk hand-over in either direction */
+#endif
+
+public:
+  /** Constructor */
+  mootEvalPrefetch(TokenReader *my_reader=NULL);
+
+  /** Destructor: calls stop() */
+  ~mootEvalPrefetch(void);
+
+  /**
+   * Start reading from \a reader; if \a use_thread is true and POSIX threads are
+   * available, reading happens in a background thread.  Returns true if a thread
+   * was started.
+   */
+  bool start(bool use_thread=true);
+
+  /** Stop the background thread (if any) and release buffered tokens */
+  void stop(void);
+
+  /** Get the next token; returns TokTypeEOF at end of input */
+  mootTokenType get_token(void);
+
+  /** Get the token read by the last call to get_token() (may be NULL) */
+  inline const mootToken *token(void)
+  {
+    if (!threaded) return reader ? reader->token() : NULL;
+    return item && item->has_tok ? &item->tok : NULL;
+  };
+
+  /** Get the input line number of the token read by the last call to get_token() */
+  inline size_t line_number(void)
+  {
+    if (!threaded) return reader ? reader->line_number() : 0;
+    return item ? item->line : 0;
+  };
+
+protected:
+  /** Background thread main loop */
+  void work(void);
+
+#ifdef MOOT_PTHREADS_ENABLED
+  /** Background thread entry point */
+  static void *_work_thread(void *data);
+#endif
+};
+
+
 moot_END_NAMESPACE
 
 #endif /* _moot_EVAL_H */
@@ -43,7 +43,9 @@ mootExpatParser::mootExpatParser(size_t bufsize, const std::string &encoding)
     xml_buflen(bufsize),
     xml_encoding(encoding),
     //xml_done(1),
-    parser(NULL)
+    parser(NULL),
+    xp_suspended(false),
+    xp_final(0)
 {
   reset();
 }
@@ -75,6 +77,8 @@ void mootExpatParser::reset(void)
 
   //-- reset 'done' flag
   //xml_done = 0;
+  xp_suspended = false;
+  xp_final     = 0;
 
   //-- allocate/reset parser
   if (parser) {
@@ -263,29 +267,66 @@ bool mootExpatParser::parse_all(mootio::mistream *in)
  */
 bool mootExpatParser::parse_chunk(int &nbytes, int &is_final, mootio::mistream *in)
 {
-  //-- minimal sanity check
-  if (!in) in = xp_istream;
-  if (!in) return false;
-  
-  //-- fill 'er up
-  nbytes = in->read(xml_buf, xml_buflen);
-  if (!in->valid()) {
-    xpcarp("parse_chunk(): Read error");
-    return false;
+  int status;
+
+#ifdef MOOT_EXPAT_SUSPEND
+  if (xp_suspended) {
+    //-- resume suspended chunk (expat has buffered its unparsed remainder)
+    nbytes   = 0;
+    is_final = xp_final;
+    status   = XML_ResumeParser(parser);
   }
+  else
+#endif
+  {
+    //-- minimal sanity check
+    if (!in) in = xp_istream;
+    if (!in) return false;
+
+    //-- fill 'er up
+    nbytes = in->read(xml_buf, xml_buflen);
+    if (!in->valid()) {
+      xpcarp("parse_chunk(): Read error");
+      return false;
+    }
+
+    //-- check for eof
+    is_final = in->eof();
 
-  //-- check for eof
-  is_final = in->eof();
+    //-- ye olde expatte guttes
+    status = XML_Parse(parser, xml_buf, nbytes, is_final);
+  }
 
-  //-- ye olde expatte guttes
-  if (!XML_Parse(parser, xml_buf, nbytes, is_final)) {
+  if (status == XML_STATUS_ERROR) {
+    xp_suspended = false;
     xpcarp("parse_chunk(): Parse error");
     return false;
   }
 
+#ifdef MOOT_EXPAT_SUSPEND
+  //-- suspended: we're not done with this chunk yet
+  xp_suspended = (status == XML_STATUS_SUSPENDED);
+  if (xp_suspended) {
+    xp_final = is_final;
+    is_final = 0;
+  }
+#endif
+
   return true;
 }
 
+/*----------------------------------------------------
+ * mootExpatParser: Parsing: Suspend
+ */
+bool mootExpatParser::suspend(void)
+{
+#ifdef MOOT_EXPAT_SUSPEND
+  return parser && XML_StopParser(parser, XML_TRUE) == XML_STATUS_OK;
+#else
+  return false;
+#endif
+}
+
 /*----------------------------------------------------
  * mootExpatParser: Context
  */
@@ -51,6 +51,11 @@
 /** Default input buffer length for XML parsers */
 #define MOOT_DEFAULT_EXPAT_BUFLEN 8192
 
+/** Defined iff expat supports suspending and resuming the parser (expat >= 1.95.8) */
+#if XML_MAJOR_VERSION > 1 || (XML_MAJOR_VERSION == 1 && (XML_MINOR_VERSION > 95 || (XML_MINOR_VERSION == 95 && XML_MICRO_VERSION >= 8)))
+# define MOOT_EXPAT_SUSPEND 1
+#endif
+
 namespace moot {
 
 /*--------------------------------------------------------------
@@ -112,6 +117,8 @@ namespace moot {
     std::string        xml_encoding; ///< Input encoding override (goofy)
     //int                xml_done;     ///< whether we're done parsing yet
     XML_Parser         parser;       ///< The underlying expat parser object
+    bool               xp_suspended; ///< whether parsing was suspended by suspend() and is resumed by the next parse_chunk()
+    int                xp_final;     ///< \p is_final flag of the suspended chunk
     //@}
  
   public:
@@ -273,6 +280,16 @@ namespace moot {
      *          calling this method -- no sanity checks are performed!
      */
     bool parse_chunk(int &nbytes, int &is_final, mootio::mistream *in=NULL);
+
+    /**
+     * Suspend parsing after the current handler returns: the current call to
+     * parse_chunk() returns (with \p is_final=0), and the next call resumes
+     * parsing of the current chunk before reading any new data.
+     * Intended to be called from handlers.
+     * Returns false if the parser could not be suspended (e.g. if expat
+     * lacks support), in which case parsing just continues.
+     */
+    bool suspend(void);
     //@}
 
     /*----------------------------------------------------*/
@@ -0,0 +1,111 @@
+/* -*- Mode: C++ -*- */
+
+/*
+   libmoot : moocow's part-of-speech tagging library
+   Copyright (C) 2004-2010 by Bryan Jurish <moocow@cpan.org>
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 3 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+/*--------------------------------------------------------------------------
+ * File: mootFdIO.cc
+ * Author: Bryan Jurish <moocow@cpan.org>
+ * Description:
+ *   + moot PoS tagger : low-level I/O abstractions for file descriptors (sockets, pipes)
+ *--------------------------------------------------------------------------*/
+
+#ifdef HAVE_CONFIG_H
+# include <mootConfig.h>
+#endif
+
+#include <mootFdIO.h>
+#include <errno.h>
+#include <unistd.h>
+
+namespace mootio {
+
+/*--------------------------------------------------------------------------
+ * mfdstream: close()
+ */
+bool mfdstream::close(void)
+{
+  bool rc = true;
+  if (fd >= 0) {
+    rc = flush();
+    if (fd_owned && ::close(fd) != 0) rc = false;
+  }
+  fd       = -1;
+  fd_owned = false;
+  fd_errno = 0;
+  ibuf.clear();
+  ipos     = 0;
+  ieof     = false;
+  obuf.clear();
+  return rc;
+}
+
+/*--------------------------------------------------------------------------
+ * mfdstream: fill()
+ */
+ByteCount mfdstream::fill(void)
+{
+  if (fd < 0 || ieof || fd_errno) return 0;
+
+  //-- discard consumed input
+  if (ipos >= ibuf.size()) {
+    ibuf.clear();
+    ipos = 0;
+  }
+
+  char buf[8192];
+  ssize_t nread;
+  do {
+    nread = ::read(fd, buf, sizeof(buf));
+  } while (nread < 0 && errno == EINTR);
+
+  if (nread < 0) {
+    fd_errno = errno;
+    return 0;
+  }
+  else if (nread == 0) {
+    ieof = true;
+    return 0;
+  }
+  ibuf.append(buf, nread);
+  return static_cast<ByteCount>(nread);
+}
+
+/*--------------------------------------------------------------------------
+ * mfdstream: flush()
+ */
+bool mfdstream::flush(void)
+{
+  if (fd < 0 || fd_errno) return false;
+  size_t nwritten = 0;
+  while (nwritten < obuf.size()) {
+    ssize_t n = ::write(fd, obuf.data()+nwritten, obuf.size()-nwritten);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      fd_errno = errno;
+      obuf.clear();
+      return false;
+    }
+    nwritten += n;
+  }
+  obuf.clear();
+  return true;
+}
+
+}; /* namespace mootio */
@@ -0,0 +1,182 @@
+/* -*- Mode: C++ -*- */
+
+/*
+   libmoot : moocow's part-of-speech tagging library
+   Copyright (C) 2004-2010 by Bryan Jurish <moocow@cpan.org>
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 3 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+/*--------------------------------------------------------------------------
+ * File: mootFdIO.h
+ * Author: Bryan Jurish <moocow@cpan.org>
+ * Description:
+ *   + moot PoS tagger : low-level I/O abstractions for file descriptors (sockets, pipes)
+ *--------------------------------------------------------------------------*/
+
+/** \file mootFdIO.h
+ *  \brief ::mootio abstraction layer for raw file descriptors
+ */
+
+#ifndef _MOOT_FDIO_H
+#define _MOOT_FDIO_H
+
+#include <mootIO.h>
+#include <string>
+
+namespace mootio {
+
+  /*====================================================================
+   * mfdstream : file descriptor i/o
+   *====================================================================*/
+  /**
+   * \brief Buffered wrapper class for raw file descriptors (e.g. sockets).
+   * \details
+   * Unlike mcstream, read() returns as soon as any data is available
+   * (at most one read(2) call per invocation), so readers on a socket
+   * or pipe see each chunk of input as soon as it arrives.  Output is
+   * buffered up to \a obuf_max bytes and written with write(2) on
+   * flush().
+   */
+  class mfdstream
+    : public mistream,
+      public mostream
+  {
+  public:
+    int          fd;        ///< underlying file descriptor (-1 for none)
+    bool         fd_owned;  ///< whether close() should close \a fd
+    int          fd_errno;  ///< errno of the last failed system call, or 0
+    std::string  ibuf;      ///< input buffer
+    size_t       ipos;      ///< read position in \a ibuf
+    bool         ieof;      ///< true if read(2) has returned end-of-file
+    std::string  obuf;      ///< output buffer
+    size_t       obuf_max;  ///< flush output buffer automatically when it exceeds this size
+
+  public:
+    /*----------------------------------------------------------
+     * mfdstream: constructors
+     */
+    ///\name Constructors etc.
+    //@{
+    /** Default constructor */
+    mfdstream(int myfd=-1, bool owned=false)
+      : fd(myfd), fd_owned(owned), fd_errno(0), ipos(0), ieof(false), obuf_max(8192)
+    {};
+
+    /** Destructor: flushes output and closes \a fd if owned */
+    ~mfdstream(void) { close(); };
+    //@}
+
+    /*----------------------------------------------------------
+     * mfdstream: integrity
+     */
+    ///\name Integrity Tests
+    //@{
+    /** Test stream integrity */
+    virtual bool valid(void) { return fd >= 0 && fd_errno == 0; };
+
+    /** Test for eof */
+    virtual bool eof(void) { return fd < 0 || (ieof && ipos >= ibuf.size()); };
+
+    /** Get current error message */
+    virtual std::string errmsg(void) {
+      return std::string(fd_errno ? strerror(fd_errno) : (fd < 0 ? "Invalid stream" : ""));
+    };
+    //@}
+
+    /*----------------------------------------------------------
+     * mfdstream: open/close
+     */
+    ///\name Open/Close
+    //@{
+    /** Select a new file descriptor (closing any current one) */
+    inline void from_fd(int myfd, bool owned=false)
+    {
+      close();
+      fd       = myfd;
+      fd_owned = owned;
+    };
+
+    /** Does nothing */
+    virtual bool reopen(void) { return fd >= 0; };
+
+    /** Flush pending output, close \a fd if owned, and reset buffers */
+    virtual bool close(void);
+    //@}
+
+    /*----------------------------------------------------------
+     * mfdstream: input
+     */
+    ///\name Input Methods
+    //@{
+    /**
+     * Append more data to \a ibuf with a single read(2) call, blocking until
+     * some data is available.  Returns the number of bytes read (0 on eof or error).
+     */
+    virtual ByteCount fill(void);
+
+    /** Read up to \p n bytes of data into \p buf,
+     *  returns number of bytes actually read (0 only on eof). */
+    virtual ByteCount read(char *buf, size_t n) {
+      if (ipos >= ibuf.size() && fill() <= 0) return 0;
+      size_t avail = ibuf.size()-ipos;
+      if (n > avail) n = avail;
+      memcpy(buf, ibuf.data()+ipos, n);
+      ipos += n;
+      return static_cast<ByteCount>(n);
+    };
+
+    /** Read a single byte of data.  Returns EOF on eof. */
+    virtual int getbyte(void) {
+      if (ipos >= ibuf.size() && fill() <= 0) return EOF;
+      return static_cast<unsigned char>(ibuf[ipos++]);
+    };
+    //@}
+
+    /*----------------------------------------------------------
+     * mfdstream: output
+     */
+    ///\name Output Methods
+    //@{
+    /** Write all pending output to \a fd */
+    virtual bool flush(void);
+
+    /** Write \p n bytes from \p buf to the stream */
+    virtual bool write(const char *buf, size_t n) {
+      if (fd < 0) return false;
+      obuf.append(buf, n);
+      return obuf.size() < obuf_max || flush();
+    };
+
+    /** Write a single byte to the stream */
+    virtual bool putbyte(unsigned char c) {
+      char ch = static_cast<char>(c);
+      return write(&ch, 1);
+    };
+
+    /** Write a C string to the stream */
+    virtual bool puts(const char *s) {
+      return write(s, strlen(s));
+    };
+    /** Write a C++ string to the stream */
+    virtual bool puts(const std::string &s) {
+      return write(s.data(), s.size());
+    };
+    //@}
+  };
+
+}; /* namespace mootio */
+
+#endif /* _MOOT_FDIO_H */
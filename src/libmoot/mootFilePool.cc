@@ -0,0 +1,264 @@
+/* -*- Mode: C++ -*- */
+
+/*
+   libmoot : moocow's part-of-speech tagging library
+   Copyright (C) 2003-2014 by Bryan Jurish <moocow@cpan.org>
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 3 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+/*--------------------------------------------------------------------------
+ * File: mootFilePool.cc
+ * Author: Bryan Jurish <moocow@cpan.org>
+ * Description:
+ *   + moot PoS tagger : parallel processing of multiple input files
+ *--------------------------------------------------------------------------*/
+
+#ifdef HAVE_CONFIG_H
+# include <mootConfig.h>
+#endif
+
+#include <mootFilePool.h>
+
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+
+namespace moot {
+
+using namespace std;
+using namespace mootio;
+
+/*======================================================================
+ * Worker
+ */
+
+//--------------------------------------------------------------
+bool cmdutil_file_pool::Worker::open(const std::string &name)
+{
+  close();
+  in.name = name;
+  if (in.reopen()) {
+#ifdef MOOT_ZLIB_ENABLED
+    const char *ext = moot_extension(in.name.c_str());
+    if (ext && (strcmp(ext,".gz")==0 || strcmp(ext,".mbz")==0)) zin.from_file(in.file);
+#endif
+    return true;
+  }
+  //-- open error
+  const char *progname = pool && pool->churner ? pool->churner->progname : "cmdutil_file_pool";
+  bool paranoid = pool && pool->churner ? pool->churner->paranoid : true;
+  fprintf(stderr, "%s: open failed for input-file '%s': %s%s\n",
+	  progname, in.name.c_str(), strerror(errno),
+	  (!paranoid ? ": skipping" : ""));
+  if (paranoid) abort();
+  return false;
+}
+
+//--------------------------------------------------------------
+void cmdutil_file_pool::Worker::close(void)
+{
+#ifdef MOOT_ZLIB_ENABLED
+  zin.close();
+#endif
+  in.close();
+}
+
+//--------------------------------------------------------------
+mootio::mistream *cmdutil_file_pool::Worker::input(void)
+{
+#ifdef MOOT_ZLIB_ENABLED
+  if (zin.file) return &zin;
+#endif
+  return &in;
+}
+
+/*======================================================================
+ * Constructors etc.
+ */
+
+//--------------------------------------------------------------
+cmdutil_file_pool::cmdutil_file_pool(cmdutil_file_churner *my_churner, size_t my_njobs)
+  : churner(my_churner),
+    njobs(my_njobs ? my_njobs : 1),
+    window(0),
+    nfiles(0),
+    nerrors(0),
+    next_job(0),
+    next_done(0),
+    eoi(false)
+{
+#ifdef MOOT_PTHREADS_ENABLED
+  pthread_mutex_init(&mutex, NULL);
+  pthread_cond_init(&cond, NULL);
+#endif
+}
+
+//--------------------------------------------------------------
+cmdutil_file_pool::~cmdutil_file_pool(void)
+{
+  for (size_t i=0; i < jobs.size(); ++i) delete jobs[i];
+  for (size_t i=0; i < workers.size(); ++i) delete workers[i];
+#ifdef MOOT_PTHREADS_ENABLED
+  pthread_cond_destroy(&cond);
+  pthread_mutex_destroy(&mutex);
+#endif
+}
+
+/*======================================================================
+ * Operation
+ */
+
+//--------------------------------------------------------------
+bool cmdutil_file_pool::run(void)
+{
+  //-- setup: job ring & workers
+  size_t nslots = window ? window : 4*njobs;
+  if (nslots < njobs) nslots = njobs;
+  while (jobs.size() < nslots) jobs.push_back(new Job());
+  while (workers.size() < njobs) workers.push_back(new Worker(this, workers.size()));
+  nfiles = nerrors = next_job = next_done = 0;
+  eoi = (churner == NULL);
+
+  //-- start worker threads
+  size_t nthreads = 0;
+#ifdef MOOT_PTHREADS_ENABLED
+  if (njobs > 1) {
+    for ( ; nthreads < njobs; ++nthreads) {
+      if (pthread_create(&workers[nthreads]->thread, NULL, _work_thread, workers[nthreads]) != 0) break;
+    }
+  }
+#endif
+
+  if (nthreads == 0) {
+    //-- sequential fallback: process & finish each job in turn
+    Worker &w = *workers[0];
+    Job *job;
+    lock();
+    while ((job = get_job()) != NULL) {
+      unlock();
+      bool ok      = w.open(job->name) && process_file(w, *job);
+      bool read_ok = w.in.file == NULL || churner->check_input(w.input(), job->name);
+      w.close();
+      lock();
+      if (!read_ok) ++churner->nerrors;
+      job->ok   = ok && read_ok;
+      job->done = true;
+      finish_jobs();
+    }
+    unlock();
+    return nerrors == 0;
+  }
+
+  //-- parallel: finish jobs in input order as they complete
+  lock();
+  while (!eoi || next_done < next_job) {
+    if (finish_jobs()) continue;
+#ifdef MOOT_PTHREADS_ENABLED
+    pthread_cond_wait(&cond, &mutex);
+#endif
+  }
+  unlock();
+
+#ifdef MOOT_PTHREADS_ENABLED
+  for (size_t i=0; i < nthreads; ++i)
+    pthread_join(workers[i]->thread, NULL);
+#endif
+  return nerrors == 0;
+}
+
+//--------------------------------------------------------------
+cmdutil_file_pool::Job *cmdutil_file_pool::get_job(void)
+{
+  //-- called with mutex held (or single-threaded)
+  while (!eoi && next_job - next_done >= jobs.size()) {
+#ifdef MOOT_PTHREADS_ENABLED
+    pthread_cond_wait(&cond, &mutex);
+#endif
+  }
+  if (eoi) return NULL;
+
+  std::string &name = churner->next_input_name();
+  if (name.empty()) {
+    eoi = true;
+#ifdef MOOT_PTHREADS_ENABLED
+    pthread_cond_broadcast(&cond);
+#endif
+    return NULL;
+  }
+
+  Job *job   = jobs[next_job % jobs.size()];
+  job->index = next_job++;
+  job->name  = name;
+  job->ok    = false;
+  job->done  = false;
+  job->obuf.clear();
+  return job;
+}
+
+//--------------------------------------------------------------
+void cmdutil_file_pool::work(Worker &worker)
+{
+  lock();
+  Job *job;
+  while ((job = get_job()) != NULL) {
+    unlock();
+    bool ok      = worker.open(job->name) && process_file(worker, *job);
+    bool read_ok = worker.in.file == NULL || churner->check_input(worker.input(), job->name);
+    worker.close();
+    lock();
+    if (!read_ok) ++churner->nerrors;
+    job->ok   = ok && read_ok;
+    job->done = true;
+#ifdef MOOT_PTHREADS_ENABLED
+    pthread_cond_broadcast(&cond);
+#endif
+  }
+  unlock();
+}
+
+//--------------------------------------------------------------
+bool cmdutil_file_pool::finish_jobs(void)
+{
+  //-- called with mutex held (or single-threaded); releases it while finishing each job
+  bool finished = false;
+  while (next_done < next_job) {
+    Job *job = jobs[next_done % jobs.size()];
+    if (!job->done) break;
+    unlock();
+    finish_file(*job);
+    lock();
+    if (!job->ok) ++nerrors;
+    ++nfiles;
+    ++next_done;
+    finished = true;
+#ifdef MOOT_PTHREADS_ENABLED
+    pthread_cond_broadcast(&cond);
+#endif
+  }
+  return finished;
+}
+
+#ifdef MOOT_PTHREADS_ENABLED
+//--------------------------------------------------------------
+void *cmdutil_file_pool::_work_thread(void *data)
+{
+  Worker *w = reinterpret_cast<Worker*>(data);
+  w->pool->work(*w);
+  return NULL;
+}
+#endif
+
+}; //-- namespace moot
@@ -0,0 +1,198 @@
+/* -*- Mode: C++ -*- */
+
+/*
+   libmoot : moocow's part-of-speech tagging library
+   Copyright (C) 2003-2014 by Bryan Jurish <moocow@cpan.org>
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 3 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+/*--------------------------------------------------------------------------
+ * File: mootFilePool.h
+ * Author: Bryan Jurish <moocow@cpan.org>
+ * Description:
+ *   + moot PoS tagger : parallel processing of multiple input files
+ *--------------------------------------------------------------------------*/
+
+/**
+\file mootFilePool.h
+\brief Worker pool for processing the input files of a cmdutil_file_churner in parallel
+*/
+
+#ifndef _MOOT_FILE_POOL_H
+#define _MOOT_FILE_POOL_H
+
+#include <mootUtils.h>
+#include <mootBufferIO.h>
+
+#ifdef MOOT_PTHREADS_ENABLED
+# include <pthread.h>
+#endif
+
+#include <string>
+#include <vector>
+
+namespace moot {
+
+  /*======================================================================
+   * class cmdutil_file_pool
+   */
+  /**
+   * \brief Worker pool for churning through many input files in parallel.
+   * \details
+   * Input filenames are taken from a cmdutil_file_churner (in either
+   * file or list mode) and handed out to \a njobs worker threads, each of
+   * which opens its files itself (decompressing *.gz and *.mbz files) and
+   * passes them to process_file().  Subclasses keep any per-worker state
+   * (readers, writers, model instances) indexed by Worker::id.
+   *
+   * Each file is handled as a Job whose \a obuf may be used to buffer output.
+   * finish_file() is called in the thread which called run(), strictly in
+   * input order, so buffered output can be concatenated deterministically;
+   * at most \a window files are in progress or waiting to be finished at
+   * any time.
+   *
+   * Without POSIX threads support (MOOT_PTHREADS_ENABLED undefined), or if
+   * \a njobs <= 1, files are processed sequentially in the calling thread.
+   */
+  class cmdutil_file_pool {
+  public:
+    /*---------------------------------------------------------------------*/
+    /** \name Embedded Types */
+    //@{
+    /** \brief A single input file */
+    class Job {
+    public:
+      size_t              index;  /**< 0-based index of this file in the input sequence */
+      std::string         name;   /**< input filename ("-" for stdin) */
+      mootio::mcbuffer    obuf;   /**< buffered output for this file (optional) */
+      bool                ok;     /**< false if the file could not be opened or read, or process_file() failed */
+      bool                done;   /**< true once processing has finished */
+    public:
+      Job(void) : index(0), ok(false), done(false) {};
+    };
+
+    /** \brief Per-thread data */
+    class Worker {
+    public:
+      cmdutil_file_pool  *pool;   /**< pool this worker belongs to */
+      size_t              id;     /**< worker index in [0,njobs) */
+      mootio::mifstream   in;     /**< current input file */
+#ifdef MOOT_ZLIB_ENABLED
+      mootio::mizbstream  zin;    /**< decompressing wrapper for \a in (*.gz, *.mbz) */
+#endif
+#ifdef MOOT_PTHREADS_ENABLED
+      pthread_t           thread; /**< worker thread */
+#endif
+    public:
+      Worker(cmdutil_file_pool *my_pool=NULL, size_t my_id=0) : pool(my_pool), id(my_id) {};
+
+      /** Open input file \a name, reporting errors as cmdutil_file_churner does */
+      bool open(const std::string &name);
+
+      /** Close current input file */
+      void close(void);
+
+      /** Get current input stream (see cmdutil_file_churner::input()) */
+      mootio::mistream *input(void);
+    };
+    //@}
+
+  public:
+    /*---------------------------------------------------------------------*/
+    /** \name Data */
+    //@{
+    cmdutil_file_churner *churner;  /**< source of input filenames */
+    size_t                njobs;    /**< number of worker threads */
+    size_t                window;   /**< maximum number of unfinished jobs (0: 4*njobs) */
+    size_t                nfiles;   /**< number of files finished by the last call to run() */
+    size_t                nerrors;  /**< number of files with Job::ok==false in the last call to run() */
+
+  protected:
+    std::vector<Job*>     jobs;       /**< ring buffer of \a window jobs, indexed by Job::index % window */
+    std::vector<Worker*>  workers;    /**< per-thread data */
+    size_t                next_job;   /**< index of next job to be started */
+    size_t                next_done;  /**< index of next job to be finished */
+    bool                  eoi;        /**< true if \a churner has no more input files */
+#ifdef MOOT_PTHREADS_ENABLED
+    pthread_mutex_t       mutex;      /**< guards the job queue and \a churner */
+    pthread_cond_t        cond;       /**< signals job completion and queue space */
+#endif
+    //@}
+
+  public:
+    /*---------------------------------------------------------------------*/
+    /** \name Constructors etc. */
+    //@{
+    /** Constructor */
+    cmdutil_file_pool(cmdutil_file_churner *my_churner=NULL, size_t my_njobs=1);
+
+    /** Destructor */
+    virtual ~cmdutil_file_pool(void);
+    //@}
+
+    /*---------------------------------------------------------------------*/
+    /** \name Callbacks */
+    //@{
+    /**
+     * Process a single input file, which is opened as \a worker.input().
+     * Called concurrently from all worker threads; should return false on error.
+     */
+    virtual bool process_file(Worker &worker, Job &job) = 0;
+
+    /** Called for each job in input order in the thread which called run(); default does nothing */
+    virtual void finish_file(Job &job) {};
+    //@}
+
+    /*---------------------------------------------------------------------*/
+    /** \name Operation */
+    //@{
+    /** Process all remaining input files; returns true iff all files were processed successfully */
+    bool run(void);
+    //@}
+
+  protected:
+    /** Get next job for a worker, blocking while \a window jobs are unfinished; returns NULL at end of input */
+    Job *get_job(void);
+
+    /** Worker main loop: process jobs until end of input */
+    void work(Worker &worker);
+
+    /** Finish all completed jobs in input order; returns true if any job was finished */
+    bool finish_jobs(void);
+
+    /** Lock / unlock queue mutex */
+    inline void lock(void)
+    {
+#ifdef MOOT_PTHREADS_ENABLED
+      pthread_mutex_lock(&mutex);
+#endif
+    };
+    inline void unlock(void)
+    {
+#ifdef MOOT_PTHREADS_ENABLED
+      pthread_mutex_unlock(&mutex);
+#endif
+    };
+
+#ifdef MOOT_PTHREADS_ENABLED
+    /** Worker thread entry point */
+    static void *_work_thread(void *data);
+#endif
+  };
+
+}; //-- namespace moot
+
+#endif /* _MOOT_FILE_POOL_H */
@@ -27,6 +27,10 @@
 
 #include "mootFlavor.h"
 
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
 namespace moot {
   using namespace std;
 
@@ -70,8 +74,34 @@ void mootTaster::clear()
   rules.clear();
   labels.clear();
   labels.insert(nolabel);
+  dfa.clear();
 };
 
+//----------------------------------------------------------------------
+void mootTaster::compile(void)
+{
+  //-- automaton character semantics must agree with regexec() in the current locale (LC_CTYPE)
+  bool utf8 = false;
+  if (MB_CUR_MAX > 1) {
+    mbstate_t mbs;
+    wchar_t   wc = 0;
+    memset(&mbs, 0, sizeof(mbs));
+    if (mbrtowc(&wc, "\xc3\xa4", 2, &mbs) != 2 || wc != 0xe4) {
+      //-- non-UTF-8 multibyte locale: match sequentially
+      dfa.clear();
+      return;
+    }
+    utf8 = true;
+  }
+
+  vector<string> regexes;
+  regexes.reserve(rules.size());
+  for (Rules::const_iterator ri=rules.begin(); ri!=rules.end(); ++ri) {
+    regexes.push_back(ri->re_s);
+  }
+  dfa.compile(regexes, utf8);
+}
+
 //----------------------------------------------------------------------
 void mootTaster::set_default_label(const mootFlavorStr &label, bool update_rules)
 {
@@ -96,6 +126,16 @@ void mootTaster::set_default_label(const mootFlavorStr &label, bool update_rules
 //----------------------------------------------------------------------
 mootTaster::Rules::const_iterator mootTaster::find(const char *s) const
 {
+  if (dfa.valid && dfa.nregexes == rules.size()) {
+    //-- combined automaton, checking any uncompiled rules of higher priority with regexec()
+    size_t best = dfa.match(s);
+    for (vector<size_t>::const_iterator fi=dfa.fallback.begin(); fi!=dfa.fallback.end() && *fi < best; ++fi) {
+      if (rules[*fi].match(s)) return rules.begin() + *fi;
+    }
+    return best==mootFlavorDFA::NoMatch ? rules.end() : rules.begin() + best;
+  }
+
+  //-- sequential matching
   for (Rules::const_iterator ri=rules.begin(); ri!=rules.end(); ++ri) {
     if (ri->match(s)) return ri;
   }
@@ -138,6 +178,7 @@ bool mootTaster::load(mootio::mistream* mis, const std::string &prefix)
     //-- normal rule
     append_rule(Rule(lab,re));
   }
+  compile();
   return true;
 };
 
@@ -158,6 +199,7 @@ void mootTaster::set_default_rules(void)
   append_rule("@CARDSEPS",	"^([0-9])([0-9,\\.\\-]+)$");
   append_rule("@CARDSUFFIX",	"^([0-9])([0-9,\\.\\-]*)([^0-9,\\.\\-])(.{0,3})$");
   set_default_label("@ALPHA");
+  compile();
 };
 
 //==============================================================================
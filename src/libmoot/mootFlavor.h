@@ -41,6 +41,7 @@
 #include <mootTypes.h>
 #include <mootIO.h>
 #include <mootCIO.h>
+#include <mootFlavorDFA.h>
 
 namespace moot {
   using namespace std;
@@ -61,7 +62,17 @@ extern const mootTaster builtinTaster;
 /**
  * \brief High-level heuristic token classifier
  * \detail
- * \note regular expressions may be sensitive to the current locale settings,
+ * Rules are compiled into a single combined automaton (see mootFlavorDFA)
+ * by compile(), which is called implicitly by load(), set_default_rules(),
+ * the copy constructor, and the assignment operator.  Rules whose regexes cannot be represented
+ * in the automaton are matched with regexec() as before.
+ * If you modify \a rules directly, you should call compile() afterwards;
+ * otherwise the rules are matched sequentially.
+ * The automaton's character semantics (UTF-8 or single-byte) are determined
+ * by the LC_CTYPE locale in effect when compile() is called, as are those
+ * of the rules' regexes (see Rule::compile()), so a copy always matches
+ * in the locale in effect when it was made.
+ * \note regular expressions not handled by the automaton may be sensitive to the current locale settings,
  *       in particular LC_CTYPE.  For best results, ensure that your locale is set
  *       sensibly whenever you use a user-defined taster, e.g. by calling setlocale(LC_ALL,"").
  */
@@ -144,6 +155,7 @@ public:
   mootFlavorStr nolabel;	///< label to return if no rule matches (default: empty)
   mootFlavorID  noid;		///< id to return if no rule matches (default: empty)
   set<mootFlavorStr> labels;	///< set of all flavor labels
+  mootFlavorDFA dfa;		///< combined automaton for \a rules (see compile())
 
 public:
   //--------------------------------------------------------------------
@@ -154,6 +166,11 @@ public:
     : nolabel(default_label), noid(default_id)
   { set_default_rules(); };
 
+  /** Copy constructor: (re-)compiles the automaton in the current locale, as for \a rules */
+  mootTaster(const mootTaster &t2)
+    : rules(t2.rules), nolabel(t2.nolabel), noid(t2.noid), labels(t2.labels)
+  { compile(); };
+
   /** Destructor */
   ~mootTaster()
   {};
@@ -181,15 +198,23 @@ public:
   inline bool is_builtin(void) const
   { return operator==(builtinTaster); };
 
-  /** assignment operator */
+  /** assignment operator: (re-)compiles the automaton in the current locale, as for \a rules */
   inline mootTaster& operator=(const mootTaster &t2)
-  { rules=t2.rules; nolabel=t2.nolabel; noid=t2.noid; labels=t2.labels; return *this; };
+  {
+    if (&t2 == this) return *this;
+    rules=t2.rules; nolabel=t2.nolabel; noid=t2.noid; labels=t2.labels;
+    compile();
+    return *this;
+  };
 
 public:
   //--------------------------------------------------------------------
   // methods: rule-set
 
-  /** append a single rule */
+  /** (re-)compile combined automaton \a dfa for the current \a rules */
+  void compile(void);
+
+  /** append a single rule; you must call compile() to include it in the automaton */
   inline void append_rule(const Rule &r)
   {
     rules.push_back(r);
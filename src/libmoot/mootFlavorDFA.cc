@@ -0,0 +1,545 @@
+/* -*- Mode: C++ -*- */
+/*
+   libmoot : moocow's part-of-speech tagging library
+   Copyright (C) 2012-2014 by Bryan Jurish <moocow@cpan.org>
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 3 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+/*--------------------------------------------------------------------------
+ * File: mootFlavorDFA.cc
+ * Author: Bryan Jurish <moocow@cpan.org>
+ * Description:
+ *   + moocow's PoS tagger : token information : "flavors" : compiled automaton
+ *--------------------------------------------------------------------------*/
+
+#include "mootFlavorDFA.h"
+
+#include <string.h>
+#include <ctype.h>
+#include <algorithm>
+#include <bitset>
+#include <map>
+
+namespace moot {
+  using namespace std;
+
+//==============================================================================
+// local types: regex syntax trees & NFA
+namespace {
+
+  typedef bitset<256> ByteSet;
+
+  //-- maximum upper bound for {m,n} intervals we're willing to expand
+  const size_t MaxRepeat = 64;
+
+  //------------------------------------------------------------
+  // syntax tree
+  enum NodeType {
+    ntEmpty,   //-- matches empty string
+    ntSet,     //-- single character from a byte-set (optionally any multibyte UTF-8 char)
+    ntCat,     //-- concatenation
+    ntAlt,     //-- alternation
+    ntRepeat,  //-- bounded or unbounded repetition
+    ntBol,     //-- ^
+    ntEol      //-- $
+  };
+
+  struct Node {
+    NodeType type;
+    ByteSet  set;       //-- ntSet: ASCII bytes matched
+    bool     mbyte;     //-- ntSet: also match any multibyte UTF-8 character?
+    size_t   min, max;  //-- ntRepeat: bounds (max==NoMax for unbounded)
+    Node    *l, *r;     //-- children
+
+    static const size_t NoMax = (size_t)-1;
+
+    Node(NodeType t, Node *left=NULL, Node *right=NULL)
+      : type(t), mbyte(false), min(0), max(0), l(left), r(right)
+    {};
+    ~Node(void)
+    { delete l; delete r; };
+  };
+
+  //------------------------------------------------------------
+  // parser for the supported ERE subset; returns NULL if unsupported
+  class Parser {
+  public:
+    const char *p;   //-- current position
+    bool ok;         //-- false if an unsupported construct was found
+
+    Parser(const char *s) : p(s), ok(true) {};
+
+    Node *fail(Node *n=NULL)
+    { delete n; ok=false; return NULL; };
+
+    //-- top-level
+    Node *parse(void)
+    {
+      Node *n = parse_alt();
+      if (!ok) return NULL;
+      if (*p) return fail(n); //-- unbalanced ')'
+      return n;
+    };
+
+    //-- alt := cat ('|' cat)*
+    Node *parse_alt(void)
+    {
+      Node *n = parse_cat();
+      while (ok && *p=='|') {
+	++p;
+	Node *r = parse_cat();
+	if (!ok) return fail(n);
+	n = new Node(ntAlt, n, r);
+      }
+      return n;
+    };
+
+    //-- cat := repeat+  (empty branches are not supported)
+    Node *parse_cat(void)
+    {
+      Node *n = NULL;
+      while (ok && *p && *p!='|' && *p!=')') {
+	Node *r = parse_repeat();
+	if (!ok) return fail(n);
+	n = n ? new Node(ntCat, n, r) : r;
+      }
+      if (!n) return fail();
+      return n;
+    };
+
+    //-- repeat := atom ('*' | '+' | '?' | '{' m [ ',' [n] ] '}')*
+    Node *parse_repeat(void)
+    {
+      Node *n = parse_atom();
+      while (ok) {
+	size_t min, max;
+	if      (*p=='*') { min=0; max=Node::NoMax; ++p; }
+	else if (*p=='+') { min=1; max=Node::NoMax; ++p; }
+	else if (*p=='?') { min=0; max=1; ++p; }
+	else if (*p=='{') {
+	  ++p;
+	  if (!parse_uint(min)) return fail(n);
+	  if (*p==',') {
+	    ++p;
+	    if (*p=='}') max = Node::NoMax;
+	    else if (!parse_uint(max)) return fail(n);
+	  } else {
+	    max = min;
+	  }
+	  if (*p != '}' || max < min || (max != Node::NoMax && max > MaxRepeat) || min > MaxRepeat)
+	    return fail(n);
+	  ++p;
+	}
+	else break;
+
+	if (n->type==ntBol || n->type==ntEol) return fail(n);
+	Node *rn = new Node(ntRepeat, n);
+	rn->min = min;
+	rn->max = max;
+	n = rn;
+      }
+      return n;
+    };
+
+    //-- parse an unsigned decimal integer
+    bool parse_uint(size_t &val)
+    {
+      if (*p < '0' || *p > '9') return false;
+      for (val=0; *p >= '0' && *p <= '9'; ++p) {
+	val = 10*val + (*p - '0');
+	if (val > 0xffff) return false;
+      }
+      return true;
+    };
+
+    //-- atom := '(' alt ')' | '^' | '$' | '.' | bracket | '\' char | char
+    Node *parse_atom(void)
+    {
+      unsigned char c = static_cast<unsigned char>(*p);
+      Node *n;
+      switch (c) {
+      case '(':
+	++p;
+	n = parse_alt();
+	if (!ok) return NULL;
+	if (*p != ')') return fail(n);
+	++p;
+	return n;
+
+      case '^':
+	++p;
+	return new Node(ntBol);
+
+      case '$':
+	++p;
+	return new Node(ntEol);
+
+      case '.':
+	++p;
+	n = new Node(ntSet);
+	for (size_t b=0; b < 0x80; ++b) n->set.set(b);
+	n->mbyte = true;
+	return n;
+
+      case '[':
+	++p;
+	return parse_bracket();
+
+      case '\\':
+	++p;
+	c = static_cast<unsigned char>(*p);
+	if (c==0 || c >= 0x80 || isalnum(c)) return fail(); //-- backrefs & GNU escapes
+	++p;
+	n = new Node(ntSet);
+	n->set.set(c);
+	return n;
+
+      case '*': case '+': case '?': case '{':
+	return fail(); //-- dangling quantifier
+
+      default:
+	if (c >= 0x80) return fail(); //-- non-ASCII literal
+	++p;
+	n = new Node(ntSet);
+	n->set.set(c);
+	return n;
+      }
+      return fail();
+    };
+
+    //-- bracket expression (after the opening '['); backslash is literal here (POSIX)
+    Node *parse_bracket(void)
+    {
+      Node *n = new Node(ntSet);
+      bool negate = false;
+      if (*p=='^') { negate=true; ++p; }
+      bool first = true;
+      while (*p && (first || *p != ']')) {
+	unsigned char lo = static_cast<unsigned char>(*p), hi;
+	if (lo >= 0x80) return fail(n);
+	if (lo=='[' && (p[1]==':' || p[1]=='.' || p[1]=='=')) return fail(n); //-- locale-dependent classes
+	++p;
+	if (*p=='-' && p[1] && p[1] != ']') {
+	  hi = static_cast<unsigned char>(p[1]);
+	  if (hi >= 0x80 || hi < lo) return fail(n);
+	  if (hi=='[' && (p[2]==':' || p[2]=='.' || p[2]=='=')) return fail(n);
+	  p += 2;
+	} else {
+	  hi = lo;
+	}
+	for (size_t b=lo; b <= hi; ++b) n->set.set(b);
+	first = false;
+      }
+      if (*p != ']') return fail(n);
+      ++p;
+      if (negate) {
+	for (size_t b=0; b < 0x80; ++b) n->set.flip(b);
+	n->mbyte = true;
+      }
+      return n;
+    };
+  };
+
+  //------------------------------------------------------------
+  // Thompson NFA
+  enum NStateType {
+    nsSet,     //-- consume a byte from set, goto out1
+    nsSplit,   //-- epsilon to out1 and out2
+    nsBol,     //-- epsilon to out1 at beginning-of-string only
+    nsEol,     //-- epsilon to out1 at end-of-string only
+    nsAccept   //-- accept regex #rule
+  };
+
+  struct NState {
+    NStateType type;
+    size_t     set;    //-- nsSet: index into NFA::sets
+    size_t     out1, out2;
+    size_t     rule;   //-- nsAccept: regex index
+  };
+
+  class NFA {
+  public:
+    bool            utf8;    //-- true: UTF-8 character semantics; false: byte semantics
+    vector<NState>  states;
+    vector<ByteSet> sets;
+    map<string,size_t> set2id;  //-- for sharing byte-sets
+
+    static const size_t None = (size_t)-1;
+
+    NFA(bool utf8_input=true) : utf8(utf8_input) {};
+
+    size_t add(NStateType type, size_t out1=None, size_t out2=None)
+    {
+      NState st;
+      st.type = type;
+      st.set  = 0;
+      st.out1 = out1;
+      st.out2 = out2;
+      st.rule = 0;
+      states.push_back(st);
+      return states.size()-1;
+    };
+
+    size_t add_set(const ByteSet &bs, size_t out)
+    {
+      string key = bs.to_string();
+      map<string,size_t>::const_iterator si = set2id.find(key);
+      size_t id;
+      if (si != set2id.end()) {
+	id = si->second;
+      } else {
+	id = sets.size();
+	sets.push_back(bs);
+	set2id[key] = id;
+      }
+      size_t q = add(nsSet, out);
+      states[q].set = id;
+      return q;
+    };
+
+    //-- byte-set for the range [lo,hi]
+    static ByteSet range(size_t lo, size_t hi)
+    {
+      ByteSet bs;
+      for (size_t b=lo; b <= hi; ++b) bs.set(b);
+      return bs;
+    };
+
+    //-- build states for node n leading to state next; returns entry state
+    size_t build(const Node *n, size_t next)
+    {
+      size_t q, body;
+      switch (n->type) {
+      case ntEmpty:
+	return next;
+
+      case ntSet:
+	if (n->mbyte && !utf8) {
+	  //-- single-byte charset: any non-ASCII byte is a character
+	  q = add_set(n->set | range(0x80,0xff), next);
+	  return q;
+	}
+	q = add_set(n->set, next);
+	if (n->mbyte) {
+	  //-- well-formed UTF-8 multibyte sequences
+	  ByteSet cont = range(0x80,0xbf);
+	  size_t c1 = add_set(cont, next);
+	  size_t c2 = add_set(cont, c1);
+	  size_t c3 = add_set(cont, c2);
+	  q = add(nsSplit, q, add_set(range(0xc2,0xdf), c1));
+	  q = add(nsSplit, q, add_set(range(0xe0,0xef), c2));
+	  q = add(nsSplit, q, add_set(range(0xf0,0xf4), c3));
+	}
+	return q;
+
+      case ntCat:
+	return build(n->l, build(n->r, next));
+
+      case ntAlt:
+	q    = build(n->r, next);
+	body = build(n->l, next);
+	return add(nsSplit, body, q);
+
+      case ntRepeat:
+	q = next;
+	if (n->max == Node::NoMax) {
+	  //-- unbounded tail: x*
+	  size_t loop = add(nsSplit, None, next);
+	  body = build(n->l, loop); //-- may reallocate states
+	  states[loop].out1 = body;
+	  q = loop;
+	} else {
+	  //-- optional tail: (x(x...)?)?
+	  for (size_t i=n->min; i < n->max; ++i) {
+	    body = build(n->l, q);
+	    q = add(nsSplit, body, next);
+	  }
+	}
+	//-- mandatory prefix
+	for (size_t i=0; i < n->min; ++i) q = build(n->l, q);
+	return q;
+
+      case ntBol:
+	return add(nsBol, next);
+
+      case ntEol:
+	return add(nsEol, next);
+      }
+      return next;
+    };
+
+    //-- epsilon closure of stack into sorted vector out (visited is scratch space)
+    void closure(vector<size_t> &stack, vector<size_t> &out, vector<bool> &seen, vector<size_t> &visited,
+		 bool bol, bool eol) const
+    {
+      out.clear();
+      visited.clear();
+      while (!stack.empty()) {
+	size_t q = stack.back();
+	stack.pop_back();
+	if (q==None || seen[q]) continue;
+	seen[q] = true;
+	visited.push_back(q);
+	const NState &st = states[q];
+	switch (st.type) {
+	case nsSet:
+	case nsAccept:
+	  out.push_back(q);
+	  break;
+	case nsSplit:
+	  stack.push_back(st.out2);
+	  stack.push_back(st.out1);
+	  break;
+	case nsBol:
+	  if (bol) stack.push_back(st.out1);
+	  break;
+	case nsEol:
+	  out.push_back(q);
+	  if (eol) stack.push_back(st.out1);
+	  break;
+	}
+      }
+      for (vector<size_t>::const_iterator vi=visited.begin(); vi != visited.end(); ++vi) seen[*vi] = false;
+      sort(out.begin(), out.end());
+    };
+  };
+
+}; //-- /anonymous namespace
+
+//==============================================================================
+// mootFlavorDFA
+
+//----------------------------------------------------------------------
+void mootFlavorDFA::clear(void)
+{
+  valid = false;
+  utf8 = true;
+  nregexes = 0;
+  fallback.clear();
+  min_index = NoMatch;
+  memset(bytecls, 0, sizeof(bytecls));
+  ncls = 0;
+  delta.clear();
+  acc.clear();
+  acc_eos.clear();
+}
+
+//----------------------------------------------------------------------
+bool mootFlavorDFA::compile(const vector<string> &regexes, bool utf8_input, size_t max_states)
+{
+  clear();
+  nregexes = regexes.size();
+  utf8 = utf8_input;
+
+  //-- parse & build NFA
+  NFA nfa(utf8);
+  vector<size_t> starts;
+  for (size_t i=0; i < regexes.size(); ++i) {
+    Parser parser(regexes[i].c_str());
+    Node *n = parser.parse();
+    if (!n) {
+      fallback.push_back(i);
+      continue;
+    }
+    size_t accq = nfa.add(nsAccept);
+    nfa.states[accq].rule = i;
+    starts.push_back(nfa.build(n, accq));
+    if (min_index == NoMatch) min_index = i;
+    delete n;
+  }
+
+  //-- compute byte equivalence classes: bytes with identical set-membership signatures
+  map<string,unsigned char> sig2cls;
+  string sig(nfa.sets.size(), '0');
+  for (size_t b=0; b < 256; ++b) {
+    for (size_t si=0; si < nfa.sets.size(); ++si) sig[si] = nfa.sets[si].test(b) ? '1' : '0';
+    map<string,unsigned char>::const_iterator ci = sig2cls.find(sig);
+    if (ci == sig2cls.end()) {
+      ci = sig2cls.insert(make_pair(sig, static_cast<unsigned char>(sig2cls.size()))).first;
+    }
+    bytecls[b] = ci->second;
+  }
+  ncls = sig2cls.size();
+
+  //-- representative byte for each class
+  vector<size_t> clsbyte(ncls, 0);
+  for (size_t b=256; b > 0; --b) clsbyte[bytecls[b-1]] = b-1;
+
+  //-- subset construction
+  vector<bool>   seen(nfa.states.size(), false);
+  vector<size_t> stack, qset, qeos, visited;
+  vector< vector<size_t> > qsets;
+  map< vector<size_t>, StateID > set2q;
+
+  //-- start state (beginning-of-string): never shared with any other state
+  stack.assign(starts.rbegin(), starts.rend());
+  nfa.closure(stack, qset, seen, visited, true, false);
+  qsets.push_back(qset);
+
+  for (StateID q=0; q < qsets.size(); ++q) {
+    //-- acceptance (copy: qsets may be reallocated below)
+    vector<size_t> cur = qsets[q];
+    bool is_start = (q==0);
+    size_t a=NoMatch, ae=NoMatch;
+    for (vector<size_t>::const_iterator ni=cur.begin(); ni != cur.end(); ++ni) {
+      if (nfa.states[*ni].type==nsAccept && nfa.states[*ni].rule < a) a = nfa.states[*ni].rule;
+    }
+    stack.assign(cur.rbegin(), cur.rend());
+    if (is_start) stack.insert(stack.end(), starts.rbegin(), starts.rend());
+    nfa.closure(stack, qeos, seen, visited, is_start, true);
+    for (vector<size_t>::const_iterator ni=qeos.begin(); ni != qeos.end(); ++ni) {
+      if (nfa.states[*ni].type==nsAccept && nfa.states[*ni].rule < ae) ae = nfa.states[*ni].rule;
+    }
+    acc.push_back(a);
+    acc_eos.push_back(ae);
+
+    //-- transitions
+    for (size_t c=0; c < ncls; ++c) {
+      size_t b = clsbyte[c];
+      stack.clear();
+      for (vector<size_t>::const_iterator ni=cur.begin(); ni != cur.end(); ++ni) {
+	const NState &st = nfa.states[*ni];
+	if (st.type==nsSet && nfa.sets[st.set].test(b)) stack.push_back(st.out1);
+      }
+      //-- unanchored search: (re-)start all regexes at every position
+      stack.insert(stack.end(), starts.rbegin(), starts.rend());
+      nfa.closure(stack, qset, seen, visited, false, false);
+
+      map< vector<size_t>, StateID >::const_iterator qi = set2q.find(qset);
+      StateID q2;
+      if (qi != set2q.end()) {
+	q2 = qi->second;
+      } else {
+	if (qsets.size() >= max_states) {
+	  //-- too big: give up
+	  clear();
+	  nregexes = regexes.size();
+	  for (size_t i=0; i < regexes.size(); ++i) fallback.push_back(i);
+	  return false;
+	}
+	q2 = qsets.size();
+	qsets.push_back(qset);
+	set2q[qset] = q2;
+      }
+      delta.push_back(q2);
+    }
+  }
+
+  valid = true;
+  return true;
+}
+
+}; /* namespace moot */
@@ -0,0 +1,144 @@
+/* -*- Mode: C++ -*- */
+
+/*
+   libmoot : moocow's part-of-speech tagging library
+   Copyright (C) 2012-2014 by Bryan Jurish <moocow@cpan.org>
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 3 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+/*--------------------------------------------------------------------------
+ * File: mootFlavorDFA.h
+ * Author: Bryan Jurish <moocow@cpan.org>
+ * Description:
+ *   + moocow's PoS tagger : token information : "flavors" : compiled automaton
+ *--------------------------------------------------------------------------*/
+
+/**
+\file mootFlavorDFA.h
+\brief combined deterministic automaton for prioritized regex-based token "flavor" heuristics
+*/
+
+#ifndef _moot_FLAVOR_DFA_H
+#define _moot_FLAVOR_DFA_H
+
+#include <vector>
+#include <string>
+#include <mootTypes.h>
+
+namespace moot {
+  using namespace std;
+
+//==============================================================================
+// mootFlavorDFA
+
+/**
+ * \brief Deterministic automaton recognizing the leftmost-priority union of a list of regexes.
+ * \detail
+ * Compiles a list of POSIX.2 extended regular expressions into a single
+ * byte-level DFA which reports the lowest index of any regex matching
+ * (anywhere in) an input string in a single left-to-right pass.
+ * Only a locale-independent subset of ERE syntax is supported
+ * (literals, \c ., bracket expressions with ASCII members, grouping,
+ * alternation, the quantifiers \c * \c + \c ? \c {m,n}, and the anchors \c ^ and \c $).
+ * Regexes outside of this subset are not compiled into the automaton,
+ * but are listed in \a fallback so that the caller can test them
+ * with regexec() instead.
+ *
+ * \note By default, input strings are interpreted as UTF-8: \c . and negated bracket
+ *       expressions match a single (well-formed) UTF-8 character, as
+ *       regexec() would in a UTF-8 locale.  If compiled with \a utf8_input=false,
+ *       they match any single byte instead, as in a single-byte locale such as "C".
+ */
+class mootFlavorDFA {
+public:
+  //--------------------------------------------------------------------
+  // Embedded Types & Constants
+
+  /** Type for automaton state identifiers */
+  typedef UInt StateID;
+
+  /** Result returned by match() if no regex matches */
+  static const size_t NoMatch = (size_t)-1;
+
+  /** Default maximum number of automaton states for compile() */
+  static const size_t DefaultMaxStates = 4096;
+
+public:
+  //--------------------------------------------------------------------
+  // Data Members
+  bool            valid;         ///< true iff the automaton has been successfully compiled
+  bool            utf8;          ///< true iff compiled for UTF-8 input (vs. single-byte charsets)
+  size_t          nregexes;      ///< number of regexes passed to compile() (for consistency checks)
+  vector<size_t>  fallback;      ///< indices of regexes not represented in the automaton, in ascending order
+  size_t          min_index;     ///< lowest regex index represented in the automaton (for early termination)
+  unsigned char   bytecls[256];  ///< maps input bytes to equivalence classes
+  size_t          ncls;          ///< number of byte equivalence classes
+  vector<StateID> delta;         ///< transition table: delta[q*ncls+bytecls[c]]
+  vector<size_t>  acc;           ///< lowest regex index accepted in state q (\a NoMatch if none)
+  vector<size_t>  acc_eos;       ///< lowest regex index accepted in state q at end-of-string
+
+public:
+  //--------------------------------------------------------------------
+  // Constructors etc.
+
+  /** Default constructor: empty automaton */
+  mootFlavorDFA(void)
+    : valid(false), utf8(true), nregexes(0), min_index(NoMatch), ncls(0)
+  {};
+
+  /** clear the automaton */
+  void clear(void);
+
+  /**
+   * (Re-)compile the automaton from \a regexes in order of decreasing priority.
+   * If \a utf8_input is true, input is interpreted as UTF-8, otherwise as
+   * a single-byte character set.
+   * Returns true on success; if the automaton would exceed
+   * \a max_states states, \a valid is false and all regexes are
+   * listed in \a fallback.
+   */
+  bool compile(const vector<string> &regexes, bool utf8_input=true, size_t max_states=DefaultMaxStates);
+
+  /** get number of automaton states */
+  inline size_t size(void) const
+  { return acc.size(); };
+
+public:
+  //--------------------------------------------------------------------
+  // Matching
+
+  /**
+   * Get lowest index of any compiled regex matching \a s,
+   * or \a NoMatch if no compiled regex matches.
+   * Regexes listed in \a fallback are not considered.
+   */
+  inline size_t match(const char *s) const
+  {
+    if (!valid) return NoMatch;
+    StateID q    = 0;
+    size_t  best = acc[0];
+    for ( ; *s && best != min_index; ++s) {
+      q = delta[q*ncls + bytecls[static_cast<unsigned char>(*s)]];
+      if (acc[q] < best) best = acc[q];
+    }
+    if (!*s && acc_eos[q] < best) best = acc_eos[q];
+    return best;
+  };
+}; //-- /mootFlavorDFA
+
+}; /* namespace moot */
+
+#endif /* _moot_FLAVOR_DFA_H */
@@ -55,6 +55,13 @@ using namespace mootio;
 //-- define this to resort to hapax counts when no suffix matches
 #define NO_SUFFIX_USE_HAPAX
 
+//-- prefetch hint for tag_batch() (no-op on non-GNU compilers)
+#ifdef __GNUC__
+# define MOOT_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+# define MOOT_PREFETCH(addr)
+#endif
+
 //-- define this to sort lexical assoc vectors by probability on compute_logprobs()
 //#define LEX_SORT_BYVALUE
 
@@ -140,6 +147,17 @@ void mootHMM::clear(bool wipe_everything, bool unlogify)
   //-- free lexical-class probabilities
   lcprobs.clear();
 
+  //-- free deferred model sections
+  deferred_data.clear();
+  deferred_sections = 0;
+
+  //-- free cached lexical lookups
+  lexcache.clear();
+#ifdef MOOT_ENABLE_SUFFIX_TRIE
+  sufcache.clear();
+  sufguesses.clear();
+#endif
+
   //-- reset to default "empty" values
   vbestpn = NULL;
   nsents = 0;
@@ -276,96 +294,120 @@ bool mootHMM::load_model(const string &modelname,
     }
 
     //-- compile HMM
-    if (verbose >= vlProgress) carp("%s: compiling HMM...", myname);
-
-    //-- ensure taster-flavors are computed for lexfreqs
-    //   + this has to happen here rather than in compile(), since compile() params (e.g. lexfreqs) are const
-    lexfreqs.unknown_threshhold = unknown_lex_threshhold;
-    lexfreqs.taster = (use_flavors ? &mtaster : NULL);
-    lexfreqs.compute_specials(false);
-
-    //-- discount frequencies for pseudo-lexemes
-    // + here, zf is s.t. zf/(N+zf) = U/N
-    //   i.e., the total probability mass allocated to @UNKNOWNs is determined
-    //   by the total frequency @UNKNOWN relative to total corpus size; a la
-    //   Good-Turing 0* := N(1)/N.
-    ProbT lexU = lexfreqs.f_word("@UNKNOWN");
-    ProbT lexN = lexfreqs.n_tokens - lexU;
-    ProbT zf = (lexU*lexN)/(lexN-lexU);
-    //carp("%s: discounting specials to pseudo-frequency = %g\n", myname, zf); //-- debug
-    lexfreqs.discount_specials(zf);
-
-    //-- compile guts (virtualized)
-    if (!this->compile(lexfreqs,ngfreqs,classfreqs,start_tag_str,mtaster)) {
-      carp("\n%s: HMM compilation FAILED\n", myname);
+    if (!compile_model(lexfreqs, ngfreqs, classfreqs, mtaster, start_tag_str, myname,
+		       do_estimate_nglambdas, do_estimate_wlambdas, do_estimate_clambdas,
+		       do_build_suffix_trie, do_compute_logprobs))
       return false;
-    }
-    else if (verbose >= vlProgress) carp(" compiled.\n");
+  }
 
-    //-- check whether to use classes
-    if (lcprobs.size() <= 2 && use_lex_classes) {
-      use_lex_classes = false;
-      moot_msg(verbose, vlWarnings, "%s: Warning: no class frequencies available: disabling lexical classes!\n", myname);
-    }
+  return true;
+}
 
-    //-- estimate smoothing constants: lexical probabiltiies (wlambdas)
-    if (do_estimate_wlambdas) {
-      if (verbose >= vlProgress)
-	carp("%s: estimating lexical lambdas...", myname);
-      if (!estimate_wlambdas(lexfreqs)) {
-	carp("\n%s: lexical lambda estimation FAILED.\n", myname);
-	return false;
-      }
-      else if (verbose >= vlProgress) carp(" done.\n");
-    }
+/*--------------------------------------------------------------------------
+ * Compilation : compile_model()
+ */
+bool mootHMM::compile_model(mootLexfreqs &lexfreqs,
+			    const mootNgrams &ngfreqs,
+			    const mootClassfreqs &classfreqs,
+			    const mootTaster &mtaster,
+			    const mootTagString &start_tag_str,
+			    const char *myname,
+			    bool  do_estimate_nglambdas,
+			    bool  do_estimate_wlambdas,
+			    bool  do_estimate_clambdas,
+			    bool  do_build_suffix_trie,
+			    bool  do_compute_logprobs)
+{
+  //-- compile HMM
+  if (verbose >= vlProgress) carp("%s: compiling HMM...", myname);
+
+  //-- ensure taster-flavors are computed for lexfreqs
+  //   + this has to happen here rather than in compile(), since compile() params (e.g. lexfreqs) are const
+  lexfreqs.unknown_threshhold = unknown_lex_threshhold;
+  lexfreqs.taster = (use_flavors ? &mtaster : NULL);
+  lexfreqs.compute_specials(false);
+
+  //-- discount frequencies for pseudo-lexemes
+  // + here, zf is s.t. zf/(N+zf) = U/N
+  //   i.e., the total probability mass allocated to @UNKNOWNs is determined
+  //   by the total frequency @UNKNOWN relative to total corpus size; a la
+  //   Good-Turing 0* := N(1)/N.
+  ProbT lexU = lexfreqs.f_word("@UNKNOWN");
+  ProbT lexN = lexfreqs.n_tokens - lexU;
+  ProbT zf = (lexU*lexN)/(lexN-lexU);
+  //carp("%s: discounting specials to pseudo-frequency = %g\n", myname, zf); //-- debug
+  lexfreqs.discount_specials(zf);
+
+  //-- compile guts (virtualized)
+  if (!this->compile(lexfreqs,ngfreqs,classfreqs,start_tag_str,mtaster)) {
+    carp("\n%s: HMM compilation FAILED\n", myname);
+    return false;
+  }
+  else if (verbose >= vlProgress) carp(" compiled.\n");
 
-    //-- estimate smoothing constants: n-gram probabiltiies (nglambdas)
-    if (do_estimate_nglambdas) {
-      if (verbose >= vlProgress)
-	carp("%s: estimating n-gram lambdas...", myname);
-      if (!estimate_lambdas(ngfreqs)) {
-	carp("\n%s: n-gram lambda estimation FAILED.\n", myname);
-	return false;
-      }
-      else if (verbose >= vlProgress) carp(" done.\n");
+  //-- check whether to use classes
+  if (lcprobs.size() <= 2 && use_lex_classes) {
+    use_lex_classes = false;
+    moot_msg(verbose, vlWarnings, "%s: Warning: no class frequencies available: disabling lexical classes!\n", myname);
+  }
+
+  //-- estimate smoothing constants: lexical probabiltiies (wlambdas)
+  if (do_estimate_wlambdas) {
+    if (verbose >= vlProgress)
+      carp("%s: estimating lexical lambdas...", myname);
+    if (!estimate_wlambdas(lexfreqs)) {
+      carp("\n%s: lexical lambda estimation FAILED.\n", myname);
+      return false;
     }
+    else if (verbose >= vlProgress) carp(" done.\n");
+  }
 
-    //-- estimate smoothing constants: class probabiltiies (clambdas)
-    if (use_lex_classes && do_estimate_clambdas) {
-      if (verbose >= vlProgress)
-	carp("%s: estimating class lambdas...", myname);
-      if (!estimate_clambdas(classfreqs)) {
-	carp("\n%s: class lambda estimation FAILED.\n", myname);
-	return false;
-      }
-      else if (verbose >= vlProgress) carp(" done.\n");
+  //-- estimate smoothing constants: n-gram probabiltiies (nglambdas)
+  if (do_estimate_nglambdas) {
+    if (verbose >= vlProgress)
+      carp("%s: estimating n-gram lambdas...", myname);
+    if (!estimate_lambdas(ngfreqs)) {
+      carp("\n%s: n-gram lambda estimation FAILED.\n", myname);
+      return false;
     }
+    else if (verbose >= vlProgress) carp(" done.\n");
+  }
 
-#ifdef MOOT_ENABLE_SUFFIX_TRIE
-    //-- build suffix trie
-    if (do_build_suffix_trie && suftrie.maxlen() != 0) {
-      if (verbose >= vlProgress)
-	carp("%s: Building suffix trie ", myname);
-      if (!build_suffix_trie(lexfreqs, ngfreqs, (verbose>=vlProgress)))
-	{
-	  carp("\n%s: suffix trie construction FAILED.\n", myname);
-	  return false;
-	}
-      else if (verbose >= vlProgress)
-	carp(": built.\n");
+  //-- estimate smoothing constants: class probabiltiies (clambdas)
+  if (use_lex_classes && do_estimate_clambdas) {
+    if (verbose >= vlProgress)
+      carp("%s: estimating class lambdas...", myname);
+    if (!estimate_clambdas(classfreqs)) {
+      carp("\n%s: class lambda estimation FAILED.\n", myname);
+      return false;
     }
-#endif //--MOOT_ENABLE_SUFFIX_TRIE
+    else if (verbose >= vlProgress) carp(" done.\n");
+  }
 
-    //-- compute log-probabilities
-    if (do_compute_logprobs) {
-      if (verbose >= vlProgress)
-	carp("%s: computing log-probabilities [hash_ngrams=%d]...", myname, static_cast<int>(hash_ngrams));
-      if (!compute_logprobs()) {
-	carp("\n%s: log-probability computation FAILED.\n", myname);
+#ifdef MOOT_ENABLE_SUFFIX_TRIE
+  //-- build suffix trie
+  if (do_build_suffix_trie && suftrie.maxlen() != 0) {
+    if (verbose >= vlProgress)
+      carp("%s: Building suffix trie ", myname);
+    if (!build_suffix_trie(lexfreqs, ngfreqs, (verbose>=vlProgress)))
+      {
+	carp("\n%s: suffix trie construction FAILED.\n", myname);
 	return false;
       }
-      else if (verbose >= vlProgress) carp(" done.\n");
+    else if (verbose >= vlProgress)
+      carp(": built.\n");
+  }
+#endif //--MOOT_ENABLE_SUFFIX_TRIE
+
+  //-- compute log-probabilities
+  if (do_compute_logprobs) {
+    if (verbose >= vlProgress)
+      carp("%s: computing log-probabilities [hash_ngrams=%d]...", myname, static_cast<int>(hash_ngrams));
+    if (!compute_logprobs()) {
+      carp("\n%s: log-probability computation FAILED.\n", myname);
+      return false;
     }
+    else if (verbose >= vlProgress) carp(" done.\n");
   }
 
   return true;
@@ -389,6 +431,10 @@ bool mootHMM::compile(const mootLexfreqs &lexfreqs,
     return false;
   }
 
+  //-- discard deferred sections of any previously loaded model
+  deferred_data.clear();
+  deferred_sections = 0;
+
   //-- setup flavors
   taster = mtaster;
 
@@ -871,6 +917,21 @@ bool mootHMM::estimate_clambdas(const mootClassfreqs &cf)
  * Compilation utilities: probability normalization
  *--------------------------------------------------------------------------*/
 bool mootHMM::compute_logprobs(void)
+{
+  compute_ngram_logprobs();
+  compute_lex_logprobs();
+  compute_class_logprobs();
+#ifdef MOOT_ENABLE_SUFFIX_TRIE
+  compute_suffix_logprobs();
+#endif
+
+  if (beamwd) beamwd = log(beamwd);
+
+  return true;
+}
+
+//--------------------------------------------------------------
+void mootHMM::compute_ngram_logprobs(void)
 {
   if (!hash_ngrams) {
     ProbT   p3=0, p23=0, p=0;
@@ -936,6 +997,15 @@ bool mootHMM::compute_logprobs(void)
     }
   }
 
+  //-- smoothing constants
+  nglambda1 = log(nglambda1);
+  nglambda2 = log(nglambda2);
+  nglambda3 = log(nglambda3);
+}
+
+//--------------------------------------------------------------
+void mootHMM::compute_lex_logprobs(void)
+{
   //-- lexical probabilities
   for (LexProbTable::iterator lpi = lexprobs.begin(); lpi != lexprobs.end(); ++lpi) {
     for (LexProbSubTable::iterator lpsi = lpi->begin(); lpsi != lpi->end(); ++lpsi) {
@@ -948,6 +1018,14 @@ bool mootHMM::compute_logprobs(void)
 #endif
   }
 
+  //-- smoothing constants
+  wlambda0  = log(wlambda0);
+  wlambda1  = log(wlambda1);
+}
+
+//--------------------------------------------------------------
+void mootHMM::compute_class_logprobs(void)
+{
   //-- class probabilities
   for (LexClassProbTable::iterator lcpi = lcprobs.begin(); lcpi != lcprobs.end(); ++lcpi) {
     for (LexClassProbSubTable::iterator lcpsi = lcpi->begin(); lcpsi != lcpi->end(); ++lcpsi) {
@@ -960,7 +1038,15 @@ bool mootHMM::compute_logprobs(void)
 #endif
   }
 
+  //-- smoothing constants
+  clambda0  = log(clambda0);
+  clambda1  = log(clambda1);
+}
+
 #ifdef MOOT_ENABLE_SUFFIX_TRIE
+//--------------------------------------------------------------
+void mootHMM::compute_suffix_logprobs(void)
+{
   //-- suffix-trie probabilities
   for (SuffixTrie::iterator sti = suftrie.begin(); sti != suftrie.end(); ++sti) {
     for (SuffixTrieDataT::iterator stdi = sti->data.begin(); stdi != sti->data.end(); ++stdi) {
@@ -971,21 +1057,8 @@ bool mootHMM::compute_logprobs(void)
     sti->data.sort_byvalue();
 # endif //-- LEX_SORT_BY_VALUE
   }
-#endif //-- MOOT_ENABLE_SUFFIX_TRIE
-
-  //-- smoothing constants
-  nglambda1 = log(nglambda1);
-  nglambda2 = log(nglambda2);
-  nglambda3 = log(nglambda3);
-  wlambda0  = log(wlambda0);
-  wlambda1  = log(wlambda1);
-  clambda0  = log(clambda0);
-  clambda1  = log(clambda1);
-
-  if (beamwd) beamwd = log(beamwd);
-
-  return true;
 }
+#endif //-- MOOT_ENABLE_SUFFIX_TRIE
 
 //======================================================================
 // Tagging: Top-Level
@@ -1003,6 +1076,55 @@ void mootHMM::tag_sentence(mootSentence &sentence)
   ++nsents;
 }
 
+//--------------------------------------------------------------
+void mootHMM::tag_batch(SentenceBatch &batch)
+{
+  SentenceBatch::iterator bi;
+  mootSentence::const_iterator si;
+  size_t nvanilla = 0;
+  require_sections(tagging_sections());
+
+  //-- pass 1: resolve lexical data for all vanilla tokens in the batch
+  for (bi = batch.begin(); bi != batch.end(); ++bi) {
+    if (!*bi) continue;
+    for (si = (*bi)->begin(); si != (*bi)->end(); ++si) {
+      if (si->toktype() == TokTypeVanilla) ++nvanilla;
+    }
+  }
+  if (vbatch.size() < nvanilla) vbatch.resize(nvanilla);
+
+  vector<LexInfo>::iterator li = vbatch.begin();
+  for (bi = batch.begin(); bi != batch.end(); ++bi) {
+    if (!*bi) continue;
+    for (si = (*bi)->begin(); si != (*bi)->end(); ++si) {
+      if (si->toktype() != TokTypeVanilla) continue;
+      if (lexcache_max) *li = lexcache_lookup(*si);
+      else              token2lexinfo(*si, *li);
+      ++li;
+    }
+  }
+
+  //-- pass 2: run Viterbi over each sentence using the pre-resolved data
+  li = vbatch.begin();
+  for (bi = batch.begin(); bi != batch.end(); ++bi) {
+    if (!*bi) continue;
+    viterbi_clear();
+    for (si = (*bi)->begin(); si != (*bi)->end(); ++si) {
+      if (si->toktype() != TokTypeVanilla) continue;
+      ++ntokens;
+      //-- hint: fetch lexical row for the next token while we step the current one
+      if (li+1 != vbatch.end() && li[1].tokid != 0 && li[1].tokid < lexprobs.size() && !lexprobs[li[1].tokid].empty())
+	MOOT_PREFETCH(&(*lexprobs[li[1].tokid].begin()));
+      viterbi_step(*li, si->text());
+      ++li;
+      if (ndots && (ntokens % ndots)==0) fputc('.', stderr);
+    }
+    viterbi_finish();
+    tag_mark_best(**bi);
+    ++nsents;
+  }
+}
+
 //--------------------------------------------------------------
 void mootHMM::tag_io(TokenReader *reader, TokenWriter *writer)
 {
@@ -1020,9 +1142,559 @@ void mootHMM::tag_io(TokenReader *reader, TokenWriter *writer)
   }
 }
 
+//======================================================================
+// Tagging: dense fixed-width trellis
+
+/**
+ * Dense trellis column for mootHMM::tag_stream_tiny().  Rows are stored in
+ * the order they were populated; node (r,q) of row r is the best path through
+ * row q of the previous column, as for the linked mootHMM::ViterbiColumn.
+ */
+template <size_t NRows>
+struct mootTinyColumn {
+  size_t         nrows;                 ///< number of rows
+  mootHMM::TagID tags[NRows];           ///< current tag for each row
+  ProbT          wprobs[NRows];         ///< lexical (log-)probability for each row
+  unsigned int   nodes[NRows];          ///< bit-mask of previous rows q for which node (r,q) exists
+  ProbT          lprobs[NRows][NRows];  ///< (log-)probability of best path to node (r,q)
+  unsigned char  backs[NRows][NRows];   ///< row in column before previous of best path to node (r,q)
+  ProbT          bbestpr;               ///< best probability in column (cf. ViterbiColumn::bbestpr)
+  ProbT          bpprmin;               ///< beam-pruning threshhold (cf. ViterbiColumn::bpprmin)
+};
+
+//--------------------------------------------------------------
+// tiny_clear(): initialize trellis window with BOS node (tagid,ptagid)
+template <size_t NRows>
+static void tiny_clear(vector< mootTinyColumn<NRows> > &cols, size_t &ncols, mootHMM::TagID tagid, mootHMM::TagID ptagid)
+{
+  //-- cols[0]: pseudo-column holding BOS ptagid
+  cols[0].nrows      = 1;
+  cols[0].tags[0]    = ptagid;
+  cols[0].nodes[0]   = 0;
+
+  //-- cols[1]: BOS column (cf. viterbi_clear())
+  mootTinyColumn<NRows> &bos = cols[1];
+  bos.nrows          = 1;
+  bos.tags[0]        = tagid;
+  bos.wprobs[0]      = MOOT_PROB_ONE;
+  bos.nodes[0]       = 1;
+  bos.lprobs[0][0]   = MOOT_PROB_ONE;
+  bos.backs[0][0]    = 0;
+  bos.bbestpr        = MOOT_PROB_ONE;
+  bos.bpprmin        = MOOT_PROB_NEG;
+  ncols = 2;
+}
+
+//--------------------------------------------------------------
+// tiny_populate(): append a row for tagid to col (cf. viterbi_populate_row())
+template <size_t NRows>
+static inline void tiny_populate(const mootHMM &hmm,
+				 const mootTinyColumn<NRows> &pprev,
+				 const mootTinyColumn<NRows> &prev,
+				 mootTinyColumn<NRows> &col,
+				 mootHMM::TagID tagid,
+				 ProbT wordpr)
+{
+  const size_t  ntags = hmm.n_tags;
+  const ProbT  *ngp   = hmm.ngprobsa + tagid;
+  size_t        r     = col.nrows++;
+  unsigned int  mask;
+  size_t        q, qq, bestqq;
+  ProbT         lprob, pr, bestpr;
+
+  col.tags[r]   = tagid;
+  col.wprobs[r] = wordpr;
+  col.nodes[r]  = 0;
+
+  for (q = 0; q < prev.nrows; ++q) {
+    const ProbT *ngpq = ngp + ntags*prev.tags[q];
+    bestpr = MOOT_PROB_NEG;
+    bestqq = NRows;
+
+    //-- previous nodes in row q, in list order
+    for (qq = 0, mask = prev.nodes[q]; mask != 0; ++qq, mask >>= 1) {
+      if (!(mask & 1)) continue;
+      lprob = prev.lprobs[q][qq];
+
+      //-- beam pruning
+      if (hmm.beamwd && lprob < col.bpprmin) continue;
+
+      //-- probability lookup: tagp(pprev.tags[qq], prev.tags[q], tagid)
+      pr = lprob + ngpq[ntags*ntags*pprev.tags[qq]];
+      if (pr > bestpr) {
+	bestpr = pr;
+	bestqq = qq;
+      }
+    }
+
+    //-- set node information
+    if (bestqq != NRows) {
+      col.nodes[r]    |= (1U << q);
+      col.lprobs[r][q] = bestpr + wordpr;
+      col.backs[r][q]  = static_cast<unsigned char>(bestqq);
+      if (col.lprobs[r][q] > col.bbestpr) col.bbestpr = col.lprobs[r][q];
+    }
+  }
+}
+
+//--------------------------------------------------------------
+// tiny_best_node(): get best node in col (cf. viterbi_best_node()); returns false if none
+template <size_t NRows>
+static bool tiny_best_node(const mootTinyColumn<NRows> &col, size_t &bestr, size_t &bestq)
+{
+  ProbT bestpr = MOOT_PROB_NEG;
+  bool  found  = false;
+  for (size_t r = col.nrows; r-- > 0; ) {
+    for (size_t q = 0; (col.nodes[r] >> q) != 0; ++q) {
+      if (!((col.nodes[r] >> q) & 1)) continue;
+      if (col.lprobs[r][q] > bestpr) {
+	bestpr = col.lprobs[r][q];
+	bestr  = r;
+	bestq  = q;
+	found  = true;
+      }
+    }
+  }
+  return found;
+}
+
+//--------------------------------------------------------------
+// tiny_flushable_node(): cf. viterbi_flushable_node(); returns false if col is not flushable
+template <size_t NRows>
+static bool tiny_flushable_node(const mootTinyColumn<NRows> &col, ProbT beamwd, size_t &bestr, size_t &bestq)
+{
+  ProbT  minpr   = col.bbestpr - beamwd;
+  ProbT  bestpr  = MOOT_PROB_NEG;
+  size_t n_nodes = 0;
+  bool   found   = false;
+
+  if (col.bpprmin < minpr)
+    minpr = col.bpprmin;
+
+  for (size_t r = col.nrows; r-- > 0; ) {
+    for (size_t q = 0; (col.nodes[r] >> q) != 0; ++q) {
+      if (!((col.nodes[r] >> q) & 1)) continue;
+      if (col.lprobs[r][q] < minpr) continue;
+      if (MOOT_PROB_SAFE(minpr) && ++n_nodes > 1) return false;
+      if (col.lprobs[r][q] > bestpr) {
+	bestpr = col.lprobs[r][q];
+	bestr  = r;
+	bestq  = q;
+	found  = true;
+      }
+    }
+  }
+  return found;
+}
+
+//--------------------------------------------------------------
+// tiny_to_generic(): copy trellis window cols[1..ncols-1] to hmm.vtable;
+// returns a copy of partial column col, or NULL if col is empty
+template <size_t NRows>
+static mootHMM::ViterbiColumn *tiny_to_generic(mootHMM &hmm,
+					       const vector< mootTinyColumn<NRows> > &cols,
+					       size_t ncols,
+					       const mootTinyColumn<NRows> &col)
+{
+  typedef mootTinyColumn<NRows> Column;
+  mootHMM::ViterbiNode   *pnodes[NRows][NRows], *nodes[NRows][NRows];
+  mootHMM::ViterbiColumn *vcol = NULL;
+  mootHMM::ViterbiRow    *vrow;
+  mootHMM::ViterbiNode   *vnod;
+  size_t j, r, q;
+
+  //-- BOS
+  hmm.viterbi_clear();
+  hmm.vtable->rows->tagid         = cols[1].tags[0];
+  hmm.vtable->rows->nodes->tagid  = cols[1].tags[0];
+  hmm.vtable->rows->nodes->ptagid = cols[0].tags[0];
+  nodes[0][0] = hmm.vtable->rows->nodes;
+
+  for (j = 2; j <= ncols; ++j) {
+    const Column &c = (j < ncols ? cols[j] : col);
+    const Column &p = cols[j-1];
+    memcpy(pnodes, nodes, sizeof(nodes));
+    if (j == ncols && c.nrows == 0) return NULL;
+
+    vcol           = hmm.viterbi_get_column();
+    vcol->rows     = NULL;
+    vcol->col_prev = hmm.vtable;
+    vcol->bbestpr  = c.bbestpr;
+    vcol->bpprmin  = c.bpprmin;
+    for (r = 0; r < c.nrows; ++r) {
+      vrow        = hmm.viterbi_get_row();
+      vrow->tagid = c.tags[r];
+      vrow->wprob = c.wprobs[r];
+      vrow->nodes = NULL;
+      for (q = p.nrows; q-- > 0; ) {
+	if (!((c.nodes[r] >> q) & 1)) continue;
+	vnod           = hmm.viterbi_get_node();
+	vnod->tagid    = c.tags[r];
+	vnod->ptagid   = p.tags[q];
+	vnod->lprob    = c.lprobs[r][q];
+	vnod->pth_prev = pnodes[q][c.backs[r][q]];
+	vnod->nod_next = vrow->nodes;
+	vrow->nodes    = vnod;
+	nodes[r][q]    = vnod;
+      }
+      vrow->row_next = vcol->rows;
+      vcol->rows     = vrow;
+    }
+    if (j < ncols) hmm.vtable = vcol;
+  }
+  return vcol;
+}
+
+//--------------------------------------------------------------
+// tiny_node_path(): get tags of best path to node (r,q) of the last column
+// into path and the BOS node for the next trellis window into (tagid,ptagid)
+template <size_t NRows>
+static void tiny_node_path(const vector< mootTinyColumn<NRows> > &cols, size_t ncols,
+			   size_t r, size_t q, mootHMM::TagID start_tagid,
+			   vector<mootHMM::TagID> &path, mootHMM::TagID &tagid, mootHMM::TagID &ptagid)
+{
+  size_t j = ncols-1, qq;
+  tagid  = cols[j].tags[r];
+  ptagid = (tagid==start_tagid ? start_tagid : cols[j-1].tags[q]);
+  path.resize(j-1);
+  for ( ; j >= 2; --j) {
+    path[j-2] = cols[j].tags[r];
+    qq = cols[j].backs[r][q];
+    r  = q;
+    q  = qq;
+  }
+}
+
+//--------------------------------------------------------------
+size_t mootHMM::tiny_viterbi_width(const TokenWriter *writer) const
+{
+#ifdef MOOT_LEX_IS_TIEBREAKER
+  return 0;
+#else
+  if (!use_tiny_viterbi || hash_ngrams || !ngprobsa || n_tags == 0
+      || save_ambiguities || save_flavors || save_mark_unknown
+      || (writer && (writer->tw_format & tiofTrace)))
+    return 0;
+
+  size_t width = uclass.size();
+  LexProbTable::const_iterator lpi;
+  for (lpi = lexprobs.begin(); lpi != lexprobs.end(); ++lpi) {
+    if (lpi->size() > width) width = lpi->size();
+  }
+  for (lpi = lcprobs.begin(); lpi != lcprobs.end(); ++lpi) {
+    if (lpi->size() > width) width = lpi->size();
+  }
+  return width > 0 ? width : 1;
+#endif
+}
+
+//--------------------------------------------------------------
+template <size_t NRows>
+void mootHMM::tag_stream_tiny(TokenReader *reader, TokenWriter *writer,
+			      const LexInfo *const *lexinfo, const mootTokString *const *lextext)
+{
+  typedef mootTinyColumn<NRows> Column;
+  int            rtok;
+  mootSentence   toks;              //-- "sentence" buffer
+  mootSentence   trash;             //-- recycled token buffer nodes
+  vector<Column> cols(16);          //-- trellis window: cols[0] holds BOS ptagid, cols[1] is BOS
+  size_t         ncols;             //-- number of columns in use
+  bool           dense = true;      //-- false while the trellis window lives in vtable
+  vector<TagID>  rtags, path;       //-- lexical rows, best path
+  vector<ProbT>  rprobs;
+  const LexInfo *info;
+  const mootTokString *text;
+  ViterbiNode   *fnod;
+  TokID          tokid;
+  TagID          tagid, ptagid;
+  size_t         i, r=0, q=0;
+  bool           flush, resume;
+
+  //-- number of fallback rows (cf. _viterbi_step_fallback())
+  const size_t   nfallback = n_tags - 1 - (start_tagid > 0 && start_tagid < n_tags ? 1 : 0);
+
+  tiny_clear(cols, ncols, start_tagid, start_tagid);
+  toks.push_front( mootToken(TokTypeUnknown) );
+
+  while ( (rtok=reader->get_token()) != TokTypeEOF ) {
+    if (trash.empty()) {
+      toks.push_back( *reader->tr_token );
+    } else {
+      toks.splice(toks.end(), trash, trash.begin());
+      toks.back() = *reader->tr_token;
+    }
+    flush  = false;   //-- flush dense trellis at node (r,q)?
+    resume = false;   //-- generic trellis was flushed: return to dense trellis?
+
+    switch (rtok) {
+    case TokTypeVanilla:
+      ++ntokens;
+      if (lexinfo && *lexinfo) {
+	//-- lexical data pre-resolved by reader
+	info = *lexinfo;
+	text = *lextext;
+      } else if (lexcache_max) {
+	info = &lexcache_lookup(toks.back());
+	text = &toks.back().text();
+      } else {
+	token2lexinfo(toks.back(), vlexinfo);
+	info = &vlexinfo;
+	text = &toks.back().text();
+      }
+      tokid = viterbi_lexrow(*info, *text, rtags, rprobs);
+
+      if (dense) {
+	if (ncols == cols.size()) cols.resize(2*ncols);
+	Column &col = cols[ncols];
+	col.nrows   = 0;
+	col.bbestpr = MOOT_PROB_NEG;
+	col.bpprmin = cols[ncols-1].bbestpr - beamwd;
+
+	if (rtags.size() > NRows) {
+	  //-- too many rows: continue with generic trellis
+	  tiny_to_generic(*this, cols, ncols, col);
+	  viterbi_step_rows(tokid, rtags, rprobs);
+	  dense = false;
+	}
+	else {
+	  for (i = 0; i < rtags.size(); ++i)
+	    tiny_populate(*this, cols[ncols-2], cols[ncols-1], col, rtags[i], rprobs[i]);
+
+	  if (col.nrows == 0 || col.nodes[col.nrows-1] == 0) {
+	    //-- fallback: cf. _viterbi_step_fallback()
+	    if (col.nrows + nfallback > NRows) {
+	      _viterbi_step_fallback(tokid, tiny_to_generic(*this, cols, ncols, col));
+	      dense = false;
+	    }
+	    else {
+	      ++nfallbacks;
+	      const LexProbSubTable &lps = lexprobs[tokid];
+	      LexProbSubTable::const_iterator lpsi;
+	      col.bpprmin = MOOT_PROB_NEG;
+	      for (tagid = 1; tagid < n_tags; ++tagid) {
+		if (tagid==start_tagid) continue;
+		lpsi = lps.find(tagid);
+		tiny_populate(*this, cols[ncols-2], cols[ncols-1], col, tagid,
+			      (lpsi != lps.end() ? lpsi->second : wlambda0));
+	      }
+	      if (col.nrows == 0 || col.nodes[col.nrows-1] == 0) {
+		//-- we STILL might not have found anything: cf. viterbi_step(TokID,TagID,ViterbiColumn*)
+		if (col.nrows + 1 > NRows) {
+		  viterbi_step(tokid, 0, tiny_to_generic(*this, cols, ncols, col));
+		  dense = false;
+		} else {
+		  tiny_populate(*this, cols[ncols-2], cols[ncols-1], col, 0, MOOT_PROB_ONE);
+		}
+	      }
+	    }
+	  }
+	  if (dense) ++ncols;
+	}
+      }
+      else {
+	viterbi_step_rows(tokid, rtags, rprobs);
+      }
+
+      if (dense) {
+	flush = tiny_flushable_node(cols[ncols-1], beamwd, r, q);
+      }
+      else if ( (fnod=viterbi_flushable_node()) ) {
+	viterbi_flush(writer,toks,fnod);
+	resume = true;
+      }
+      break;
+
+    case TokTypeEOS:
+      if (dense) {
+	//-- cf. viterbi_finish()
+	if (ncols == cols.size()) cols.resize(2*ncols);
+	Column &col = cols[ncols];
+	col.nrows   = 0;
+	col.bbestpr = MOOT_PROB_NEG;
+	col.bpprmin = MOOT_PROB_NEG;
+	tiny_populate(*this, cols[ncols-2], cols[ncols-1], col, (start_tagid < n_tags ? start_tagid : 0), MOOT_PROB_ONE);
+	++ncols;
+	flush = tiny_best_node(cols[ncols-1], r, q);
+      }
+      else {
+	viterbi_finish();
+	viterbi_flush(writer,toks,viterbi_best_node());
+	resume = true;
+      }
+      break;
+
+    default:
+      //-- ignore
+      break;
+    }
+
+    if (flush) {
+      tiny_node_path(cols, ncols, r, q, start_tagid, path, tagid, ptagid);
+      viterbi_flush_tags(writer, toks, path);
+      tiny_clear(cols, ncols, tagid, ptagid);
+
+      //-- shift token-buffer, recycling nodes
+      trash.splice(trash.end(), toks, toks.begin(), toks.end());
+      toks.splice(toks.end(), trash, trash.begin());
+      toks.back() = mootToken(TokTypeUnknown);
+    }
+    else if (resume) {
+      //-- back to the dense trellis, starting from the BOS node set by viterbi_flush()
+      tiny_clear(cols, ncols, vtable->rows->tagid, vtable->rows->nodes->ptagid);
+      dense = true;
+    }
+  }
+
+  if ( !toks.empty() ) {
+    toks.push_back( mootToken(TokTypeEOF) );
+    if (!dense) {
+      viterbi_flush(writer,toks,viterbi_best_node());
+    }
+    else {
+      if (tiny_best_node(cols[ncols-1], r, q)) {
+	tiny_node_path(cols, ncols, r, q, start_tagid, path, tagid, ptagid);
+      } else {
+	path.clear();
+      }
+      viterbi_flush_tags(writer, toks, path);
+    }
+  }
+}
+
+//--------------------------------------------------------------
+mootHMM::TokID mootHMM::viterbi_lexrow(const LexInfo &info, const mootTokString &toktext,
+				       vector<TagID> &tags, vector<ProbT> &probs)
+{
+  TokID                  tokid   = info.tokid < n_toks ? info.tokid : 0;
+  ClassID                classid = info.classid;
+  const LexClass        *lclass  = &info.lclass;
+  const LexProbSubTable *lps;
+  LexProbSubTable::const_iterator lpsi;
+
+  tags.clear();
+  probs.clear();
+
+  if (info.lclass.empty()) {
+    ++nunclassed;
+    if (!use_lex_classes) {
+      //-- cf. viterbi_step(TokID,mootTokString)
+      if (tokid==0) ++nnewtokens;
+#ifndef MOOT_ENABLE_SUFFIX_TRIE
+      lps = &(lexprobs[tokid]);
+#else
+      lps = (tokid != 0 ? &(lexprobs[tokid]) : sufprobs_cached(toktext, &lexprobs[tokid]));
+#endif
+      for (lpsi = lps->begin(); lpsi != lps->end(); ++lpsi) {
+	if (lpsi->first == 0 || lpsi->first >= n_tags) continue;
+	tags.push_back(lpsi->first);
+	probs.push_back(lpsi->second);
+      }
+      return tokid;
+    }
+    classid = 0;
+    lclass  = &uclass;
+  }
+
+  //-- cf. viterbi_step(TokID,ClassID,LexClass,mootTokString)
+  if (classid >= n_classes) classid = 0;
+  if (tokid==0) {
+    ++nnewtokens;
+    if (classid == 0) ++nunknown;
+  }
+
+  if (tokid != 0) {
+    lps = &(lexprobs[tokid]);
+  }
+  else if (use_lex_classes) {
+#ifndef MOOT_ENABLE_SUFFIX_TRIE
+    lps = &(lcprobs[classid]);
+#else
+    lps = (classid != 0 ? &(lcprobs[classid]) : sufprobs_cached(toktext, &(lcprobs[classid])));
+#endif
+  }
+  else {
+#ifdef MOOT_ENABLE_SUFFIX_TRIE
+    lps = sufprobs_cached(toktext, &(lexprobs[0]));
+#else
+    lps = &(lexprobs[0]);
+#endif
+  }
+
+  if (relax) {
+    for (lpsi = lps->begin(); lpsi != lps->end(); ++lpsi) {
+      if (lpsi->first >= n_tags || lpsi->first == 0) continue;
+      tags.push_back(lpsi->first);
+      probs.push_back(lpsi->second);
+    }
+  } else {
+    for (LexClass::const_iterator lci = lclass->begin(); lci != lclass->end(); ++lci) {
+      if (*lci >= n_tags || *lci == 0) continue;
+      lpsi = lps->find(*lci);
+      tags.push_back(*lci);
+      probs.push_back(lpsi==lps->end() ? wlambda0 : lpsi->second);
+    }
+  }
+  return tokid;
+}
+
+//--------------------------------------------------------------
+void mootHMM::viterbi_step_rows(TokID tokid, const vector<TagID> &tags, const vector<ProbT> &probs,
+				ViterbiColumn *col)
+{
+  for (size_t i = 0; i < tags.size(); ++i)
+    col = viterbi_populate_row(tags[i], probs[i], col);
+
+  if (!viterbi_column_ok(col)) {
+    _viterbi_step_fallback(tokid, col);
+  } else {
+    vtable = col;
+  }
+}
+
+//--------------------------------------------------------------
+void mootHMM::viterbi_flush_tags(TokenWriter *writer, mootSentence &toks, const vector<TagID> &path)
+{
+  vector<TagID>::const_iterator pi = path.begin();
+  for (mootSentence::iterator si = toks.begin(); si != toks.end(); ++si) {
+    if (si->toktype() != TokTypeVanilla) continue; //-- ignore non-vanilla tokens
+    if (pi != path.end()) {
+      si->besttag(tagids.id2name(*pi));
+      ++pi;
+    }
+    else {
+      carp("%s: Error: no best tag for token '%s'!\n", "mootHMM::tag_mark_best()", si->text().c_str());
+      si->besttag(tagids.id2name(0)); //-- use 'unknown' tag
+    }
+  }
+  if (writer) {
+    TOKDEBUG(for (mootSentence::const_iterator si=toks.begin(); si!=toks.end(); ++si) { si->dump("VITERBI_FLUSH:PUT"); });
+    writer->put_tokens(toks);
+  }
+}
+
 //--------------------------------------------------------------
 void mootHMM::tag_stream(TokenReader *reader, TokenWriter *writer)
 {
+  tag_stream(reader, writer, NULL, NULL);
+}
+
+//--------------------------------------------------------------
+void mootHMM::tag_stream(TokenReader *reader, TokenWriter *writer,
+			 const LexInfo *const *lexinfo, const mootTokString *const *lextext)
+{
+  require_sections(tagging_sections());
+
+  //-- narrow lexical distributions: use a dense trellis
+  size_t width = tiny_viterbi_width(writer);
+  if (width > 0 && width <= 8) {
+    tag_stream_tiny<8>(reader, writer, lexinfo, lextext);
+    return;
+  }
+  else if (width > 0 && width <= 16) {
+    tag_stream_tiny<16>(reader, writer, lexinfo, lextext);
+    return;
+  }
+
   int rtok;
   mootSentence toks;   //-- "sentence" buffer
   ViterbiNode *fnod=NULL;   //-- flushable node
@@ -1035,7 +1707,13 @@ void mootHMM::tag_stream(TokenReader *reader, TokenWriter *writer)
 
     switch (rtok) {
     case TokTypeVanilla:
-      viterbi_step( toks.back() );
+      if (lexinfo && *lexinfo) {
+	//-- lexical data pre-resolved by reader
+	++ntokens;
+	viterbi_step( **lexinfo, **lextext );
+      } else {
+	viterbi_step( toks.back() );
+      }
       if ( (fnod=viterbi_flushable_node()) )
 	viterbi_flush(writer,toks,fnod);
       break;
@@ -1096,6 +1774,9 @@ void mootHMM::viterbi_flush(TokenWriter *writer, mootSentence &toks, ViterbiNode
  */
 void mootHMM::viterbi_clear(void)
 {
+  //-- decode deferred model sections on first use
+  if (deferred_sections) require_sections(tagging_sections());
+
   //-- move to trash: trellis
   ViterbiColumn  *col, *col_next;
   ViterbiRow     *row, *row_next;
@@ -1163,11 +1844,7 @@ void mootHMM::viterbi_step(TokID tokid, const mootTokString &toktext)
   if (tokid != 0) {
     lps = &(lexprobs[tokid]);
   } else {
-    size_t matchlen;
-    lps = &(suftrie.sufprobs(toktext,&matchlen));
-# ifdef NO_SUFFIX_USE_HAPAX
-    if (!matchlen) lps = &lexprobs[tokid];
-# endif //-- NO_SUFFIX_USE_HAPAX
+    lps = sufprobs_cached(toktext, &lexprobs[tokid]);
   }
 #endif //-- MOOT_ENABLE_SUFFIX_TRIE
 
@@ -1230,21 +1907,13 @@ void mootHMM::viterbi_step(TokID tokid,
     if (classid != 0) {
       lps   = &(lcprobs[classid]);
     } else {
-      size_t matchlen;
-      lps = &(suftrie.sufprobs(toktext,&matchlen));
-# ifdef NO_SUFFIX_USE_HAPAX
-      if (!matchlen) lps = &(lcprobs[classid]);
-# endif //-- NO_SUFFIX_USE_HAPAX
+      lps = sufprobs_cached(toktext, &(lcprobs[classid]));
     }
 #endif //-- MOOT_ENABLE_SUFFIX_TRIE
   }
   else {
 #ifdef MOOT_ENABLE_SUFFIX_TRIE
-    size_t matchlen;
-    lps = &(suftrie.sufprobs(toktext,&matchlen));
-# ifdef NO_SUFFIX_USE_HAPAX
-    if (!matchlen) lps = &(lexprobs[0]);
-# endif
+    lps = sufprobs_cached(toktext, &(lexprobs[0]));
 #else //-- NO_SUFFIX_USE_HAPAX
     lps = &(lexprobs[0]);
 #endif //-- MOOT_ENABLE_SUFFIX_TRIE
@@ -1721,6 +2390,95 @@ void mootHMM::token2lexclass(const mootToken &token, LexClass &tok_class) const
   }
 }
 
+//--------------------------------------------------------------
+const mootHMM::LexInfo &mootHMM::lexcache_lookup(const mootToken &token)
+{
+  //-- build key: text + NUL-separated analysis tags
+  lexcache_key.assign(token.text());
+  for (mootToken::Analyses::const_iterator ani = token.analyses().begin(); ani != token.analyses().end(); ++ani) {
+    lexcache_key.push_back('\0');
+    lexcache_key.append(ani->tag);
+  }
+
+  LexCache::iterator lci = lexcache.find(lexcache_key);
+  if (lci != lexcache.end()) return lci->second;
+
+  //-- cache miss: flush if full, then compute & insert
+  if (lexcache.size() >= lexcache_max) lexcache.clear();
+  LexInfo &info = lexcache[lexcache_key];
+  token2lexinfo(token, info);
+  return info;
+}
+
+//======================================================================
+// Low-Level: Suffix Lookup
+#ifdef MOOT_ENABLE_SUFFIX_TRIE
+
+//--------------------------------------------------------------
+mootHMM::SufLookup mootHMM::suffix_lookup(const mootTokString &toktext) const
+{
+  size_t matchlen;
+  const LexProbSubTable *lps = &(suftrie.sufprobs(toktext,&matchlen));
+#ifdef NO_SUFFIX_USE_HAPAX
+  return SufLookup(lps, matchlen != 0);
+#else
+  return SufLookup(lps, true);
+#endif
+}
+
+//--------------------------------------------------------------
+const mootHMM::LexProbSubTable *mootHMM::sufprobs_cached(const mootTokString &toktext, const LexProbSubTable *hapax)
+{
+  SufLookupTable::const_iterator sli;
+
+  //-- precomputed guesses
+  if (!sufguesses.empty() && (sli = sufguesses.find(toktext)) != sufguesses.end())
+    return sli->second.matched ? sli->second.lps : hapax;
+
+  if (!sufcache_max) {
+    SufLookup sl = suffix_lookup(toktext);
+    return sl.matched ? sl.lps : hapax;
+  }
+
+  //-- cache
+  if ((sli = sufcache.find(toktext)) != sufcache.end())
+    return sli->second.matched ? sli->second.lps : hapax;
+
+  //-- cache miss: flush if full, then compute & insert
+  if (sufcache.size() >= sufcache_max) sufcache.clear();
+  const SufLookup &sl = (sufcache[toktext] = suffix_lookup(toktext));
+  return sl.matched ? sl.lps : hapax;
+}
+
+//--------------------------------------------------------------
+bool mootHMM::load_suffix_guesses(const char *filename, size_t max_entries)
+{
+  mootio::mifstream mis(filename);
+  if (!mis.valid()) {
+    carp("mootHMM::load_suffix_guesses(): open failed for \"%s\"\n", filename);
+    return false;
+  }
+
+  string line, text;
+  size_t nguesses = 0;
+  while (!mis.eof() && (!max_entries || nguesses < max_entries)) {
+    mis.getline(line);
+    if (line.find("%%")==0) continue; //-- ignore comments
+
+    text.assign(line, 0, line.find_first_of("\t\r\n"));
+    if (text.empty() || token2id(text) != 0) continue; //-- known forms never consult the trie
+
+    sufguesses[text] = suffix_lookup(text);
+    ++nguesses;
+  }
+  mis.close();
+
+  moot_msg(verbose, vlProgress, "mootHMM::load_suffix_guesses(): loaded %zu guesses from \"%s\"\n", nguesses, filename);
+  return true;
+}
+
+#endif /* MOOT_ENABLE_SUFFIX_TRIE */
+
 //--------------------------------------------------------------
 mootHMM::LexClass *mootHMM::tagset2lexclass(const mootTagSet &tagset, LexClass *lclass, bool add_tagids)
 {
@@ -1784,53 +2542,149 @@ mootHMM::ClassID mootHMM::class2id(const LexClass &lclass, bool autopopulate, bo
 //======================================================================
 // DEBUG
 
+//--------------------------------------------------------------
+// Debug: HMM dump: buffered formatter
+class mootHMMDumpBuffer {
+public:
+  FILE   *file;
+  size_t  len;
+  char    buf[65536];
+
+public:
+  mootHMMDumpBuffer(FILE *myfile) : file(myfile), len(0) {};
+  ~mootHMMDumpBuffer(void) { flush(); };
+
+  inline void flush(void)
+  {
+    if (len) fwrite(buf, 1, len, file);
+    len = 0;
+  };
+
+  inline void reserve(size_t n)
+  { if (len+n > sizeof(buf)) flush(); };
+
+  inline void put(const char *s, size_t n)
+  {
+    reserve(n);
+    if (n > sizeof(buf)) { fwrite(s, 1, n, file); return; }
+    memcpy(buf+len, s, n);
+    len += n;
+  };
+  inline void put(const string &s)
+  { put(s.data(), s.size()); };
+  inline void put(char c)
+  { reserve(1); buf[len++] = c; };
+
+  /** append ID in decimal */
+  inline void put_id(unsigned int id)
+  {
+    char tmp[16], *e=tmp+sizeof(tmp), *p=e;
+    do { *--p = '0' + (id%10); id /= 10; } while (id);
+    put(p, e-p);
+  };
+
+  /** append ID("NAME") */
+  inline void put_idname(unsigned int id, const string &name)
+  {
+    put_id(id);
+    put("(\"", 2);
+    put(name);
+    put("\")", 2);
+  };
+
+  /** append log-probability and probability as for fprintf("%e\t%e\n",p,exp(p)) */
+  inline void put_prob(ProbT prob)
+  {
+    reserve(64);
+    len += snprintf(buf+len, 64, "%e\t%e\n", prob, exp(prob));
+  };
+
+  /** append printf()-formatted string (headers only) */
+  void printf(const char *fmt, ...)
+  {
+    va_list ap;
+    flush();
+    va_start(ap,fmt);
+    vfprintf(file, fmt, ap);
+    va_end(ap);
+  };
+};
+
 //--------------------------------------------------------------
 // Debug: HMM dump
 void mootHMM::txtdump(FILE *file, bool dump_constants, bool dump_lexprobs, bool dump_classprobs, bool dump_suftrie, bool dump_ngprobs)
 {
-  fprintf(file, "%%%% mootHMM text dump\n");
-
-  if (dump_constants) {
-    fprintf(file, "\n");
-    fprintf(file, "%%%%-----------------------------------------------------\n");
-    fprintf(file, "%%%% Constants\n");
-    fprintf(file, "%%%%-----------------------------------------------------\n");
-    fprintf(file, "LC_NUMERIC=%s\n", moot_lc_numeric());
-    fprintf(file, "LC_CTYPE=%s\n", moot_lc_ctype());
-    fprintf(file, "start_tagid\t%u(\"%s\")\n", start_tagid, tagids.id2name(start_tagid).c_str());
-    fprintf(file, "nglambda1\t%e (=%e)\n", nglambda1, exp(nglambda1));
-    fprintf(file, "nglambda2\t%e (=%e)\n", nglambda2, exp(nglambda2));
-    fprintf(file, "nglambda3\t%e (=%e)\n", nglambda3, exp(nglambda3));
-    fprintf(file, "wlambda0\t%e (=%e)\n", wlambda0, exp(wlambda0));
-    fprintf(file, "wlambda1\t%e (=%e)\n", wlambda1, exp(wlambda1));
+  TxtDumpOptions opts;
+  opts.dump_constants  = dump_constants;
+  opts.dump_lexprobs   = dump_lexprobs;
+  opts.dump_classprobs = dump_classprobs;
+  opts.dump_suftrie    = dump_suftrie;
+  opts.dump_ngprobs    = dump_ngprobs;
+  txtdump(file, opts);
+}
+
+//--------------------------------------------------------------
+void mootHMM::txtdump(FILE *file, const TxtDumpOptions &opts)
+{
+  require_sections((opts.dump_constants  ? bsFlavors    : bsNone)
+		   | (opts.dump_lexprobs   ? bsLexProbs   : bsNone)
+		   | (opts.dump_classprobs ? bsClassProbs : bsNone)
+		   | (opts.dump_suftrie    ? bsSuffixTrie : bsNone)
+		   | (opts.dump_ngprobs    ? bsNgramProbs : bsNone));
+
+  mootHMMDumpBuffer ob(file);
+  ob.printf("%%%% mootHMM text dump\n");
+
+  //-- tag filter: tagmask[tagid] is true iff tagid is wanted
+  bool         filter_tags = !opts.tags.empty();
+  vector<bool> tagmask(filter_tags ? tagids.size() : 0, false);
+  for (set<mootTagString>::const_iterator ti = opts.tags.begin(); ti != opts.tags.end(); ++ti) {
+    TagID tid = tagids.name2id(*ti);
+    if (tid < tagmask.size() && tagids.id2name(tid) == *ti) tagmask[tid] = true;
+  }
+#define WANT_TAG(tid) (!filter_tags || ((tid) < tagmask.size() && tagmask[tid]))
+
+  if (opts.dump_constants) {
+    ob.printf("\n");
+    ob.printf("%%%%-----------------------------------------------------\n");
+    ob.printf("%%%% Constants\n");
+    ob.printf("%%%%-----------------------------------------------------\n");
+    ob.printf("LC_NUMERIC=%s\n", moot_lc_numeric());
+    ob.printf("LC_CTYPE=%s\n", moot_lc_ctype());
+    ob.printf("start_tagid\t%u(\"%s\")\n", start_tagid, tagids.id2name(start_tagid).c_str());
+    ob.printf("nglambda1\t%e (=%e)\n", nglambda1, exp(nglambda1));
+    ob.printf("nglambda2\t%e (=%e)\n", nglambda2, exp(nglambda2));
+    ob.printf("nglambda3\t%e (=%e)\n", nglambda3, exp(nglambda3));
+    ob.printf("wlambda0\t%e (=%e)\n", wlambda0, exp(wlambda0));
+    ob.printf("wlambda1\t%e (=%e)\n", wlambda1, exp(wlambda1));
     //
-    fprintf(file, "clambda0\t%e (=%e)\n", clambda0, exp(clambda0));
-    fprintf(file, "clambda1\t%e (=%e)\n", clambda1, exp(clambda1));
+    ob.printf("clambda0\t%e (=%e)\n", clambda0, exp(clambda0));
+    ob.printf("clambda1\t%e (=%e)\n", clambda1, exp(clambda1));
     //
-    fprintf(file, "hash_ngrams\t%d\n", hash_ngrams ? 1 : 0);
-    fprintf(file, "relax\t%d\n", relax ? 1 : 0);
-    fprintf(file, "use_lex_classes\t%d\n", use_lex_classes ? 1 : 0);
-    fprintf(file, "use_flavors\t%d\n", use_flavors ? 1 : 0);
+    ob.printf("hash_ngrams\t%d\n", hash_ngrams ? 1 : 0);
+    ob.printf("relax\t%d\n", relax ? 1 : 0);
+    ob.printf("use_lex_classes\t%d\n", use_lex_classes ? 1 : 0);
+    ob.printf("use_flavors\t%d\n", use_flavors ? 1 : 0);
     //
-    fprintf(file, "beamwd\t%e (=%e)\n", beamwd, exp(beamwd));
+    ob.printf("beamwd\t%e (=%e)\n", beamwd, exp(beamwd));
     //
-    fputs("uclass\t", file);
+    ob.put("uclass\t", 7);
     for (LexClass::const_iterator lci = uclass.begin();  lci != uclass.end(); ++lci) {
-      if (lci!=uclass.begin()) fputc(' ', file);
-      fputs(tagids.id2name(*lci).c_str(), file);
+      if (lci!=uclass.begin()) ob.put(' ');
+      ob.put(tagids.id2name(*lci));
     }
-    fputc('\n', file);
+    ob.put('\n');
 
     //-- dump: flavors
-    fprintf(file, "\n");
-    fprintf(file, "%%%%-----------------------------------------------------\n");
-    fprintf(file, "%%%% Flavors (LC_CTYPE=%s)\n", moot_lc_ctype());
-    fprintf(file, "%%%% Id\tLabel\tRegex\n");
-    fprintf(file, "%%%%-----------------------------------------------------\n");
+    ob.printf("\n");
+    ob.printf("%%%%-----------------------------------------------------\n");
+    ob.printf("%%%% Flavors (LC_CTYPE=%s)\n", moot_lc_ctype());
+    ob.printf("%%%% Id\tLabel\tRegex\n");
+    ob.printf("%%%%-----------------------------------------------------\n");
     for (mootTaster::Rules::const_iterator ri=taster.rules.begin(); ri!=taster.rules.end(); ++ri) {
-      fprintf(file, "%u\t%s\t%s\n", ri->id, ri->lab.c_str(), ri->re_s.c_str());
+      ob.printf("%u\t%s\t%s\n", ri->id, ri->lab.c_str(), ri->re_s.c_str());
     }
-    fprintf(file, "%u\t%s\n", taster.noid, taster.nolabel.c_str());
+    ob.printf("%u\t%s\n", taster.noid, taster.nolabel.c_str());
   }
   //--/dump_constants
 
@@ -1838,47 +2692,55 @@ void mootHMM::txtdump(FILE *file, bool dump_constants, bool dump_lexprobs, bool
   TokID tokid;
   TagID tagid, ptagid;
   ProbT prob;
- 
 
-  if (dump_lexprobs) {
-    fprintf(file, "\n");
-    fprintf(file, "%%%%-----------------------------------------------------\n");
-    fprintf(file, "%%%% Lexical Probabilities\n");
-    fprintf(file, "%%%% TokID(\"TokStr\")\tTagID(\"TagStr\")\tlog(p(TokID|TagID))\tp\n");
-    fprintf(file, "%%%%-----------------------------------------------------\n");
-    LexProbTable::const_iterator lpi;
-    for (lpi = lexprobs.begin() , tokid = 0;
-	 lpi != lexprobs.end()  ;
-	 ++lpi                  , ++tokid)
+  if (opts.dump_lexprobs) {
+    ob.printf("\n");
+    ob.printf("%%%%-----------------------------------------------------\n");
+    ob.printf("%%%% Lexical Probabilities\n");
+    ob.printf("%%%% TokID(\"TokStr\")\tTagID(\"TagStr\")\tlog(p(TokID|TagID))\tp\n");
+    ob.printf("%%%%-----------------------------------------------------\n");
+
+    //-- token filter: visit only the requested rows
+    set<TokID> want_tokids;
+    for (set<mootTokString>::const_iterator toki = opts.tokens.begin(); toki != opts.tokens.end(); ++toki)
+      want_tokids.insert(token2id(*toki));
+    set<TokID>::const_iterator wti = want_tokids.begin();
+
+    for (tokid = opts.tokens.empty() ? 0 : (wti==want_tokids.end() ? lexprobs.size() : *wti);
+	 tokid < lexprobs.size();
+	 tokid = opts.tokens.empty() ? tokid+1 : (++wti==want_tokids.end() ? lexprobs.size() : *wti))
       {
-	for (LexProbSubTable::const_iterator lpsi = lpi->begin(); lpsi != lpi->end(); ++lpsi)
+	const LexProbSubTable &lps = lexprobs[tokid];
+	const mootTokString   &tokstr = tokids.id2name(tokid);
+	for (LexProbSubTable::const_iterator lpsi = lps.begin(); lpsi != lps.end(); ++lpsi)
 	  {
-	    TagID tagid = lpsi->first;
-	    ProbT prob  = lpsi->second;
-	    fprintf(file, "%u(\"%s\")\t%u(\"%s\")\t%e\t%e\n",
-		    tokid, tokids.id2name(tokid).c_str(),
-		    tagid, tagids.id2name(tagid).c_str(),
-		    prob,
-		    exp(prob));
+	    tagid = lpsi->first;
+	    if (!WANT_TAG(tagid)) continue;
+	    ob.put_idname(tokid, tokstr);
+	    ob.put('\t');
+	    ob.put_idname(tagid, tagids.id2name(tagid));
+	    ob.put('\t');
+	    ob.put_prob(lpsi->second);
 	  }
       }
   }
   //--/dump_lexprobs
 
-  if (dump_classprobs) {
-    fprintf(file, "\n");
-    fprintf(file, "%%%%-----------------------------------------------------\n");
-    fprintf(file, "%%%% Class Probabilities\n");
-    fprintf(file, "%%%% ClassID(\"ClassStr\")\tTagID(\"TagStr\")\tlog(p(ClassID|TagID))\tp\n");
-    fprintf(file, "%%%%-----------------------------------------------------\n");
+  if (opts.dump_classprobs) {
+    ob.printf("\n");
+    ob.printf("%%%%-----------------------------------------------------\n");
+    ob.printf("%%%% Class Probabilities\n");
+    ob.printf("%%%% ClassID(\"ClassStr\")\tTagID(\"TagStr\")\tlog(p(ClassID|TagID))\tp\n");
+    ob.printf("%%%%-----------------------------------------------------\n");
     LexClassProbTable::const_iterator cpi;
     ClassID cid;
+    string classname;
     for (cpi = lcprobs.begin() , cid = 0;
 	 cpi != lcprobs.end()  ;
 	 ++cpi                 , ++cid)
       {
 	const LexClass &lclass = classids.id2name(cid);
-	string classname = "";
+	classname.clear();
 
 	for (LexClass::const_iterator lci = lclass.begin();  lci != lclass.end(); ++lci) {
 	  if (lci!=lclass.begin()) classname.push_back(' ');
@@ -1886,78 +2748,107 @@ void mootHMM::txtdump(FILE *file, bool dump_constants, bool dump_lexprobs, bool
 	}
 
 	if (cpi->empty()) {
-	  fprintf(file, "%u(\"%s\")\t--EMPTY--\n", cid, classname.c_str());
+	  if (filter_tags) continue;
+	  ob.put_idname(cid, classname);
+	  ob.put("\t--EMPTY--\n", 11);
 	  continue;
 	}
 
 	for (LexClassProbSubTable::const_iterator cpsi = cpi->begin(); cpsi != cpi->end(); ++cpsi)
 	  {
 	    TagID ctagid = cpsi->first;
-	    ProbT cprob  = cpsi->second;
-
-	    fprintf(file, "%u(\"%s\")\t%u(\"%s\")\t%e\t%e\n",
-		    cid, classname.c_str(),
-		    ctagid, tagids.id2name(ctagid).c_str(), cprob, exp(cprob));
+	    if (!WANT_TAG(ctagid)) continue;
+	    ob.put_idname(cid, classname);
+	    ob.put('\t');
+	    ob.put_idname(ctagid, tagids.id2name(ctagid));
+	    ob.put('\t');
+	    ob.put_prob(cpsi->second);
 	  }
       }
   }
   //--/dump_classprobs
 
-  if (dump_suftrie) {
-    fprintf(file, "\n");
-    fprintf(file, "%%%%-----------------------------------------------------\n");
-    fprintf(file, "%%%% Suffix Trie\n");
-    fprintf(file, "%%%% maxlen=%zd ; theta=%e\n", suftrie.maxlen(), suftrie.theta);
-    fprintf(file, "%%%% \"Suffix\"\tTagID(\"TagStr\")\tlog(p(Suffix|TagID))\tp\n");
-    fprintf(file, "%%%%-----------------------------------------------------\n");
+  if (opts.dump_suftrie) {
+    ob.printf("\n");
+    ob.printf("%%%%-----------------------------------------------------\n");
+    ob.printf("%%%% Suffix Trie\n");
+    ob.printf("%%%% maxlen=%zd ; theta=%e\n", suftrie.maxlen(), suftrie.theta);
+    ob.printf("%%%% \"Suffix\"\tTagID(\"TagStr\")\tlog(p(Suffix|TagID))\tp\n");
+    ob.printf("%%%%-----------------------------------------------------\n");
 #ifdef MOOT_ENABLE_SUFFIX_TRIE
+    //-- token filter: collect nodes on the (reversed) lookup paths of the requested tokens
+    set<SuffixTrie::NodeId> want_nodes;
+    for (set<mootTokString>::const_iterator toki = opts.tokens.begin(); toki != opts.tokens.end(); ++toki) {
+      SuffixTrie::const_iterator sti = suftrie.begin();
+      if (sti == suftrie.end()) break;
+      want_nodes.insert(0);
+      for (mootTokString::const_reverse_iterator ci = toki->rbegin(); ci != toki->rend(); ++ci) {
+	sti = suftrie.find_dtr(*sti, *ci);
+	if (sti == suftrie.end()) break;
+	want_nodes.insert(sti - suftrie.begin());
+      }
+    }
+
     for (SuffixTrie::const_iterator sti = suftrie.begin(); sti != suftrie.end(); ++sti) {
+      if (sti->data.empty()) continue;
+      if (!opts.tokens.empty() && want_nodes.find(sti - suftrie.begin()) == want_nodes.end()) continue;
       string suf = suftrie.node_string(*sti);
+
       for (SuffixTrieDataT::const_iterator stdi=sti->data.begin(); stdi != sti->data.end(); ++stdi)
 	{
-	  fprintf(file, "\"%s\"\t%u(\"%s\")\t%e\t%e\n",
-		  suf.c_str(),
-		  stdi->first,
-		  tagids.id2name(stdi->first).c_str(),
-		  stdi->second,
-		  exp(stdi->second));
+	  if (!WANT_TAG(stdi->first)) continue;
+	  ob.put('"');
+	  ob.put(suf);
+	  ob.put("\"\t", 2);
+	  ob.put_idname(stdi->first, tagids.id2name(stdi->first));
+	  ob.put('\t');
+	  ob.put_prob(stdi->second);
 	}
     }
 #else
-    fprintf(file, "%%%% DISABLED (re-compile with MOOT_ENABLE_SUFFIX_TRIE defined to enable)\n");
+    ob.printf("%%%% DISABLED (re-compile with MOOT_ENABLE_SUFFIX_TRIE defined to enable)\n");
 #endif //-- MOOT_ENABLE_SUFFIX_TRIE
   }
   //--/dump_suftrie
 
-  if (dump_ngprobs) {
+  if (opts.dump_ngprobs) {
     long unsigned int n_tags_lu = n_tags;
     long unsigned int ng_array_size = n_tags_lu * n_tags_lu * n_tags_lu;
 
-    fprintf(file, "\n");
-    fprintf(file, "%%%%-----------------------------------------------------\n");
-    fprintf(file, "%%%% N-gram (Uni-, Bi-, and Trigram) Probabilities\n");
-    fprintf(file, "%%%%  + n_tags = %zu\n", n_tags);
-    fprintf(file, "%%%%  + tagids_size = %u\n", tagids.size());
-    fprintf(file, "%%%%  + hash_size = %zu\n", ngprobsh.size());
-    fprintf(file, "%%%%  + array_size = %lu\n", (hash_ngrams ? 0 : ng_array_size));
-    fprintf(file, "%%%% Tag1Id(\"Tag1Str\")\tTag2Id(\"Tag2Str\")\tTag3Id(\"Tag3Str\")\tlog(p(Tag3|Tag1,Tag2))\tp\n");
-    fprintf(file, "%%%%-----------------------------------------------------\n");
+    ob.printf("\n");
+    ob.printf("%%%%-----------------------------------------------------\n");
+    ob.printf("%%%% N-gram (Uni-, Bi-, and Trigram) Probabilities\n");
+    ob.printf("%%%%  + n_tags = %zu\n", n_tags);
+    ob.printf("%%%%  + tagids_size = %u\n", tagids.size());
+    ob.printf("%%%%  + hash_size = %zu\n", ngprobsh.size());
+    ob.printf("%%%%  + array_size = %lu\n", (hash_ngrams ? 0 : ng_array_size));
+    ob.printf("%%%% Tag1Id(\"Tag1Str\")\tTag2Id(\"Tag2Str\")\tTag3Id(\"Tag3Str\")\tlog(p(Tag3|Tag1,Tag2))\tp\n");
+    ob.printf("%%%%-----------------------------------------------------\n");
     TagID pptagid;
 
     if ( (hash_ngrams && !ngprobsh.empty()) || (!hash_ngrams && ngprobsa!=NULL) ) {
       if (!hash_ngrams) {
+	const ProbT *ngp = ngprobsa;
 	for (pptagid = 0; pptagid < n_tags; ++pptagid) {
 	  for (ptagid = 0; ptagid < n_tags; ++ptagid) {
-	    for (tagid = 0; tagid < n_tags; ++tagid) {
-	      prob = tagp(pptagid, ptagid, tagid);
-	      if (prob != MOOT_PROB_ZERO) {
-		fprintf(file, "%u(\"%s\")\t%u(\"%s\")\t%u(\"%s\")\t%e\t%e\n",
-			pptagid,  tagids.id2name(pptagid).c_str(),
-			ptagid,  tagids.id2name(ptagid).c_str(),
-			tagid, tagids.id2name(tagid).c_str(),
-			prob,
-			exp(prob));
+	    for (tagid = 0; tagid < n_tags; ++tagid, ++ngp) {
+	      prob = *ngp;
+	      if (prob == MOOT_PROB_ZERO || !WANT_TAG(tagid)) continue;
+	      if (opts.sparse) {
+		//-- sparse: skip UNKNOWN and cells never written by compute_ngram_logprobs() (as for hash_ngrams)
+		if (tagid == 0 || (pptagid != 0 && ptagid == 0))
+		  continue;
+		//-- sparse: skip trigrams equal to their bigram, bigrams equal to their unigram
+		if (ptagid != 0 && (pptagid != 0 ? (prob == ngprobsa[(n_tags*ptagid)+tagid]) : (prob == ngprobsa[tagid])))
+		  continue;
 	      }
+	      ob.put_idname(pptagid, tagids.id2name(pptagid));
+	      ob.put('\t');
+	      ob.put_idname(ptagid, tagids.id2name(ptagid));
+	      ob.put('\t');
+	      ob.put_idname(tagid, tagids.id2name(tagid));
+	      ob.put('\t');
+	      ob.put_prob(prob);
 	    }
 	  }
 	}
@@ -1967,21 +2858,24 @@ void mootHMM::txtdump(FILE *file, bool dump_constants, bool dump_lexprobs, bool
 	  pptagid = ngi->first.tag1;
 	  ptagid  = ngi->first.tag2;
 	  tagid   = ngi->first.tag3;
-	  fprintf(file, "%u(\"%s\")\t%u(\"%s\")\t%u(\"%s\")\t%e\t%e\n",
-		  pptagid,  tagids.id2name(pptagid).c_str(),
-		  ptagid,  tagids.id2name(ptagid).c_str(),
-		  tagid, tagids.id2name(tagid).c_str(),
-		  prob,
-		  exp(prob));
+	  if (!WANT_TAG(tagid)) continue;
+	  ob.put_idname(pptagid, tagids.id2name(pptagid));
+	  ob.put('\t');
+	  ob.put_idname(ptagid, tagids.id2name(ptagid));
+	  ob.put('\t');
+	  ob.put_idname(tagid, tagids.id2name(tagid));
+	  ob.put('\t');
+	  ob.put_prob(prob);
 	}
       }
     } else {
-      fprintf(file, "%%%% (NULL | empty)\n");
+      ob.printf("%%%% (NULL | empty)\n");
     }
   }
   //-- /dump_ngprobs
+#undef WANT_TAG
 
-  fprintf(file, "\n");
+  ob.printf("\n");
 }
 
 /*--------------------------------------------------------------------------
@@ -2096,7 +2990,7 @@ const HeaderInfo::VersionT BINCOMPAT_MIN_VER_LOAD = 2; //-- native: we can load
 const HeaderInfo::VersionT BINCOMPAT_MIN_REV_LOAD = 5;
 #endif
 */
-/* v2.0.9-1 .. CURRENT */
+/* v2.0.9-1 .. v2.0.20
 const HeaderInfo::VersionT BINCOMPAT_VER = 3;          //-- we save files as BINCOMPAT_$(VER.REV)
 const HeaderInfo::VersionT BINCOMPAT_REV = 2;
 #if MOOT_32BIT_FORCE
@@ -2110,17 +3004,39 @@ const HeaderInfo::VersionT BINCOMPAT_MIN_REV_SAVE = 1;
 const HeaderInfo::VersionT BINCOMPAT_MIN_VER_LOAD = 2; //-- native: we can load files >= BINCOMPAT_MIN_VER_LOAD_$(VER.REV)
 const HeaderInfo::VersionT BINCOMPAT_MIN_REV_LOAD = 5;
 #endif
+*/
+/* v2.0.21 .. CURRENT : sectioned format */
+const HeaderInfo::VersionT BINCOMPAT_VER = 4;          //-- we save files as BINCOMPAT_$(VER.REV)
+const HeaderInfo::VersionT BINCOMPAT_REV = 0;
+const HeaderInfo::VersionT BINCOMPAT_MIN_VER_SAVE = 4; //-- our files can be loaded by libs >= BINCOMPAT_MIN_VER_SAVE_$(VER.REV)
+const HeaderInfo::VersionT BINCOMPAT_MIN_REV_SAVE = 0;
+#if MOOT_32BIT_FORCE
+const HeaderInfo::VersionT BINCOMPAT_MIN_VER_LOAD = 3; //-- 32bit: we can load files >= BINCOMPAT_MIN_VER_LOAD_$(VER.REV)
+const HeaderInfo::VersionT BINCOMPAT_MIN_REV_LOAD = 1;
+#else
+const HeaderInfo::VersionT BINCOMPAT_MIN_VER_LOAD = 2; //-- native: we can load files >= BINCOMPAT_MIN_VER_LOAD_$(VER.REV)
+const HeaderInfo::VersionT BINCOMPAT_MIN_REV_LOAD = 5;
+#endif
+
+/** Binary model sections in file order (format >= 4.0) */
+static const int binSectionOrder[] = {
+  mootHMM::bsConstants,
+  mootHMM::bsIds,
+  mootHMM::bsFlavors,
+  mootHMM::bsLexProbs,
+  mootHMM::bsClassProbs,
+  mootHMM::bsNgramProbs,
+#ifdef MOOT_ENABLE_SUFFIX_TRIE
+  mootHMM::bsSuffixTrie,
+#endif
+  mootHMM::bsNone
+};
 
 
 bool mootHMM::save(const char *filename, int compression_level)
 {
   //-- open file
-#ifdef MOOT_ZLIB_ENABLED
-  mootio::mozfstream 
-#else 
-  mootio::mofstream
-#endif
-    ofs(filename,"wb");
+  mootio::mozbstream ofs(filename,"wb");
 
   if (!ofs.valid()) {
     carp("mootHMM::save(): open failed for \"%s\": %s\n", filename, ofs.errmsg().c_str());
@@ -2137,6 +3053,7 @@ bool mootHMM::save(const char *filename, int compression_level)
 bool mootHMM::save(mootio::mostream *obs, const char *filename)
 {
   if (!obs || !obs->valid()) return false;
+  if (!require_sections(bsAll)) return false;
 
   HeaderInfo hi(string("mootHMM"),
 		BINCOMPAT_VER,          BINCOMPAT_REV,
@@ -2169,77 +3086,128 @@ bool mootHMM::save(mootio::mostream *obs, const char *filename)
 
 bool mootHMM::_bindump(mootio::mostream *obs, const HeaderInfo &hdr, const char *filename)
 {
-  //-- variables
   Item<size_t> size_item;
-  Item<TagID> tagid_item;
-  Item<ProbT> probt_item;
-  Item<bool> bool_item;
-  Item<LexClass> lclass_item;
-  Item<TokIDTable> tokids_item;
-  Item<TagIDTable> tagids_item;
-  Item<ClassIDTable> classids_item;
-  Item<LexProbTable> lexprobs_item;
-  Item<LexClassProbTable> lcprobs_item;
-  Item<NgramProbHash> nghash_item;
-  Item<mootTaster> taster_item;
-
-#ifdef MOOT_ENABLE_SUFFIX_TRIE
-  Item<SuffixTrie> trie_item;
-#endif
-
-  if (! (tagid_item.save(obs, start_tagid)
-	 && probt_item.save(obs, unknown_lex_threshhold)
-	 && probt_item.save(obs, nglambda1)
-	 && probt_item.save(obs, nglambda2)
-	 && probt_item.save(obs, nglambda3)
-	 && probt_item.save(obs, wlambda0)
-	 && probt_item.save(obs, wlambda1)
-
-	 && bool_item.save(obs, hash_ngrams)
-	 && bool_item.save(obs, relax)
-	 && bool_item.save(obs, use_lex_classes)
-	 && bool_item.save(obs, use_flavors)   //-- v2.0.9-1 / binfmt 3.2
-	 && lclass_item.save(obs, uclass)
-	 && probt_item.save(obs, clambda0)
-	 && probt_item.save(obs, clambda1)
-
-	 && probt_item.save(obs, beamwd)
-
-	 && tokids_item.save(obs, tokids)
-	 && tagids_item.save(obs, tagids)
-	 && classids_item.save(obs, classids)
-	 && size_item.save(obs, n_tags)
-	 && size_item.save(obs, n_toks)
-	 && size_item.save(obs, n_classes)
-	 && lexprobs_item.save(obs, lexprobs)
-	 && lcprobs_item.save(obs, lcprobs)
-	 && (hash_ngrams
-	     ? nghash_item.save(obs, ngprobsh)
-	     : probt_item.save_n(obs, ngprobsa, n_tags*n_tags*n_tags)
-	     )
-	 ))
-    {
-      carp("mootHMM::save(): could not save data%s%s\n",
+  mootio::mcbuffer buf(0);
+  vector<BinSection> sections;
+
+  //-- serialize sections
+  for (const int *idp = binSectionOrder; *idp != bsNone; ++idp) {
+    buf.clear();
+    if (!_bindump_section(*idp, &buf)) {
+      carp("mootHMM::save(): could not save %s%s%s\n", section_name(*idp),
 	   (filename ? " to file " : ""), (filename ? filename : ""));
       return false;
     }
+    sections.push_back(BinSection());
+    BinSection &sec = sections.back();
+    sec.id = *idp;
+    sec.data.assign(buf.cb_wdata, buf.cb_used);
+    sec.crc = moot_crc32(sec.data.data(), sec.data.size());
+  }
 
-#ifdef MOOT_ENABLE_SUFFIX_TRIE
-  if (!trie_item.save(obs, suftrie))
-    {
-      carp("mootHMM::save(): could not save suffix trie%s%s\n",
-	   (filename ? " to file " : ""), (filename ? filename : ""));
-      return false;
-    }
-#endif //--MOOT_ENABLE_SUFFIX_TRIE
+  //-- table of contents: (id, length, crc) for each section
+  bool rc = size_item.save(obs, sections.size());
+  for (vector<BinSection>::const_iterator si = sections.begin(); rc && si != sections.end(); ++si) {
+    rc = (size_item.save(obs, si->id)
+	  && size_item.save(obs, si->data.size())
+	  && size_item.save(obs, si->crc));
+  }
+
+  //-- section data
+  for (vector<BinSection>::const_iterator si = sections.begin(); rc && si != sections.end(); ++si) {
+    rc = obs->write(si->data.data(), si->data.size());
+  }
 
-  if (!taster_item.save(obs, taster)) { //-- v2.0.9-1 / binfmt 3.2
-    carp("mootHMM::save(): could not save flavor data%s%s\n",
+  if (!rc) {
+    carp("mootHMM::save(): could not save data%s%s\n",
 	 (filename ? " to file " : ""), (filename ? filename : ""));
-    return false;
   }
+  return rc;
+}
 
-  return true;
+bool mootHMM::_bindump_section(int id, mootio::mostream *obs)
+{
+  switch (id) {
+  case bsConstants: {
+    Item<TagID> tagid_item;
+    Item<ProbT> probt_item;
+    Item<bool> bool_item;
+    Item<LexClass> lclass_item;
+    return (tagid_item.save(obs, start_tagid)
+	    && probt_item.save(obs, unknown_lex_threshhold)
+	    && probt_item.save(obs, nglambda1)
+	    && probt_item.save(obs, nglambda2)
+	    && probt_item.save(obs, nglambda3)
+	    && probt_item.save(obs, wlambda0)
+	    && probt_item.save(obs, wlambda1)
+	    && bool_item.save(obs, hash_ngrams)
+	    && bool_item.save(obs, relax)
+	    && bool_item.save(obs, use_lex_classes)
+	    && bool_item.save(obs, use_flavors)
+	    && lclass_item.save(obs, uclass)
+	    && probt_item.save(obs, clambda0)
+	    && probt_item.save(obs, clambda1)
+	    && probt_item.save(obs, beamwd));
+  }
+  case bsIds: {
+    Item<size_t> size_item;
+    Item<TokIDTable> tokids_item;
+    Item<TagIDTable> tagids_item;
+    Item<ClassIDTable> classids_item;
+    return (tokids_item.save(obs, tokids)
+	    && tagids_item.save(obs, tagids)
+	    && classids_item.save(obs, classids)
+	    && size_item.save(obs, n_tags)
+	    && size_item.save(obs, n_toks)
+	    && size_item.save(obs, n_classes));
+  }
+  case bsLexProbs: {
+    Item<LexProbTable> lexprobs_item;
+    return lexprobs_item.save(obs, lexprobs);
+  }
+  case bsClassProbs: {
+    Item<LexClassProbTable> lcprobs_item;
+    return lcprobs_item.save(obs, lcprobs);
+  }
+  case bsNgramProbs: {
+    //-- store the table type with the table, since hash_ngrams may change before it is decoded
+    Item<bool> bool_item;
+    Item<ProbT> probt_item;
+    Item<NgramProbHash> nghash_item;
+    return (bool_item.save(obs, hash_ngrams)
+	    && (hash_ngrams
+		? nghash_item.save(obs, ngprobsh)
+		: probt_item.save_n(obs, ngprobsa, n_tags*n_tags*n_tags)));
+  }
+#ifdef MOOT_ENABLE_SUFFIX_TRIE
+  case bsSuffixTrie: {
+    Item<SuffixTrie> trie_item;
+    return trie_item.save(obs, suftrie);
+  }
+#endif
+  case bsFlavors: {
+    Item<mootTaster> taster_item;
+    return taster_item.save(obs, taster);
+  }
+  default:
+    break;
+  }
+  return false;
+}
+
+const char *mootHMM::section_name(int id)
+{
+  switch (id) {
+  case bsConstants:  return "model constants";
+  case bsIds:        return "ID data";
+  case bsLexProbs:   return "lexical probabilities";
+  case bsClassProbs: return "class probabilities";
+  case bsNgramProbs: return "n-gram probabilities";
+  case bsSuffixTrie: return "trie data";
+  case bsFlavors:    return "flavor data";
+  default:           break;
+  }
+  return "unknown section";
 }
 
 /*--------------------------------------------------------------------------
@@ -2249,12 +3217,7 @@ bool mootHMM::_bindump(mootio::mostream *obs, const HeaderInfo &hdr, const char
 bool mootHMM::load(const char *filename)
 {
   //-- open file
-#ifdef MOOT_ZLIB_ENABLED
-  mootio::mizfstream
-#else //-- !MOOT_ZLIB_ENABLED
-  mootio::mifstream
-#endif
-    ifs(filename,"rb");
+  mootio::mizbstream ifs(filename,"rb");
 
   if (!ifs.valid()) {
     carp("mootHMM::load(): open failed for \"%s\": %s\n",
@@ -2342,23 +3305,31 @@ bool mootHMM::load(mootio::mistream *ibs, const char *filename)
   if(!_binload(ibs, hi, filename))
     return false;
 
-  if (crc != (start_tagid + n_tags + n_toks + n_classes
+  //-- legacy checksum (sectioned files have per-section checksums)
+  if (hi.version < 4
+      && crc != (start_tagid + n_tags + n_toks + n_classes
 #ifdef MOOT_ENABLE_SUFFIX_TRIE
-	      + suftrie.size()
+		 + suftrie.size()
 #endif
-	      ))
+		 ))
     {
       carp("mootHMM::load(): checksum failed%s%s\n",
 	   (filename ? " for file " : ""), (filename ? filename : ""));
     }
 
-  viterbi_clear(); //-- (re-)initialize Viterbi table
+  //-- (re-)initialize Viterbi table, leaving deferred sections for first use
+  int deferred = deferred_sections;
+  deferred_sections = 0;
+  viterbi_clear();
+  deferred_sections = deferred;
   return true;
 }
 
 
 bool mootHMM::_binload(mootio::mistream *ibs, const HeaderInfo &hdr, const char *filename)
 {
+  if (hdr.version >= 4) return _binload_sections(ibs, hdr, filename);
+
   //-- variables
   Item<size_t> size_item;
   Item<TagID> tagid_item;
@@ -2468,6 +3439,169 @@ bool mootHMM::_binload(mootio::mistream *ibs, const HeaderInfo &hdr, const char
 }
 
 
+
+bool mootHMM::_binload_sections(mootio::mistream *ibs, const HeaderInfo &hdr, const char *filename)
+{
+  Item<size_t> size_item;
+  size_t nsections, id, len, crc;
+
+  //-- table of contents
+  if (!size_item.load(ibs, nsections)) {
+    carp("mootHMM::load(): could not load section table%s%s\n",
+	 (filename ? " from file " : ""), (filename ? filename : ""));
+    return false;
+  }
+  vector<BinSection> sections(nsections);
+  for (vector<BinSection>::iterator si = sections.begin(); si != sections.end(); ++si) {
+    if (! (size_item.load(ibs, id)
+	   && size_item.load(ibs, len)
+	   && size_item.load(ibs, crc)))
+      {
+	carp("mootHMM::load(): could not load section table%s%s\n",
+	     (filename ? " from file " : ""), (filename ? filename : ""));
+	return false;
+      }
+    si->id  = static_cast<int>(id);
+    si->crc = static_cast<unsigned int>(crc);
+    si->data.resize(len);
+  }
+
+  //-- section data: check, then decode or defer; unknown sections are ignored
+  int defer = defer_sections & ~(bsConstants|bsIds);
+  for (vector<BinSection>::iterator si = sections.begin(); si != sections.end(); ++si) {
+    for (size_t off = 0; off < si->data.size(); ) {
+      size_t n = si->data.size() - off;
+      if (n > (1U<<30)) n = (1U<<30);
+      if (ibs->read(&si->data[off], n) != static_cast<ByteCount>(n)) {
+	carp("mootHMM::load(): could not load %s%s%s\n", section_name(si->id),
+	     (filename ? " from file " : ""), (filename ? filename : ""));
+	return false;
+      }
+      off += n;
+    }
+    if ((si->id & bsAll) == 0) continue;
+    if (moot_crc32(si->data.data(), si->data.size()) != si->crc) {
+      carp("mootHMM::load(): checksum failed for %s%s%s\n", section_name(si->id),
+	   (filename ? " in file " : ""), (filename ? filename : ""));
+      return false;
+    }
+    if (si->id & defer) {
+      deferred_sections |= si->id;
+      deferred_data.push_back(BinSection());
+      deferred_data.back().id  = si->id;
+      deferred_data.back().crc = si->crc;
+      deferred_data.back().data.swap(si->data);
+    }
+    else if (!_binload_section_data(*si, filename)) {
+      return false;
+    }
+    si->data.clear();
+  }
+  return true;
+}
+
+bool mootHMM::_binload_section_data(const BinSection &sec, const char *filename)
+{
+  mootio::micbuffer mib(sec.data.data(), sec.data.size());
+  if (!_binload_section(sec.id, &mib)) {
+    carp("mootHMM::load(): could not load %s%s%s\n", section_name(sec.id),
+	 (filename ? " from file " : ""), (filename ? filename : ""));
+    return false;
+  }
+  return true;
+}
+
+bool mootHMM::_binload_section(int id, mootio::mistream *ibs)
+{
+  switch (id) {
+  case bsConstants: {
+    Item<TagID> tagid_item;
+    Item<ProbT> probt_item;
+    Item<bool> bool_item;
+    Item<LexClass> lclass_item;
+    return (tagid_item.load(ibs, start_tagid)
+	    && probt_item.load(ibs, unknown_lex_threshhold)
+	    && probt_item.load(ibs, nglambda1)
+	    && probt_item.load(ibs, nglambda2)
+	    && probt_item.load(ibs, nglambda3)
+	    && probt_item.load(ibs, wlambda0)
+	    && probt_item.load(ibs, wlambda1)
+	    && bool_item.load(ibs, hash_ngrams)
+	    && bool_item.load(ibs, relax)
+	    && bool_item.load(ibs, use_lex_classes)
+	    && bool_item.load(ibs, use_flavors)
+	    && lclass_item.load(ibs, uclass)
+	    && probt_item.load(ibs, clambda0)
+	    && probt_item.load(ibs, clambda1)
+	    && probt_item.load(ibs, beamwd));
+  }
+  case bsIds: {
+    Item<size_t> size_item;
+    Item<TokIDTable> tokids_item;
+    Item<TagIDTable> tagids_item;
+    Item<ClassIDTable> classids_item;
+    return (tokids_item.load(ibs, tokids)
+	    && tagids_item.load(ibs, tagids)
+	    && classids_item.load(ibs, classids)
+	    && size_item.load(ibs, n_tags)
+	    && size_item.load(ibs, n_toks)
+	    && size_item.load(ibs, n_classes));
+  }
+  case bsLexProbs: {
+    Item<LexProbTable> lexprobs_item;
+    return lexprobs_item.load(ibs, lexprobs);
+  }
+  case bsClassProbs: {
+    Item<LexClassProbTable> lcprobs_item;
+    return lcprobs_item.load(ibs, lcprobs);
+  }
+  case bsNgramProbs: {
+    Item<bool> bool_item;
+    Item<ProbT> probt_item;
+    Item<NgramProbHash> nghash_item;
+    size_t ngprobsa_size = 0;
+    bool hashed;
+    if (ngprobsa) {
+      free(ngprobsa);
+      ngprobsa = NULL;
+    }
+    ngprobsh.clear();
+    return (bool_item.load(ibs, hashed)
+	    && (hashed
+		? nghash_item.load(ibs, ngprobsh)
+		: probt_item.load_n(ibs, ngprobsa, ngprobsa_size)));
+  }
+#ifdef MOOT_ENABLE_SUFFIX_TRIE
+  case bsSuffixTrie: {
+    Item<SuffixTrie> trie_item;
+    return trie_item.load(ibs, suftrie);
+  }
+#endif
+  case bsFlavors: {
+    Item<mootTaster> taster_item;
+    return taster_item.load(ibs, taster);
+  }
+  default:
+    break;
+  }
+  return true; //-- ignore unsupported sections
+}
+
+bool mootHMM::load_deferred(int sections)
+{
+  bool rc = true;
+  for (vector<BinSection>::iterator si = deferred_data.begin(); si != deferred_data.end(); ) {
+    if ((si->id & sections) == 0) {
+      ++si;
+      continue;
+    }
+    deferred_sections &= ~si->id;
+    rc = _binload_section_data(*si) && rc;
+    si = deferred_data.erase(si);
+  }
+  return rc;
+}
+
 /*--------------------------------------------------------------------------
  * Error reporting
  *--------------------------------------------------------------------------*/
@@ -180,6 +180,26 @@ public:
       return x==y;
     };
   };
+
+  /**
+   * Pre-resolved lexical lookup data for a single token,
+   * as computed by token2lexinfo() and consumed by viterbi_step(const LexInfo&,...).
+   */
+  class LexInfo {
+  public:
+    TokID    tokid;    /**< token-ID (or flavor-ID) */
+    ClassID  classid;  /**< class-ID (0 if unclassed or if !use_lex_classes) */
+    LexClass lclass;   /**< lexical class (empty if token is unclassed) */
+  public:
+    /** Default constructor */
+    LexInfo(void) : tokid(0), classid(0) {};
+  };
+
+  /**
+   * Type for the lexical lookup cache (see lexcache_lookup()):
+   * keys are token text followed by NUL-separated analysis tags.
+   */
+  typedef hash_map<mootTokString,LexInfo> LexCache;
   //@}
 
   /*---------------------------------------------------------------------*/
@@ -311,6 +331,23 @@ public:
   typedef Trigram          NgramProbKey;    ///< Generic n-gram key: trigrams
   typedef TrigramProbHash  NgramProbHash;   ///< Generic n-gram probabilities: trigrams, hashed
   typedef TrigramProbArray NgramProbArray;  ///< Generic n-gram probabilities: trigrams, dense
+
+#ifdef MOOT_ENABLE_SUFFIX_TRIE
+  /// Resolved suffix-trie lookup for a single unknown token text (see sufprobs_cached())
+  class SufLookup {
+  public:
+    const LexProbSubTable *lps;      ///< longest matching suffix distribution
+    bool                   matched;  ///< false iff no suffix matched (caller falls back to hapax distribution)
+  public:
+    /// Constructor
+    SufLookup(const LexProbSubTable *lps_=NULL, bool matched_=false)
+      : lps(lps_), matched(matched_)
+    {};
+  };
+
+  /// Type for suffix-trie lookup cache and unknown-word guess table: token text -> lookup
+  typedef hash_map<mootTokString,SufLookup> SufLookupTable;
+#endif
   //@}
 
   /*---------------------------------------------------------------------*/
@@ -450,6 +487,14 @@ public:
    */
   bool      use_flavors;
 
+  /**
+   * Whether tag_stream() may use a dense fixed-width Viterbi trellis
+   * (see tag_stream_tiny()) if no lexical distribution of the model
+   * has more than 16 entries (Default=true).  Output is identical
+   * either way.
+   */
+  bool      use_tiny_viterbi;
+
   /**
    * Boundary tag, used during compilation, viterbi_start(), and viterbi_finish()
    * This gets set by the \c start_tag_str argument to compile().
@@ -504,6 +549,26 @@ public:
    * A value of zero indicates no beam pruning.
    */
   ProbT             beamwd;
+
+  /**
+   * Maximum number of entries in the lexical lookup cache used
+   * by \c viterbi_step(mootToken); the cache is flushed whenever it
+   * grows beyond this size.
+   * A value of zero disables caching.
+   * You must call lexcache_clear() if you change \c use_flavors,
+   * \c use_lex_classes, or the ID tables after tagging has begun.
+   */
+  size_t            lexcache_max;
+
+#ifdef MOOT_ENABLE_SUFFIX_TRIE
+  /**
+   * Maximum number of entries in the suffix-trie lookup cache for
+   * unknown tokens (see sufprobs_cached()); the cache is flushed
+   * whenever it grows beyond this size.
+   * A value of zero disables caching.
+   */
+  size_t            sufcache_max;
+#endif
   //@}
 
   /*---------------------------------------------------------------------*/
@@ -530,9 +595,46 @@ public:
 
 #ifdef MOOT_ENABLE_SUFFIX_TRIE
   SuffixTrie        suftrie;    /**< string-suffix (log-)probability trie */
+  SufLookupTable    sufguesses; /**< precomputed suffix lookups for frequent unknown forms: see load_suffix_guesses() */
 #endif
   //@}
 
+  /*---------------------------------------------------------------------*/
+  /** \name Binary Model Sections */
+  //@{
+  /** Sections of binary model files (format >= 4.0), as bit-mask values */
+  enum BinSectionE {
+    bsNone       = 0x00,  ///< no section
+    bsConstants  = 0x01,  ///< smoothing constants and flags
+    bsIds        = 0x02,  ///< token, tag and class ID tables
+    bsLexProbs   = 0x04,  ///< lexical probabilities (lexprobs)
+    bsClassProbs = 0x08,  ///< lexical-class probabilities (lcprobs)
+    bsNgramProbs = 0x10,  ///< tag n-gram probabilities (ngprobsh or ngprobsa)
+    bsSuffixTrie = 0x20,  ///< suffix trie (suftrie)
+    bsFlavors    = 0x40,  ///< flavor heuristics (taster)
+    bsAll        = 0x7f   ///< all sections
+  };
+
+  /**
+   * Sections of binary model files whose decoding load() defers until
+   * first use (see require_sections()).  Ignored for bsConstants and bsIds.
+   * Only sections which are not modified before first use should be deferred.
+   * Default=bsClassProbs, which is decoded only if use_lex_classes is true
+   * when tagging starts.
+   */
+  int               defer_sections;
+
+  /** Raw data of a binary model section */
+  struct BinSection {
+    int          id;   /**< section ID (BinSectionE) */
+    unsigned int crc;  /**< CRC-32 checksum of \a data */
+    std::string  data; /**< raw section data */
+  };
+
+  /** Sections of the current model which have been read but not yet decoded */
+  int               deferred_sections;
+  //@}
+
   /*---------------------------------------------------------------------*/
   /** \name Viterbi Trellis Data */
   //@{
@@ -561,6 +663,12 @@ protected:
   ViterbiPathNode *trash_pathnodes; /**< Recycling bin for Viterbi path-nodes */
   //@}
 
+  /*---------------------------------------------------------------------*/
+  /** \name Low-level data: deferred model sections */
+  //@{
+  vector<BinSection> deferred_data; /**< Raw data of deferred model sections: see load_deferred() */
+  //@}
+
   /*---------------------------------------------------------------------*/
   /** \name Low-level data: temporaries */
   //@{
@@ -572,6 +680,16 @@ protected:
 
   ViterbiPathNode  *vbestpath;  /**< For node->path conversion */
 
+  vector<LexInfo>   vbatch;     /**< Pre-resolved token data for tag_batch() */
+  LexInfo           vlexinfo;   /**< Temporary lexical data for uncached viterbi_step(mootToken) */
+
+  LexCache          lexcache;     /**< Lexical lookup cache: see lexcache_lookup() */
+  mootTokString     lexcache_key; /**< Key buffer for lexcache_lookup() */
+
+#ifdef MOOT_ENABLE_SUFFIX_TRIE
+  SufLookupTable    sufcache;     /**< Suffix-trie lookup cache: see sufprobs_cached() */
+#endif
+
   //ProbT           bbestpr;   /**< Best current (log-)probability for beam pruning */
   //ProbT           bpprmin;   /**< Minimum previous probability for beam pruning */
   //@}
@@ -591,6 +709,7 @@ public:
       relax(true),
       use_lex_classes(true),
       use_flavors(true),
+      use_tiny_viterbi(true),
       start_tagid(0),
       unknown_lex_threshhold(1.0),
       unknown_class_threshhold(1.0),
@@ -601,10 +720,16 @@ public:
       clambda0(mootProbEpsilon),
       clambda1(1.0 - mootProbEpsilon),
       beamwd(1000),
+      lexcache_max(65536),
+#ifdef MOOT_ENABLE_SUFFIX_TRIE
+      sufcache_max(16384),
+#endif
       n_tags(0),
       n_toks(0),
       n_classes(0),
       ngprobsa(NULL),
+      defer_sections(bsClassProbs),
+      deferred_sections(0),
       vtable(NULL),
       nsents(0),
       ntokens(0),
@@ -663,6 +788,36 @@ public:
 
   /** Low-level: load guts from a binary stream */
   bool _binload(mootio::mistream *ibs, const mootBinIO::HeaderInfo &hdr, const char *filename=NULL);
+
+  /** Low-level: save section \a id (a BinSectionE value) to a binary stream */
+  bool _bindump_section(int id, mootio::mostream *obs);
+
+  /** Low-level: load section \a id (a BinSectionE value) from a binary stream */
+  bool _binload_section(int id, mootio::mistream *ibs);
+
+  /** Low-level: load sectioned guts (binary format >= 4.0) from a binary stream */
+  bool _binload_sections(mootio::mistream *ibs, const mootBinIO::HeaderInfo &hdr, const char *filename=NULL);
+
+  /** Decode checked section data \a sec, for load() and load_deferred() */
+  bool _binload_section_data(const BinSection &sec, const char *filename=NULL);
+
+  /** Decode all deferred sections of the current model in the bit-mask \a sections */
+  bool load_deferred(int sections=bsAll);
+
+  /** Ensure that \a sections of the current model have been decoded (see defer_sections) */
+  inline bool require_sections(int sections)
+  {
+    return (deferred_sections & sections)==0 || load_deferred(sections);
+  };
+
+  /** Get bit-mask of sections required for tagging with the current flags */
+  inline int tagging_sections(void) const
+  {
+    return use_lex_classes ? bsAll : (bsAll & ~bsClassProbs);
+  };
+
+  /** Get name of binary model section \a id, for diagnostics */
+  static const char *section_name(int id);
   //@}
 
   /*------------------------------------------------------------*/
@@ -722,6 +877,31 @@ public:
 			  bool  do_build_suffix_trie=true,
 			  bool  do_compute_logprobs=true);
 
+  /**
+   * Mid-level: compile a model from in-memory raw frequency data, and estimate
+   * smoothing constants.  Called by load_model() for text-format models.
+   * Returns true on success, false on failure.
+   *
+   * @param lexfreqs raw lexical frequencies: modified in place (computes and discounts
+   *        pseudo-frequencies for "special" lexemes according to \c unknown_lex_threshhold)
+   * @param ngfreqs raw n-gram frequencies
+   * @param classfreqs raw lexical-class frequencies (ignored unless \c use_lex_classes is true)
+   * @param mtaster token flavor heuristics (ignored unless \c use_flavors is true)
+   *
+   * Other parameters are as for load_model().
+   */
+  bool compile_model(mootLexfreqs &lexfreqs,
+		     const mootNgrams &ngfreqs,
+		     const mootClassfreqs &classfreqs,
+		     const mootTaster &mtaster,
+		     const mootTagString &start_tag_str="__$",
+		     const char *myname="mootHMM::compile_model()",
+		     bool  do_estimate_nglambdas=true,
+		     bool  do_estimate_wlambdas=true,
+		     bool  do_estimate_clambdas=true,
+		     bool  do_build_suffix_trie=true,
+		     bool  do_compute_logprobs=true);
+
   /**
    * Compile
    * probabilites from raw frequency counts in 'lexfreqs' and 'ngrams'.
@@ -765,15 +945,43 @@ public:
 			 bool  verbose=false)
   {
 #ifdef MOOT_ENABLE_SUFFIX_TRIE
+    sufcache.clear();
+    sufguesses.clear();
     return suftrie.build(lf,ng,tagids,start_tagid,verbose);
 #else
     return false;
 #endif
   };
 
+  /**
+   * Load precomputed suffix-trie lookups ("guesses") for frequent unknown
+   * word forms from \c filename, which should contain one word per line
+   * (only the first TAB-separated field is used; lines beginning with
+   * "%%" are ignored).  Forms known to the model are skipped.
+   * If \c max_entries is nonzero, at most that many guesses are loaded.
+   * Guesses are never evicted and are consulted before \c sufcache.
+   * Must be called after the model (and thus the suffix trie) has been
+   * loaded.  Returns false on failure.
+   */
+  bool load_suffix_guesses(const char *filename, size_t max_entries=0);
+
   /** Pre-compute runtime log-probability tables: NOT called by compile(). */
   bool compute_logprobs(void);
 
+  /** Smooth and logify raw n-gram probabilities, then logify \c nglambda*: called by compute_logprobs() */
+  void compute_ngram_logprobs(void);
+
+  /** Logify raw lexical probabilities and \c wlambda*: called by compute_logprobs() */
+  void compute_lex_logprobs(void);
+
+  /** Logify raw lexical-class probabilities and \c clambda*: called by compute_logprobs() */
+  void compute_class_logprobs(void);
+
+#ifdef MOOT_ENABLE_SUFFIX_TRIE
+  /** Logify raw suffix-trie probabilities: called by compute_logprobs() */
+  void compute_suffix_logprobs(void);
+#endif
+
   /** Low-level utility: set a (raw) n-gram probability.  Used by compile() */
   inline void set_ngram_prob(ProbT p, TagID t1=0, TagID t2=0, TagID t3=0)
   {
@@ -797,13 +1005,87 @@ public:
    */
   void tag_sentence(mootSentence &sentence);
 
+  /** Type for a batch of sentences to be tagged by tag_batch() */
+  typedef vector<mootSentence*> SentenceBatch;
+
+  /**
+   * Top-level tagging interface: tag a whole batch of sentences (destructive).
+   * Output is identical to calling tag_sentence() for each element of \c batch
+   * in order, but token- and class-ID lookups for the whole batch are resolved
+   * in a single pass before any Viterbi iterations are run, and trellis
+   * storage is recycled across all sentences of the batch.
+   * NULL elements of \c batch are silently ignored.
+   */
+  virtual void tag_batch(SentenceBatch &batch);
+
   /** Top-level tagging interface: TokenIO layer using sentence-level I/O */
   virtual void tag_io(TokenReader *reader, TokenWriter *writer);
 
   /** Top-level tagging interface: TokenIO layer using token-level I/O */
   virtual void tag_stream(TokenReader *reader, TokenWriter *writer);
+
+  /**
+   * Top-level tagging interface: token-level I/O using lexical data
+   * resolved by the token source itself (e.g. wasteLexerReader::bind_model()).
+   * Behaves like tag_stream(TokenReader*,TokenWriter*), except that whenever
+   * \c *lexinfo is non-NULL after a call to \c reader->get_token(), it is used
+   * in place of the token's text and analyses, and \c *lextext is used as
+   * token text for suffix-trie lookup.  The reader is responsible for
+   * updating both pointers on each call to get_token().
+   *
+   * Uses tag_stream_tiny() if tiny_viterbi_width() allows it.
+   */
+  void tag_stream(TokenReader *reader, TokenWriter *writer,
+		  const LexInfo *const *lexinfo, const mootTokString *const *lextext);
+  //@}
+
+protected:
+  /*---------------------------------------------------------------------*/
+  /** \name Tagging: dense fixed-width trellis */
+  //@{
+  /**
+   * Returns the maximum number of lexical probability entries for any
+   * token or class if tag_stream() can use tag_stream_tiny() for output
+   * to \c writer, or 0 if it cannot (e.g. if \c use_tiny_viterbi is false,
+   * \c hash_ngrams is true, trellis data is required by \c save_ambiguities
+   * or a tiofTrace writer).
+   */
+  size_t tiny_viterbi_width(const TokenWriter *writer) const;
+
+  /**
+   * Guts for tag_stream() with a dense trellis of at most \c NRows rows
+   * per column, which avoids the linked lists and trash stacks of
+   * viterbi_populate_row().  Rows are populated in the same order as by
+   * viterbi_step(), so ties are broken identically.  If a column needs more
+   * than \c NRows rows (e.g. on fallback), the current trellis window is
+   * copied to \c vtable and tagging continues with the generic methods up
+   * to the next flush.
+   */
+  template <size_t NRows>
+  void tag_stream_tiny(TokenReader *reader, TokenWriter *writer,
+		       const LexInfo *const *lexinfo, const mootTokString *const *lextext);
+
+  /**
+   * Get lexical trellis rows for a single token into \c tags and \c probs,
+   * as viterbi_step(const LexInfo&,const mootTokString&) would populate them
+   * (statistics are updated accordingly).  Returns the sanitized token-ID.
+   */
+  TokID viterbi_lexrow(const LexInfo &info, const mootTokString &toktext,
+		       vector<TagID> &tags, vector<ProbT> &probs);
+
+  /** Generic Viterbi step for rows as returned by viterbi_lexrow(), appending to \c col if non-NULL */
+  void viterbi_step_rows(TokID tokid, const vector<TagID> &tags, const vector<ProbT> &probs,
+			 ViterbiColumn *col=NULL);
+
+  /**
+   * Like viterbi_flush(), but marks vanilla tokens in \c toks with the tags
+   * in \c path and leaves both \c toks and the trellis alone.
+   */
+  void viterbi_flush_tags(TokenWriter *writer, mootSentence &toks, const vector<TagID> &path);
   //@}
 
+public:
+
   /*====================================================================
    * VITERBI: Mid-level
    *====================================================================*/
@@ -823,9 +1105,12 @@ public:
   inline void viterbi_step(const mootToken &token) {
     if (token.toktype() != TokTypeVanilla) return; //-- ignore non-vanilla tokens
     ++ntokens;
-    LexClass tok_class;
-    token2lexclass(token, tok_class);
-    viterbi_step(token2id(token.text()), tok_class, token.text());
+    if (lexcache_max) {
+      viterbi_step(lexcache_lookup(token), token.text());
+    } else {
+      token2lexinfo(token, vlexinfo);
+      viterbi_step(vlexinfo, token.text());
+    }
   };
 
   //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -859,6 +1144,24 @@ public:
     }
   };
 
+  //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Viterbi: single iteration: (LexInfo)
+  /**
+   * Step a single Viterbi iteration using pre-resolved lexical
+   * data \c info as returned by token2lexinfo().
+   * Behaves exactly like \c viterbi_step(TokID,LexClass,mootTokString).
+   */
+  inline void viterbi_step(const LexInfo &info, const mootTokString &toktext="")
+  {
+    if (info.lclass.empty()) {
+      ++nunclassed;
+      if (use_lex_classes) viterbi_step(info.tokid, 0, uclass, toktext);
+      else                 viterbi_step(info.tokid, toktext);
+    } else {
+      viterbi_step(info.tokid, info.classid, info.lclass, toktext);
+    }
+  };
+
   //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
   // Viterbi: single iteration: (TokID,ClassID,LexClass)
   /**
@@ -1195,6 +1498,31 @@ public:
   /** Add \c tag fields of mootToken::analyses to \c tok_class */
   void token2lexclass(const mootToken &token, LexClass &tok_class) const;
 
+  //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  /**
+   * Resolve all lexical lookup data for \c token into \c info.
+   * New lexical classes are assigned IDs just as for \c viterbi_step(mootToken).
+   */
+  inline void token2lexinfo(const mootToken &token, LexInfo &info)
+  {
+    info.tokid = token2id(token.text());
+    info.lclass.clear();
+    token2lexclass(token, info.lclass);
+    info.classid = (use_lex_classes && !info.lclass.empty()) ? class2id(info.lclass,0,1) : 0;
+  };
+
+  /**
+   * Cached version of token2lexinfo(): returns lexical lookup data for
+   * \c token from the cache \c lexcache, computing and inserting it if
+   * not already present.  The returned reference is valid only until
+   * the next call to this method.
+   */
+  const LexInfo &lexcache_lookup(const mootToken &token);
+
+  /** Clear the lexical lookup cache */
+  inline void lexcache_clear(void)
+  { lexcache.clear(); };
+
   //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
   /**
    * Convert string-form tagsets to lexical classes.
@@ -1239,6 +1567,22 @@ public:
     return lpsi != lps.end() ? lpsi->value() : MOOT_PROB_ZERO;
   };
 
+#ifdef MOOT_ENABLE_SUFFIX_TRIE
+  /**
+   * Get lexical probability distribution for an unknown token \c toktext
+   * from the suffix trie, consulting \c sufguesses and \c sufcache first.
+   * Returns \c hapax if no suffix of \c toktext matched.
+   */
+  const LexProbSubTable *sufprobs_cached(const mootTokString &toktext, const LexProbSubTable *hapax);
+
+  /** Uncached suffix-trie lookup for \c toktext */
+  SufLookup suffix_lookup(const mootTokString &toktext) const;
+
+  /** Clear the suffix-trie lookup cache (but not \c sufguesses) */
+  inline void sufcache_clear(void)
+  { sufcache.clear(); };
+#endif
+
   /**
    * \deprecated{prefer direct lookup}
    *
@@ -1388,9 +1732,37 @@ public:
 
   /** \name Debugging */
   //@{
+  /** \brief Table selection and filters for txtdump() */
+  class TxtDumpOptions {
+  public:
+    bool dump_constants;   /**< dump scalar constants and flavors */
+    bool dump_lexprobs;    /**< dump lexical probabilities */
+    bool dump_classprobs;  /**< dump lexical-class probabilities */
+    bool dump_suftrie;     /**< dump suffix trie */
+    bool dump_ngprobs;     /**< dump tag n-gram probabilities */
+    bool sparse;           /**< omit dense n-gram entries equal to their (n-1)-gram backoff value */
+    std::set<mootTokString> tokens; /**< if non-empty, dump only lexical entries and suffixes of these tokens */
+    std::set<mootTagString> tags;   /**< if non-empty, dump only entries whose (last) tag is in this set */
+
+  public:
+    TxtDumpOptions(void)
+      : dump_constants(true), dump_lexprobs(true), dump_classprobs(true),
+	dump_suftrie(true), dump_ngprobs(true), sparse(false)
+    {};
+  };
+
   /** Debugging method: dump basic HMM contents to a text file. */
   void txtdump(FILE *file, bool dump_constants=true, bool dump_lexprobs=true, bool dump_classprobs=true, bool dump_suftrie=true, bool dump_ngprobs=true);
 
+  /**
+   * Debugging method: dump selected HMM tables to a text file through an output buffer.
+   * Tokens in \a opts.tokens are looked up as by the tagger (see token2id()).
+   * With \a opts.sparse, dense n-gram entries equal to the backoff value which
+   * tagp() would return for a hashed model are omitted, so that only observed
+   * n-grams are written.
+   */
+  void txtdump(FILE *file, const TxtDumpOptions &opts);
+
   /** Debugging method: dump entire Viterbi trellis to a text file
    *  \deprecated in favor of viterbi_dump_trace()
    */
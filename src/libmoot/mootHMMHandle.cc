@@ -0,0 +1,213 @@
+/* -*- Mode: C++ -*- */
+
+/*
+   libmoot : moocow's part-of-speech tagging library
+   Copyright (C) 2003-2014 by Bryan Jurish <moocow@cpan.org>
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 3 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+/*--------------------------------------------------------------------------
+ * File: mootHMMHandle.cc
+ * Author: Bryan Jurish <moocow@cpan.org>
+ * Description:
+ *   + moot PoS tagger : HMM model handle for hot-reloading in long-running processes
+ *--------------------------------------------------------------------------*/
+
+#ifdef HAVE_CONFIG_H
+# include <mootConfig.h>
+#endif
+
+#include <mootHMMHandle.h>
+#include <mootBufferIO.h>
+#include <mootUtils.h>
+
+moot_BEGIN_NAMESPACE
+
+using namespace std;
+using namespace mootio;
+
+/*======================================================================
+ * Constructors etc.
+ */
+
+//--------------------------------------------------------------
+mootHMMHandle::mootHMMHandle(size_t nslots)
+  : verbose(1),
+    start_tag_str("__$"),
+    slots(nslots ? nslots : 1),
+    generation(0),
+    loading(false),
+    async_done(false),
+    async_rc(true)
+{
+#ifdef MOOT_PTHREADS_ENABLED
+  pthread_mutex_init(&mutex, NULL);
+#endif
+}
+
+//--------------------------------------------------------------
+mootHMMHandle::~mootHMMHandle(void)
+{
+  wait();
+  for (vector<Slot>::iterator si = slots.begin(); si != slots.end(); ++si) {
+    if (si->hmm)     delete si->hmm;
+    if (si->pending) delete si->pending;
+  }
+  slots.clear();
+#ifdef MOOT_PTHREADS_ENABLED
+  pthread_mutex_destroy(&mutex);
+#endif
+}
+
+/*======================================================================
+ * Loading & publication
+ */
+
+//--------------------------------------------------------------
+bool mootHMMHandle::load(const std::string &name)
+{
+  //-- load prototype (which is used directly for slot 0)
+  mootHMM *proto = new_hmm();
+  if (!proto->load_model(name, start_tag_str, "mootHMMHandle::load()")) {
+    moot_msg(verbose, vlErrors, "mootHMMHandle::load(): failed to load model '%s'\n", name.c_str());
+    delete proto;
+    return false;
+  }
+
+  vector<mootHMM*> hmms(slots.size(), NULL);
+  hmms[0] = proto;
+
+  if (slots.size() > 1) {
+    //-- serialize prototype once, then clone for remaining slots
+    mcbuffer buf;
+    buf.cb_get = 1<<20;
+    bool rc = proto->save(&buf, name.c_str());
+    for (size_t i=1; rc && i < hmms.size(); ++i) {
+      micbuffer ibuf(buf.data(), buf.size());
+      hmms[i] = new_hmm();
+      rc = hmms[i]->load(&ibuf, name.c_str());
+    }
+    if (!rc) {
+      moot_msg(verbose, vlErrors, "mootHMMHandle::load(): failed to clone model '%s'\n", name.c_str());
+      for (size_t i=0; i < hmms.size(); ++i) if (hmms[i]) delete hmms[i];
+      return false;
+    }
+  }
+
+  publish(hmms, name);
+  moot_msg(verbose, vlProgress, "mootHMMHandle::load(): published model '%s' as generation %zu\n",
+	   name.c_str(), current_generation());
+  return true;
+}
+
+//--------------------------------------------------------------
+void mootHMMHandle::publish(const vector<mootHMM*> &hmms, const std::string &name)
+{
+  vector<mootHMM*> stale;
+  lock();
+  size_t gen = generation + 1;
+  for (size_t i=0; i < slots.size(); ++i) {
+    Slot &s = slots[i];
+    if (s.pending) stale.push_back(s.pending); //-- never picked up: superseded
+    s.pending     = i < hmms.size() ? hmms[i] : NULL;
+    s.pending_gen = gen;
+  }
+  modelname  = name;
+  generation = gen;
+  unlock();
+
+  //-- free superseded instances outside of the lock
+  for (vector<mootHMM*>::iterator hi = stale.begin(); hi != stale.end(); ++hi) delete *hi;
+}
+
+//--------------------------------------------------------------
+mootHMM *mootHMMHandle::_sync_slow(Slot &s)
+{
+  mootHMM *old = NULL;
+  lock();
+  if (s.pending) {
+    old         = s.hmm;
+    s.hmm       = s.pending;
+    s.gen       = s.pending_gen;
+    s.pending   = NULL;
+  } else {
+    s.gen = generation;
+  }
+  unlock();
+  if (old) delete old;
+  return s.hmm;
+}
+
+/*======================================================================
+ * Background loading
+ */
+
+#ifdef MOOT_PTHREADS_ENABLED
+//--------------------------------------------------------------
+void *mootHMMHandle::_load_thread(void *data)
+{
+  mootHMMHandle *h = reinterpret_cast<mootHMMHandle*>(data);
+  bool rc = h->load(h->async_name);
+  h->lock();
+  h->async_rc   = rc;
+  h->async_done = true;
+  h->unlock();
+  return NULL;
+}
+#endif
+
+//--------------------------------------------------------------
+bool mootHMMHandle::load_async(const std::string &name)
+{
+#ifdef MOOT_PTHREADS_ENABLED
+  if (loading) {
+    //-- join a finished loader thread which has not been waited for
+    lock();
+    bool done = async_done;
+    unlock();
+    if (!done) return false;
+    pthread_join(loader, NULL);
+    loading = false;
+  }
+  async_name = name;
+  async_rc   = false;
+  async_done = false;
+  if (pthread_create(&loader, NULL, _load_thread, this) != 0) {
+    moot_msg(verbose, vlErrors, "mootHMMHandle::load_async(): could not create loader thread\n");
+    return false;
+  }
+  loading = true;
+  return true;
+#else
+  //-- no threads: load synchronously
+  async_rc = load(name);
+  return true;
+#endif
+}
+
+//--------------------------------------------------------------
+bool mootHMMHandle::wait(void)
+{
+#ifdef MOOT_PTHREADS_ENABLED
+  if (loading) {
+    pthread_join(loader, NULL);
+    loading = false;
+  }
+#endif
+  return async_rc;
+}
+
+moot_END_NAMESPACE
@@ -0,0 +1,204 @@
+/* -*- Mode: C++ -*- */
+
+/*
+   libmoot : moocow's part-of-speech tagging library
+   Copyright (C) 2003-2014 by Bryan Jurish <moocow@cpan.org>
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 3 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+/*--------------------------------------------------------------------------
+ * File: mootHMMHandle.h
+ * Author: Bryan Jurish <moocow@cpan.org>
+ * Description:
+ *   + moot PoS tagger : HMM model handle for hot-reloading in long-running processes
+ *--------------------------------------------------------------------------*/
+
+/**
+\file mootHMMHandle.h
+\brief Shared HMM model handle supporting background reloading under concurrent taggers
+*/
+
+#ifndef _MOOT_HMM_HANDLE_H
+#define _MOOT_HMM_HANDLE_H
+
+#include <mootHMM.h>
+
+#ifdef MOOT_PTHREADS_ENABLED
+# include <pthread.h>
+#endif
+
+moot_BEGIN_NAMESPACE
+
+/*======================================================================
+ * class mootHMMHandle
+ */
+/**
+ * \brief Model handle for switching tagger models in long-running (multi-threaded) processes.
+ * \details
+ * Since mootHMM objects keep per-sentence Viterbi state, each tagging thread
+ * needs its own instance.  A handle manages one such instance per "slot"
+ * (typically one slot per worker thread).  Calling load() or load_async()
+ * loads a model once into a prototype, clones it into a fresh instance for
+ * every slot, and then publishes the new instances as a new \a generation.
+ *
+ * Worker threads call sync() with their slot index between sentences:
+ * the common case (no new generation) is a single comparison under a
+ * briefly held mutex; otherwise the worker picks up its pre-built instance
+ * for the new generation and deletes its old one, so in-flight sentences
+ * are never interrupted and workers never wait for a model to load.
+ *
+ * Without POSIX threads support (MOOT_PTHREADS_ENABLED undefined),
+ * load_async() falls back to a synchronous load().
+ */
+class mootHMMHandle {
+public:
+  /*---------------------------------------------------------------------*/
+  /** \name Embedded Types */
+  //@{
+  /** \brief Per-worker data: current and pending model instances */
+  class Slot {
+  public:
+    mootHMM *hmm;         /**< current instance (owned by the worker) */
+    size_t   gen;         /**< generation of \a hmm */
+    mootHMM *pending;     /**< next instance, not yet picked up by sync() */
+    size_t   pending_gen; /**< generation of \a pending */
+  public:
+    Slot(void) : hmm(NULL), gen(0), pending(NULL), pending_gen(0) {};
+  };
+  //@}
+
+public:
+  /*---------------------------------------------------------------------*/
+  /** \name Data */
+  //@{
+  int              verbose;       /**< verbosity level (see mootHMM::verbose) */
+  mootTagString    start_tag_str; /**< boundary tag passed to mootHMM::load_model() */
+  vector<Slot>     slots;         /**< per-worker model instances */
+  size_t           generation;    /**< most recently published generation (0: none; guarded by \a mutex) */
+  std::string      modelname;     /**< name of most recently published model (guarded by \a mutex) */
+
+protected:
+#ifdef MOOT_PTHREADS_ENABLED
+  pthread_mutex_t  mutex;         /**< guards \a generation, \a slots[*].pending, and \a async_done */
+  pthread_t        loader;        /**< background loader thread */
+#endif
+  bool             loading;       /**< true while a background loader thread has not been joined */
+  bool             async_done;    /**< true once the background load has finished */
+  std::string      async_name;    /**< model name for background load */
+  bool             async_rc;      /**< return value of background load */
+  //@}
+
+public:
+  /*---------------------------------------------------------------------*/
+  /** \name Constructors etc. */
+  //@{
+  /** Constructor: create a handle for \a nslots workers (no model loaded) */
+  mootHMMHandle(size_t nslots=1);
+
+  /** Destructor: waits for any background load and frees all instances */
+  virtual ~mootHMMHandle(void);
+
+  /**
+   * Create a new (empty) mootHMM instance for the prototype and for each slot.
+   * Override this to set runtime options (e.g. \c verbose, \c save_ambiguities,
+   * \c hash_ngrams) or to use a mootHMM subclass.
+   */
+  virtual mootHMM *new_hmm(void) const
+  { return new mootHMM(); };
+  //@}
+
+  /*---------------------------------------------------------------------*/
+  /** \name Loading & publication */
+  //@{
+  /**
+   * Load model \a name (binary or text, see mootHMM::load_model()),
+   * clone it for each slot, and publish the clones as a new generation.
+   * Returns false (leaving the current generation in place) on failure.
+   * May be called from any thread.
+   */
+  bool load(const std::string &name);
+
+  /**
+   * Start loading model \a name in a background thread.
+   * Returns false if another background load is still running; a finished
+   * background load which has not been waited for is joined first
+   * (discarding its result).  Use wait() to collect the result.
+   */
+  bool load_async(const std::string &name);
+
+  /** Wait for a background load to finish, returning its result (true if none was running) */
+  bool wait(void);
+
+  /** Publish instances \a hmms (one per slot, adopted by the handle) as a new generation */
+  void publish(const vector<mootHMM*> &hmms, const std::string &name="");
+  //@}
+
+  /*---------------------------------------------------------------------*/
+  /** \name Worker interface */
+  //@{
+  /**
+   * Get current model instance for slot \a i, switching to the most recently
+   * published generation if necessary.  Should be called only by the worker
+   * owning slot \a i, and only between sentences.  Returns NULL if no model
+   * has been published yet.
+   */
+  inline mootHMM *sync(size_t i)
+  {
+    Slot &s = slots[i];
+    lock();
+    bool current = (s.gen == generation);
+    unlock();
+    if (current) return s.hmm; //-- fast path: no new generation
+    return _sync_slow(s);
+  };
+
+  /** Get most recently published generation (0: none) */
+  inline size_t current_generation(void)
+  {
+    lock();
+    size_t gen = generation;
+    unlock();
+    return gen;
+  };
+  //@}
+
+protected:
+  /** Pick up pending instance for slot \a s */
+  mootHMM *_sync_slow(Slot &s);
+
+  /** Lock / unlock publication mutex */
+  inline void lock(void)
+  {
+#ifdef MOOT_PTHREADS_ENABLED
+    pthread_mutex_lock(&mutex);
+#endif
+  };
+  inline void unlock(void)
+  {
+#ifdef MOOT_PTHREADS_ENABLED
+    pthread_mutex_unlock(&mutex);
+#endif
+  };
+
+#ifdef MOOT_PTHREADS_ENABLED
+  /** Background loader thread entry point */
+  static void *_load_thread(void *data);
+#endif
+};
+
+moot_END_NAMESPACE
+
+#endif /* _MOOT_HMM_HANDLE_H */
@@ -0,0 +1,446 @@
+/* -*- Mode: C++ -*- */
+
+/*
+   libmoot : moocow's part-of-speech tagging library
+   Copyright (C) 2003-2014 by Bryan Jurish <moocow@cpan.org>
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 3 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+/*--------------------------------------------------------------------------
+ * File: mootHMMSweep.cc
+ * Author: Bryan Jurish <moocow@cpan.org>
+ * Description:
+ *   + moot PoS tagger : cross-validation and smoothing-parameter sweeps
+ *--------------------------------------------------------------------------*/
+
+#ifdef HAVE_CONFIG_H
+# include <mootConfig.h>
+#endif
+
+#include <mootHMMSweep.h>
+#include <mootBufferIO.h>
+#include <mootUtils.h>
+
+#include <math.h>
+#include <string.h>
+
+moot_BEGIN_NAMESPACE
+
+using namespace std;
+using namespace mootio;
+
+/*======================================================================
+ * Fold
+ */
+
+//--------------------------------------------------------------
+void mootHMMSweep::Fold::release(void)
+{
+  if (hmm) delete hmm;
+  if (raw) delete raw;
+  hmm = raw = NULL;
+  trainer.lexfreqs.clear();
+  trainer.ngrams.clear();
+  trainer.lcfreqs.clear();
+}
+
+/*======================================================================
+ * Constructors etc.
+ */
+
+//--------------------------------------------------------------
+mootHMMSweep::mootHMMSweep(size_t my_nfolds, size_t my_njobs)
+  : verbose(vlErrors),
+    start_tag_str("__$"),
+    nfolds(my_nfolds ? my_nfolds : 1),
+    njobs(my_njobs ? my_njobs : 1),
+    next_fold(0),
+    nerrors(0)
+{
+#ifdef MOOT_PTHREADS_ENABLED
+  pthread_mutex_init(&mutex, NULL);
+#endif
+}
+
+//--------------------------------------------------------------
+mootHMMSweep::~mootHMMSweep(void)
+{
+  for (size_t i=0; i < folds.size(); ++i) delete folds[i];
+#ifdef MOOT_PTHREADS_ENABLED
+  pthread_mutex_destroy(&mutex);
+#endif
+}
+
+/*======================================================================
+ * Setup
+ */
+
+//--------------------------------------------------------------
+bool mootHMMSweep::load_corpus(TokenReader *reader)
+{
+  if (!reader) return false;
+  mootTokenType typ;
+  do {
+    typ = reader->get_sentence();
+    const mootSentence *sent = reader->sentence();
+    if (!sent) break;
+
+    //-- keep only vanilla tokens: these are the ones we train on and evaluate
+    mootSentence toks;
+    for (mootSentence::const_iterator si = sent->begin(); si != sent->end(); ++si) {
+      if (si->toktype() == TokTypeVanilla) toks.push_back(*si);
+    }
+    if (toks.empty()) continue;
+    sentences.push_back(mootSentence());
+    sentences.back().swap(toks);
+  } while (typ != TokTypeEOF);
+  return true;
+}
+
+//--------------------------------------------------------------
+void mootHMMSweep::add_grid(const vector<Params> &nglambdas,
+			    const vector<Params> &wlambdas,
+			    const vector<Params> &clambdas,
+			    const vector<Params> &thresholds,
+			    const vector<Params> &beamwds)
+{
+  const vector<Params> dflt(1);
+  const vector<Params> &ngv = nglambdas.empty()  ? dflt : nglambdas;
+  const vector<Params> &wv  = wlambdas.empty()   ? dflt : wlambdas;
+  const vector<Params> &cv  = clambdas.empty()   ? dflt : clambdas;
+  const vector<Params> &tv  = thresholds.empty() ? dflt : thresholds;
+  const vector<Params> &bv  = beamwds.empty()    ? dflt : beamwds;
+
+  for (vector<Params>::const_iterator ti = tv.begin(); ti != tv.end(); ++ti) {
+    for (vector<Params>::const_iterator ci = cv.begin(); ci != cv.end(); ++ci) {
+      for (vector<Params>::const_iterator wi = wv.begin(); wi != wv.end(); ++wi) {
+	for (vector<Params>::const_iterator ngi = ngv.begin(); ngi != ngv.end(); ++ngi) {
+	  for (vector<Params>::const_iterator bi = bv.begin(); bi != bv.end(); ++bi) {
+	    Params p;
+	    p.unknown_lex_threshhold   = ti->unknown_lex_threshhold;
+	    p.unknown_class_threshhold = ti->unknown_class_threshhold;
+	    p.est_clambdas  = ci->est_clambdas;
+	    p.clambda0      = ci->clambda0;
+	    p.clambda1      = ci->clambda1;
+	    p.est_wlambdas  = wi->est_wlambdas;
+	    p.wlambda0      = wi->wlambda0;
+	    p.wlambda1      = wi->wlambda1;
+	    p.est_nglambdas = ngi->est_nglambdas;
+	    p.nglambda1     = ngi->nglambda1;
+	    p.nglambda2     = ngi->nglambda2;
+	    p.nglambda3     = ngi->nglambda3;
+	    p.beamwd        = bi->beamwd;
+	    settings.push_back(p);
+	  }
+	}
+      }
+    }
+  }
+}
+
+/*======================================================================
+ * Operation
+ */
+
+//--------------------------------------------------------------
+bool mootHMMSweep::run(void)
+{
+  //-- setup: results & folds (contiguous blocks of sentences)
+  results.assign(settings.size(), vector<Result>(nfolds));
+  for (size_t i=0; i < folds.size(); ++i) delete folds[i];
+  folds.clear();
+  for (size_t i=0; i < nfolds; ++i) {
+    Fold *f  = new Fold(this, i);
+    f->begin = (sentences.size() * i) / nfolds;
+    f->end   = (sentences.size() * (i+1)) / nfolds;
+    folds.push_back(f);
+  }
+  next_fold = 0;
+  nerrors   = 0;
+
+  //-- start worker threads
+  size_t nthreads = 0;
+#ifdef MOOT_PTHREADS_ENABLED
+  size_t nwant = njobs < nfolds ? njobs : nfolds;
+  vector<pthread_t> threads(nwant);
+  if (nwant > 1) {
+    for ( ; nthreads < nwant; ++nthreads) {
+      if (pthread_create(&threads[nthreads], NULL, _work_thread, this) != 0) break;
+    }
+  }
+#endif
+
+  if (nthreads == 0) {
+    //-- sequential fallback
+    work();
+  }
+#ifdef MOOT_PTHREADS_ENABLED
+  for (size_t i=0; i < nthreads; ++i)
+    pthread_join(threads[i], NULL);
+#endif
+
+  return nerrors == 0;
+}
+
+//--------------------------------------------------------------
+mootHMMSweep::Result mootHMMSweep::total(size_t i) const
+{
+  Result r;
+  if (i < results.size()) {
+    for (vector<Result>::const_iterator ri = results[i].begin(); ri != results[i].end(); ++ri)
+      r.add(*ri);
+  }
+  return r;
+}
+
+//--------------------------------------------------------------
+void mootHMMSweep::work(void)
+{
+  lock();
+  while (next_fold < folds.size()) {
+    Fold *f = folds[next_fold++];
+    unlock();
+    bool ok = process_fold(*f);
+    f->release();
+    lock();
+    if (!ok) ++nerrors;
+  }
+  unlock();
+}
+
+#ifdef MOOT_PTHREADS_ENABLED
+//--------------------------------------------------------------
+void *mootHMMSweep::_work_thread(void *data)
+{
+  reinterpret_cast<mootHMMSweep*>(data)->work();
+  return NULL;
+}
+#endif
+
+/*======================================================================
+ * Low-level utilities
+ */
+
+//--------------------------------------------------------------
+bool mootHMMSweep::process_fold(Fold &f)
+{
+  moot_msg(verbose, vlProgress, "mootHMMSweep: fold %zu: training on %zu of %zu sentences\n",
+	   f.id, sentences.size() - (f.end - f.begin), sentences.size());
+  train(f);
+
+  for (size_t i=0; i < settings.size(); ++i) {
+    if (!prepare(f, settings[i])) {
+      moot_msg(verbose, vlErrors, "mootHMMSweep: fold %zu: compilation FAILED for setting %zu\n", f.id, i);
+      return false;
+    }
+    evaluate(f, results[i][f.id]);
+  }
+
+  moot_msg(verbose, vlProgress, "mootHMMSweep: fold %zu: evaluated %zu setting(s)\n", f.id, settings.size());
+  return true;
+}
+
+//--------------------------------------------------------------
+void mootHMMSweep::train(Fold &f)
+{
+  mootHMMTrainer &t = f.trainer;
+  t.clear();
+  t.taster  = taster;
+  t.eos_tag = start_tag_str;
+
+  t.train_init();
+  for (size_t i=0; i < sentences.size(); ++i) {
+    if (i >= f.begin && i < f.end) continue;
+    const mootSentence &sent = sentences[i];
+    for (mootSentence::const_iterator si = sent.begin(); si != sent.end(); ++si)
+      t.train_token(*si);
+    t.train_eos();
+    t.train_bos();
+  }
+  t.train_finish();
+}
+
+//--------------------------------------------------------------
+bool mootHMMSweep::prepare(Fold &f, const Params &p)
+{
+  //-- (re-)compile raw model from in-memory frequency data if thresholds changed
+  if (!f.raw || !p.same_thresholds(f.raw_params)) {
+    if (f.hmm) delete f.hmm;
+    if (f.raw) delete f.raw;
+    f.hmm = NULL;
+    f.raw = new_hmm();
+    f.raw->unknown_lex_threshhold   = p.unknown_lex_threshhold;
+    f.raw->unknown_class_threshhold = p.unknown_class_threshhold;
+
+    mootLexfreqs lexfreqs(f.trainer.lexfreqs); //-- compile_model() modifies its lexfreqs
+    mootTaster   notaster;                     //-- as for load_model(): no flavors unless use_flavors
+    notaster.clear();
+    if (!f.raw->compile_model(lexfreqs, f.trainer.ngrams, f.trainer.lcfreqs,
+			      (f.raw->use_flavors ? taster : notaster),
+			      start_tag_str, "mootHMMSweep::prepare()",
+			      true, true, true, true, false))
+      return false;
+
+    //-- remember estimated (raw) smoothing constants
+    f.raw_params = p;
+    f.raw_params.nglambda1 = f.raw->nglambda1;
+    f.raw_params.nglambda2 = f.raw->nglambda2;
+    f.raw_params.nglambda3 = f.raw->nglambda3;
+    f.raw_params.wlambda0  = f.raw->wlambda0;
+    f.raw_params.wlambda1  = f.raw->wlambda1;
+    f.raw_params.clambda0  = f.raw->clambda0;
+    f.raw_params.clambda1  = f.raw->clambda1;
+  }
+
+  //-- effective parameters
+  Params e = p;
+  if (p.est_nglambdas) {
+    e.nglambda1 = f.raw_params.nglambda1;
+    e.nglambda2 = f.raw_params.nglambda2;
+    e.nglambda3 = f.raw_params.nglambda3;
+  }
+  if (p.est_wlambdas) {
+    e.wlambda0 = f.raw_params.wlambda0;
+    e.wlambda1 = f.raw_params.wlambda1;
+  }
+  if (p.est_clambdas) {
+    e.clambda0 = f.raw_params.clambda0;
+    e.clambda1 = f.raw_params.clambda1;
+  }
+
+  //-- get working model: fresh clone needs everything logified
+  int dirty = dfNone;
+  if (!f.hmm) {
+    if (!(f.hmm = clone_hmm(f.raw))) return false;
+    dirty = dfAll;
+  }
+  else {
+    const Params &h = f.hmm_params;
+    if (e.nglambda1 != h.nglambda1 || e.nglambda2 != h.nglambda2 || e.nglambda3 != h.nglambda3)
+      dirty |= dfNgrams;
+    if (e.wlambda0 != h.wlambda0 || e.wlambda1 != h.wlambda1)
+      dirty |= dfLex;
+    if (e.clambda0 != h.clambda0 || e.clambda1 != h.clambda1)
+      dirty |= dfClasses;
+  }
+
+  mootHMM &hmm = *f.hmm;
+  hmm.nglambda1 = e.nglambda1;
+  hmm.nglambda2 = e.nglambda2;
+  hmm.nglambda3 = e.nglambda3;
+  hmm.wlambda0  = e.wlambda0;
+  hmm.wlambda1  = e.wlambda1;
+  hmm.clambda0  = e.clambda0;
+  hmm.clambda1  = e.clambda1;
+  hmm.beamwd    = e.beamwd;
+
+  if (dirty == dfAll) {
+    hmm.compute_logprobs();
+  }
+  else {
+    //-- partial update: restore affected tables from raw model & re-logify only those
+    if (dirty & dfNgrams) {
+      if (hmm.hash_ngrams)
+	hmm.ngprobsh = f.raw->ngprobsh;
+      else
+	memcpy(hmm.ngprobsa, f.raw->ngprobsa, sizeof(ProbT) * hmm.n_tags * hmm.n_tags * hmm.n_tags);
+      hmm.compute_ngram_logprobs();
+    }
+    else {
+      hmm.nglambda1 = log(e.nglambda1);
+      hmm.nglambda2 = log(e.nglambda2);
+      hmm.nglambda3 = log(e.nglambda3);
+    }
+
+    if (dirty & dfLex) {
+      hmm.lexprobs = f.raw->lexprobs;
+      hmm.compute_lex_logprobs();
+    }
+    else {
+      hmm.wlambda0 = log(e.wlambda0);
+      hmm.wlambda1 = log(e.wlambda1);
+    }
+
+    if (dirty & dfClasses) {
+      hmm.lcprobs = f.raw->lcprobs;
+      hmm.compute_class_logprobs();
+    }
+    else {
+      hmm.clambda0 = log(e.clambda0);
+      hmm.clambda1 = log(e.clambda1);
+    }
+
+    if (hmm.beamwd) hmm.beamwd = log(hmm.beamwd);
+
+    if (dirty != dfNone) {
+      hmm.lexcache_clear();
+#ifdef MOOT_ENABLE_SUFFIX_TRIE
+      hmm.sufcache_clear();
+#endif
+    }
+  }
+
+  f.hmm_params = e;
+  return true;
+}
+
+//--------------------------------------------------------------
+void mootHMMSweep::evaluate(Fold &f, Result &r)
+{
+  mootEval      eval;
+  mootEvalStats stats;
+  mootSentence  tagged;
+  stats.lexicon = &f.trainer.lexfreqs;
+
+  for (size_t i=f.begin; i < f.end; ++i) {
+    const mootSentence &gold = sentences[i];
+
+    //-- tag a copy with best tags removed
+    tagged = gold;
+    for (mootSentence::iterator ti = tagged.begin(); ti != tagged.end(); ++ti)
+      ti->besttag(mootTagString());
+    f.hmm->tag_sentence(tagged);
+
+    mootSentence::const_iterator gi = gold.begin();
+    mootSentence::const_iterator ti = tagged.begin();
+    for ( ; gi != gold.end() && ti != tagged.end(); ++gi, ++ti)
+      stats.add(eval, *gi, *ti);
+  }
+
+  r.all.ntokens      = stats.ntokens;
+  r.all.ncorrect     = stats.ntokens - stats.nbestmisses;
+  r.known            = stats.known;
+  r.unknown          = stats.unknown;
+}
+
+//--------------------------------------------------------------
+mootHMM *mootHMMSweep::clone_hmm(mootHMM *src) const
+{
+  mcbuffer buf;
+  buf.cb_get = 1<<20;
+  if (!src->save(&buf, "mootHMMSweep")) return NULL;
+
+  micbuffer ibuf(buf.data(), buf.size());
+  mootHMM *dst = new_hmm();
+  dst->defer_sections = 0; //-- tables are modified before first use
+  if (!dst->load(&ibuf, "mootHMMSweep")) {
+    delete dst;
+    return NULL;
+  }
+  return dst;
+}
+
+moot_END_NAMESPACE
@@ -0,0 +1,275 @@
+/* -*- Mode: C++ -*- */
+
+/*
+   libmoot : moocow's part-of-speech tagging library
+   Copyright (C) 2003-2014 by Bryan Jurish <moocow@cpan.org>
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 3 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+/*--------------------------------------------------------------------------
+ * File: mootHMMSweep.h
+ * Author: Bryan Jurish <moocow@cpan.org>
+ * Description:
+ *   + moot PoS tagger : cross-validation and smoothing-parameter sweeps
+ *--------------------------------------------------------------------------*/
+
+/**
+\file mootHMMSweep.h
+\brief Cross-validation and smoothing-parameter sweeps over in-memory training data
+*/
+
+#ifndef _MOOT_HMM_SWEEP_H
+#define _MOOT_HMM_SWEEP_H
+
+#include <mootHMM.h>
+#include <mootHMMTrainer.h>
+#include <mootEval.h>
+
+#ifdef MOOT_PTHREADS_ENABLED
+# include <pthread.h>
+#endif
+
+moot_BEGIN_NAMESPACE
+
+/*======================================================================
+ * class mootHMMSweep
+ */
+/**
+ * \brief K-fold cross-validation of mootHMM over a grid of compile-time parameters.
+ * \details
+ * The corpus is read once into memory and split into \a nfolds contiguous
+ * blocks of sentences.  For each fold, frequency data are gathered once
+ * from the remaining folds with mootHMMTrainer and kept in memory; each
+ * setting in \a settings is then evaluated by tagging the held-out fold.
+ *
+ * Between consecutive settings, only the affected tables are recomputed:
+ * the model is recompiled from the fold's frequency data only if an
+ * "unknown" threshold changes, n-gram, lexical, and lexical-class tables
+ * are restored from a raw (compiled but not yet logified) copy and
+ * re-logified only if the respective smoothing constants change, and
+ * beam-width changes require no recomputation at all.  Settings should
+ * therefore be ordered with thresholds varying slowest and beam widths
+ * varying fastest (see add_grid()).
+ *
+ * Folds are processed in up to \a njobs parallel threads, each working
+ * through the whole grid for one fold at a time.  Without POSIX threads
+ * support, folds are processed sequentially.
+ */
+class mootHMMSweep {
+public:
+  /*---------------------------------------------------------------------*/
+  /** \name Embedded Types */
+  //@{
+  /** \brief Compile-time parameters for a single sweep setting */
+  class Params {
+  public:
+    bool  est_nglambdas;             /**< estimate n-gram smoothing constants (ignore nglambda*) */
+    ProbT nglambda1;                 /**< unigram smoothing constant */
+    ProbT nglambda2;                 /**< bigram smoothing constant */
+    ProbT nglambda3;                 /**< trigram smoothing constant */
+    bool  est_wlambdas;              /**< estimate lexical smoothing constants (ignore wlambda*) */
+    ProbT wlambda0;                  /**< lexical smoothing constant: unknown */
+    ProbT wlambda1;                  /**< lexical smoothing constant: known */
+    bool  est_clambdas;              /**< estimate lexical-class smoothing constants (ignore clambda*) */
+    ProbT clambda0;                  /**< class smoothing constant: unknown */
+    ProbT clambda1;                  /**< class smoothing constant: known */
+    ProbT unknown_lex_threshhold;    /**< see mootHMM::unknown_lex_threshhold */
+    ProbT unknown_class_threshhold;  /**< see mootHMM::unknown_class_threshhold */
+    ProbT beamwd;                    /**< beam width (0 for none; see mootHMM::beamwd) */
+
+  public:
+    Params(void)
+      : est_nglambdas(true), nglambda1(mootProbEpsilon), nglambda2(1.0-mootProbEpsilon), nglambda3(0),
+	est_wlambdas(true), wlambda0(mootProbEpsilon), wlambda1(1.0-mootProbEpsilon),
+	est_clambdas(true), clambda0(mootProbEpsilon), clambda1(1.0-mootProbEpsilon),
+	unknown_lex_threshhold(1), unknown_class_threshhold(1), beamwd(1000)
+    {};
+
+    /** True iff \a p requires no recompilation (i.e. has the same thresholds) */
+    inline bool same_thresholds(const Params &p) const
+    { return unknown_lex_threshhold==p.unknown_lex_threshhold && unknown_class_threshhold==p.unknown_class_threshhold; };
+  };
+
+  /** \brief Evaluation results for one setting on one fold */
+  class Result {
+  public:
+    mootEvalStats::Accuracy all;      /**< all tokens */
+    mootEvalStats::Accuracy known;    /**< tokens occurring in the fold's training data */
+    mootEvalStats::Accuracy unknown;  /**< tokens not occurring in the fold's training data */
+
+  public:
+    /** Add counts from \a r */
+    inline void add(const Result &r)
+    {
+      all.ntokens += r.all.ntokens;         all.ncorrect += r.all.ncorrect;
+      known.ntokens += r.known.ntokens;     known.ncorrect += r.known.ncorrect;
+      unknown.ntokens += r.unknown.ntokens; unknown.ncorrect += r.unknown.ncorrect;
+    };
+  };
+
+  /** \brief Per-fold (per-thread) data */
+  class Fold {
+  public:
+    mootHMMSweep   *sweep;    /**< sweep this fold belongs to */
+    size_t          id;       /**< fold index */
+    size_t          begin;    /**< index of first held-out sentence */
+    size_t          end;      /**< index after last held-out sentence */
+    mootHMMTrainer  trainer;  /**< frequency data gathered from all other folds */
+    mootHMM        *raw;      /**< model compiled for \a raw_params, without log-probabilities (owned) */
+    mootHMM        *hmm;      /**< working model, logified for \a hmm_params (owned) */
+    Params          raw_params; /**< parameters of \a raw, with estimated constants filled in */
+    Params          hmm_params; /**< parameters of \a hmm, with estimated constants filled in */
+
+  public:
+    Fold(mootHMMSweep *my_sweep=NULL, size_t my_id=0)
+      : sweep(my_sweep), id(my_id), begin(0), end(0), raw(NULL), hmm(NULL)
+    {};
+    ~Fold(void) { release(); };
+
+    /** Free fold models and frequency data */
+    void release(void);
+  };
+
+  /** Recomputation flags used by prepare() */
+  enum DirtyFlags {
+    dfNone    = 0x00,  /**< nothing to recompute */
+    dfNgrams  = 0x01,  /**< re-logify n-gram probabilities */
+    dfLex     = 0x02,  /**< re-logify lexical probabilities */
+    dfClasses = 0x04,  /**< re-logify lexical-class probabilities */
+    dfAll     = 0x07   /**< re-logify everything */
+  };
+  //@}
+
+public:
+  /*---------------------------------------------------------------------*/
+  /** \name Data */
+  //@{
+  int                     verbose;        /**< verbosity level (see mootHMM::verbose) */
+  mootTagString           start_tag_str;  /**< boundary tag (see mootHMM::load_model()) */
+  mootTaster              taster;         /**< token flavor heuristics for training and compilation (default: built-in) */
+  size_t                  nfolds;         /**< number of cross-validation folds */
+  size_t                  njobs;          /**< maximum number of folds processed in parallel */
+  vector<mootSentence>    sentences;      /**< in-memory corpus */
+  vector<Params>          settings;       /**< parameter settings to evaluate, in order */
+  vector< vector<Result> > results;       /**< results[setting][fold], filled by run() */
+
+protected:
+  vector<Fold*>           folds;          /**< fold data, allocated by run() */
+  size_t                  next_fold;      /**< next fold to be picked up by a worker */
+  size_t                  nerrors;        /**< number of failed folds */
+#ifdef MOOT_PTHREADS_ENABLED
+  pthread_mutex_t         mutex;          /**< guards \a next_fold and \a nerrors */
+#endif
+  //@}
+
+public:
+  /*---------------------------------------------------------------------*/
+  /** \name Constructors etc. */
+  //@{
+  /** Constructor */
+  mootHMMSweep(size_t my_nfolds=10, size_t my_njobs=1);
+
+  /** Destructor */
+  virtual ~mootHMMSweep(void);
+
+  /**
+   * Create a new (empty) mootHMM instance for a fold.
+   * Override this to set compile-time and runtime options (e.g. \c use_lex_classes,
+   * \c use_flavors, \c relax, \c hash_ngrams, suffix trie parameters).
+   */
+  virtual mootHMM *new_hmm(void) const
+  { return new mootHMM(); };
+  //@}
+
+  /*---------------------------------------------------------------------*/
+  /** \name Setup */
+  //@{
+  /** Append all sentences from \a reader to \a sentences; returns false on error */
+  bool load_corpus(TokenReader *reader);
+
+  /**
+   * Append the cross product of the given parameter values to \a settings,
+   * with thresholds varying slowest and beam widths fastest.  Any empty
+   * vector is treated as a single default Params value (i.e. estimated
+   * smoothing constants, default thresholds and beam width).  Only the
+   * respective fields of the elements of each vector are used.
+   */
+  void add_grid(const vector<Params> &nglambdas,
+		const vector<Params> &wlambdas,
+		const vector<Params> &clambdas,
+		const vector<Params> &thresholds,
+		const vector<Params> &beamwds);
+  //@}
+
+  /*---------------------------------------------------------------------*/
+  /** \name Operation */
+  //@{
+  /** Evaluate all \a settings on all folds, filling \a results; returns false if any fold failed */
+  bool run(void);
+
+  /** Get results for setting \a i summed over all folds */
+  Result total(size_t i) const;
+  //@}
+
+  /*---------------------------------------------------------------------*/
+  /** \name Low-level utilities */
+  //@{
+  /** Gather frequency data for fold \a f from all sentences outside [f.begin,f.end) */
+  void train(Fold &f);
+
+  /**
+   * Bring f.hmm up to date for parameters \a p, recompiling or re-logifying
+   * only what has changed since the last call; returns false on error.
+   */
+  bool prepare(Fold &f, const Params &p);
+
+  /** Tag the held-out sentences of \a f with f.hmm and compare them against the originals */
+  void evaluate(Fold &f, Result &r);
+
+  /** Process fold \a f: train, then prepare() and evaluate() for each setting */
+  bool process_fold(Fold &f);
+  //@}
+
+protected:
+  /** Worker main loop: process folds until none are left */
+  void work(void);
+
+  /** Copy raw model \a src into a new instance (via the binary format) */
+  mootHMM *clone_hmm(mootHMM *src) const;
+
+  /** Lock / unlock fold mutex */
+  inline void lock(void)
+  {
+#ifdef MOOT_PTHREADS_ENABLED
+    pthread_mutex_lock(&mutex);
+#endif
+  };
+  inline void unlock(void)
+  {
+#ifdef MOOT_PTHREADS_ENABLED
+    pthread_mutex_unlock(&mutex);
+#endif
+  };
+
+#ifdef MOOT_PTHREADS_ENABLED
+  /** Worker thread entry point */
+  static void *_work_thread(void *data);
+#endif
+};
+
+moot_END_NAMESPACE
+
+#endif /* _MOOT_HMM_SWEEP_H */
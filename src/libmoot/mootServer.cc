@@ -0,0 +1,510 @@
+/* -*- Mode: C++ -*- */
+
+/*
+   libmoot : moocow's part-of-speech tagging library
+   Copyright (C) 2003-2014 by Bryan Jurish <moocow@cpan.org>
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 3 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+/*--------------------------------------------------------------------------
+ * File: mootServer.cc
+ * Author: Bryan Jurish <moocow@cpan.org>
+ * Description:
+ *   + moot PoS tagger : persistent tagging daemon on a Unix domain socket
+ *--------------------------------------------------------------------------*/
+
+#ifdef HAVE_CONFIG_H
+# include <mootConfig.h>
+#endif
+
+#include <mootServer.h>
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#include <algorithm>
+
+#if defined(HAVE_SYS_SOCKET_H) && defined(HAVE_SYS_UN_H) && defined(HAVE_POLL_H)
+# define MOOT_SOCKETS_ENABLED 1
+# include <sys/types.h>
+# include <sys/socket.h>
+# include <sys/stat.h>
+# include <sys/time.h>
+# include <sys/un.h>
+# include <poll.h>
+#endif
+
+moot_BEGIN_NAMESPACE
+
+using namespace std;
+using namespace mootio;
+
+volatile sig_atomic_t mootServer::stop_signal = 0;
+
+/*======================================================================
+ * Stream
+ */
+
+//--------------------------------------------------------------
+size_t mootServer::Stream::available(void)
+{
+  if (eor) return 0;
+  if (ipos >= ibuf.size() && fill() <= 0) return 0;
+
+  //-- end-of-request marker at beginning of line?
+  if (bol && ibuf[ipos] == EOR) {
+    if (ipos+1 >= ibuf.size()) fill();
+    if (ipos+1 >= ibuf.size() || ibuf[ipos+1] == '\n') {
+      ipos += (ipos+1 < ibuf.size() ? 2 : 1);
+      eor   = true;
+      bol   = true;
+      return 0;
+    }
+  }
+
+  //-- scan for the next line which might start with a marker
+  const char *beg = ibuf.data()+ipos;
+  const char *nl  = static_cast<const char*>(memchr(beg, '\n', ibuf.size()-ipos));
+  return nl ? (nl-beg)+1 : ibuf.size()-ipos;
+}
+
+//--------------------------------------------------------------
+ByteCount mootServer::Stream::read(char *buf, size_t n)
+{
+  size_t avail = available();
+  if (avail == 0) return 0;
+  if (n > avail) n = avail;
+  memcpy(buf, ibuf.data()+ipos, n);
+  ipos += n;
+  bol = (buf[n-1] == '\n');
+  return static_cast<ByteCount>(n);
+}
+
+//--------------------------------------------------------------
+int mootServer::Stream::getbyte(void)
+{
+  if (available() == 0) return EOF;
+  unsigned char c = static_cast<unsigned char>(ibuf[ipos++]);
+  bol = (c == '\n');
+  return c;
+}
+
+//--------------------------------------------------------------
+bool mootServer::Stream::next_request(void)
+{
+  if (!eor) return false;
+  eor = false;
+  return valid() && !mfdstream::eof();
+}
+
+/*======================================================================
+ * Constructors etc.
+ */
+
+//--------------------------------------------------------------
+mootServer::mootServer(const std::string &my_path)
+  : path(my_path),
+    verbose(0),
+    batch_size(64),
+    backlog(16),
+    timeout(60),
+    listen_fd(-1),
+    stopping(false)
+{
+  wake_fd[0] = wake_fd[1] = -1;
+#ifdef MOOT_PTHREADS_ENABLED
+  pthread_mutex_init(&mutex, NULL);
+  pthread_cond_init(&cond, NULL);
+#endif
+}
+
+//--------------------------------------------------------------
+mootServer::~mootServer(void)
+{
+  close();
+  for (size_t i=0; i < sessions.size(); ++i) delete sessions[i];
+#ifdef MOOT_PTHREADS_ENABLED
+  pthread_cond_destroy(&cond);
+  pthread_mutex_destroy(&mutex);
+#endif
+}
+
+//--------------------------------------------------------------
+mootServer::Session *mootServer::add_session(mootHMM *hmm, TokenReader *reader, TokenWriter *writer)
+{
+  Session *s = new Session(this, sessions.size(), hmm, reader, writer);
+  sessions.push_back(s);
+  return s;
+}
+
+/*======================================================================
+ * Operation
+ */
+
+//--------------------------------------------------------------
+bool mootServer::open(void)
+{
+  close();
+#ifdef MOOT_SOCKETS_ENABLED
+  struct sockaddr_un addr;
+  if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+    moot_msg(verbose, vlErrors, "mootServer::open(): invalid socket path '%s'\n", path.c_str());
+    return false;
+  }
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, path.c_str());
+
+  //-- remove stale socket file (but nothing else)
+  struct stat st;
+  if (lstat(path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode)) unlink(path.c_str());
+
+  if ((listen_fd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0
+      || bind(listen_fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0
+      || listen(listen_fd, backlog) != 0)
+    {
+      moot_msg(verbose, vlErrors, "mootServer::open(): could not listen on '%s': %s\n",
+	       path.c_str(), strerror(errno));
+      if (listen_fd >= 0) ::close(listen_fd);
+      listen_fd = -1;
+      return false;
+    }
+  return true;
+#else
+  moot_msg(verbose, vlErrors, "mootServer::open(): Unix domain sockets not supported on this system\n");
+  return false;
+#endif
+}
+
+//--------------------------------------------------------------
+void mootServer::close(void)
+{
+  if (listen_fd < 0) return;
+  ::close(listen_fd);
+  listen_fd = -1;
+  unlink(path.c_str());
+}
+
+//--------------------------------------------------------------
+void mootServer::_on_signal(int sig)
+{
+  stop_signal = 1;
+}
+
+//--------------------------------------------------------------
+bool mootServer::run(void)
+{
+#ifdef MOOT_SOCKETS_ENABLED
+  if (listen_fd < 0 && !open()) return false;
+  if (sessions.empty()) {
+    moot_msg(verbose, vlErrors, "mootServer::run(): no sessions defined\n");
+    return false;
+  }
+
+  //-- signals: INT/TERM interrupt accept(2); a client hanging up must not kill us
+  struct sigaction sa, sa_int, sa_term, sa_pipe;
+  memset(&sa, 0, sizeof(sa));
+  sigemptyset(&sa.sa_mask);
+  sa.sa_handler = SIG_IGN;
+  sigaction(SIGPIPE, &sa, &sa_pipe);
+  sa.sa_handler = _on_signal;
+  sa.sa_flags   = 0; //-- no SA_RESTART
+  sigaction(SIGINT,  &sa, &sa_int);
+  sigaction(SIGTERM, &sa, &sa_term);
+  stop_signal = 0;
+  stopping    = false;
+
+  //-- self-pipe for sessions returning connections to the poll set
+  if (pipe(wake_fd) == 0) {
+    fcntl(wake_fd[0], F_SETFL, O_NONBLOCK);
+    fcntl(wake_fd[1], F_SETFL, O_NONBLOCK);
+  } else {
+    wake_fd[0] = wake_fd[1] = -1;
+  }
+
+  //-- start session threads (with INT/TERM blocked, so they are delivered to us)
+  size_t nthreads = 0;
+#ifdef MOOT_PTHREADS_ENABLED
+  sigset_t sigs, osigs;
+  sigemptyset(&sigs);
+  sigaddset(&sigs, SIGINT);
+  sigaddset(&sigs, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &sigs, &osigs);
+  for ( ; nthreads < sessions.size(); ++nthreads) {
+    if (pthread_create(&sessions[nthreads]->thread, NULL, _work_thread, sessions[nthreads]) != 0) break;
+  }
+  pthread_sigmask(SIG_SETMASK, &osigs, NULL);
+#endif
+
+  moot_msg(verbose, vlProgress, "mootServer: listening on '%s' with %u session(s)\n",
+	   path.c_str(), (unsigned)(nthreads ? nthreads : 1));
+
+  //-- main loop: accept connections, and hand idle connections to sessions when input arrives
+  //   + poll(2) with a timeout, so a signal arriving just before accept(2) is not missed
+  vector<struct pollfd> pfds;
+  vector<Connection*>   polled, expired;
+  while (!stop_signal) {
+    struct pollfd pfd;
+    pfd.events  = POLLIN;
+    pfd.revents = 0;
+    pfds.clear();
+    pfd.fd = listen_fd;
+    pfds.push_back(pfd);
+    pfd.fd = wake_fd[0];
+    pfds.push_back(pfd);
+    lock();
+    polled = idle;
+    unlock();
+    for (vector<Connection*>::const_iterator ci = polled.begin(); ci != polled.end(); ++ci) {
+      pfd.fd = (*ci)->stream.fd;
+      pfds.push_back(pfd);
+    }
+
+    if (poll(&pfds[0], pfds.size(), 500) < 0) continue;
+
+    //-- wake-up pipe: just drain it
+    if (pfds[1].revents) {
+      char buf[64];
+      while (::read(wake_fd[0], buf, sizeof(buf)) > 0) ;
+    }
+
+    //-- idle connections: hand over on input (or hangup), close when expired
+    time_t now = time(NULL);
+    expired.clear();
+    lock();
+    for (size_t i=0; i < polled.size(); ++i) {
+      Connection *c = polled[i];
+      bool ready = pfds[i+2].revents != 0;
+      if (!ready && (timeout <= 0 || now - c->since < timeout)) continue;
+      idle.erase(std::find(idle.begin(), idle.end(), c));
+      if (ready) pending.push_back(c);
+      else       expired.push_back(c);
+#ifdef MOOT_PTHREADS_ENABLED
+      if (ready) pthread_cond_signal(&cond);
+#endif
+    }
+    unlock();
+    for (size_t i=0; i < expired.size(); ++i) {
+      moot_msg(verbose, vlInfo, "mootServer: closing idle connection\n");
+      delete expired[i];
+    }
+
+    //-- new connection?
+    if (!pfds[0].revents) continue;
+    int fd = accept(listen_fd, NULL, NULL);
+    if (fd < 0) {
+      if (errno == EINTR || errno == ECONNABORTED || errno == EAGAIN) continue;
+      moot_msg(verbose, vlErrors, "mootServer::run(): accept() failed: %s\n", strerror(errno));
+      break;
+    }
+    if (timeout > 0) {
+      //-- bound blocking reads & writes within a request
+      struct timeval tv;
+      tv.tv_sec  = timeout;
+      tv.tv_usec = 0;
+      setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+      setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    }
+    Connection *c = new Connection(fd);
+    if (nthreads == 0) {
+      //-- sequential fallback: serve all requests on this connection
+      while (serve(*sessions[0], *c)) ;
+      delete c;
+      continue;
+    }
+    lock();
+    idle.push_back(c);
+    unlock();
+  }
+
+  //-- shutdown: drop waiting & idle connections, let active requests finish reading
+  vector<Connection*> dropped;
+  lock();
+  stopping = true;
+  dropped.assign(pending.begin(), pending.end());
+  dropped.insert(dropped.end(), idle.begin(), idle.end());
+  pending.clear();
+  idle.clear();
+  for (size_t i=0; i < nthreads; ++i) {
+    if (sessions[i]->conn) shutdown(sessions[i]->conn->stream.fd, SHUT_RD);
+  }
+#ifdef MOOT_PTHREADS_ENABLED
+  pthread_cond_broadcast(&cond);
+#endif
+  unlock();
+  for (size_t i=0; i < dropped.size(); ++i) delete dropped[i];
+
+#ifdef MOOT_PTHREADS_ENABLED
+  for (size_t i=0; i < nthreads; ++i)
+    pthread_join(sessions[i]->thread, NULL);
+#endif
+
+  if (wake_fd[0] >= 0) ::close(wake_fd[0]);
+  if (wake_fd[1] >= 0) ::close(wake_fd[1]);
+  wake_fd[0] = wake_fd[1] = -1;
+  close();
+  sigaction(SIGINT,  &sa_int,  NULL);
+  sigaction(SIGTERM, &sa_term, NULL);
+  sigaction(SIGPIPE, &sa_pipe, NULL);
+  return true;
+#else
+  return open();
+#endif
+}
+
+//--------------------------------------------------------------
+void mootServer::work(Session &s)
+{
+  lock();
+  for (;;) {
+    while (!stopping && pending.empty()) {
+#ifdef MOOT_PTHREADS_ENABLED
+      pthread_cond_wait(&cond, &mutex);
+#endif
+    }
+    if (stopping) break;
+    Connection *c = pending.front();
+    pending.pop_front();
+    s.conn = c;
+    unlock();
+
+    bool keep = serve(s, *c);
+
+    lock();
+    s.conn = NULL;
+    if (keep && !stopping) {
+      //-- return connection: directly to the queue if the next request is already buffered
+      c->since = time(NULL);
+      if (c->stream.buffered()) {
+	pending.push_back(c);
+      } else {
+	idle.push_back(c);
+	wake();
+      }
+      continue;
+    }
+    unlock();
+    delete c;
+    lock();
+  }
+  unlock();
+}
+
+//--------------------------------------------------------------
+void mootServer::wake(void)
+{
+  //-- a full pipe means that run() will wake up anyway
+  if (wake_fd[1] >= 0 && ::write(wake_fd[1], "", 1) < 0) return;
+}
+
+#ifdef MOOT_PTHREADS_ENABLED
+//--------------------------------------------------------------
+void *mootServer::_work_thread(void *data)
+{
+  Session *s = reinterpret_cast<Session*>(data);
+  s->server->work(*s);
+  return NULL;
+}
+#endif
+
+/*======================================================================
+ * Low-level utilities
+ */
+
+//--------------------------------------------------------------
+bool mootServer::serve(Session &s, Connection &c)
+{
+  Stream &stream = c.stream;
+  bool    keep   = false;
+
+  //-- connections are handed over when readable: end-of-file here means the client is done
+  if (stream.buffered() || stream.fill() > 0) {
+    serve_request(s, stream);
+    ++s.nrequests;
+    if (stream.eor) stream.puts("\x04\n");
+    keep = stream.flush() && stream.next_request();
+  }
+
+  if (!stream.valid() && stream.fd_errno != EPIPE && stream.fd_errno != ECONNRESET) {
+    moot_msg(verbose, vlWarnings, "mootServer: session %u: connection error: %s\n",
+	     (unsigned)s.id,
+	     (stream.fd_errno == EAGAIN || stream.fd_errno == EWOULDBLOCK
+	      ? "timed out"
+	      : stream.errmsg().c_str()));
+  }
+  return keep;
+}
+
+//--------------------------------------------------------------
+void mootServer::serve_request(Session &s, Stream &stream)
+{
+  TokenReader *reader = s.reader;
+  TokenWriter *writer = s.writer;
+  if (reader->tr_format & tiofNative) {
+    //-- native input is lexed under a global lock (see TokenReaderNative):
+    //   read the whole request first, so a slow client cannot stall other sessions
+    char      buf[8192];
+    ByteCount nread;
+    s.request.clear();
+    while ((nread = stream.read(buf, sizeof(buf))) > 0)
+      s.request.append(buf, nread);
+    reader->from_buffer(s.request.data(), s.request.size());
+  } else {
+    reader->from_mstream(&stream);
+  }
+  writer->to_mstream(&stream);
+
+  //-- trace output must be dumped right after each sentence is tagged
+  size_t bsize = (writer->tw_format & tiofTrace) ? 1 : batch_size;
+  if (bsize < 1) bsize = 1;
+  if (s.batch.size() < bsize) s.batch.resize(bsize);
+
+  size_t n = 0;
+  mootSentence *sent;
+  while (reader->get_sentence() != TokTypeEOF) {
+    sent = reader->sentence();
+    if (!sent) continue;
+    s.batch[n++] = *sent;
+    if (n >= bsize) {
+      flush_batch(s, n);
+      n = 0;
+    }
+  }
+  if (n > 0) flush_batch(s, n);
+
+  writer->close();
+  reader->close();
+}
+
+//--------------------------------------------------------------
+void mootServer::flush_batch(Session &s, size_t n)
+{
+  TokenWriter *writer = s.writer;
+  if (n == 1) {
+    s.hmm->tag_sentence(s.batch[0]);
+    if (writer->tw_format & tiofTrace)
+      s.hmm->tag_dump_trace(s.batch[0], (writer->tw_format&tiofPredict)!=0);
+  } else {
+    s.batchp.resize(n);
+    for (size_t i=0; i < n; ++i) s.batchp[i] = &s.batch[i];
+    s.hmm->tag_batch(s.batchp);
+  }
+  for (size_t i=0; i < n; ++i) writer->put_sentence(s.batch[i]);
+}
+
+moot_END_NAMESPACE
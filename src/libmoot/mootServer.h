@@ -0,0 +1,264 @@
+/* -*- Mode: C++ -*- */
+
+/*
+   libmoot : moocow's part-of-speech tagging library
+   Copyright (C) 2003-2014 by Bryan Jurish <moocow@cpan.org>
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 3 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+/*--------------------------------------------------------------------------
+ * File: mootServer.h
+ * Author: Bryan Jurish <moocow@cpan.org>
+ * Description:
+ *   + moot PoS tagger : persistent tagging daemon on a Unix domain socket
+ *--------------------------------------------------------------------------*/
+
+/**
+\file mootServer.h
+\brief Persistent tagging daemon serving token streams over a Unix domain socket
+*/
+
+#ifndef _MOOT_SERVER_H
+#define _MOOT_SERVER_H
+
+#include <mootHMM.h>
+#include <mootTokenIO.h>
+#include <mootFdIO.h>
+
+#ifdef MOOT_PTHREADS_ENABLED
+# include <pthread.h>
+#endif
+
+#include <deque>
+#include <signal.h>
+#include <time.h>
+
+moot_BEGIN_NAMESPACE
+
+/*======================================================================
+ * class mootServer
+ */
+/**
+ * \brief Tagging daemon listening on a Unix domain socket.
+ * \details
+ * A server owns a fixed number of sessions, each with its own model
+ * instance, TokenReader, and TokenWriter (supplied by the caller, typically
+ * copies of a single loaded model).  Each session runs in its own thread.
+ * Open connections are polled by the thread which called run(), and a
+ * connection is handed to a free session only once input for a request
+ * has arrived; after the request has been answered, the connection is
+ * returned to the poll set.  Idle clients therefore never occupy a session.
+ * Connections idle for more than \a timeout seconds are closed, as are
+ * connections on which a single read or write blocks for that long.
+ * Without POSIX threads support, connections are served one at a time
+ * by the thread which called run().
+ *
+ * Protocol: a client sends one or more requests, each consisting of a token
+ * stream in the reader's format, and receives the tagged token stream in the
+ * writer's format for each request.  A request ends either when the client
+ * shuts down its side of the connection, or at a line consisting of the single
+ * byte \a EOR (ASCII EOT, Ctrl-D); in the latter case, the response is
+ * terminated by the same marker line and the connection remains open for
+ * further requests.  Sentences of a request are tagged in batches of up to
+ * \a batch_size sentences using mootHMM::tag_batch().
+ */
+class mootServer {
+public:
+  /*---------------------------------------------------------------------*/
+  /** \name Embedded Types */
+  //@{
+  /** End-of-request marker byte (ASCII EOT) */
+  static const char EOR = '\x04';
+
+  /** \brief Connection stream: reports end-of-file at end-of-request markers */
+  class Stream : public mootio::mfdstream {
+  public:
+    bool bol;  ///< true if the next input byte begins a line
+    bool eor;  ///< true if an end-of-request marker has been read
+
+  public:
+    Stream(void) : mfdstream(), bol(true), eor(false) {};
+
+    /** Select connection \a myfd and reset request state */
+    void from_fd(int myfd, bool owned=false)
+    {
+      mfdstream::from_fd(myfd, owned);
+      bol = true;
+      eor = false;
+    };
+
+    /** Step to the next request after an end-of-request marker (without blocking); returns false if the connection has ended */
+    bool next_request(void);
+
+    /** True if input for the next request is already buffered */
+    inline bool buffered(void) const
+    { return ipos < ibuf.size(); };
+
+    /** Test for end of the current request */
+    virtual bool eof(void) { return eor || mfdstream::eof(); };
+
+    /** Read up to \p n bytes of the current request into \p buf; returns 0 at end of request */
+    virtual mootio::ByteCount read(char *buf, size_t n);
+
+    /** Read a single byte of the current request; returns EOF at end of request */
+    virtual int getbyte(void);
+
+  protected:
+    /** Get number of bytes available before the next end-of-request marker, filling \a ibuf if necessary */
+    size_t available(void);
+  };
+
+  /** \brief Client connection, handed to a free session for each request */
+  class Connection {
+  public:
+    Stream  stream;  /**< connection stream (owns the socket) */
+    time_t  since;   /**< time at which the connection was accepted or last became idle */
+  public:
+    Connection(int myfd=-1) : since(time(NULL))
+    { stream.from_fd(myfd, true); };
+  };
+
+  /** \brief Per-session (per-thread) data */
+  class Session {
+  public:
+    mootServer            *server;        /**< server this session belongs to */
+    size_t                 id;            /**< session index */
+    mootHMM               *hmm;           /**< model instance (not owned) */
+    TokenReader           *reader;        /**< request reader (not owned) */
+    TokenWriter           *writer;        /**< response writer (not owned) */
+    Connection            *conn;          /**< connection being served, NULL if idle (guarded by server mutex) */
+    vector<mootSentence>   batch;         /**< sentence buffer for tag_batch() */
+    mootHMM::SentenceBatch batchp;        /**< pointers into \a batch */
+    std::string            request;       /**< buffered request text for native-format readers */
+    size_t                 nrequests;     /**< number of requests served */
+#ifdef MOOT_PTHREADS_ENABLED
+    pthread_t              thread;        /**< session thread */
+#endif
+  public:
+    Session(mootServer *my_server=NULL, size_t my_id=0, mootHMM *my_hmm=NULL,
+	    TokenReader *my_reader=NULL, TokenWriter *my_writer=NULL)
+      : server(my_server), id(my_id), hmm(my_hmm), reader(my_reader), writer(my_writer),
+	conn(NULL), nrequests(0)
+    {};
+  };
+  //@}
+
+public:
+  /*---------------------------------------------------------------------*/
+  /** \name Data */
+  //@{
+  std::string       path;        /**< filesystem path of the listening socket */
+  int               verbose;     /**< verbosity level (see mootHMM::verbose) */
+  size_t            batch_size;  /**< maximum number of sentences passed to tag_batch() at once */
+  int               backlog;     /**< listen(2) backlog */
+  int               timeout;     /**< seconds after which idle or blocked connections are closed (0: never; default: 60) */
+  vector<Session*>  sessions;    /**< sessions (owned) */
+
+protected:
+  int                      listen_fd;  /**< listening socket, -1 if not open */
+  std::deque<Connection*>  pending;    /**< connections with request input waiting for a free session */
+  vector<Connection*>      idle;       /**< open connections between requests, polled by run() */
+  int                      wake_fd[2]; /**< self-pipe: wakes up run() when a connection is returned to \a idle */
+  bool                     stopping;   /**< true once run() is shutting down */
+#ifdef MOOT_PTHREADS_ENABLED
+  pthread_mutex_t   mutex;       /**< guards \a pending, \a idle, \a stopping, and Session::conn */
+  pthread_cond_t    cond;        /**< signals new requests and shutdown */
+#endif
+
+  /** Set by the SIGINT / SIGTERM handler installed by run() */
+  static volatile sig_atomic_t stop_signal;
+  //@}
+
+public:
+  /*---------------------------------------------------------------------*/
+  /** \name Constructors etc. */
+  //@{
+  /** Constructor */
+  mootServer(const std::string &my_path="");
+
+  /** Destructor: closes the listening socket and frees all sessions */
+  virtual ~mootServer(void);
+
+  /** Add a session using model instance \a hmm, reader \a reader and writer \a writer (none adopted) */
+  Session *add_session(mootHMM *hmm, TokenReader *reader, TokenWriter *writer);
+  //@}
+
+  /*---------------------------------------------------------------------*/
+  /** \name Operation */
+  //@{
+  /** Create and bind the listening socket at \a path (replacing any stale socket file); returns false on error */
+  bool open(void);
+
+  /** Close the listening socket and remove the socket file */
+  void close(void);
+
+  /**
+   * Serve connections until SIGINT or SIGTERM is received (or stop() is called
+   * from a signal handler).  Opens the socket if necessary.  On shutdown,
+   * requests in progress are finished and all connections closed.
+   */
+  bool run(void);
+
+  /** Request run() to return (async-signal-safe) */
+  static void stop(void) { stop_signal = 1; };
+  //@}
+
+  /*---------------------------------------------------------------------*/
+  /** \name Low-level utilities */
+  //@{
+  /** Serve one request on connection \a c using session \a s; returns true if \a c remains open for further requests */
+  bool serve(Session &s, Connection &c);
+
+  /** Serve a single request on \a stream using session \a s */
+  void serve_request(Session &s, Stream &stream);
+
+  /** Tag and write the first \a n sentences of \a s.batch */
+  void flush_batch(Session &s, size_t n);
+  //@}
+
+protected:
+  /** Session main loop: serve pending requests until shutdown */
+  void work(Session &s);
+
+  /** Wake up run() from a session thread, e.g. after returning a connection to \a idle */
+  void wake(void);
+
+  /** Lock / unlock server mutex */
+  inline void lock(void)
+  {
+#ifdef MOOT_PTHREADS_ENABLED
+    pthread_mutex_lock(&mutex);
+#endif
+  };
+  inline void unlock(void)
+  {
+#ifdef MOOT_PTHREADS_ENABLED
+    pthread_mutex_unlock(&mutex);
+#endif
+  };
+
+  /** Signal handler for SIGINT / SIGTERM */
+  static void _on_signal(int sig);
+
+#ifdef MOOT_PTHREADS_ENABLED
+  /** Session thread entry point */
+  static void *_work_thread(void *data);
+#endif
+};
+
+moot_END_NAMESPACE
+
+#endif /* _MOOT_SERVER_H */
@@ -38,6 +38,7 @@
 
 #include <list>
 #include <vector>
+#include <algorithm>
 #include <mootTypes.h>
 
 /**
@@ -381,6 +382,17 @@ public:
     return *this;
   };
 
+  /** exchange contents with \a x without copying text or analyses */
+  inline void swap(mootToken &x)
+  {
+    std::swap(tok_type, x.tok_type);
+    tok_text.swap(x.tok_text);
+    tok_besttag.swap(x.tok_besttag);
+    tok_analyses.swap(x.tok_analyses);
+    std::swap(tok_location, x.tok_location);
+    std::swap(tok_data, x.tok_data);
+  };
+
   /*------------------------------------------------------------
    * Manipulators: General
    */
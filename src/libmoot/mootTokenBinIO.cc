@@ -0,0 +1,551 @@
+/* -*- Mode: C++ -*- */
+/*
+   libmoot : moocow's part-of-speech tagging library
+   Copyright (C) 2003-2014 by Bryan Jurish <moocow@cpan.org>
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 3 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+/*--------------------------------------------------------------------------
+ * File: mootTokenBinIO.cc
+ * Author: Bryan Jurish <moocow@cpan.org>
+ * Description:
+ *   + moocow's PoS tagger : token I/O : binary token streams
+ *--------------------------------------------------------------------------*/
+
+#include "mootTokenBinIO.h"
+
+#include <string.h>
+
+moot_BEGIN_NAMESPACE
+
+/*==========================================================================
+ * Binary token streams: encoding utilities
+ */
+
+//--------------------------------------------------------------
+/** Append unsigned LEB128 encoding of \a val to \a buf */
+static inline void tokbin_put_varint(std::string &buf, unsigned long val)
+{
+  while (val >= 0x80) {
+    buf.push_back(static_cast<char>((val & 0x7f) | 0x80));
+    val >>= 7;
+  }
+  buf.push_back(static_cast<char>(val));
+}
+
+//--------------------------------------------------------------
+/** Append length-prefixed string to \a buf */
+static inline void tokbin_put_string(std::string &buf, const std::string &s)
+{
+  tokbin_put_varint(buf, s.size());
+  buf.append(s);
+}
+
+//--------------------------------------------------------------
+/** Returns true iff host byte order is little-endian */
+static inline bool tokbin_little_endian(void)
+{
+  static const unsigned int one = 1;
+  return *reinterpret_cast<const unsigned char*>(&one) == 1;
+}
+
+//--------------------------------------------------------------
+/** Append little-endian IEEE-754 encoding of \a val (float or double) to \a buf */
+template<typename FloatT>
+static inline void tokbin_put_ieee(std::string &buf, FloatT val)
+{
+  unsigned char bytes[sizeof(FloatT)];
+  memcpy(bytes, &val, sizeof(FloatT));
+  if (tokbin_little_endian()) {
+    buf.append(reinterpret_cast<const char*>(bytes), sizeof(FloatT));
+  } else {
+    for (size_t i=sizeof(FloatT); i > 0; --i)
+      buf.push_back(static_cast<char>(bytes[i-1]));
+  }
+}
+
+//--------------------------------------------------------------
+/** Returns analysis flag for details implied by the tag (tbaTagDetails, tbaBracketDetails), or tbaDetails */
+static inline unsigned char tokbin_details_flag(const mootToken::Analysis &a)
+{
+  if (a.details == a.tag)
+    return tbaTagDetails;
+  if (a.details.size() == a.tag.size()+2
+      && a.details[0] == '['
+      && a.details.compare(1, a.tag.size(), a.tag) == 0
+      && a.details[a.tag.size()+1] == ']')
+    return tbaBracketDetails;
+  return tbaDetails;
+}
+
+//--------------------------------------------------------------
+/** Decode an unsigned LEB128 value from [*pp,end) into \a val; returns false if truncated */
+static inline bool tokbin_get_varint(const char **pp, const char *end, unsigned long &val)
+{
+  const char *p = *pp;
+  unsigned int shift = 0;
+  val = 0;
+  for ( ; p < end && shift < 8*sizeof(unsigned long); shift += 7) {
+    unsigned char c = static_cast<unsigned char>(*p++);
+    val |= static_cast<unsigned long>(c & 0x7f) << shift;
+    if (!(c & 0x80)) {
+      *pp = p;
+      return true;
+    }
+  }
+  return false;
+}
+
+//--------------------------------------------------------------
+/** Decode a length-prefixed string from [*pp,end) into \a s; returns false if truncated */
+static inline bool tokbin_get_string(const char **pp, const char *end, std::string &s)
+{
+  unsigned long len;
+  if (!tokbin_get_varint(pp, end, len) || len > static_cast<unsigned long>(end - *pp))
+    return false;
+  s.assign(*pp, len);
+  *pp += len;
+  return true;
+}
+
+//--------------------------------------------------------------
+/** Decode a little-endian IEEE-754 float or double from [*pp,end) into \a val; returns false if truncated */
+template<typename FloatT>
+static inline bool tokbin_get_ieee(const char **pp, const char *end, FloatT &val)
+{
+  if (end - *pp < static_cast<long>(sizeof(FloatT))) return false;
+  unsigned char bytes[sizeof(FloatT)];
+  if (tokbin_little_endian()) {
+    memcpy(bytes, *pp, sizeof(FloatT));
+  } else {
+    for (size_t i=0; i < sizeof(FloatT); ++i)
+      bytes[i] = static_cast<unsigned char>((*pp)[sizeof(FloatT)-1-i]);
+  }
+  memcpy(&val, bytes, sizeof(FloatT));
+  *pp += sizeof(FloatT);
+  return true;
+}
+
+//--------------------------------------------------------------
+/** Decode a tag reference from [*pp,end) into \a tag, updating \a tags; returns false on error */
+static inline bool tokbin_get_tag(const char **pp, const char *end, mootTokBinTagTable &tags, mootTagString &tag)
+{
+  unsigned long id;
+  if (!tokbin_get_varint(pp, end, id)) return false;
+  if (id < tags.size()) {
+    tag = tags.id2name(id);
+    return true;
+  }
+  else if (id == tags.size()) {
+    //-- new tag: string follows
+    if (!tokbin_get_string(pp, end, tag)) return false;
+    tags.insert(tag, id);
+    return true;
+  }
+  return false;
+}
+
+/*==========================================================================
+ * TokenReaderBinary
+ */
+
+//--------------------------------------------------------------
+void TokenReaderBinary::from_mstream(mootio::mistream *mistreamp)
+{
+  TokenReader::from_mstream(mistreamp);
+  trb_buf.clear();
+  trb_pos  = 0;
+  trb_byte = 0;
+  trb_eof  = (tr_istream == NULL || !tr_istream->valid());
+  trb_tags.clear();
+  trb_tags.unknown_name(mootTagString());
+}
+
+//--------------------------------------------------------------
+void TokenReaderBinary::close(void)
+{
+  TokenReader::close();
+  trb_buf.clear();
+  trb_pos = 0;
+  trb_eof = true;
+}
+
+//--------------------------------------------------------------
+bool TokenReaderBinary::fill(size_t n)
+{
+  size_t avail = trb_buf.size() - trb_pos;
+  if (avail >= n) return true;
+
+  //-- compact buffer
+  if (trb_pos > 0) {
+    trb_buf.erase(0, trb_pos);
+    trb_byte += trb_pos;
+    trb_pos   = 0;
+  }
+
+  while (avail < n && !trb_eof) {
+    size_t want = n - avail;
+    if (want < TRB_DEFAULT_BUFSIZE) want = TRB_DEFAULT_BUFSIZE;
+    trb_buf.resize(avail + want);
+    mootio::ByteCount nread = tr_istream->read(&trb_buf[avail], want);
+    if (nread <= 0) {
+      nread   = 0;
+      trb_eof = true;
+    }
+    avail += nread;
+    trb_buf.resize(avail);
+  }
+  return avail >= n;
+}
+
+//--------------------------------------------------------------
+mootTokenType TokenReaderBinary::read_token(mootToken &token)
+{
+  for (;;) {
+    if (!fill(1)) {
+      token.toktype(TokTypeEOF);
+      return TokTypeEOF;
+    }
+
+    unsigned char typ = static_cast<unsigned char>(trb_buf[trb_pos]);
+    if (typ == static_cast<unsigned char>(MOOT_TOKBIN_MAGIC[0])) {
+      //-- header: (re-)start of stream
+      if (!fill(5) || memcmp(trb_buf.data()+trb_pos, MOOT_TOKBIN_MAGIC, 4) != 0) {
+	carp("Error: bad binary stream header");
+	break;
+      }
+      if (static_cast<unsigned char>(trb_buf[trb_pos+4]) != MOOT_TOKBIN_VERSION) {
+	carp("Error: unsupported binary stream version %d", static_cast<unsigned char>(trb_buf[trb_pos+4]));
+	break;
+      }
+      trb_pos += 5;
+      trb_tags.clear();
+      trb_tags.unknown_name(mootTagString());
+      continue;
+    }
+    if (typ >= NTokTypes) {
+      carp("Error: bad binary token type %d", typ);
+      break;
+    }
+
+    //-- record length (a varint is at most 10 bytes)
+    fill(11);
+    const char   *p   = trb_buf.data() + trb_pos + 1;
+    const char   *end = trb_buf.data() + trb_buf.size();
+    unsigned long len;
+    if (!tokbin_get_varint(&p, end, len)) {
+      carp("Error: truncated binary token record");
+      break;
+    }
+    size_t hdrlen = p - (trb_buf.data() + trb_pos);
+    if (!fill(hdrlen + len)) {
+      carp("Error: truncated binary token record");
+      break;
+    }
+    p   = trb_buf.data() + trb_pos + hdrlen;
+    end = p + len;
+    trb_pos += hdrlen + len;
+
+    //-- payload
+    token.toktype(static_cast<mootTokenType>(typ));
+    token.tok_text.clear();
+    token.tok_besttag.clear();
+    token.tok_location.clear();
+    if (p == end) {
+      token.tok_analyses.clear();
+      return token.toktype();
+    }
+
+    unsigned char fields = static_cast<unsigned char>(*p++);
+    bool ok = true;
+    if (fields & tbfText)
+      ok = tokbin_get_string(&p, end, token.tok_text);
+    if (ok && (fields & tbfBestTag))
+      ok = tokbin_get_tag(&p, end, trb_tags, token.tok_besttag);
+    if (ok && (fields & tbfLocation))
+      ok = (tokbin_get_varint(&p, end, token.tok_location.offset)
+	    && tokbin_get_varint(&p, end, token.tok_location.length));
+
+    mootToken::Analyses::iterator ai = token.tok_analyses.begin();
+    if (ok && (fields & tbfAnalyses)) {
+      unsigned long n;
+      ok = tokbin_get_varint(&p, end, n);
+      for ( ; ok && n > 0; --n) {
+	//-- re-use existing analysis nodes
+	if (ai == token.tok_analyses.end())
+	  ai = token.tok_analyses.insert(ai, mootToken::Analysis());
+	ok = p < end;
+	if (!ok) break;
+	unsigned char aflags = static_cast<unsigned char>(*p++);
+	ok = tokbin_get_tag(&p, end, trb_tags, ai->tag);
+	if (ok && (aflags & tbaDetails)) {
+	  ok = tokbin_get_string(&p, end, ai->details);
+	} else if (aflags & tbaTagDetails) {
+	  ai->details = ai->tag;
+	} else if (aflags & tbaBracketDetails) {
+	  ai->details.assign(1, '[');
+	  ai->details.append(ai->tag);
+	  ai->details.push_back(']');
+	} else {
+	  ai->details.clear();
+	}
+	double prob  = 0;
+	float  probf = 0;
+	if (ok && (aflags & tbaProb))
+	  ok = tokbin_get_ieee(&p, end, prob);
+	else if (ok && (aflags & tbaProbFloat) && (ok = tokbin_get_ieee(&p, end, probf)))
+	  prob = probf;
+	ai->prob = static_cast<ProbT>(prob);
+	ai->data = NULL;
+	++ai;
+      }
+    }
+    token.tok_analyses.erase(ai, token.tok_analyses.end());
+
+    if (!ok) {
+      carp("Error: malformed binary token record");
+      break;
+    }
+    //-- any remaining payload bytes are silently ignored
+    return token.toktype();
+  }
+
+  //-- error: treat as end-of-input
+  trb_pos = trb_buf.size();
+  trb_eof = true;
+  token.toktype(TokTypeEOF);
+  return TokTypeEOF;
+}
+
+//--------------------------------------------------------------
+mootTokenType TokenReaderBinary::get_token(void)
+{
+  tr_token = &trb_token;
+  return read_token(trb_token);
+}
+
+//--------------------------------------------------------------
+mootTokenType TokenReaderBinary::get_sentence(void)
+{
+  if (!tr_sentence) tr_sentence = &trb_sentence;
+  mootTokenType typ = TokTypeUnknown;
+
+  //-- re-use existing token nodes
+  mootSentence::iterator si = tr_sentence->begin();
+  while (typ != TokTypeEOS && typ != TokTypeEOF) {
+    if (si == tr_sentence->end())
+      si = tr_sentence->insert(si, mootToken());
+    typ = read_token(*si);
+    if (typ != TokTypeEOS && typ != TokTypeEOF) ++si;
+  }
+  tr_sentence->erase(si, tr_sentence->end());
+
+  //-- a final sentence without EOS record is returned as EOS (as for native input)
+  if (typ == TokTypeEOF && !tr_sentence->empty()) return TokTypeEOS;
+  return typ;
+}
+
+/*==========================================================================
+ * TokenWriterBinary
+ */
+
+//--------------------------------------------------------------
+void TokenWriterBinary::to_mstream(mootio::mostream *os)
+{
+  TokenWriter::to_mstream(os);
+  twb_tags.clear();
+  twb_tags.unknown_name(mootTagString());
+  twb_header = false;
+}
+
+//--------------------------------------------------------------
+void TokenWriterBinary::close(void)
+{
+  _flush_buffer();
+  TokenWriter::close();
+  twb_buf.clear();
+}
+
+//--------------------------------------------------------------
+bool TokenWriterBinary::flush(void)
+{
+  _flush_buffer();
+  return TokenWriter::flush();
+}
+
+//--------------------------------------------------------------
+void TokenWriterBinary::_flush_buffer(size_t minsize)
+{
+  if (twb_buf.size() <= minsize && !(twb_buf.size() && (tw_format&tiofFlush))) return;
+  if (tw_ostream && tw_ostream->valid()) {
+    tw_ostream->write(twb_buf.data(), twb_buf.size());
+    autoflush(tw_ostream);
+  }
+  twb_buf.clear();
+}
+
+//--------------------------------------------------------------
+void TokenWriterBinary::_put_record(mootTokenType typ)
+{
+  if (!twb_header) {
+    twb_buf.append(MOOT_TOKBIN_MAGIC, 4);
+    twb_buf.push_back(static_cast<char>(MOOT_TOKBIN_VERSION));
+    twb_header = true;
+  }
+  twb_buf.push_back(static_cast<char>(typ));
+  tokbin_put_varint(twb_buf, twb_rec.size());
+  twb_buf.append(twb_rec);
+}
+
+//--------------------------------------------------------------
+void TokenWriterBinary::_put_tag(const mootTagString &tag)
+{
+  if (tag.empty()) {
+    twb_rec.push_back('\0');
+    return;
+  }
+  mootEnumID id = twb_tags.name2id(tag);
+  if (id) {
+    tokbin_put_varint(twb_rec, id);
+  } else {
+    tokbin_put_varint(twb_rec, twb_tags.insert(tag));
+    tokbin_put_string(twb_rec, tag);
+  }
+}
+
+//--------------------------------------------------------------
+void TokenWriterBinary::_put_text_token(mootTokenType typ, const char *text, size_t len)
+{
+  twb_rec.clear();
+  if (len > 0) {
+    twb_rec.push_back(static_cast<char>(tbfText));
+    tokbin_put_varint(twb_rec, len);
+    twb_rec.append(text, len);
+  }
+  _put_record(typ);
+}
+
+//--------------------------------------------------------------
+void TokenWriterBinary::_put_token(const mootToken &token)
+{
+  switch (token.toktype()) {
+  case TokTypeVanilla:
+  case TokTypeLibXML:
+    {
+      unsigned char fields = 0;
+      twb_rec.assign(1, '\0');
+      if ((tw_format & tiofText) && !token.text().empty()) {
+	fields |= tbfText;
+	tokbin_put_string(twb_rec, token.text());
+      }
+      if ((tw_format & tiofTagged) && !token.besttag().empty()) {
+	fields |= tbfBestTag;
+	_put_tag(token.besttag());
+      }
+      if (tw_format & tiofLocation) {
+	fields |= tbfLocation;
+	tokbin_put_varint(twb_rec, token.location().offset);
+	tokbin_put_varint(twb_rec, token.location().length);
+      }
+      if ((tw_format & tiofAnalyzed) && !token.analyses().empty()) {
+	//-- count analyses first, since we may be pruning
+	size_t n = 0;
+	mootToken::Analyses::const_iterator ai;
+	for (ai = token.analyses().begin(); ai != token.analyses().end(); ++ai) {
+	  if ((tw_format & tiofPruned) && ai->tag != token.besttag()) continue;
+	  ++n;
+	}
+	if (n > 0) {
+	  fields |= tbfAnalyses;
+	  tokbin_put_varint(twb_rec, n);
+	  for (ai = token.analyses().begin(); ai != token.analyses().end(); ++ai) {
+	    if ((tw_format & tiofPruned) && ai->tag != token.besttag()) continue;
+	    unsigned char aflags = 0;
+	    if (!ai->details.empty())
+	      aflags |= tokbin_details_flag(*ai);
+	    if ((tw_format & tiofCost) && ai->prob != 0)
+	      aflags |= (static_cast<double>(static_cast<float>(ai->prob)) == static_cast<double>(ai->prob)
+			 ? tbaProbFloat : tbaProb);
+	    twb_rec.push_back(static_cast<char>(aflags));
+	    _put_tag(ai->tag);
+	    if (aflags & tbaDetails) tokbin_put_string(twb_rec, ai->details);
+	    if (aflags & tbaProb) tokbin_put_ieee(twb_rec, static_cast<double>(ai->prob));
+	    if (aflags & tbaProbFloat) tokbin_put_ieee(twb_rec, static_cast<float>(ai->prob));
+	  }
+	}
+      }
+      if (fields) twb_rec[0] = static_cast<char>(fields);
+      else twb_rec.clear();
+      _put_record(token.toktype());
+    }
+    break;
+
+  case TokTypeEOF:
+    //-- end-of-input is implicit
+    break;
+
+  default:
+    //-- other token types: text only
+    _put_text_token(token.toktype(), token.text().data(), token.text().size());
+    break;
+  }
+}
+
+//--------------------------------------------------------------
+void TokenWriterBinary::put_token(const mootToken &token)
+{
+  if (tw_format & tiofNull) return;
+  _put_token(token);
+  _flush_buffer(TWB_DEFAULT_BUFSIZE);
+}
+
+//--------------------------------------------------------------
+void TokenWriterBinary::put_tokens(const mootSentence &tokens)
+{
+  if (tw_format & tiofNull) return;
+  for (mootSentence::const_iterator si=tokens.begin(); si!=tokens.end(); ++si)
+    _put_token(*si);
+  _flush_buffer(TWB_DEFAULT_BUFSIZE);
+}
+
+//--------------------------------------------------------------
+void TokenWriterBinary::put_sentence(const mootSentence &sentence)
+{
+  if (tw_format & tiofNull) return;
+  for (mootSentence::const_iterator si=sentence.begin(); si!=sentence.end(); ++si)
+    _put_token(*si);
+  if (sentence.empty() || sentence.back().toktype() != TokTypeEOS)
+    _put_text_token(TokTypeEOS, NULL, 0);
+  _flush_buffer(TWB_DEFAULT_BUFSIZE);
+}
+
+//--------------------------------------------------------------
+void TokenWriterBinary::put_raw_buffer(const char *buf, size_t len)
+{
+  if (tw_format & tiofNull) return;
+  if (!tw_is_comment_block) return; //-- no binary representation for raw data
+
+  //-- one comment token per line (as for native input)
+  size_t i, j;
+  for (i=0; i < len; i=j+1) {
+    for (j=i; j < len && buf[j] != '\n'; j++)
+      ;
+    _put_text_token(TokTypeComment, buf+i, j-i);
+  }
+  _flush_buffer(TWB_DEFAULT_BUFSIZE);
+}
+
+moot_END_NAMESPACE
@@ -0,0 +1,268 @@
+/* -*- Mode: C++ -*- */
+/*
+   libmoot : moocow's part-of-speech tagging library
+   Copyright (C) 2003-2014 by Bryan Jurish <moocow@cpan.org>
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 3 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+/*--------------------------------------------------------------------------
+ * File: mootTokenBinIO.h
+ * Author: Bryan Jurish <moocow@cpan.org>
+ * Description:
+ *   + moocow's PoS tagger : token I/O : binary token streams
+ *--------------------------------------------------------------------------*/
+
+/**
+\file mootTokenBinIO.h
+\brief moot::TokenIO layer for parse-free binary token streams (moot::tiofBinary)
+
+Binary token streams are intended for lossless, fast piping of tokens
+between moot processes.  A stream is a sequence of records:
+
+\verbatim
+ stream   := record*
+ record   := header | token
+ header   := 0x89 "mtb" VERSION                  ; VERSION = 1 byte (currently 1); resets the tag table
+ token    := TYPE LEN PAYLOAD                    ; TYPE = 1 byte (moot::mootTokenType), LEN = varint byte length of PAYLOAD
+ PAYLOAD  := FIELDS [text] [besttag] [location] [analyses]
+ FIELDS   := 1 byte: 0x01=text, 0x02=besttag, 0x04=location, 0x08=analyses
+ text     := string
+ besttag  := tag
+ location := varint(offset) varint(length)
+ analyses := varint(count) analysis*
+ analysis := AFLAGS tag [string(details) if AFLAGS&0x01] [double(prob) if AFLAGS&0x02] [float(prob) if AFLAGS&0x10]
+                                                 ; details are tag if AFLAGS&0x04, "[" tag "]" if AFLAGS&0x08
+ tag      := varint(ID) [string, iff ID is the next unused ID]  ; ID 0 is the empty tag
+ string   := varint(LEN) LEN bytes
+ varint   := unsigned LEB128
+ double   := 8 bytes, IEEE-754 little-endian
+ float    := 4 bytes, IEEE-754 little-endian
+\endverbatim
+
+Tag strings (best tags and analysis tags) are interned: each distinct tag
+is written only once per stream, and referred to by its numeric ID afterwards.
+Analysis details which merely repeat the tag, bare or in brackets (as
+parsed from native input), are not stored, and costs which are exactly representable
+as single-precision floats take 4 bytes.
+Readers skip payload bytes they do not understand, so fields may be
+added in later versions.
+*/
+
+#ifndef _MOOT_TOKEN_BIN_IO_H
+#define _MOOT_TOKEN_BIN_IO_H
+
+#include <mootTokenIO.h>
+#include <mootEnum.h>
+
+moot_BEGIN_NAMESPACE
+
+/** Magic bytes starting a binary token stream header record */
+#define MOOT_TOKBIN_MAGIC "\x89mtb"
+
+/** Current binary token stream version */
+#define MOOT_TOKBIN_VERSION 1
+
+/** Binary token stream field flags */
+enum mootTokBinFieldE {
+  tbfText      = 0x01,  ///< token text
+  tbfBestTag   = 0x02,  ///< best tag
+  tbfLocation  = 0x04,  ///< location
+  tbfAnalyses  = 0x08   ///< analyses
+};
+
+/** Binary token stream analysis flags */
+enum mootTokBinAnalysisE {
+  tbaDetails        = 0x01,  ///< analysis details
+  tbaProb           = 0x02,  ///< analysis prob (cost), as double
+  tbaTagDetails     = 0x04,  ///< analysis details are the tag itself (not stored)
+  tbaBracketDetails = 0x08,  ///< analysis details are "[" tag "]" (not stored)
+  tbaProbFloat      = 0x10   ///< analysis prob (cost), as float
+};
+
+/** Type for interned tag tables of binary token streams */
+typedef mootEnum<mootTagString> mootTokBinTagTable;
+
+//==========================================================================
+// TokenReaderBinary
+
+/**
+ * \brief Class for binary token stream input (moot::tiofBinary).
+ * \details
+ * All fields present in the input are returned, regardless of
+ * \a tr_format.  Several binary streams may be concatenated.
+ */
+class TokenReaderBinary : public TokenReader {
+public:
+  /** Default size of input buffer. */
+  static const size_t TRB_DEFAULT_BUFSIZE = 65536;
+
+public:
+  /*----------------------------------------
+   * Reader: Binary: Data
+   */
+  mootToken          trb_token;     ///< token buffer for get_token()
+  mootSentence       trb_sentence;  ///< sentence buffer for get_sentence()
+  mootTokBinTagTable trb_tags;      ///< tag table of current stream
+  std::string        trb_buf;       ///< input buffer
+  size_t             trb_pos;       ///< position of next unread byte in \a trb_buf
+  mootio::ByteOffset trb_byte;      ///< number of input bytes consumed
+  bool               trb_eof;       ///< true iff \a tr_istream is exhausted
+
+public:
+  /*----------------------------------------
+   * Reader: Binary: Methods
+   */
+  /** \name Constructors etc. */
+  //@{
+  /** Default constructor
+   * @param fmt bitmask of moot::TokenIOFormat flags.
+   * @param name name of input source, for diagnostics.
+   */
+  TokenReaderBinary(int                fmt  =tiofWellDone|tiofBinary,
+		    const std::string &name ="TokenReaderBinary")
+    : TokenReader(fmt,name),
+      trb_pos(0),
+      trb_byte(0),
+      trb_eof(true)
+  {
+    tr_format  |= tiofBinary;
+    tr_token    = &trb_token;
+    tr_sentence = &trb_sentence;
+  };
+
+  /** Default destructor */
+  virtual ~TokenReaderBinary(void)
+  {};
+  //@}
+
+  /** \name Input Selection */
+  //@{
+  /** Select input stream; resets the tag table */
+  virtual void from_mstream(mootio::mistream *mistreamp);
+
+  /** Finish input from current source */
+  virtual void close(void);
+  //@}
+
+  /** \name Token-Level Access */
+  //@{
+  /** Get next token into *tr_token */
+  virtual mootTokenType get_token(void);
+
+  /** Get next sentence (without its final EOS token) into *tr_sentence; a final sentence not terminated by an EOS record is returned as TokTypeEOS */
+  virtual mootTokenType get_sentence(void);
+  //@}
+
+  /** \name Diagnostics */
+  //@{
+  /** Get current byte number. */
+  virtual mootio::ByteOffset byte_number(void) { return trb_byte + trb_pos; };
+  //@}
+
+protected:
+  /** Ensure at least \a n unread bytes are buffered; returns false at eof */
+  bool fill(size_t n);
+
+  /** Read next token record into \a token; returns TokTypeEOF at end of input or on error */
+  mootTokenType read_token(mootToken &token);
+};
+
+//==========================================================================
+// TokenWriterBinary
+
+/**
+ * \brief Class for binary token stream output (moot::tiofBinary).
+ * \details
+ * Token fields are written according to \a tw_format (moot::tiofText,
+ * moot::tiofTagged, moot::tiofAnalyzed, moot::tiofLocation, moot::tiofCost,
+ * moot::tiofPruned).  Comment blocks (and thus put_comment() etc.) are
+ * written as TokTypeComment tokens, one per line; raw data outside of
+ * comment blocks has no binary representation and is ignored.
+ * Output is buffered, and flushed at least by flush() and close().
+ */
+class TokenWriterBinary : public TokenWriter {
+public:
+  /** Maximum size of output buffer before it is flushed */
+  static const size_t TWB_DEFAULT_BUFSIZE = 65536;
+
+public:
+  /*----------------------------------------
+   * Writer: Binary: Data
+   */
+  mootTokBinTagTable twb_tags;    ///< tag table of current stream
+  std::string        twb_buf;     ///< output buffer (complete records)
+  std::string        twb_rec;     ///< current record payload
+  bool               twb_header;  ///< whether a header record has been written to the current stream
+
+public:
+  /** \name Constructors etc. */
+  //@{
+  /** Default constructor */
+  TokenWriterBinary(int fmt=tiofWellDone|tiofBinary,
+		    const std::string &name="TokenWriterBinary")
+    : TokenWriter(fmt,name),
+      twb_header(false)
+  {
+    tw_format |= tiofBinary;
+  };
+
+  /** Default destructor */
+  virtual ~TokenWriterBinary(void)
+  {
+    close();
+  };
+  //@}
+
+  /** \name Output Selection */
+  //@{
+  /** Select output stream; resets the tag table */
+  virtual void to_mstream(mootio::mostream *os);
+
+  /** Flush buffered output and close current sink */
+  virtual void close(void);
+
+  /** Flush buffered output */
+  virtual bool flush(void);
+  //@}
+
+  /** \name Overrides */
+  //@{
+  virtual void put_token(const mootToken &token);
+  virtual void put_tokens(const mootSentence &tokens);
+  virtual void put_sentence(const mootSentence &sentence);
+  virtual void put_raw_buffer(const char *buf, size_t len);
+  //@}
+
+protected:
+  /** Append encoded \a token to \a twb_buf */
+  void _put_token(const mootToken &token);
+
+  /** Append a token record of type \a typ with text \a text to \a twb_buf */
+  void _put_text_token(mootTokenType typ, const char *text, size_t len);
+
+  /** Append record of type \a typ with payload \a twb_rec to \a twb_buf */
+  void _put_record(mootTokenType typ);
+
+  /** Append tag reference for \a tag to \a twb_rec */
+  void _put_tag(const mootTagString &tag);
+
+  /** Write out \a twb_buf if it is larger than \a minsize */
+  void _flush_buffer(size_t minsize=0);
+};
+
+moot_END_NAMESPACE
+
+#endif /* _MOOT_TOKEN_BIN_IO_H */
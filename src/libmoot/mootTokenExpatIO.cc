@@ -114,13 +114,16 @@ mootTokenType TokenReaderExpat::get_sentence(void)
   //-- fill TokenReader sentence buffer by scanning callback buffer & splicing
   trx_sentbuf.clear();
   mootSentence::iterator si;
-  while (trx_sentbuf.empty()) {                                   //-- ignore empty sentences
-    for (si = cb_fullsents.begin(); si != cb_fullsents.end() && si->toktype() != TokTypeEOS; si++)
-      ;
-    trx_sentbuf.splice(trx_sentbuf.begin(), cb_fullsents, cb_fullsents.begin(), si);
-    if (si->toktype() == TokTypeEOS) {
+  for (si = cb_fullsents.begin(); si != cb_fullsents.end() && si->toktype() != TokTypeEOS; si++)
+    ;
+  trx_sentbuf.splice(trx_sentbuf.begin(), cb_fullsents, cb_fullsents.begin(), si);
+  if (si != cb_fullsents.end()) {
+    if (save_raw_xml && !si->tok_text.empty()) {
+      //-- keep raw boundary markup (e.g. a sentence end-tag) as the last token of the sentence
+      si->tok_type = TokTypeXMLRaw;
+      trx_sentbuf.splice(trx_sentbuf.end(), cb_fullsents, si);
+    } else {
       cb_fullsents.pop_front();
-      break;
     }
   }
   return TokTypeEOS;
@@ -350,6 +353,10 @@ void TokenReaderExpat::EndElementHandler(const char *el)
   if (typ == TokTypeEOS) {
     //-- splice in new full sentence if we've got one
     cb_fullsents.splice(cb_fullsents.end(), cb_nxtsent);
+
+    //-- ... and stop parsing until it has been consumed, so that at most one
+    //   sentence is buffered regardless of the parse buffer size
+    suspend();
   }
 }
 
@@ -575,9 +582,15 @@ void TokenWriterExpat::_put_token_raw(const mootToken &token, mootio::mostream *
     break;
       
   case TokTypeEOS:
-    os->printf("%s<%s/>",
-	       (tw_format&tiofPretty ? "\n  " : ""),
-	       eos_elt.c_str());
+    //-- raw mode: boundary markup from XML input is in the token text, cf. _put_sentence()
+    if (token.text().find('<') != token.text().npos) {
+      os->write(token.text().data(), token.text().size());
+    } else {
+      //-- ... boundaries from non-XML input have none (at most whitespace)
+      os->printf("%s<%s/>",
+		 (tw_format&tiofPretty ? "\n  " : ""),
+		 eos_elt.c_str());
+    }
     break;
 
   default:
@@ -132,7 +132,7 @@ public:
   mootToken            *cb_nxttok;  ///< Construction buffer for tokens (points into nxtsent)
 
   //-- output buffers
-  mootSentence         cb_fullsents; ///< LONG buffer of fully parsed sentences (for expat callbacks)
+  mootSentence         cb_fullsents; ///< buffer of fully parsed sentences (for expat callbacks); parsing is suspended after each sentence if expat supports it
   mootSentence         trx_sentbuf;  ///< current output sentence buffer (for TokenReader interface)
   //@}
  
@@ -208,32 +208,37 @@ public:
   virtual void from_mstream(mootio::mistream *mistreamp) {
     TokenReader::from_mstream(mistreamp);
     mootExpatParser::from_mstream(tr_istream,false);
-    done = 0;
+    reset();
   };
   virtual void from_mstream(mootio::mistream &mis) {
     TokenReader::from_mstream(mis);
     mootExpatParser::from_mstream(tr_istream,false);
-    done = 0;
+    reset();
   };
   virtual void from_filename(const char *filename) {
     TokenReader::from_filename(filename);
     mootExpatParser::from_mstream(tr_istream,false);
+    reset();
   };
   virtual void from_file(FILE *infile) {
     TokenReader::from_file(infile);
     mootExpatParser::from_mstream(tr_istream,false);
+    reset();
   };
   virtual void from_fd(int fd) {
     TokenReader::from_fd(fd);
     mootExpatParser::from_mstream(tr_istream,false);
+    reset();
   };
   virtual void from_buffer(const void *buf, size_t len) {
     TokenReader::from_buffer(buf,len);
     mootExpatParser::from_mstream(tr_istream,false);
+    reset();
   };
   virtual void from_cxxstream(std::istream &is) {
     TokenReader::from_cxxstream(is);
     mootExpatParser::from_mstream(tr_istream,false);
+    reset();
   };
   //@}
 
@@ -419,7 +424,10 @@ public:
    * tokens of type TokTypeXMLRaw for all document content except
    * the following:
    *
-   * \li sentence boundary markers (TokTypeEOS)
+   * \li sentence boundary markers (TokTypeEOS), whose text (if any) is
+   *     written verbatim: TokenReaderExpat stores the raw boundary markup
+   *     there (resp. in a preceding TokTypeXMLRaw token), so no boundary
+   *     element is generated
    * \li 'vanilla' tokens (TokTypeVanilla)
    *     In 'use_raw_xml' mode, only the 'besttag' element will be written for
    *     'vanilla' tokens -- in other words, TokTypeXMLRaw tokens are expected
@@ -32,10 +32,16 @@
 #include <mootUtils.h>
 #include <assert.h>
 
+#include <mootTokenBinIO.h>
+
 #ifdef MOOT_LIBXML_ENABLED
 # include <mootTokenXmlDoc.h>
 #endif /* MOOT_LIBXML_ENABLED */
 
+#ifdef MOOT_PTHREADS_ENABLED
+# include <pthread.h>
+#endif
+
 #ifdef MOOT_EXPAT_ENABLED
 # include <mootTokenExpatIO.h>
 #endif /* MOOT_EXPAT_ENABLED */
@@ -84,6 +90,7 @@ int TokenIO::parse_format_string(const std::string &fmtString)
       else if (s=="unknown") flag = tiofUnknown;
       else if (s=="native") flag = tiofNative;
       else if (s=="xml") flag = tiofXML;
+      else if (s=="binary" || s=="bin") flag = tiofBinary;
       //else if (s=="expat") flag = tiofExpat;
       else if (s=="conserve") flag = tiofConserve;
       else if (s=="pretty") flag = tiofPretty;
@@ -147,6 +154,9 @@ int TokenIO::guess_filename_format(const char *filename)
 
       else if (*exti == "xml" ) flags |= tiofXML;
       else if (*exti == "moot") flags |= tiofNative;
+      else if (*exti == "mtb" ) flags |= tiofBinary;
+      else if (*exti == "gz"  ) continue; //-- compressed: check next extension
+      else if (*exti == "mbz" ) continue; //-- block-indexed compressed: check next extension
 
       else {
 	//-- unknown extension - break off search
@@ -178,8 +188,9 @@ int TokenIO::sanitize_format(int fmt, int fmt_implied, int fmt_default)
   if (is_empty_format(san)) san |= fmt_default;
 
   //-- select only one basic format
-  if      (fmt & tiofXML)    san &= ~tiofNative;
-  else if (fmt & tiofNative) san &= ~tiofXML;
+  if      (fmt & tiofXML)    san &= ~(tiofNative|tiofBinary);
+  else if (fmt & tiofBinary) san &= ~(tiofNative|tiofXML);
+  else if (fmt & tiofNative) san &= ~(tiofXML|tiofBinary);
   else if (!(fmt&tiofUser))  san |= tiofNative;
 
   //-- and return
@@ -214,6 +225,7 @@ std::string TokenIO::format_canonical_string(int fmt)
   if (fmt & tiofNull) s.append("Null,");
   if (fmt & tiofNative) s.append("Native,");
   if (fmt & tiofXML) s.append("XML,");
+  if (fmt & tiofBinary) s.append("Binary,");
   //if (fmt & tiofExpat) s.append("Expat,");
   if (fmt & tiofConserve) s.append("Conserve,");
   if (fmt & tiofPretty) s.append("Pretty,");
@@ -242,6 +254,7 @@ class TokenReader *TokenIO::new_reader(int fmt)
 {
   //-- format dispatch
   if      (fmt & tiofNative) { return new TokenReaderNative(fmt); }
+  else if (fmt & tiofBinary) { return new TokenReaderBinary(fmt); }
 
   //else if (fmt & (tiofExpat|tiofXML)) {
 else if (fmt & tiofXML) {
@@ -272,6 +285,12 @@ class TokenWriter *TokenIO::new_writer(int fmt)
     {
       return new TokenWriterNative(fmt);
     }
+
+  //-- binary output
+  else if (fmt & tiofBinary)
+    {
+      return new TokenWriterBinary(fmt);
+    }
   
   //-- XML output
   //else if (fmt & (tiofXML|tiofExpat)) {
@@ -416,13 +435,39 @@ void TokenReaderNative::from_mstream(mootio::mistream *mis)
 }
 
 
+/*------------------------------------------------------------
+ * Reader : Native : Lexer lock
+ *  + the flex++ scanner keeps its backtracking state (yy_state_buf, yy_full_match, ...)
+ *    in file-scope variables shared by all mootTokenLexer instances
+ */
+#ifdef MOOT_PTHREADS_ENABLED
+static pthread_mutex_t native_lexer_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+static inline void native_lexer_lock(void)
+{
+#ifdef MOOT_PTHREADS_ENABLED
+  pthread_mutex_lock(&native_lexer_mutex);
+#endif
+}
+
+static inline void native_lexer_unlock(void)
+{
+#ifdef MOOT_PTHREADS_ENABLED
+  pthread_mutex_unlock(&native_lexer_mutex);
+#endif
+}
+
 /*------------------------------------------------------------
  * Reader : Native : Methods : get_token()
  */
 mootTokenType TokenReaderNative::get_token(void)
 {
   tr_token = lexer.mtoken = &(lexer.mtoken_default); //-- grab to lexer-internal token
-  return static_cast<mootTokenType>(lexer.yylex());
+  native_lexer_lock();
+  int lxtyp = lexer.yylex();
+  native_lexer_unlock();
+  return static_cast<mootTokenType>(lxtyp);
 };
 
 /*------------------------------------------------------------
@@ -433,12 +478,14 @@ mootTokenType TokenReaderNative::get_sentence(void)
   if (!tr_sentence) tr_sentence = &trn_sentence;
   int lxtyp = TokTypeUnknown;
   tr_sentence->clear();
+  native_lexer_lock();
   while (lxtyp != TokTypeEOS && lxtyp != TokTypeEOF) {
     //-- allocate new destination token
     tr_sentence->push_back(mootToken());
     lexer.mtoken = &(tr_sentence->back());
     lxtyp = lexer.yylex();
   }
+  native_lexer_unlock();
   tr_sentence->pop_back();
   return static_cast<mootTokenType>(lxtyp);
 };
@@ -36,6 +36,7 @@
 
 #include <mootTokenLexer.h> //-- includes GenericLexer -> BufferIO -> Utils -> CIO -> IO
 #include <mootCxxIO.h>
+#include <mootZBlockIO.h>
 
 #include <stdexcept>
 
@@ -63,7 +64,8 @@ enum TokenIOFormatE {
   tiofCost      = 0x00001000,  ///< parse/output analysis 'prob' field
   tiofTrace     = 0x00002000,  ///< save full Viterbi trellis trace?
   tiofPredict   = 0x00004000,  ///< include Viterbi trellis predictions in trace?
-  tiofFlush     = 0x00008000   ///< autoflush output stream after write (native i/o only)?
+  tiofFlush     = 0x00008000,  ///< autoflush output stream after write (native and binary i/o only)?
+  tiofBinary    = 0x00010000   ///< parse-free binary format (see mootTokenBinIO.h)
 };
 typedef TokenIOFormatE TokenIOFormat;
 
@@ -322,7 +324,11 @@ public:
    */
   virtual void from_filename(const char *filename)
   {
-    this->from_mstream(new mootio::mifstream(filename,"rb"));
+    const char *ext = moot_extension(filename);
+    if (ext && (strcmp(ext,".gz")==0 || strcmp(ext,".mbz")==0))
+      this->from_mstream(new mootio::mizbstream(filename,"rb"));
+    else
+      this->from_mstream(new mootio::mifstream(filename,"rb"));
     tr_istream_created = true;
     if (!tr_istream || !tr_istream->valid()) {
       this->carp("open failed for \"%s\": %s", filename, strerror(errno));
@@ -493,6 +499,10 @@ public:
 
 /**
  * \brief Class for native "cooked" text-format token input.
+ *
+ * The underlying flex++ scanner keeps part of its state in file-scope
+ * variables, so calls to get_token() and get_sentence() are serialized
+ * across all instances if POSIX threads support is enabled.
  */
 class TokenReaderNative : public TokenReader {
 public:
@@ -765,7 +775,13 @@ public:
    */
   virtual void to_filename(const char *filename)
   {
-    this->to_mstream(new mootio::mofstream(filename,"wb"));
+    const char *ext = moot_extension(filename);
+    if (ext && strcmp(ext,".gz")==0)
+      this->to_mstream(new mootio::mozbstream(filename,"wb"));
+    else if (ext && strcmp(ext,".mbz")==0)
+      this->to_mstream(new mootio::mozblockstream(filename,"wb"));
+    else
+      this->to_mstream(new mootio::mofstream(filename,"wb"));
     tw_ostream_created = true;
     if (!tw_ostream || !tw_ostream->valid()) {
       this->carp("open failed for \"%s\": %s", filename, strerror(errno));
@@ -277,6 +277,33 @@ std::string std_ssprintf(const char *fmt, ...)
 }
 
 
+/*--------------------------------------------------------------------
+ * Checksum Utilities
+ *---------------------------------------------------------------------*/
+
+/** CRC-32 lookup table for the reflected polynomial 0xedb88320 */
+struct mootCrc32Table {
+  unsigned int tab[256];
+  mootCrc32Table(void) {
+    for (unsigned int i=0; i < 256; ++i) {
+      unsigned int c = i;
+      for (int k=0; k < 8; ++k)
+	c = (c & 1) ? (0xedb88320U ^ (c >> 1)) : (c >> 1);
+      tab[i] = c;
+    }
+  };
+};
+static const mootCrc32Table moot_crc32_table;
+
+unsigned int moot_crc32(const void *buf, size_t len, unsigned int crc)
+{
+  const unsigned char *p = reinterpret_cast<const unsigned char *>(buf);
+  crc = ~crc;
+  while (len-- > 0)
+    crc = moot_crc32_table.tab[(crc ^ *p++) & 0xff] ^ (crc >> 8);
+  return ~crc;
+}
+
 /*--------------------------------------------------------------------
  * Named File Utilities
  *---------------------------------------------------------------------*/
@@ -350,10 +377,20 @@ FILE *cmdutil_file_churner::first_input_file() {
  * in = cmdutil_file_churner::next_input_file();
  */
 FILE *cmdutil_file_churner::next_input_file() {
+  if (in.file && !check_input(input(), in.name)) ++nerrors;
   do {
+#ifdef MOOT_ZLIB_ENABLED
+    zin.close();
+#endif
     in.close();
     if (next_input_name().empty()) return NULL;
-    if (in.reopen()) return in.file;
+    if (in.reopen()) {
+#ifdef MOOT_ZLIB_ENABLED
+      const char *ext = moot_extension(in.name.c_str());
+      if (ext && (strcmp(ext,".gz")==0 || strcmp(ext,".mbz")==0)) zin.from_file(in.file);
+#endif
+      return in.file;
+    }
     //-- open error
     fprintf(stderr, "%s: open failed for input-file '%s': %s%s\n",
 	    progname, in.name.c_str(), strerror(errno),
@@ -364,6 +401,26 @@ FILE *cmdutil_file_churner::next_input_file() {
 }
 
 
+/*
+ * mis = cmdutil_file_churner::input();
+ */
+mootio::mistream *cmdutil_file_churner::input(void) {
+#ifdef MOOT_ZLIB_ENABLED
+  if (zin.file) return &zin;
+#endif
+  return &in;
+}
+
+/*
+ * ok = cmdutil_file_churner::check_input(mis, name);
+ */
+bool cmdutil_file_churner::check_input(mootio::mistream *mis, const std::string &name) {
+  if (mis->valid()) return true;
+  moot_msg(verbose, vlErrors, "%s: error reading input-file '%s': %s\n",
+	   progname, name.c_str(), mis->errmsg().c_str());
+  return false;
+}
+
 /*
  * name = cmdutil_file_churner::first_input_name();
  *   + get first input name
@@ -420,6 +477,9 @@ std::string &cmdutil_file_churner::first_input_name() {
  * in = cmdutil_file_churner::next_input_name();
  */
 std::string &cmdutil_file_churner::next_input_name() {
+#ifdef MOOT_ZLIB_ENABLED
+  zin.close();
+#endif
   in.close();
   if (use_list) {
     //-- list mode: read next input-filename from list-file
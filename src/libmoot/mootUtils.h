@@ -34,6 +34,7 @@
 #define _moot_UTILS_H
 
 #include <mootCIO.h>
+#include <mootZIO.h>
 
 #include <list>
 #include <vector>
@@ -252,6 +253,16 @@ namespace moot {
   std::string std_ssprintf(const char *fmt, ...);
   //@}
 
+  /*----------------------------------------------------------------------*/
+  /** \name Checksum Utilities */
+  //@{
+  /**
+   * Update a CRC-32 checksum (as used by gzip and zlib's crc32()) with \p len bytes
+   * from \p buf.  The initial checksum value is 0.
+   */
+  unsigned int moot_crc32(const void *buf, size_t len, unsigned int crc=0);
+  //@}
+
   /*----------------------------------------------------------------------*/
   /** \name Named File Utilities */
   //@{
@@ -295,9 +306,16 @@ namespace moot {
     // -- operation flags
     bool use_list;        /**< Whether inputs are filenames or list-filenames */
     bool paranoid;        /**< Whether to abort() for unreadable files */
+    int  verbose;         /**< Verbosity level for read error messages (see check_input()) */
+
+    // -- status data
+    size_t nerrors;       /**< Number of input files for which a read error was reported (by next_input_file() or cmdutil_file_pool) */
 
     // -- file data
     mifstream           in;    /**< Current real input file, wrapped */
+#ifdef MOOT_ZLIB_ENABLED
+    mizbstream          zin;   /**< Decompressing wrapper for \a in, used for gzip-compressed (*.gz, *.mbz) input files */
+#endif
     mifstream           list;  /**< Current list input file, if in list-mode */
 
     // -- buffer data
@@ -318,6 +336,8 @@ namespace moot {
 	ninputs(my_ninputs),
 	use_list(my_use_list),
 	paranoid(my_paranoid),
+	verbose(1),
+	nerrors(0),
 	is_first_input(true)
     {};
 
@@ -340,6 +360,17 @@ namespace moot {
     /** Step the the next input file, without opening it */
     std::string &next_input_name();
 
+    /** Get current input stream: \a zin for gzip-compressed (*.gz, *.mbz) files, otherwise \a in */
+    mootio::mistream *input(void);
+
+    /**
+     * Check input stream \a mis for read errors (e.g. truncated gzip data)
+     * once it has been read, reporting any error for input file \a name.
+     * Returns true if no error occurred.  Called by next_input_file() for
+     * the current input file; does not itself count errors in \a nerrors.
+     */
+    bool check_input(mootio::mistream *mis, const std::string &name);
+
   private:
     /** Step the the next input-list filename (list mode): returns NULL if no input files are left */
     FILE *next_list_file();
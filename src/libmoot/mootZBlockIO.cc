@@ -0,0 +1,459 @@
+/* -*- Mode: C++ -*- */
+
+/*
+   libmoot : moocow's part-of-speech tagging library
+   Copyright (C) 2004-2010 by Bryan Jurish <moocow@cpan.org>
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 3 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+/*--------------------------------------------------------------------------
+ * File: mootZBlockIO.cc
+ * Author: Bryan Jurish <moocow@cpan.org>
+ * Description:
+ *   + moot PoS tagger : block-indexed compressed token files
+ *--------------------------------------------------------------------------*/
+
+#include <mootConfig.h>
+#include <mootZBlockIO.h>
+
+#ifdef MOOT_ZLIB_ENABLED
+
+#include <algorithm>
+#include <unistd.h>
+#include <errno.h>
+
+namespace mootio {
+
+/*======================================================================
+ * local utilities
+ */
+
+/** Maximum number of index entries per index member (XLEN is 16 bits) */
+#define MOOT_ZBLOCK_ENTRIES_PER_MEMBER 2000
+
+//----------------------------------------------------------------------
+static void zb_put_u64(std::string &s, unsigned long long u)
+{
+  for (int i=0; i < 8; ++i, u >>= 8)
+    s.push_back(static_cast<char>(u & 0xff));
+}
+
+//----------------------------------------------------------------------
+static unsigned long long zb_get_u64(const unsigned char *p)
+{
+  unsigned long long u = 0;
+  for (int i=7; i >= 0; --i)
+    u = (u << 8) | p[i];
+  return u;
+}
+
+//----------------------------------------------------------------------
+static inline unsigned zb_get_u16(const unsigned char *p)
+{
+  return p[0] | (static_cast<unsigned>(p[1]) << 8);
+}
+
+//----------------------------------------------------------------------
+/** pread() exactly \a n bytes at offset \a off */
+static bool zb_pread(int fd, char *buf, size_t n, off_t off)
+{
+  while (n > 0) {
+    ssize_t nr = pread(fd, buf, n, off);
+    if (nr < 0 && errno == EINTR) continue;
+    if (nr <= 0) return false;
+    buf += nr;
+    n   -= nr;
+    off += nr;
+  }
+  return true;
+}
+
+/*======================================================================
+ * mozblockstream
+ */
+
+//----------------------------------------------------------------------
+void mozblockstream::_init_blocks(void)
+{
+  zb_index.clear();
+  zb_nindexed      = 0;
+  zb_zoffset       = 0;
+  zb_offset        = 0;
+  zb_nsents        = 0;
+  zb_scanpos       = 0;
+  zb_scan          = mootZBlockScanState();
+}
+
+//----------------------------------------------------------------------
+size_t mozblockstream::boundary(void) const
+{
+  size_t n = zb_cur.size();
+  if (n < zb_blocksize) return 0;
+
+  const char *s = zb_cur.data();
+  size_t i = std::max(zb_scanpos, zb_blocksize-1);
+  for ( ; i < n; ++i) {
+    if (s[i] != '\n') continue;
+
+    //-- check whether the line ending at i is blank
+    size_t j = i;
+    while (j > 0 && (s[j-1]==' ' || s[j-1]=='\t' || s[j-1]=='\r' || s[j-1]=='\f' || s[j-1]=='\v'))
+      --j;
+    if (j > 0 ? s[j-1]=='\n' : !zb_scan.line_nonblank)
+      return i+1;
+  }
+  const_cast<mozblockstream*>(this)->zb_scanpos = n;
+
+  size_t maxsize = zb_max_blocksize ? zb_max_blocksize : 4*zb_blocksize;
+  if (n < maxsize) return 0;
+
+  //-- no blank line: cut after the last newline, if any
+  size_t nl = zb_cur.rfind('\n');
+  return nl != std::string::npos && nl+1 >= zb_blocksize ? nl+1 : n;
+}
+
+//----------------------------------------------------------------------
+bool mozblockstream::submit_block(size_t n)
+{
+  std::string rest(zb_cur, n);
+  zb_cur.resize(n);
+
+  Entry e;
+  e.zoffset = 0;
+  e.offset  = zb_offset;
+  e.first   = zb_nsents;
+  e.state   = zb_scan.to_ulong();
+  zb_index.push_back(e);
+
+  zb_offset += n;
+  zb_nsents += zb_scan.count(zb_cur.data(), n);
+  zb_scanpos = 0;
+
+  bool rc = submit();
+  zb_cur.swap(rest);
+  return rc;
+}
+
+//----------------------------------------------------------------------
+void mozblockstream::written(size_t nbytes)
+{
+  if (zb_nindexed < zb_index.size())
+    zb_index[zb_nindexed++].zoffset = zb_zoffset;
+  zb_zoffset += nbytes;
+}
+
+//----------------------------------------------------------------------
+bool mozblockstream::write(const char *buf, size_t n)
+{
+  if (!file) return false;
+  zb_cur.append(buf, n);
+  for (size_t len; (len = boundary()) > 0; ) {
+    if (!submit_block(len)) return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------
+bool mozblockstream::flush(void)
+{
+  if (!file) return false;
+  bool rc = true;
+  if (!zb_cur.empty()) rc = submit_block(zb_cur.size());
+  return mozbstream::flush() && rc;
+}
+
+//----------------------------------------------------------------------
+bool mozblockstream::write_extra_member(char si1, char si2, const std::string &data)
+{
+  std::string m("\x1f\x8b\x08\x04\0\0\0\0\0\xff", 10);
+  size_t xlen = data.size() + 4;
+  m.push_back(static_cast<char>(xlen & 0xff));
+  m.push_back(static_cast<char>(xlen >> 8));
+  m.push_back(si1);
+  m.push_back(si2);
+  m.push_back(static_cast<char>(data.size() & 0xff));
+  m.push_back(static_cast<char>(data.size() >> 8));
+  m.append(data);
+  m.append("\x03\0\0\0\0\0\0\0\0\0", 10); //-- empty final deflate block, crc32, isize
+
+  if (fwrite(m.data(), 1, m.size(), file) != m.size()) {
+    zb_error = strerror(errno);
+    return false;
+  }
+  zb_zoffset += m.size();
+  zb_written  = true;
+  return true;
+}
+
+//----------------------------------------------------------------------
+bool mozblockstream::close(void)
+{
+  if (!file) return true;
+  bool rc = flush();
+
+  //-- index: one entry per block, plus a sentinel for the end of the data
+  Entry e;
+  e.zoffset = zb_zoffset;
+  e.offset  = zb_offset;
+  e.first   = zb_nsents;
+  e.state   = zb_scan.to_ulong();
+  zb_index.push_back(e);
+
+  ByteOffset ioffset = zb_zoffset;
+  std::string data;
+  for (size_t i=0; rc && i < zb_index.size(); ++i) {
+    zb_put_u64(data, zb_index[i].zoffset);
+    zb_put_u64(data, zb_index[i].offset);
+    zb_put_u64(data, zb_index[i].first);
+    zb_put_u64(data, zb_index[i].state);
+    if ((i+1) % MOOT_ZBLOCK_ENTRIES_PER_MEMBER == 0 || i+1 == zb_index.size()) {
+      rc = write_extra_member('M','I',data);
+      data.clear();
+    }
+  }
+
+  //-- trailer
+  if (rc) {
+    zb_put_u64(data, ioffset);
+    zb_put_u64(data, zb_index.size());
+    rc = write_extra_member('M','T',data);
+  }
+
+  rc = mozbstream::close() && rc;
+  _init_blocks();
+  return rc;
+}
+
+/*======================================================================
+ * mizblockstream
+ */
+
+//----------------------------------------------------------------------
+bool mizblockstream::open(const char *filename)
+{
+  close();
+  name = filename;
+  file = fopen(filename, "rb");
+  if (!file) {
+    zb_error = strerror(errno);
+    return false;
+  }
+  created = true;
+  return read_index();
+}
+
+//----------------------------------------------------------------------
+bool mizblockstream::from_file(FILE *f)
+{
+  close();
+  file = f;
+  if (!file) return false;
+  return read_index();
+}
+
+//----------------------------------------------------------------------
+bool mizblockstream::close(void)
+{
+  bool rc = true;
+  if (file && created) rc = (fclose(file) == 0);
+  file    = NULL;
+  created = false;
+  index.clear();
+  zb_cur.clear();
+  zb_pos   = 0;
+  zb_block = 0;
+  zb_error.clear();
+  return rc;
+}
+
+//----------------------------------------------------------------------
+bool mizblockstream::read_index(void)
+{
+  int fd = fileno(file);
+  off_t fsize = lseek(fd, 0, SEEK_END);
+  unsigned char tr[MOOT_ZBLOCK_TRAILER_SIZE];
+  if (fsize < MOOT_ZBLOCK_TRAILER_SIZE
+      || !zb_pread(fd, reinterpret_cast<char*>(tr), MOOT_ZBLOCK_TRAILER_SIZE, fsize-MOOT_ZBLOCK_TRAILER_SIZE)
+      || memcmp(tr, "\x1f\x8b\x08\x04", 4) != 0
+      || zb_get_u16(tr+10) != 20
+      || tr[12] != 'M' || tr[13] != 'T'
+      || zb_get_u16(tr+14) != 16)
+    {
+      zb_error = "no block index found";
+      return false;
+    }
+  off_t  ioffset  = zb_get_u64(tr+16);
+  size_t nentries = zb_get_u64(tr+24);
+  off_t  iend     = fsize - MOOT_ZBLOCK_TRAILER_SIZE;
+  if (ioffset > iend || nentries == 0) {
+    zb_error = "corrupt block index";
+    return false;
+  }
+
+  //-- parse index members
+  std::string ibuf(iend-ioffset, '\0');
+  if (!ibuf.empty() && !zb_pread(fd, &ibuf[0], ibuf.size(), ioffset)) {
+    zb_error = "could not read block index";
+    return false;
+  }
+  const unsigned char *p   = reinterpret_cast<const unsigned char*>(ibuf.data());
+  const unsigned char *end = p + ibuf.size();
+  index.reserve(nentries);
+  while (p < end) {
+    if (end-p < 12 || memcmp(p, "\x1f\x8b\x08\x04", 4) != 0) break;
+    size_t xlen = zb_get_u16(p+10);
+    if (static_cast<size_t>(end-p) < 12+xlen+10) break;
+    for (const unsigned char *x=p+12, *xend=x+xlen; x+4 <= xend; ) {
+      size_t slen = zb_get_u16(x+2);
+      if (x+4+slen > xend) break;
+      if (x[0]=='M' && x[1]=='I') {
+	for (const unsigned char *e=x+4; e+32 <= x+4+slen; e += 32) {
+	  Entry ent;
+	  ent.zoffset = zb_get_u64(e);
+	  ent.offset  = zb_get_u64(e+8);
+	  ent.first   = zb_get_u64(e+16);
+	  ent.state   = zb_get_u64(e+24);
+	  index.push_back(ent);
+	}
+      }
+      x += 4+slen;
+    }
+    p += 12+xlen+10;
+  }
+  if (p != end || index.size() != nentries || index.back().zoffset != static_cast<ByteOffset>(ioffset)) {
+    index.clear();
+    zb_error = "corrupt block index";
+    return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------
+size_t mizblockstream::sentence_block(size_t n) const
+{
+  if (n >= nsentences()) return nblocks();
+  size_t lo=0, hi=nblocks();
+  //-- find last block i with index[i].first <= n
+  while (hi-lo > 1) {
+    size_t mid = lo + (hi-lo)/2;
+    if (index[mid].first <= n) lo = mid;
+    else hi = mid;
+  }
+  return lo;
+}
+
+//----------------------------------------------------------------------
+bool mizblockstream::read_block(size_t i, std::string &out) const
+{
+  out.clear();
+  if (!file || i >= nblocks()) return false;
+  const Entry &b = index[i], &e = index[i+1];
+  if (e.zoffset < b.zoffset || e.offset < b.offset) return false;
+
+  std::string zbuf(e.zoffset - b.zoffset, '\0');
+  if (!zbuf.empty() && !zb_pread(fileno(file), &zbuf[0], zbuf.size(), b.zoffset))
+    return false;
+
+  z_stream zs;
+  memset(&zs, 0, sizeof(zs));
+  if (inflateInit2(&zs, 15+16) != Z_OK) return false;
+
+  size_t usize = e.offset - b.offset;
+  out.resize(usize+1);
+  zs.next_in   = reinterpret_cast<Bytef*>(const_cast<char*>(zbuf.data()));
+  zs.avail_in  = zbuf.size();
+  zs.next_out  = reinterpret_cast<Bytef*>(&out[0]);
+  zs.avail_out = out.size();
+
+  int rc = inflate(&zs, Z_FINISH);
+  bool ok = (rc == Z_STREAM_END && zs.total_out == usize);
+  inflateEnd(&zs);
+  out.resize(ok ? usize : 0);
+  return ok;
+}
+
+//----------------------------------------------------------------------
+bool mizblockstream::seek_block(size_t i)
+{
+  if (!file) return false;
+  zb_cur.clear();
+  zb_pos   = 0;
+  zb_block = std::min(i, nblocks());
+  return i <= nblocks();
+}
+
+//----------------------------------------------------------------------
+bool mizblockstream::seek_sentence(size_t n)
+{
+  if (!file) return false;
+  if (n >= nsentences()) {
+    seek_block(nblocks());
+    return n == nsentences();
+  }
+
+  size_t b = sentence_block(n);
+  if (!seek_block(b) || !underflow()) return false;
+
+  //-- scan for the start of the (n-index[b].first)-th sentence in this block
+  mootZBlockScanState scan(index[b].state);
+  size_t want = n - index[b].first;
+  const char *s = zb_cur.data();
+  for (size_t i=0; i < zb_cur.size(); ++i) {
+    if (!scan.step(s[i])) continue;
+    if (want-- > 0) continue;
+    while (i > 0 && s[i-1] != '\n') --i;
+    zb_pos = i;
+    return true;
+  }
+  zb_error = "corrupt block index";
+  return false;
+}
+
+//----------------------------------------------------------------------
+bool mizblockstream::underflow(void)
+{
+  zb_cur.clear();
+  zb_pos = 0;
+  while (zb_cur.empty()) {
+    if (!file || zb_block >= nblocks()) return false;
+    if (!read_block(zb_block, zb_cur)) {
+      zb_error = "could not decompress block";
+      zb_block = nblocks();
+      return false;
+    }
+    ++zb_block;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------
+ByteCount mizblockstream::read(char *buf, size_t n)
+{
+  size_t nread = 0;
+  while (nread < n) {
+    if (zb_pos >= zb_cur.size() && !underflow()) break;
+    size_t len = zb_cur.size() - zb_pos;
+    if (len > n-nread) len = n-nread;
+    memcpy(buf+nread, zb_cur.data()+zb_pos, len);
+    zb_pos += len;
+    nread  += len;
+  }
+  return static_cast<ByteCount>(nread);
+}
+
+}; //-- /namespace mootio
+
+#endif /* MOOT_ZLIB_ENABLED */
@@ -0,0 +1,320 @@
+/* -*- Mode: C++ -*- */
+
+/*
+   libmoot : moocow's part-of-speech tagging library
+   Copyright (C) 2004-2010 by Bryan Jurish <moocow@cpan.org>
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 3 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+/*--------------------------------------------------------------------------
+ * File: mootZBlockIO.h
+ * Author: Bryan Jurish <moocow@cpan.org>
+ * Description:
+ *   + moot PoS tagger : block-indexed compressed token files
+ *--------------------------------------------------------------------------*/
+
+/** \file mootZBlockIO.h
+ *  \brief ::mootio I/O layer for block-indexed compressed token files (*.mbz)
+ *
+ * A block-indexed token file is a gzip-compatible file consisting of
+ * independently compressed gzip members ("blocks"), each of which ends at a
+ * sentence boundary (a blank line in native format), followed by a block index.
+ * The index is stored in the FEXTRA header fields of empty gzip members, so
+ * \c zcat and mootio::mizbstream read such a file as the plain token file.
+ *
+ * \verbatim
+ FILE    := BLOCK* INDEX+ TRAILER
+ BLOCK   := gzip member                        ; compressed data
+ INDEX   := empty gzip member, FEXTRA subfield "MI": ENTRY*
+ TRAILER := empty gzip member, FEXTRA subfield "MT": u64(index_offset) u64(n_entries)
+ ENTRY   := u64(zoffset) u64(offset) u64(first_sentence) u64(state)
+ \endverbatim
+ *
+ * All integers are little-endian.  The index holds one ENTRY per block plus a final
+ * sentinel ENTRY describing the end of the data.  \a zoffset is the file offset of
+ * the block, \a offset its offset in the uncompressed data, \a first_sentence the
+ * number of sentences starting before the block, and \a state the sentence scanner
+ * state at the start of the block (see mootZBlockScanState), which is non-zero only
+ * for blocks not starting at a sentence boundary.  The TRAILER member has a fixed
+ * size of MOOT_ZBLOCK_TRAILER_SIZE bytes.
+ *
+ * A "sentence" is a maximal run of lines which do not consist solely of whitespace.
+ */
+
+#ifndef _MOOT_ZBLOCK_IO_H
+#define _MOOT_ZBLOCK_IO_H
+
+#include <mootZIO.h>
+
+#ifdef MOOT_ZLIB_ENABLED
+
+namespace mootio {
+
+  /** Size of a block-index trailer member (bytes) */
+#define MOOT_ZBLOCK_TRAILER_SIZE 42
+
+  /*====================================================================
+   * mootZBlockScanState
+   *====================================================================*/
+  /** \brief Sentence boundary scanner state for block-indexed token files */
+  class mootZBlockScanState {
+  public:
+    bool in_sentence;   ///< true if a sentence is open
+    bool line_nonblank; ///< true if the current line contains non-whitespace
+
+  public:
+    mootZBlockScanState(unsigned long state=0)
+      : in_sentence(state & 1), line_nonblank(state & 2)
+    {};
+
+    /** Get state as an integer (for the block index) */
+    inline unsigned long to_ulong(void) const
+    { return (in_sentence ? 1 : 0) | (line_nonblank ? 2 : 0); };
+
+    /** Update state for character \a c, returns true iff \a c starts a new sentence */
+    inline bool step(char c)
+    {
+      if (c == '\n') {
+	if (!line_nonblank) in_sentence = false;
+	line_nonblank = false;
+	return false;
+      }
+      if (c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v') return false;
+      line_nonblank = true;
+      if (in_sentence) return false;
+      in_sentence = true;
+      return true;
+    };
+
+    /** Count sentence starts in \a buf[0..n-1] */
+    inline size_t count(const char *buf, size_t n)
+    {
+      size_t nsents = 0;
+      for (size_t i=0; i < n; ++i)
+	if (step(buf[i])) ++nsents;
+      return nsents;
+    };
+  };
+
+  /*====================================================================
+   * mozblockstream : block-indexed compressed output
+   *====================================================================*/
+  /** \brief Output stream for block-indexed compressed token files.
+   *
+   * Like mootio::mozbstream (blocks are compressed in parallel), but each block
+   * is an independent gzip member, blocks
+   * end at the first blank line after \a zb_blocksize bytes if any occurs
+   * within \a zb_max_blocksize bytes, and a block index is written by close().
+   * The output file must be seekable for random access, but not for writing.
+   * Calling flush() ends the current block even within a sentence.
+   */
+  class mozblockstream : public mozbstream {
+  public:
+    /** \brief Block index entry */
+    struct Entry {
+      ByteOffset    zoffset;  ///< offset of compressed block in file
+      ByteOffset    offset;   ///< offset of block in uncompressed data
+      size_t        first;    ///< number of sentences starting before this block
+      unsigned long state;    ///< scanner state at start of block (mootZBlockScanState::to_ulong())
+    };
+
+  public:
+    size_t              zb_max_blocksize; ///< maximum block size (bytes; 0: 4*zb_blocksize)
+
+  protected:
+    std::vector<Entry>  zb_index;   ///< index entries (zoffset is set when the block is written)
+    size_t              zb_nindexed;///< number of index entries with valid zoffset
+    ByteOffset          zb_zoffset; ///< number of compressed bytes written
+    ByteOffset          zb_offset;  ///< number of uncompressed bytes submitted
+    size_t              zb_nsents;  ///< number of sentence starts submitted
+    size_t              zb_scanpos; ///< position in \a zb_cur from which boundary() continues searching
+    mootZBlockScanState zb_scan;    ///< scanner state after submitted data
+
+  public:
+    ///\name Constructors etc.
+    //@{
+    /** Default constructor */
+    mozblockstream(void) : zb_max_blocksize(0) {
+      zb_blocksize = 1<<18;
+      zb_members   = true;
+      _init_blocks();
+    };
+
+    /** Constructor given filename and mode (as for gzopen(), e.g. "wb9") */
+    mozblockstream(const char *filename, const char *mode=NULL) : zb_max_blocksize(0) {
+      zb_blocksize = 1<<18;
+      zb_members   = true;
+      _init_blocks();
+      open(filename,mode);
+    };
+
+    /** Destructor: auto-closes */
+    virtual ~mozblockstream(void) { close(); };
+    //@}
+
+    ///\name Overrides
+    //@{
+    /** Compress and write all pending data, ending the current block */
+    virtual bool flush(void);
+
+    /** Write all pending data and the block index, and close the output */
+    virtual bool close(void);
+
+    /** Write \p n bytes from \p buf to the stream */
+    virtual bool write(const char *buf, size_t n);
+
+    /** Write a single byte to the stream */
+    virtual bool putbyte(unsigned char c) {
+      char ch = static_cast<char>(c);
+      return write(&ch,1);
+    };
+    //@}
+
+  protected:
+    /** Reset block index */
+    void _init_blocks(void);
+
+    /** Get length of next complete block in \a zb_cur (0 if none) */
+    size_t boundary(void) const;
+
+    /** Submit the first \a n bytes of \a zb_cur as a block */
+    bool submit_block(size_t n);
+
+    /** Record file offset of a block written by collect() */
+    virtual void written(size_t nbytes);
+
+    /** Write an empty gzip member with a single FEXTRA subfield \a si1 \a si2 holding \a data */
+    bool write_extra_member(char si1, char si2, const std::string &data);
+  };
+
+  /*====================================================================
+   * mizblockstream : block-indexed compressed input
+   *====================================================================*/
+  /** \brief Random-access input stream for block-indexed compressed token files.
+   *
+   * Reads blocks via pread(), so read_block() may be called concurrently from
+   * several threads (e.g. to decode different blocks in parallel).
+   * The mistream interface reads sequentially from the current position,
+   * which can be set with seek_block() or seek_sentence().
+   */
+  class mizblockstream : virtual public mistream {
+  public:
+    /** \brief Block index entry */
+    typedef mozblockstream::Entry Entry;
+
+  public:
+    FILE               *file;     ///< underlying file
+    bool                created;  ///< whether we opened \a file ourselves
+    std::vector<Entry>  index;    ///< block index (nblocks()+1 entries)
+
+  protected:
+    std::string         zb_cur;   ///< current decompressed block
+    size_t              zb_pos;   ///< read position in \a zb_cur
+    size_t              zb_block; ///< index of next block to decompress
+    std::string         zb_error; ///< error message, if any
+
+  public:
+    ///\name Constructors etc.
+    //@{
+    /** Default constructor */
+    mizblockstream(void) : file(NULL), created(false), zb_pos(0), zb_block(0) {};
+
+    /** Constructor given filename */
+    mizblockstream(const char *filename)
+      : file(NULL), created(false), zb_pos(0), zb_block(0)
+    { open(filename); };
+
+    /** Destructor: auto-closes */
+    virtual ~mizblockstream(void) { close(); };
+    //@}
+
+    ///\name Open/Close
+    //@{
+    /** Open a named block-indexed file; returns false if it cannot be opened or has no valid index */
+    bool open(const char *filename);
+
+    /** Read from an open seekable C stream, which is \b not closed by close() */
+    bool from_file(FILE *f);
+
+    /** Close current input */
+    virtual bool close(void);
+    //@}
+
+    ///\name Integrity Tests
+    //@{
+    virtual bool valid(void) { return file != NULL && zb_error.empty(); };
+    virtual bool eof(void) { return zb_pos >= zb_cur.size() && zb_block >= nblocks(); };
+    virtual std::string errmsg(void) {
+      return (!file && zb_error.empty()) ? std::string("no input file") : zb_error;
+    };
+    //@}
+
+    ///\name Index Access
+    //@{
+    /** Get number of blocks */
+    inline size_t nblocks(void) const { return index.empty() ? 0 : index.size()-1; };
+
+    /** Get total number of sentences */
+    inline size_t nsentences(void) const { return index.empty() ? 0 : index.back().first; };
+
+    /** Get index of the block containing the start of sentence \a n (nblocks() if none) */
+    size_t sentence_block(size_t n) const;
+
+    /** Decompress block \a i into \a out; thread-safe.  Returns false on error. */
+    bool read_block(size_t i, std::string &out) const;
+    //@}
+
+    ///\name Positioning
+    //@{
+    /** Continue reading at the start of block \a i */
+    bool seek_block(size_t i);
+
+    /** Continue reading at the start of sentence \a n (0-based) */
+    bool seek_sentence(size_t n);
+    //@}
+
+    ///\name Input Methods
+    //@{
+    virtual ByteCount read(char *buf, size_t n);
+
+    virtual int getbyte(void) {
+      if (zb_pos < zb_cur.size() || underflow())
+	return static_cast<unsigned char>(zb_cur[zb_pos++]);
+      return EOF;
+    };
+    //@}
+
+  protected:
+    /** Read block index */
+    bool read_index(void);
+
+    /** Decompress next block into \a zb_cur; returns false at eof */
+    bool underflow(void);
+  };
+
+}; //-- /namespace mootio
+
+#else  /* MOOT_ZLIB_ENABLED */
+
+namespace mootio {
+
+  typedef mozbstream mozblockstream;
+
+}; //-- /namespace mootio
+
+#endif /* MOOT_ZLIB_ENABLED */
+
+#endif /* _MOOT_ZBLOCK_IO_H */
@@ -0,0 +1,679 @@
+/* -*- Mode: C++ -*- */
+
+/*
+   libmoot : moocow's part-of-speech tagging library
+   Copyright (C) 2004-2010 by Bryan Jurish <moocow@cpan.org>
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 3 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+/*--------------------------------------------------------------------------
+ * File: mootZIO.cc
+ * Author: Bryan Jurish <moocow@cpan.org>
+ * Description:
+ *   + moot PoS tagger : low-level I/O abstractions for zlib: buffered & threaded streams
+ *--------------------------------------------------------------------------*/
+
+#include <mootConfig.h>
+#include <mootZIO.h>
+
+#ifdef MOOT_ZLIB_ENABLED
+
+#include <unistd.h>
+
+namespace mootio {
+
+/*======================================================================
+ * mizbstream
+ */
+
+//----------------------------------------------------------------------
+void mizbstream::_init(void)
+{
+  file          = NULL;
+  created       = false;
+  zb_bufsize    = 1<<20;
+  zb_nbufs      = 4;
+  zb_threaded   = true;
+  zb_pos        = 0;
+  zb_gzip       = false;
+  zb_zinit      = false;
+  zb_member_end = false;
+  zb_in_eof     = true;
+  zb_inlen      = 0;
+  zb_head       = 0;
+  zb_tail       = 0;
+  zb_done       = true;
+  zb_stop       = false;
+  zb_running    = false;
+#ifdef MOOT_PTHREADS_ENABLED
+  pthread_mutex_init(&zb_mutex, NULL);
+  pthread_cond_init(&zb_cond, NULL);
+#endif
+}
+
+//----------------------------------------------------------------------
+mizbstream::~mizbstream(void)
+{
+  close();
+#ifdef MOOT_PTHREADS_ENABLED
+  pthread_cond_destroy(&zb_cond);
+  pthread_mutex_destroy(&zb_mutex);
+#endif
+}
+
+//----------------------------------------------------------------------
+bool mizbstream::open(const char *filename, const char *mode)
+{
+  close();
+  name = filename;
+  if (name == "-") {
+    file = stdin;
+  } else {
+    file = fopen(filename, mode && *mode ? mode : "rb");
+    if (!file) {
+      zb_error = strerror(errno);
+      return false;
+    }
+    created = true;
+  }
+  return _start();
+}
+
+//----------------------------------------------------------------------
+bool mizbstream::from_file(FILE *f)
+{
+  close();
+  file = f;
+  if (!file) return false;
+  return _start();
+}
+
+//----------------------------------------------------------------------
+bool mizbstream::close(void)
+{
+  bool rc = true;
+#ifdef MOOT_PTHREADS_ENABLED
+  if (zb_running) {
+    pthread_mutex_lock(&zb_mutex);
+    zb_stop = true;
+    pthread_cond_broadcast(&zb_cond);
+    pthread_mutex_unlock(&zb_mutex);
+    pthread_join(zb_thread, NULL);
+    zb_running = false;
+  }
+#endif
+  if (zb_zinit) {
+    inflateEnd(&zb_zs);
+    zb_zinit = false;
+  }
+  if (file && created) rc = (fclose(file) == 0);
+  file    = NULL;
+  created = false;
+  zb_cur.clear();
+  zb_pos  = 0;
+  zb_ring.clear();
+  zb_head = zb_tail = 0;
+  zb_done = true;
+  zb_stop = false;
+  zb_error.clear();
+  return rc;
+}
+
+//----------------------------------------------------------------------
+bool mizbstream::eof(void)
+{
+  if (zb_pos < zb_cur.size()) return false;
+#ifdef MOOT_PTHREADS_ENABLED
+  pthread_mutex_lock(&zb_mutex);
+  bool rc = zb_done && zb_head == zb_tail;
+  pthread_mutex_unlock(&zb_mutex);
+  return rc;
+#else
+  return zb_done;
+#endif
+}
+
+//----------------------------------------------------------------------
+std::string mizbstream::errmsg(void)
+{
+  if (!file) return zb_error.empty() ? std::string("no input file") : zb_error;
+#ifdef MOOT_PTHREADS_ENABLED
+  pthread_mutex_lock(&zb_mutex);
+  std::string msg = zb_error;
+  pthread_mutex_unlock(&zb_mutex);
+  return msg;
+#else
+  return zb_error;
+#endif
+}
+
+//----------------------------------------------------------------------
+void mizbstream::set_error(const char *msg)
+{
+#ifdef MOOT_PTHREADS_ENABLED
+  pthread_mutex_lock(&zb_mutex);
+#endif
+  if (zb_error.empty()) zb_error = msg;
+#ifdef MOOT_PTHREADS_ENABLED
+  pthread_mutex_unlock(&zb_mutex);
+#endif
+}
+
+//----------------------------------------------------------------------
+bool mizbstream::_start(void)
+{
+  //-- sniff input format
+  zb_inbuf.resize(1<<16);
+  zb_inlen  = fread(&zb_inbuf[0], 1, zb_inbuf.size(), file);
+  zb_in_eof = (zb_inlen < zb_inbuf.size());
+  zb_gzip   = (zb_inlen >= 2
+	       && static_cast<unsigned char>(zb_inbuf[0]) == 0x1f
+	       && static_cast<unsigned char>(zb_inbuf[1]) == 0x8b);
+  zb_member_end = false;
+
+  memset(&zb_zs, 0, sizeof(zb_zs));
+  if (zb_gzip) {
+    if (inflateInit2(&zb_zs, 15+16) != Z_OK) {
+      set_error("inflateInit2() failed");
+      return false;
+    }
+    zb_zinit = true;
+  }
+  zb_zs.next_in  = reinterpret_cast<Bytef*>(&zb_inbuf[0]);
+  zb_zs.avail_in = zb_inlen;
+
+  zb_ring.assign(zb_nbufs > 0 ? zb_nbufs : 1, std::string());
+  zb_head = zb_tail = 0;
+  zb_done = false;
+  zb_stop = false;
+
+#ifdef MOOT_PTHREADS_ENABLED
+  if (zb_threaded) {
+    zb_running = (pthread_create(&zb_thread, NULL, _produce_thread, this) == 0);
+  }
+#endif
+  return true;
+}
+
+//----------------------------------------------------------------------
+bool mizbstream::produce(std::string &out)
+{
+  out.resize(zb_bufsize);
+  size_t n = 0;
+
+  while (n < zb_bufsize) {
+    //-- refill raw input
+    size_t avail = zb_zs.avail_in;
+    if (avail == 0) {
+      if (zb_in_eof) break;
+      zb_inlen  = fread(&zb_inbuf[0], 1, zb_inbuf.size(), file);
+      if (zb_inlen == 0) {
+	zb_in_eof = true;
+	if (ferror(file)) set_error(strerror(errno));
+	break;
+      }
+      zb_zs.next_in  = reinterpret_cast<Bytef*>(&zb_inbuf[0]);
+      zb_zs.avail_in = zb_inlen;
+      continue;
+    }
+
+    if (!zb_gzip) {
+      //-- pass-through: copy raw input
+      size_t len = avail < zb_bufsize-n ? avail : zb_bufsize-n;
+      memcpy(&out[n], zb_zs.next_in, len);
+      zb_zs.next_in  += len;
+      zb_zs.avail_in -= len;
+      n += len;
+      continue;
+    }
+
+    if (zb_member_end) {
+      //-- another gzip member, or trailing garbage
+      if (static_cast<unsigned char>(*zb_zs.next_in) != 0x1f) {
+	zb_zs.avail_in = 0;
+	zb_in_eof      = true;
+	break;
+      }
+      inflateReset(&zb_zs);
+      zb_member_end = false;
+    }
+
+    zb_zs.next_out  = reinterpret_cast<Bytef*>(&out[n]);
+    zb_zs.avail_out = zb_bufsize - n;
+    int rc = inflate(&zb_zs, Z_NO_FLUSH);
+    n = zb_bufsize - zb_zs.avail_out;
+    if (rc == Z_STREAM_END) {
+      zb_member_end = true;
+    }
+    else if (rc != Z_OK && !(rc == Z_BUF_ERROR && zb_zs.avail_in == 0)) {
+      set_error(zb_zs.msg ? zb_zs.msg : "inflate() failed");
+      zb_in_eof = true;
+      zb_zs.avail_in = 0;
+      break;
+    }
+  }
+
+  if (zb_gzip && zb_in_eof && zb_zs.avail_in == 0 && !zb_member_end && n < zb_bufsize)
+    set_error("unexpected end of compressed data");
+
+  out.resize(n);
+  return n > 0;
+}
+
+//----------------------------------------------------------------------
+bool mizbstream::underflow(void)
+{
+  zb_cur.clear();
+  zb_pos = 0;
+
+#ifdef MOOT_PTHREADS_ENABLED
+  if (zb_running) {
+    pthread_mutex_lock(&zb_mutex);
+    while (zb_head == zb_tail && !zb_done)
+      pthread_cond_wait(&zb_cond, &zb_mutex);
+    bool got = zb_head != zb_tail;
+    if (got) {
+      zb_cur.swap(zb_ring[zb_head % zb_ring.size()]);
+      ++zb_head;
+      pthread_cond_broadcast(&zb_cond);
+    }
+    pthread_mutex_unlock(&zb_mutex);
+    return got;
+  }
+#endif
+
+  //-- synchronous decompression
+  if (zb_done || !file) return false;
+  if (!produce(zb_cur)) zb_done = true;
+  return !zb_cur.empty();
+}
+
+#ifdef MOOT_PTHREADS_ENABLED
+//----------------------------------------------------------------------
+void *mizbstream::_produce_thread(void *data)
+{
+  mizbstream *zb = reinterpret_cast<mizbstream*>(data);
+  size_t nbufs = zb->zb_ring.size();
+  std::string buf;
+  for (;;) {
+    //-- decompress next block (outside of the lock)
+    bool more = zb->produce(buf);
+
+    pthread_mutex_lock(&zb->zb_mutex);
+    while (zb->zb_tail - zb->zb_head >= nbufs && !zb->zb_stop)
+      pthread_cond_wait(&zb->zb_cond, &zb->zb_mutex);
+    if (more && !zb->zb_stop) {
+      buf.swap(zb->zb_ring[zb->zb_tail % nbufs]);
+      ++zb->zb_tail;
+    }
+    if (!more || zb->zb_stop) zb->zb_done = true;
+    bool done = zb->zb_done;
+    pthread_cond_broadcast(&zb->zb_cond);
+    pthread_mutex_unlock(&zb->zb_mutex);
+
+    if (done) break;
+  }
+  return NULL;
+}
+#endif
+
+//----------------------------------------------------------------------
+ByteCount mizbstream::read(char *buf, size_t n)
+{
+  size_t nread = 0;
+  while (nread < n) {
+    if (zb_pos >= zb_cur.size() && !underflow()) break;
+    size_t len = zb_cur.size() - zb_pos;
+    if (len > n-nread) len = n-nread;
+    memcpy(buf+nread, zb_cur.data()+zb_pos, len);
+    zb_pos += len;
+    nread  += len;
+  }
+  return static_cast<ByteCount>(nread);
+}
+
+/*======================================================================
+ * mozbstream
+ */
+
+//----------------------------------------------------------------------
+void mozbstream::_init(void)
+{
+  file         = NULL;
+  created      = false;
+  zb_level     = Z_DEFAULT_COMPRESSION;
+  zb_strategy  = Z_DEFAULT_STRATEGY;
+  zb_blocksize = 1<<20;
+  zb_nthreads  = 0;
+  zb_next      = 0;
+  zb_members   = false;
+  zb_written   = false;
+  zb_crc       = 0;
+  zb_isize     = 0;
+}
+
+//----------------------------------------------------------------------
+mozbstream::~mozbstream(void)
+{
+  close();
+}
+
+//----------------------------------------------------------------------
+bool mozbstream::open(const char *filename, const char *mode)
+{
+  close();
+  name = filename;
+
+  //-- parse mode: gzopen()-style compression level, fopen() mode otherwise
+  std::string fmode;
+  for (const char *s = (mode && *mode ? mode : "wb"); *s; ++s) {
+    if (*s >= '0' && *s <= '9') zb_level = *s - '0';
+    else fmode.push_back(*s);
+  }
+
+  if (name == "-") {
+    file = stdout;
+  } else {
+    file = fopen(filename, fmode.c_str());
+    if (!file) {
+      zb_error = strerror(errno);
+      return false;
+    }
+    created = true;
+  }
+  _start();
+  return true;
+}
+
+//----------------------------------------------------------------------
+bool mozbstream::to_file(FILE *f)
+{
+  close();
+  file = f;
+  if (!file) return false;
+  _start();
+  return true;
+}
+
+//----------------------------------------------------------------------
+void mozbstream::_start(void)
+{
+  size_t njobs = zb_nthreads;
+#if defined(MOOT_PTHREADS_ENABLED) && defined(_SC_NPROCESSORS_ONLN)
+  if (njobs == 0) {
+    long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+    njobs = ncpus > 0 ? static_cast<size_t>(ncpus) : 1;
+  }
+#endif
+  if (njobs == 0) njobs = 1;
+
+  zb_jobs.assign(njobs, NULL);
+  for (size_t i=0; i < njobs; ++i) {
+    Job *job      = new Job();
+    job->busy     = false;
+    job->pending  = false;
+    job->stop     = false;
+    job->ok       = true;
+    job->threaded = false;
+    job->owner    = this;
+#ifdef MOOT_PTHREADS_ENABLED
+    pthread_mutex_init(&job->mutex, NULL);
+    pthread_cond_init(&job->cond, NULL);
+    //-- if thread creation fails, this job compresses synchronously
+    job->threaded = (pthread_create(&job->thread, NULL, _compress_thread, job) == 0);
+#endif
+    zb_jobs[i] = job;
+  }
+  zb_next    = 0;
+  zb_written = false;
+  zb_crc     = crc32(0L, Z_NULL, 0);
+  zb_isize   = 0;
+  zb_hist.clear();
+  zb_cur.reserve(zb_blocksize);
+}
+
+//----------------------------------------------------------------------
+void mozbstream::_stop(void)
+{
+  for (size_t i=0; i < zb_jobs.size(); ++i) {
+    Job *job = zb_jobs[i];
+    if (!job) continue;
+#ifdef MOOT_PTHREADS_ENABLED
+    if (job->threaded) {
+      pthread_mutex_lock(&job->mutex);
+      job->stop = true;
+      pthread_cond_broadcast(&job->cond);
+      pthread_mutex_unlock(&job->mutex);
+      pthread_join(job->thread, NULL);
+    }
+    pthread_cond_destroy(&job->cond);
+    pthread_mutex_destroy(&job->mutex);
+#endif
+    delete job;
+  }
+  zb_jobs.clear();
+}
+
+//----------------------------------------------------------------------
+bool mozbstream::close(void)
+{
+  if (!file) return true;
+
+  bool rc = flush();
+  if (!zb_members) {
+    //-- single member: final (empty) deflate block and gzip trailer
+    std::string trailer("\x03\0", 2);
+    for (int i=0; i < 32; i += 8) trailer.push_back(static_cast<char>((zb_crc >> i) & 0xff));
+    for (int i=0; i < 32; i += 8) trailer.push_back(static_cast<char>((zb_isize >> i) & 0xff));
+    rc = rc && (zb_written || write_header());
+    if (rc && fwrite(trailer.data(), 1, trailer.size(), file) != trailer.size()) {
+      zb_error = strerror(errno);
+      rc = false;
+    }
+  }
+  else if (!zb_written && rc) {
+    //-- empty output: write a single empty gzip member
+    zb_cur.clear();
+    if (!zb_jobs.empty()) {
+      Job *job = zb_jobs[zb_next];
+      rc = collect(job);
+      job->in.clear();
+      rc = rc && compress(job) && fwrite(job->out.data(), 1, job->out.size(), file) == job->out.size();
+    }
+  }
+  _stop();
+
+  if (created) rc = (fclose(file) == 0) && rc;
+  else rc = (fflush(file) == 0) && rc;
+  file    = NULL;
+  created = false;
+  zb_cur.clear();
+  zb_error.clear();
+  return rc;
+}
+
+//----------------------------------------------------------------------
+bool mozbstream::write(const char *buf, size_t n)
+{
+  if (!file) return false;
+  while (n > 0) {
+    size_t len = zb_blocksize - zb_cur.size();
+    if (len > n) len = n;
+    zb_cur.append(buf, len);
+    buf += len;
+    n   -= len;
+    if (zb_cur.size() >= zb_blocksize && !submit()) return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------
+bool mozbstream::flush(void)
+{
+  if (!file) return false;
+  bool rc = true;
+  if (!zb_cur.empty()) rc = submit();
+
+  //-- collect all pending jobs in submission order
+  for (size_t i=0; i < zb_jobs.size(); ++i) {
+    rc = collect(zb_jobs[(zb_next+i) % zb_jobs.size()]) && rc;
+  }
+  return (fflush(file) == 0) && rc;
+}
+
+//----------------------------------------------------------------------
+bool mozbstream::submit(void)
+{
+  Job *job = zb_jobs[zb_next];
+  zb_next  = (zb_next+1) % zb_jobs.size();
+
+  //-- write out previous contents of this job
+  bool rc = collect(job);
+
+  job->in.swap(zb_cur);
+  zb_cur.clear();
+  job->pending = true;
+
+  if (!zb_members) {
+    //-- single member: prime compression with the preceding window of data
+    job->dict = zb_hist;
+    if (job->in.size() >= 32768) {
+      zb_hist.assign(job->in, job->in.size()-32768, 32768);
+    } else {
+      zb_hist.append(job->in);
+      if (zb_hist.size() > 32768) zb_hist.erase(0, zb_hist.size()-32768);
+    }
+  }
+
+#ifdef MOOT_PTHREADS_ENABLED
+  if (job->threaded) {
+    pthread_mutex_lock(&job->mutex);
+    job->busy = true;
+    pthread_cond_broadcast(&job->cond);
+    pthread_mutex_unlock(&job->mutex);
+    return rc;
+  }
+#endif
+
+  //-- no worker thread: compress and write synchronously
+  job->ok = compress(job);
+  return collect(job) && rc;
+}
+
+//----------------------------------------------------------------------
+bool mozbstream::collect(Job *job)
+{
+#ifdef MOOT_PTHREADS_ENABLED
+  pthread_mutex_lock(&job->mutex);
+  while (job->busy)
+    pthread_cond_wait(&job->cond, &job->mutex);
+  pthread_mutex_unlock(&job->mutex);
+#endif
+  if (!job->pending) return true;
+  job->pending = false;
+
+  if (!job->ok) {
+    zb_error = "deflate() failed";
+    return false;
+  }
+  if (!zb_members) {
+    if (!zb_written && !write_header()) return false;
+    zb_crc    = crc32_combine(zb_crc, job->crc, job->in.size());
+    zb_isize += job->in.size();
+  }
+  if (fwrite(job->out.data(), 1, job->out.size(), file) != job->out.size()) {
+    zb_error = strerror(errno);
+    return false;
+  }
+  zb_written = true;
+  written(job->out.size());
+  return true;
+}
+
+//----------------------------------------------------------------------
+bool mozbstream::write_header(void)
+{
+  //-- magic, CM=deflate, no flags, no mtime, XFL (max/fast compression), OS=unknown
+  char hdr[10] = { '\x1f', '\x8b', 8, 0, 0, 0, 0, 0, 0, '\xff' };
+  if (zb_level == Z_BEST_COMPRESSION)  hdr[8] = 2;
+  else if (zb_level == Z_BEST_SPEED)   hdr[8] = 4;
+  if (fwrite(hdr, 1, sizeof(hdr), file) != sizeof(hdr)) {
+    zb_error = strerror(errno);
+    return false;
+  }
+  zb_written = true;
+  return true;
+}
+
+//----------------------------------------------------------------------
+bool mozbstream::compress(Job *job)
+{
+  z_stream zs;
+  memset(&zs, 0, sizeof(zs));
+  //-- independent members get their own gzip wrapper; otherwise raw deflate data
+  if (deflateInit2(&zs, zb_level, Z_DEFLATED, (zb_members ? 15+16 : -15), 8, zb_strategy) != Z_OK)
+    return false;
+  if (!zb_members) {
+    if (!job->dict.empty()
+	&& deflateSetDictionary(&zs, reinterpret_cast<const Bytef*>(job->dict.data()), job->dict.size()) != Z_OK)
+      {
+	deflateEnd(&zs);
+	return false;
+      }
+    job->crc = crc32(crc32(0L, Z_NULL, 0), reinterpret_cast<const Bytef*>(job->in.data()), job->in.size());
+  }
+
+  job->out.resize(deflateBound(&zs, job->in.size()) + 32);
+  zs.next_in   = reinterpret_cast<Bytef*>(const_cast<char*>(job->in.data()));
+  zs.avail_in  = job->in.size();
+  zs.next_out  = reinterpret_cast<Bytef*>(&job->out[0]);
+  zs.avail_out = job->out.size();
+
+  //-- single member: a sync flush byte-aligns the block without ending the deflate stream
+  int rc = deflate(&zs, zb_members ? Z_FINISH : Z_SYNC_FLUSH);
+  job->out.resize(zs.total_out);
+  deflateEnd(&zs);
+  if (zb_members) return rc == Z_STREAM_END;
+  return rc == Z_OK && zs.avail_in == 0 && zs.avail_out > 0;
+}
+
+#ifdef MOOT_PTHREADS_ENABLED
+//----------------------------------------------------------------------
+void *mozbstream::_compress_thread(void *data)
+{
+  Job *job = reinterpret_cast<Job*>(data);
+  pthread_mutex_lock(&job->mutex);
+  for (;;) {
+    while (!job->busy && !job->stop)
+      pthread_cond_wait(&job->cond, &job->mutex);
+    if (!job->busy) break;
+
+    pthread_mutex_unlock(&job->mutex);
+    bool ok = job->owner->compress(job);
+    pthread_mutex_lock(&job->mutex);
+
+    job->ok   = ok;
+    job->busy = false;
+    pthread_cond_broadcast(&job->cond);
+  }
+  pthread_mutex_unlock(&job->mutex);
+  return NULL;
+}
+#endif
+
+}; //-- /namespace mootio
+
+#endif /* MOOT_ZLIB_ENABLED */
@@ -38,8 +38,13 @@
 #ifdef MOOT_ZLIB_ENABLED
 
 #include <zlib.h>
+#include <vector>
 #define MOOT_DEFAULT_COMPRESSION Z_DEFAULT_COMPRESSION
 
+#ifdef MOOT_PTHREADS_ENABLED
+# include <pthread.h>
+#endif
+
 namespace mootio {
 
   /*====================================================================
@@ -337,6 +342,329 @@ namespace mootio {
     //@}
   }; //-- /mofstream
 
+  /*====================================================================
+   * mizbstream : buffered read-ahead gzip input
+   *====================================================================*/
+  /** \brief Buffered gzip input stream with background decompression.
+   *
+   * Reads a C FILE* (either opened by name or attached with from_file())
+   * and inflates it in large blocks of \a zb_bufsize bytes.  If POSIX threads
+   * are enabled, decompression runs ahead in a background thread, buffering
+   * up to \a zb_nbufs blocks, so that it overlaps with the consumer
+   * (e.g. a token lexer and the tagger).  getbyte() and read() are served
+   * from memory.
+   *
+   * Multi-member gzip files (as written by mozbstream or \c pigz) are
+   * decoded as a single stream.  As for gzread(), input which does not begin
+   * with a gzip header is passed through unchanged, and trailing garbage after
+   * the last gzip member is ignored.
+   */
+  class mizbstream : virtual public mistream {
+  public:
+    /*----------------------------------------------------------
+     * mizbstream: data
+     */
+    FILE        *file;        ///< underlying compressed input
+    bool         created;     ///< whether we opened \a file ourselves
+    size_t       zb_bufsize;  ///< size of decompressed blocks (bytes)
+    size_t       zb_nbufs;    ///< maximum number of blocks decompressed ahead
+    bool         zb_threaded; ///< whether to decompress in a background thread (if available)
+
+  protected:
+    //-- consumer state
+    std::string  zb_cur;      ///< current decompressed block
+    size_t       zb_pos;      ///< read position in \a zb_cur
+
+    //-- producer state (owned by the decompression thread while it runs)
+    z_stream     zb_zs;       ///< inflate state
+    bool         zb_gzip;     ///< true if input is gzip-compressed, false for pass-through
+    bool         zb_zinit;    ///< whether \a zb_zs is initialized
+    bool         zb_member_end; ///< true after the end of a gzip member
+    bool         zb_in_eof;   ///< true if \a file is exhausted
+    std::string  zb_inbuf;    ///< raw input buffer (\a zb_zs.next_in and \a zb_zs.avail_in point into it)
+    size_t       zb_inlen;    ///< number of valid bytes in \a zb_inbuf
+
+    //-- shared state
+    std::vector<std::string> zb_ring; ///< decompressed blocks (ring buffer of \a zb_nbufs)
+    size_t       zb_head;     ///< number of blocks consumed
+    size_t       zb_tail;     ///< number of blocks produced
+    bool         zb_done;     ///< true if the producer has finished
+    bool         zb_stop;     ///< true if the producer should stop
+    std::string  zb_error;    ///< decompression error message, if any
+    bool         zb_running;  ///< whether the background thread is running
+#ifdef MOOT_PTHREADS_ENABLED
+    pthread_t       zb_thread;  ///< background thread
+    pthread_mutex_t zb_mutex;   ///< guards shared state
+    pthread_cond_t  zb_cond;    ///< signals changes of shared state
+#endif
+
+  public:
+    /*----------------------------------------------------------
+     * mizbstream: constructors
+     */
+    ///\name Constructors etc.
+    //@{
+    /** Default constructor */
+    mizbstream(void) { _init(); };
+
+    /** Constructor given filename; \a mode is passed to fopen() */
+    mizbstream(const char *filename, const char *mode=NULL) {
+      _init();
+      open(filename,mode);
+    };
+
+    /** Destructor: auto-closes */
+    virtual ~mizbstream(void);
+    //@}
+
+    /*----------------------------------------------------------
+     * mizbstream: open/close
+     */
+    ///\name Open/Close
+    //@{
+    /** Open a named file for input; "-" is stdin */
+    bool open(const char *filename, const char *mode=NULL);
+
+    /** Read from an open C stream, which is \b not closed by close() */
+    bool from_file(FILE *f);
+
+    /** Stop decompression and close the current input (if we opened it) */
+    virtual bool close(void);
+    //@}
+
+    /*----------------------------------------------------------
+     * mizbstream: integrity
+     */
+    ///\name Integrity Tests
+    //@{
+    /** Test stream integrity */
+    virtual bool valid(void) { return file != NULL && errmsg().empty(); };
+
+    /** Test for eof */
+    virtual bool eof(void);
+
+    /** Get current error message */
+    virtual std::string errmsg(void);
+    //@}
+
+    /*----------------------------------------------------------
+     * mizbstream: input
+     */
+    ///\name Input Methods
+    //@{
+    /** Read up to \p n bytes of data into \p buf,
+     *  returns number of bytes actually read. */
+    virtual ByteCount read(char *buf, size_t n);
+
+    /** Read a single byte of data.  Returns EOF on eof. */
+    virtual int getbyte(void) {
+      if (zb_pos < zb_cur.size() || underflow())
+	return static_cast<unsigned char>(zb_cur[zb_pos++]);
+      return EOF;
+    };
+    //@}
+
+  protected:
+    /** Initialize members */
+    void _init(void);
+
+    /** Detect input format and start decompression */
+    bool _start(void);
+
+    /** Get next decompressed block into \a zb_cur; returns false at eof */
+    bool underflow(void);
+
+    /** Decompress next block into \a out; returns false if there is no more data */
+    bool produce(std::string &out);
+
+    /** Set error message (if none is set yet) */
+    void set_error(const char *msg);
+
+#ifdef MOOT_PTHREADS_ENABLED
+    /** Decompression thread entry point: \a data is a pointer to the mizbstream */
+    static void *_produce_thread(void *data);
+#endif
+  }; //-- /mizbstream
+
+  /*====================================================================
+   * mozbstream : block-parallel gzip output
+   *====================================================================*/
+  /** \brief gzip output stream with parallel block compression.
+   *
+   * Output is collected in blocks of \a zb_blocksize bytes, and each block is
+   * compressed separately (primed with the preceding 32K of data, as by \c pigz)
+   * into deflate data ending with a sync flush.  All blocks go into a single gzip
+   * member, so flush() does not start a new member, and the output is readable by
+   * any gzip-compatible tool.  If \a zb_members is true (as for mozblockstream),
+   * each block is instead written as an independent gzip member.
+   * If POSIX threads are enabled, up to \a zb_nthreads blocks are compressed in
+   * parallel by background threads, while output order is preserved.
+   * Compressed data is written to a C FILE* (either opened by name or attached
+   * with to_file()).
+   */
+  class mozbstream : virtual public mostream {
+  public:
+    /** \brief Compression job: one input block and its compressed output */
+    struct Job {
+      std::string in;       ///< uncompressed data
+      std::string out;      ///< compressed data (valid if !busy)
+      bool        busy;     ///< true while \a in is being compressed
+      bool        pending;  ///< true if \a out has not been written yet
+      bool        stop;     ///< tells the worker thread to terminate
+      bool        ok;       ///< false if compression failed
+      bool        threaded; ///< whether a worker thread compresses this job
+      std::string dict;     ///< preset dictionary: data preceding \a in (single-member output only)
+      uLong       crc;      ///< crc32 of \a in (single-member output only)
+      mozbstream *owner;    ///< owning stream
+#ifdef MOOT_PTHREADS_ENABLED
+      pthread_t       thread;
+      pthread_mutex_t mutex;
+      pthread_cond_t  cond;
+#endif
+    };
+
+  public:
+    /*----------------------------------------------------------
+     * mozbstream: data
+     */
+    FILE        *file;          ///< underlying compressed output
+    bool         created;       ///< whether we opened \a file ourselves
+    int          zb_level;      ///< compression level
+    int          zb_strategy;   ///< compression strategy
+    size_t       zb_blocksize;  ///< size of uncompressed blocks (bytes)
+    size_t       zb_nthreads;   ///< number of compression threads (0: one per online CPU)
+
+  protected:
+    std::string        zb_cur;      ///< current (incomplete) block
+    std::vector<Job*>  zb_jobs;     ///< compression jobs (round-robin)
+    size_t             zb_next;     ///< index of next job to use
+    bool               zb_members;  ///< whether blocks are written as independent gzip members
+    bool               zb_written;  ///< whether any output (gzip header or member) has been written
+    uLong              zb_crc;      ///< crc32 of uncompressed data written (single-member output only)
+    uLong              zb_isize;    ///< size of uncompressed data written, modulo 2^32 (single-member output only)
+    std::string        zb_hist;     ///< last 32K of submitted data (single-member output only)
+    std::string        zb_error;    ///< error message, if any
+
+  public:
+    /*----------------------------------------------------------
+     * mozbstream: constructors
+     */
+    ///\name Constructors etc.
+    //@{
+    /** Default constructor */
+    mozbstream(void) { _init(); };
+
+    /** Constructor given filename and mode (as for gzopen(), e.g. "wb9") */
+    mozbstream(const char *filename, const char *mode=NULL) {
+      _init();
+      open(filename,mode);
+    };
+
+    /** Destructor: auto-closes */
+    virtual ~mozbstream(void);
+    //@}
+
+    /*----------------------------------------------------------
+     * mozbstream: open/close
+     */
+    ///\name Open/Close
+    //@{
+    /** Open a named file for output; "-" is stdout.  A digit in \a mode sets the compression level. */
+    bool open(const char *filename, const char *mode=NULL);
+
+    /** Write to an open C stream, which is \b not closed by close() */
+    bool to_file(FILE *f);
+
+    /** Flush all pending output and close the current output (if we opened it) */
+    virtual bool close(void);
+
+    /** Set compression parameters; should be called before any data is written */
+    inline void setparams(int level=Z_DEFAULT_COMPRESSION,
+			  int strategy=Z_DEFAULT_STRATEGY)
+    {
+      if (level != Z_DEFAULT_COMPRESSION
+	  && (level > Z_BEST_COMPRESSION || level < Z_NO_COMPRESSION))
+	{
+	  level = Z_DEFAULT_COMPRESSION;
+	}
+      zb_level    = level;
+      zb_strategy = strategy;
+    };
+    //@}
+
+    /*----------------------------------------------------------
+     * mozbstream: integrity
+     */
+    ///\name Integrity Tests
+    //@{
+    /** Test stream integrity */
+    virtual bool valid(void) { return file != NULL && zb_error.empty(); };
+
+    /** Test for eof (always false while open) */
+    virtual bool eof(void) { return file == NULL; };
+
+    /** Get current error message */
+    virtual std::string errmsg(void) {
+      return (!file && zb_error.empty()) ? std::string("no output file") : zb_error;
+    };
+    //@}
+
+    /*----------------------------------------------------------
+     * mozbstream: output
+     */
+    ///\name Output Methods
+    //@{
+    /** Compress and write all pending data (ends the current block with a sync flush) */
+    virtual bool flush(void);
+
+    /** Write \p n bytes from \p buf to the stream */
+    virtual bool write(const char *buf, size_t n);
+
+    /** Write a single byte to the stream */
+    virtual bool putbyte(unsigned char c) {
+      if (!file) return false;
+      zb_cur.push_back(static_cast<char>(c));
+      return zb_cur.size() < zb_blocksize || submit();
+    };
+
+    /** Write a C string to the stream */
+    virtual bool puts(const char *s) { return write(s, strlen(s)); };
+
+    /** Write a C++ string to the stream */
+    virtual bool puts(const std::string &s) { return write(s.data(), s.size()); };
+    //@}
+
+  protected:
+    /** Initialize members */
+    void _init(void);
+
+    /** Start compression jobs for the current output */
+    void _start(void);
+
+    /** Stop compression threads and free jobs */
+    void _stop(void);
+
+    /** Hand current block to the next job; returns false on error */
+    bool submit(void);
+
+    /** Wait for job \a job to finish and write its output; returns false on error */
+    bool collect(Job *job);
+
+    /** Compress \a job->in into \a job->out as a gzip member (\a zb_members) or as sync-flushed deflate data */
+    bool compress(Job *job);
+
+    /** Write the gzip header for single-member output; returns false on error */
+    bool write_header(void);
+
+    /** Called by collect() after a compressed block of \a nbytes bytes has been written */
+    virtual void written(size_t nbytes) {};
+
+#ifdef MOOT_PTHREADS_ENABLED
+    /** Compression thread entry point: \a data is a pointer to a Job */
+    static void *_compress_thread(void *data);
+#endif
+  }; //-- /mozbstream
+
 }; //-- /namespace mootio
 
 #else  // _MOOT_ZLIB_ENABLED
@@ -351,6 +679,8 @@ namespace mootio {
   typedef mfstream   mzfstream;
   typedef mifstream  mizfstream;
   typedef mofstream  mozfstream;
+  typedef mifstream  mizbstream;
+  typedef mofstream  mozbstream;
 
 }; //-- /namespace mootio
 
@@ -1,6 +1,8 @@
 /* Generated by re2c (version information omitted for version control friendliness) */
 /*-*- Mode: C++; coding: utf-8; c-basic-offset: 2; -*-*/
 #include "wasteCase.h"
+#include <string.h>  //-- for memcpy(), memset()
+#include <stdint.h>
 
 #define UNUSED(x) {(void)(x);} /* avoid 'variable yych set but unused' warning for variable x */
 
@@ -9,10 +11,41 @@ namespace moot {
 std::string utf8ToLower(const std::string &s)
 {
   std::string ls;
-  const unsigned char *sp  = (const unsigned char*)s.data();
-  const unsigned char *end = sp + s.size();
+  utf8ToLower(s.data(), s.size(), ls);
+  return ls;
+}
+
+void utf8ToLower(const char *s, size_t len, std::string &ls)
+{
+  const unsigned char *sp  = (const unsigned char*)s;
+  const unsigned char *end = sp + len;
+  unsigned char tail[8];   //-- NUL-padded copy of the last few input bytes: the automaton may read ahead
+  bool in_tail = false;
+  ls.reserve(ls.size() + len);
 
   while (sp < end) {
+    //-- ASCII fast path: 8 bytes at a time
+    while (end - sp >= 8) {
+      uint64_t w;
+      memcpy(&w, sp, 8);
+      if (w & 0x8080808080808080ULL)
+	break;
+      uint64_t ge_A = w + 0x3f3f3f3f3f3f3f3fULL;  //-- high bit set iff byte >= 'A'
+      uint64_t gt_Z = w + 0x2525252525252525ULL;  //-- high bit set iff byte >  'Z'
+      w |= ((ge_A & ~gt_Z) & 0x8080808080808080ULL) >> 2;
+      ls.append((const char*)&w, 8);
+      sp += 8;
+    }
+    if (sp >= end)
+      break;
+    if (end - sp < 4 && !in_tail) {
+      size_t n = end - sp;
+      memset(tail, 0, sizeof(tail));
+      memcpy(tail, sp, n);
+      sp      = tail;
+      end     = tail + n;
+      in_tail = true;
+    }
     
 
     //-- Auto-generated lower-case rules go here
@@ -6213,8 +6246,6 @@ yy2281:
         }
 
   }
-
-  return ls;
 }
 
 }; /*-- /namespace moot */
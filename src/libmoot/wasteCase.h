@@ -40,6 +40,13 @@ namespace moot {
 /** Return a lower-cased version of \a s ; in- and outputs are UTF-8 encoded byte strings */
 std::string utf8ToLower(const std::string &s);
 
+/**
+ * Append a lower-cased version of the \a len bytes at \a s to \a ls ; in- and outputs are UTF-8 encoded.
+ * Runs of ASCII characters are folded 8 bytes at a time, and no memory is allocated if \a ls has
+ * sufficient capacity.
+ */
+void utf8ToLower(const char *s, size_t len, std::string &ls);
+
 };
 
 #endif /* _WASTE_CASE_H */
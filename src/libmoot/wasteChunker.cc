@@ -0,0 +1,113 @@
+/* -*- Mode: C++; coding: utf-8; c-basic-offset: 2; -*- */
+/*
+   libmoot : moot part-of-speech tagging library
+   Copyright (C) 2013-2016 by Bryan Jurish <moocow@cpan.org> and Kay-Michael Würzner
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 3 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#include "wasteChunker.h"
+
+moot_BEGIN_NAMESPACE
+
+//============================================================================
+// wasteChunker
+
+//----------------------------------------------------------------------
+bool wasteChunker::fill(size_t n)
+{
+  if (wc_eof) return false;
+  if (n < 65536) n = 65536;
+  size_t used = wc_buf.size();
+  wc_buf.resize(used+n);
+  mootio::ByteCount nread = wc_in->read(&wc_buf[used], n);
+  if (nread <= 0) {
+    nread  = 0;
+    wc_eof = true;
+  }
+  wc_buf.resize(used+nread);
+  return nread > 0;
+}
+
+//----------------------------------------------------------------------
+size_t wasteChunker::boundary(void) const
+{
+  size_t limit = wc_buf.size() < wc_max_size ? wc_buf.size() : wc_max_size;
+  size_t i     = wc_chunk_size > 0 ? wc_chunk_size-1 : 0;
+  while (i < limit && (i=wc_buf.find('\n',i)) != std::string::npos && i < limit) {
+    //-- skip whitespace on the following line
+    size_t j;
+    for (j=i+1; j < limit && (wc_buf[j]==' ' || wc_buf[j]=='\t' || wc_buf[j]=='\r' || wc_buf[j]=='\f' || wc_buf[j]=='\v'); ++j) ;
+    //-- blank line: boundary, unless it follows a hyphen (dehyphenation may span it)
+    if (j < limit && wc_buf[j]=='\n' && !(i > 0 && wc_buf[i-1]=='-'))
+      return j+1;
+    i = j;
+  }
+  return 0;
+}
+
+//----------------------------------------------------------------------
+bool wasteChunker::get_chunk(std::string &chunk, mootio::ByteOffset &offset, size_t *lead)
+{
+  size_t n;
+  while ((n=boundary()) == 0 && !wc_eof && wc_buf.size() < wc_max_size)
+    fill(wc_chunk_size);
+
+  if (wc_buf.empty())
+    return false;
+
+  if (n == 0) {
+    if (wc_eof && wc_buf.size() <= wc_max_size) {
+      //-- last chunk
+      n = wc_buf.size();
+    }
+    else {
+      //-- no blank line: cut after last newline (not following a hyphen), whitespace, or character
+      size_t limit = wc_buf.size() < wc_max_size ? wc_buf.size() : wc_max_size;
+      size_t i;
+      for (i=wc_buf.rfind('\n',limit-1); i != std::string::npos && i > 0 && wc_buf[i-1]=='-'; i=wc_buf.rfind('\n',i-1)) ;
+      if (i != std::string::npos)
+	n = i+1;
+      else if ((i=wc_buf.find_last_of(" \t\r\f\v",limit-1)) != std::string::npos)
+	n = i+1;
+      else {
+	for (n=limit; n > 0 && (static_cast<unsigned char>(wc_buf[n]) & 0xC0) == 0x80; --n) ;
+	if (n == 0) n = limit;
+      }
+    }
+  }
+
+  //-- lead-in: complete lines from the end of the previous chunk
+  size_t nlead = 0;
+  if (lead && !wc_tail.empty()) {
+    size_t i = wc_tail.find('\n');
+    if (i != std::string::npos && i+1 < wc_tail.size())
+      nlead = wc_tail.size()-(i+1);
+  }
+  chunk.assign(wc_tail, wc_tail.size()-nlead, nlead);
+  chunk.append(wc_buf, 0, n);
+  offset = wc_offset - nlead;
+  if (lead) *lead = nlead;
+
+  //-- remember tail for next lead-in
+  size_t ntail = n < wc_lead_size ? n : wc_lead_size;
+  wc_tail.assign(wc_buf, n-ntail, ntail);
+
+  wc_buf.erase(0, n);
+  wc_offset += n;
+  return true;
+}
+
+moot_END_NAMESPACE
@@ -0,0 +1,118 @@
+/* -*- Mode: C++; coding: utf-8; c-basic-offset: 2; -*- */
+/*
+   libmoot : moot part-of-speech tagging library
+   Copyright (C) 2013-2016 by Bryan Jurish <moocow@cpan.org> and Kay-Michael Würzner
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 3 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+/**
+ * \file wasteChunker.h
+ *
+ * \brief splits raw text input into independently scannable chunks
+ *
+ * \author moocow
+ *
+ * \date 2026
+ *
+ */
+
+#ifndef _WASTE_CHUNKER_H
+#define _WASTE_CHUNKER_H
+
+#include <mootIO.h>
+#include <string>
+
+moot_BEGIN_NAMESPACE
+
+/*============================================================================
+ * wasteChunker
+ */
+/**
+ * \brief splits raw text input into chunks at paragraph boundaries
+ * \details
+ * Reads a mootio::mistream in blocks and returns chunks of roughly
+ * \a wc_chunk_size bytes each, ending immediately after a blank line
+ * (a newline followed by a line containing only whitespace), so that each
+ * chunk can be passed through the waste scanner, lexer, and tagger
+ * independently of its neighbours.  If no blank line is found within
+ * \a wc_max_size bytes, the chunk ends after the last newline, or failing
+ * that after the last ASCII whitespace character, or failing that at a
+ * UTF-8 character boundary.
+ *
+ * Each chunk is returned together with its byte offset in the input stream,
+ * which should be assigned to the scanner (wasteTokenScanner::byte_number())
+ * to get correct token locations.
+ *
+ * If \a wc_lead_size is non-zero, each chunk after the first is prefixed with
+ * a "lead-in" consisting of up to \a wc_lead_size bytes of complete lines from
+ * the end of the preceding chunk.  Processing the lead-in lets the lexer and
+ * tagger state resynchronize with what sequential processing would have seen
+ * at the chunk boundary; output for tokens within the lead-in should then be
+ * discarded.  This is not guaranteed: the tagger only matches sequential
+ * processing if its trellis collapses to a single path within the lead-in.
+ *
+ * Newlines following a hyphen are never used as chunk boundaries, since the
+ * lexer may join hyphenated words across them (even across blank lines).
+ */
+class wasteChunker
+{
+public:
+  mootio::mistream   *wc_in;         /**< input stream */
+  size_t              wc_chunk_size; /**< minimum chunk size (in bytes) before a boundary is accepted */
+  size_t              wc_max_size;   /**< maximum chunk size (in bytes) */
+  size_t              wc_lead_size;  /**< maximum lead-in size (in bytes); 0 for none */
+  mootio::ByteOffset  wc_offset;     /**< input offset of next chunk */
+  std::string         wc_buf;        /**< input read beyond the end of the previous chunk */
+  std::string         wc_tail;       /**< end of previous chunk (lead-in candidate) */
+  bool                wc_eof;        /**< true iff wc_in is exhausted */
+
+public:
+  /** Default constructor */
+  wasteChunker(mootio::mistream *in=NULL, size_t chunk_size=1048576)
+    : wc_in(NULL), wc_chunk_size(chunk_size), wc_max_size(4*chunk_size), wc_lead_size(0)
+  {
+    from_mstream(in);
+  };
+
+  /** Select input stream and reset offset */
+  void from_mstream(mootio::mistream *in)
+  {
+    wc_in     = in;
+    wc_offset = 0;
+    wc_buf.clear();
+    wc_tail.clear();
+    wc_eof    = (in == NULL);
+  };
+
+  /**
+   * Get next chunk into \a chunk and its input offset into \a offset.
+   * If \a lead is non-NULL, the chunk is prefixed with a lead-in whose length
+   * is returned in \a *lead (\a offset is the input offset of the lead-in).
+   * Returns false if input is exhausted.
+   */
+  bool get_chunk(std::string &chunk, mootio::ByteOffset &offset, size_t *lead=NULL);
+
+protected:
+  /** Read at least \a n more bytes into wc_buf if possible; returns false at eof */
+  bool fill(size_t n);
+
+  /** Get length of next chunk in wc_buf (0 if more input is required) */
+  size_t boundary(void) const;
+};
+
+moot_END_NAMESPACE
+
+#endif /* _WASTE_CHUNKER_H */
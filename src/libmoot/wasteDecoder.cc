@@ -65,30 +65,44 @@ void wasteDecoder::to_writer(TokenWriter *sink)
 void wasteDecoder::flush_buffer(bool force)
 {
   if (!wd_sink) return;
-  for (; !wd_buf.empty() && (force || buffer_can_shift()); wd_buf.pop_front()) {
-    TOKDEBUG(wd_buf.front().dump("DECODE:PUT"));
-    wd_sink->put_token(wd_buf.front());
+  wd_npending = 0;
+  mootSentence::iterator end;
+  for (end=wd_buf.begin(); end != wd_buf.end() && (force || &(*end) != wd_tok); ++end) {
+    TOKDEBUG(end->dump("DECODE:PUT"));
   }
-} 
+  if (end == wd_buf.begin()) return;
+
+  wd_out.splice(wd_out.end(), wd_buf, wd_buf.begin(), end);
+  wd_sink->put_tokens(wd_out);
+  wd_free.splice(wd_free.end(), wd_out);
+}
 
 //----------------------------------------------------------------------
 void wasteDecoder::_put_token(const mootToken &token)
 {
   //-- merge or push token
+  bool eos = false;
   switch (token.tok_type) {
   case TokTypeVanilla:
   case TokTypeLibXML:
     {
-      //-- parse raw text from details
-      const mootTagString &detail = token.tok_analyses.empty() ? "" : token.tok_analyses.front().details;
-      mootTagString rawtext("");
-      size_t rawtext_start = detail.size() > 21 ? detail.find(' ', 21) : detail.npos;
-      if (rawtext_start!=detail.npos && detail.size()-rawtext_start > 2)
-	rawtext.assign(detail, rawtext_start+1, detail.size()-rawtext_start-2);
+      //-- locate raw text in details (unanalyzed tokens from a model-bound wasteLexerReader carry raw text)
+      const char *rawtext = token.tok_text.data();
+      size_t      rawlen  = 0;
+      if (token.tok_analyses.empty()) {
+	rawlen = token.tok_text.size();
+      } else {
+	const mootTagString &detail = token.tok_analyses.front().details;
+	size_t rawtext_start = detail.size() > 21 ? detail.find(' ', 21) : detail.npos;
+	if (rawtext_start!=detail.npos && detail.size()-rawtext_start > 2) {
+	  rawtext = detail.data() + rawtext_start+1;
+	  rawlen  = detail.size()-rawtext_start-2;
+	}
+      }
 
       if (wd_tok && !tag_attr_w(token.besttag())) {
 	//-- merge tokens, don't flush
-	wd_tok->tok_text += rawtext;
+	wd_tok->tok_text.append(rawtext, rawlen);
 	wd_tok->tok_besttag.push_back(' ');
 	wd_tok->tok_besttag += token.besttag();
 	wd_tok->tok_location.length = (token.tok_location.offset + token.tok_location.length - wd_tok->tok_location.offset);
@@ -97,18 +111,21 @@ void wasteDecoder::_put_token(const mootToken &token)
       }
       else if (!wd_sb && wd_eos && tag_attr_s(token.besttag())) {
 	//-- we have a buffered EOS attribute
-	wd_buf.push_back( mootToken(TokTypeEOS) );
+	buffer_push( mootToken(TokTypeEOS) );
 
 	//-- spit out old wd_tok and update
 	wd_tok = NULL;
 	flush_buffer();
       }
 
-      //-- no buffered wd_tok: buffer this one
-      wd_buf.push_back(token);
-      wd_tok = &(wd_buf.back());
-      wd_tok->text(rawtext);
+      //-- no buffered wd_tok: buffer this one (without analyses)
+      wd_tok = &buffer_push();
+      wd_tok->tok_type     = token.tok_type;
+      wd_tok->tok_text.assign(rawtext, rawlen);
+      wd_tok->tok_besttag  = token.tok_besttag;
       wd_tok->tok_analyses.clear();
+      wd_tok->tok_location = token.tok_location;
+      wd_tok->tok_data     = token.tok_data;
       wd_sb  = false;
       wd_eos = tag_attr_S(token.besttag());
       break;
@@ -117,32 +134,37 @@ void wasteDecoder::_put_token(const mootToken &token)
   case TokTypeWB:
     //-- word break: flush wd_tok
     wd_tok = NULL;
-    wd_buf.push_back( token );
+    buffer_push( token );
     break;
 
   case TokTypeSB:
     //-- sentence break: flush WIP token
     wd_tok = NULL;
-    wd_buf.push_back(token);
+    buffer_push(token);
     if (!wd_sb) {
-      wd_buf.push_back( mootToken(TokTypeEOS) );
+      buffer_push( mootToken(TokTypeEOS) );
       wd_sb  = true;
     }
+    eos = true;
     break;
 
   case TokTypeEOS:
     //-- EOS: pass through (unless we've just inserted one)
     if (wd_sb) break;
     wd_sb  = true;
-    wd_buf.push_back( token );
+    buffer_push( token );
+    eos = true;
     break;
   
   default:
     //-- default: comment, xmlraw, etc: just buffer
-    wd_buf.push_back(token);
+    buffer_push(token);
     break;
   }
-  flush_buffer();
+
+  //-- pass on complete sentences (or long sentence prefixes)
+  if (eos || wd_npending >= wd_batch_max)
+    flush_buffer();
 }
 
 //----------------------------------------------------------------------
@@ -40,7 +40,15 @@ moot_BEGIN_NAMESPACE
 /*============================================================================
  * wasteDecoder
  */
-/** \brief waste decoder component converts hidden tag attributes 's','S','w' to sentence- and token-boundaries */
+/**
+ * \brief waste decoder component converts hidden tag attributes 's','S','w' to sentence- and token-boundaries
+ * \details
+ * Decoded tokens are buffered in \a wd_buf and passed to the sink in batches
+ * via TokenWriter::put_tokens(), usually a whole sentence at a time.  Buffer nodes
+ * (and the string storage of their tokens) are recycled through \a wd_free, so
+ * merging segments into a token just appends to storage which has usually been
+ * allocated already.
+ */
 class wasteDecoder : public TokenWriter
 {
 public:
@@ -68,6 +76,10 @@ public:
   mootSentence  wd_buf;   /** intermediate token buffer */
   mootToken    *wd_tok;   /** current token under construction (NULL for none), pointer into wd_buf */
   TokenWriter  *wd_sink;  /** underlying data sink */
+  mootSentence  wd_out;   /** batch of tokens being passed to wd_sink */
+  mootSentence  wd_free;  /** recycled buffer nodes */
+  size_t        wd_batch_max; /** maximum number of tokens buffered between flushes if no sentence ends (default=1024) */
+  size_t        wd_npending;  /** number of tokens buffered since the last flush */
   //@}
 
 public:
@@ -80,7 +92,9 @@ public:
       wd_sb(false),
       wd_eos(false),
       wd_tok(NULL),
-      wd_sink(NULL)
+      wd_sink(NULL),
+      wd_batch_max(1024),
+      wd_npending(0)
   {};
 
   /** destructor calls close() */
@@ -122,9 +136,27 @@ public:
   /** Select output to subordinate TokenWriter */
   void to_writer(TokenWriter *sink);
 
-  /** flush buffer to current output sink if defined */
+  /**
+   * flush buffer to current output sink if defined: passes all tokens preceding wd_tok
+   * (all tokens if \a force is true) to the sink in a single put_tokens() call
+   */
   void flush_buffer(bool force=false);
 
+  /** append a recycled token node to the buffer and return it (contents are stale) */
+  inline mootToken &buffer_push(void)
+  {
+    if (wd_free.empty())
+      wd_buf.push_back(mootToken());
+    else
+      wd_buf.splice(wd_buf.end(), wd_free, wd_free.begin());
+    ++wd_npending;
+    return wd_buf.back();
+  };
+
+  /** append a copy of \a token to the buffer */
+  inline void buffer_push(const mootToken &token)
+  { buffer_push() = token; };
+
   /** peek at top buffer element */
   inline mootToken &buffer_peek(void)
   { return wd_buf.front(); };
@@ -135,7 +167,7 @@ public:
 
   /** shift the first element off the buffer if possible */
   inline void buffer_shift(void) 
-  { if (!wd_buf.empty()) wd_buf.pop_front(); };
+  { if (!wd_buf.empty()) wd_free.splice(wd_free.begin(), wd_buf, wd_buf.begin()); };
 
   void _put_token(const mootToken &token);
   void _put_tokens(const mootSentence &tokens);
@@ -20,10 +20,42 @@
 
 #include "wasteLexer.h"
 #include "wasteCase.h"
+#include "wasteScanner.h"
 #include <sstream>
 
 moot_BEGIN_NAMESPACE
 
+/*============================================================================
+ * wasteLexer::wasteLexerBuffer
+ */
+const wasteLexer::wasteLexerBuffer::Index wasteLexer::wasteLexerBuffer::npos;
+
+//----------------------------------------------------------------------
+wasteLexer::wasteLexerBuffer::wasteLexerBuffer(size_t size)
+  : lb_begin(0),
+    lb_end(0)
+{
+  size_t n;
+  for (n=1; n < size; n <<= 1) ;
+  lb_slots.resize(n);
+  lb_mask = n-1;
+}
+
+//----------------------------------------------------------------------
+void wasteLexer::wasteLexerBuffer::grow(void)
+{
+  size_t n = lb_slots.size();
+  std::vector<wasteLexerToken> slots(2*n);
+  for (Index i=lb_begin; i != lb_end; ++i) {
+    wasteLexerToken &src = lb_slots[i & lb_mask];
+    wasteLexerToken &dst = slots[i & (2*n-1)];
+    dst.wlt_token.swap(src.wlt_token);
+    dst.set_wlt_data(src.wlt_type, src.wlt_blanked, src.s, src.S, src.w);
+  }
+  lb_slots.swap(slots);
+  lb_mask = 2*n-1;
+}
+
 /*============================================================================
  * wasteLexer
  */
@@ -31,9 +63,10 @@ moot_BEGIN_NAMESPACE
 //----------------------------------------------------------------------
 wasteLexer::wasteLexer()
   : wl_state(ls_init),
-    wl_current_tok(NULL),
-    wl_head_tok(NULL),
-    wl_dehyph_mode(true)
+    wl_current_tok(wasteLexerBuffer::npos),
+    wl_head_tok(wasteLexerBuffer::npos),
+    wl_dehyph_mode(true),
+    wl_hmm(NULL)
 {
   // build the tagset
   const char* cls_strings[n_cls] = {"stop","rom","alpha","num","$.","$,","$:","$;","$?","$(","$)","$-","$+","$/","$\"","$\'","$~","other"};
@@ -87,22 +120,20 @@ wasteLexer::~wasteLexer()
 void wasteLexer::reset(void)
 {
   wl_state = ls_init;
-  wl_current_tok = NULL;
-  wl_head_tok = NULL;
+  wl_current_tok = wasteLexerBuffer::npos;
+  wl_head_tok = wasteLexerBuffer::npos;
 }
 
 //----------------------------------------------------------------------
-void wasteLexer::buffer_token(const mootToken& stok)
+void wasteLexer::buffer_token(const mootToken& stok, wasteLexerType lextype)
 {
   wl_state &= ~(ls_flush);
-  wasteLexerToken local_token;
-  local_token.wlt_token = stok;
-  wasteLexerType lextype;
-  switch (local_token.wlt_token.tok_type) {
+  switch (stok.tok_type) {
     case TokTypeVanilla:
     case TokTypeLibXML:
-      //-- categorize scanned token text
-      lextype = waste_lexertype(local_token.wlt_token.tok_text);
+      //-- categorize scanned token text (unless the scanner already did)
+      if (lextype == NwLexerTypes)
+        lextype = waste_lexertype(stok.tok_text);
       switch (lextype)
       {
         case wLexerTypeNewline:
@@ -116,51 +147,39 @@ void wasteLexer::buffer_token(const mootToken& stok)
           // -- some hyphen is a hyphenating hyphen
           if((wl_state & ls_head) && ((wl_state & ls_blanked) == 0))
             wl_state |= ls_hyph;
-          // -- set token features according to lexer state and reset
-          local_token.wlt_type = lextype;
-          local_token.wlt_blanked = (wl_state & ls_blanked) ? true : false;
-          local_token.s = (wl_state & ls_sb_fw) ? true : false;
-          local_token.w = (wl_state & ls_wb_fw) ? true : false;
-          wl_state &= ~(ls_blanked|ls_sb_fw|ls_wb_fw);
-          // -- store token
-          wl_lexbuf.push_back(local_token);
-          // -- update pointers into buffer
-          wl_current_tok = &(wl_lexbuf.back());
+          // -- store token with features according to lexer state and reset
+          // -- update index into buffer
+          wl_current_tok = lexbuf_push_state(stok, lextype);
           return;
 
         case wLexerTypeAlphaLower:
 	case wLexerTypeRomanLower:
-          if( wl_dehyph_mode && ((wl_state & ls_head_hyph_nl) == ls_head_hyph_nl) && !wl_conjunctions.lookup(local_token.wlt_token.tok_text))
+          if( wl_dehyph_mode && ((wl_state & ls_head_hyph_nl) == ls_head_hyph_nl) && wl_head_tok != wasteLexerBuffer::npos && !wl_conjunctions.lookup(stok.tok_text))
           {
-            wl_lexbuf.push_back(local_token);
-            wl_current_tok = &(wl_lexbuf.back());
-            wasteLexerBuffer::iterator it_head = wl_lexbuf.begin ();
-            // -- find head of hyphenation in buffer
-            while(&(*it_head) != wl_head_tok)
-            {
-              ++it_head;
-            }
-            wasteLexerBuffer::iterator it_tail = it_head;
+            wl_current_tok = lexbuf_push_back(stok);
+            // -- head of hyphenation in buffer
+            wasteLexerToken &head = wl_lexbuf[wl_head_tok];
+            wasteLexerBuffer::Index it_tail = wl_head_tok;
             // -- merge tokens until tail is reached
             do
             {
-              ++it_tail;
+              wasteLexerToken &tail = wl_lexbuf[++it_tail];
               // -- update length of the dehyphenated token
-              it_head->wlt_token.tok_location.length += it_tail->wlt_token.tok_location.offset + it_tail->wlt_token.tok_location.length - it_head->wlt_token.tok_location.offset - it_head->wlt_token.tok_location.length;
+              head.wlt_token.tok_location.length += tail.wlt_token.tok_location.offset + tail.wlt_token.tok_location.length - head.wlt_token.tok_location.offset - head.wlt_token.tok_location.length;
               // -- head may have been a roman number, now we know it is not
-              if (it_head->wlt_type == wLexerTypeRomanCaps)
-                it_head->wlt_type = wLexerTypeAlphaUpper;
-              else if (it_head->wlt_type == wLexerTypeRomanLower)
-                it_head->wlt_type = wLexerTypeAlphaLower;
+              if (head.wlt_type == wLexerTypeRomanCaps)
+                head.wlt_type = wLexerTypeAlphaUpper;
+              else if (head.wlt_type == wLexerTypeRomanLower)
+                head.wlt_type = wLexerTypeAlphaLower;
               // -- only text tokens are deleted from buffer
-              if(it_tail->wlt_token.tok_type == TokTypeVanilla || it_tail->wlt_token.tok_type == TokTypeLibXML) {
-                if (it_tail->wlt_type != wLexerTypeHyph) {
-                  it_head->wlt_token.tok_text.append ( it_tail->wlt_token.tok_text );
+              if(tail.wlt_token.tok_type == TokTypeVanilla || tail.wlt_token.tok_type == TokTypeLibXML) {
+                if (tail.wlt_type != wLexerTypeHyph) {
+                  head.wlt_token.tok_text.append ( tail.wlt_token.tok_text );
                 }
-                it_tail->wlt_token.tok_type = TokTypeUnknown;
+                tail.wlt_token.tok_type = TokTypeUnknown;
               }
             }
-            while(&(*it_tail) != wl_current_tok);
+            while(it_tail != wl_current_tok);
 
             // -- breaks hyphenation
             wl_state &= ~(ls_hyph|ls_nl);
@@ -176,31 +195,17 @@ void wasteLexer::buffer_token(const mootToken& stok)
           wl_state |= ls_head;
           // -- breaks hyphenation
           wl_state &= ~(ls_hyph|ls_nl);
-          // -- set token features according to lexer state and reset
-          local_token.wlt_type = lextype;
-          local_token.wlt_blanked = (wl_state & ls_blanked) ? true : false;
-          local_token.s = (wl_state & ls_sb_fw) ? true : false;
-          local_token.w = (wl_state & ls_wb_fw) ? true : false;
-          wl_state &= ~(ls_blanked|ls_sb_fw|ls_wb_fw);
-          // -- store token
-          wl_lexbuf.push_back(local_token);
-          // -- update pointers into buffer
-          wl_current_tok = wl_head_tok = &(wl_lexbuf.back());
+          // -- store token with features according to lexer state and reset
+          // -- update indices into buffer
+          wl_current_tok = wl_head_tok = lexbuf_push_state(stok, lextype);
           return;
 
         default:
           // -- breaks hyphenation
           wl_state &= ~(ls_hyph|ls_nl|ls_head);
-          // -- set token features according to lexer state and reset
-          local_token.wlt_type = lextype;
-          local_token.wlt_blanked = (wl_state & ls_blanked) ? true : false;
-          local_token.s = (wl_state & ls_sb_fw) ? true : false;
-          local_token.w = (wl_state & ls_wb_fw) ? true : false;
-          wl_state &= ~(ls_blanked|ls_sb_fw|ls_wb_fw);
-          // -- store token
-          wl_lexbuf.push_back(local_token);
-          // -- update pointers into buffer
-          wl_current_tok = &(wl_lexbuf.back());
+          // -- store token with features according to lexer state and reset
+          // -- update index into buffer
+          wl_current_tok = lexbuf_push_state(stok, lextype);
           return;
       }
       return;
@@ -211,15 +216,15 @@ void wasteLexer::buffer_token(const mootToken& stok)
       wl_state |= ls_wb_fw;
 
       // -- set eos for last alnum token
-      if(wl_current_tok)
+      if(wl_current_tok != wasteLexerBuffer::npos)
       {
-        wl_current_tok->S = true;
-        wl_current_tok = NULL;
+        wl_lexbuf[wl_current_tok].S = true;
+        wl_current_tok = wasteLexerBuffer::npos;
       }
       // -- output possible
       wl_state |= ls_flush;
       // -- breaks hyphenation
-      wl_head_tok = NULL;
+      wl_head_tok = wasteLexerBuffer::npos;
       wl_state &= ~(ls_head|ls_hyph|ls_nl);
       break;
 
@@ -237,19 +242,20 @@ void wasteLexer::buffer_token(const mootToken& stok)
     default:
       break;
   }
-  wl_lexbuf.push_back(local_token);
+  lexbuf_push_back(stok);
 }
 
 //----------------------------------------------------------------------
-void wasteLexer::set_token(mootToken &token, const wasteLexerToken &lex_token)
+void wasteLexer::get_features(const wasteLexerToken &lex_token,
+                              cls &tok_class, cas &tok_case, binary &tok_abbr, len &tok_length, binary &tok_blanked) const
 {
   //-- default length setting
-  len tok_length = le_null;
+  tok_length = le_null;
 
   //-- class selection (based on waste_lexertype)
-  cls tok_class = other;
-  cas tok_case = non;
-  binary tok_abbr = uk;
+  tok_class = other;
+  tok_case = non;
+  tok_abbr = uk;
   switch (lex_token.wlt_type) {
 
       //
@@ -328,13 +334,13 @@ void wasteLexer::set_token(mootToken &token, const wasteLexerToken &lex_token)
       break;
     case wLexerTypeRomanCaps:
       tok_class = (wl_stopwords.lookup(lex_token.wlt_token.tok_text)) ? stop : rom;
-      tok_case = (wl_stopwords.lookup(lex_token.wlt_token.tok_text)) ? cap : non;
+      tok_case = (tok_class == stop) ? cap : non;
       tok_abbr = (wl_abbrevs.lookup(lex_token.wlt_token.tok_text)) ? kn : uk;
       tok_length = length_attr(lex_token.wlt_token.tok_text.length());
       break;
     case wLexerTypeRomanLower:
       tok_class = (wl_stopwords.lookup(lex_token.wlt_token.tok_text)) ? stop : rom;
-      tok_case = (wl_stopwords.lookup(lex_token.wlt_token.tok_text)) ? lo : non;
+      tok_case = (tok_class == stop) ? lo : non;
       tok_abbr = (wl_abbrevs.lookup(lex_token.wlt_token.tok_text)) ? kn : uk;
       tok_length = length_attr(lex_token.wlt_token.tok_text.length());
       break;
@@ -348,48 +354,34 @@ void wasteLexer::set_token(mootToken &token, const wasteLexerToken &lex_token)
   }
 
   //-- blanked state
-  binary tok_blanked = lex_token.wlt_blanked ? kn : uk;
+  tok_blanked = lex_token.wlt_blanked ? kn : uk;
+}
+
+//----------------------------------------------------------------------
+void wasteLexer::set_token(mootToken &token, const wasteLexerToken &lex_token)
+{
+  cls tok_class;
+  cas tok_case;
+  binary tok_abbr, tok_blanked;
+  len tok_length;
+  get_features(lex_token, tok_class, tok_case, tok_abbr, tok_length, tok_blanked);
 
   //-- set model token text
   token.tok_text = wl_tagset[tok_class][tok_case][tok_abbr][tok_length][tok_blanked][0];
   if (tok_class == stop)
   {
     token.tok_text.push_back(':');
-    token.tok_text.append( tok_case==lo ? lex_token.wlt_token.tok_text : utf8ToLower(lex_token.wlt_token.tok_text) );
+    if (tok_case == lo)
+      token.tok_text.append( lex_token.wlt_token.tok_text );
+    else
+      utf8ToLower( lex_token.wlt_token.tok_text.data(), lex_token.wlt_token.tok_text.size(), token.tok_text );
   }
 
   //-- set model analyses (includes scanned token text)
+  int hmask = hidden_mask(lex_token);
   for (int i = 1; i < n_hidden; ++i) {
-    switch (i)
-    {
-      case 1:
-        if ( lex_token.s || lex_token.S || lex_token.w )
-          continue;
-        else
-          break;
-      case 2:
-        if ( lex_token.s || lex_token.w )
-          continue;
-        else
-          break;
-      case 3:
-        if ( lex_token.s || lex_token.S )
-          continue;
-        else
-          break;
-      case 4:
-        if ( lex_token.s )
-          continue;
-        else
-          break;
-      case 5:
-        if ( lex_token.S )
-          continue;
-        else
-          break;
-      default:
-        break;
-    }
+    if (!hidden_allowed(i, hmask))
+      continue;
     std::string analysis = "[";
     analysis.append(wl_tagset[tok_class][tok_case][tok_abbr][tok_length][tok_blanked][i]);
     analysis.push_back(' ');
@@ -399,6 +391,73 @@ void wasteLexer::set_token(mootToken &token, const wasteLexerToken &lex_token)
   }
 }
 
+//----------------------------------------------------------------------
+void wasteLexer::bind_model(mootHMM *hmm)
+{
+  wl_hmm = hmm;
+  wl_model.clear();
+  wl_model_stop.clear();
+  if (wl_hmm)
+    wl_model.resize(model_index(n_cls,non,uk,le_null,uk,0));
+}
+
+//----------------------------------------------------------------------
+void wasteLexer::model_resolve(ModelEntry &e, const mootTokString &model_text, const std::vector<std::string> &tags, int hmask)
+{
+  //-- cf. mootHMM::token2lexinfo()
+  e.info.tokid = wl_hmm->token2id(model_text);
+  e.info.lclass.clear();
+  for (int i = 1; i < n_hidden; ++i) {
+    if (hidden_allowed(i, hmask))
+      e.info.lclass.insert(wl_hmm->tagids.name2id(tags[i]));
+  }
+  e.info.classid = (wl_hmm->use_lex_classes && !e.info.lclass.empty()) ? wl_hmm->class2id(e.info.lclass,0,1) : 0;
+  e.resolved = true;
+}
+
+//----------------------------------------------------------------------
+void wasteLexer::model_key(const wasteLexerToken &lex_token, ModelKey &key) const
+{
+  get_features(lex_token, key.tok_class, key.tok_case, key.tok_abbr, key.tok_length, key.tok_blanked);
+  key.hmask = hidden_mask(lex_token);
+  key.stoptext.clear();
+  if (key.tok_class == stop)
+  {
+    //-- stopword: model text depends on token text
+    key.stoptext = wl_tagset[key.tok_class][key.tok_case][key.tok_abbr][key.tok_length][key.tok_blanked][0];
+    key.stoptext.push_back(':');
+    if (key.tok_case == lo)
+      key.stoptext.append( lex_token.wlt_token.tok_text );
+    else
+      utf8ToLower( lex_token.wlt_token.tok_text.data(), lex_token.wlt_token.tok_text.size(), key.stoptext );
+  }
+}
+
+//----------------------------------------------------------------------
+const mootHMM::LexInfo &wasteLexer::model_lexinfo(const ModelKey &key, const mootTokString *&model_text)
+{
+  const std::vector<std::string> &tags = wl_tagset[key.tok_class][key.tok_case][key.tok_abbr][key.tok_length][key.tok_blanked];
+  ModelEntry *e;
+
+  if (key.tok_class == stop)
+  {
+    ModelStopTable::iterator msi = wl_model_stop.find(key.stoptext);
+    if (msi == wl_model_stop.end())
+      msi = wl_model_stop.insert(ModelStopTable::value_type(key.stoptext, ModelTable(n_hidden_masks))).first;
+    model_text = &(msi->first);
+    e = &(msi->second[key.hmask]);
+  }
+  else
+  {
+    model_text = &tags[0];
+    e = &wl_model[model_index(key.tok_class, key.tok_case, key.tok_abbr, key.tok_length, key.tok_blanked, key.hmask)];
+  }
+
+  if (!e->resolved)
+    model_resolve(*e, *model_text, tags, key.hmask);
+  return e->info;
+}
+
 /*==========================================================================
  * wasteLexerReader
  */
@@ -406,7 +465,11 @@ void wasteLexer::set_token(mootToken &token, const wasteLexerToken &lex_token)
 //----------------------------------------------------------------------
 wasteLexerReader::wasteLexerReader(int fmt, const std::string &name)
   : TokenReader(fmt,name),
-    scanner(NULL)
+    scanner(NULL),
+    wlr_scan_lextype(NULL),
+    wlr_keyed(false),
+    wlr_lexinfo(NULL),
+    wlr_lextext(NULL)
 {
   tr_token = &wlr_token;
   tr_sentence = &wlr_sentence;
@@ -426,9 +489,14 @@ void wasteLexerReader::from_mstream(mootio::mistream *mistreamp)
 }
 
 //----------------------------------------------------------------------
-void wasteLexerReader::from_reader(TokenReader *reader)
+void wasteLexerReader::from_reader(TokenReader *reader, const wasteLexerType *lextype)
 {
   scanner = reader;
+  wlr_scan_lextype = lextype;
+  if (!lextype) {
+    wasteTokenScanner *wts = dynamic_cast<wasteTokenScanner*>(reader);
+    if (wts) wlr_scan_lextype = &wts->wts_lextype;
+  }
 }
 
 //----------------------------------------------------------------------
@@ -437,6 +505,7 @@ void wasteLexerReader::close(void)
   wlr_token.clear();
   wlr_sentence.clear();
   scanner = NULL;
+  wlr_scan_lextype = NULL;
   lexer.reset();
   TokenReader::close();
 }
@@ -445,6 +514,8 @@ void wasteLexerReader::close(void)
 mootTokenType wasteLexerReader::get_token(void)
 {
   wlr_token.clear();
+  wlr_lexinfo = NULL;
+  wlr_lextext = NULL;
 
   //-- if scanner has not been set return EOF
   if (!scanner)
@@ -454,7 +525,7 @@ mootTokenType wasteLexerReader::get_token(void)
   while (lexer.wl_lexbuf.empty() || ((lexer.wl_state & ls_flush) == 0))
   {
     scanner->get_token();
-    lexer.buffer_token (*(scanner->token()));
+    lexer.buffer_token (*(scanner->token()), wlr_scan_lextype ? *wlr_scan_lextype : NwLexerTypes);
   }
 
   while (!lexer.wl_lexbuf.empty() && lexer.wl_lexbuf.front().wlt_token.tok_type ==  TokTypeUnknown) // skip unknown tokens
@@ -463,15 +534,20 @@ mootTokenType wasteLexerReader::get_token(void)
   }
 
   if (lexer.wl_lexbuf.empty()) return TokTypeEOF;
-  wlr_token = lexer.wl_lexbuf.front().wlt_token;
-  switch (wlr_token.tok_type)
-  {
-    case TokTypeVanilla:
-    case TokTypeLibXML:
-      lexer.set_token(wlr_token, lexer.wl_lexbuf.front());
-      break;
-    default:
-      break;
+  wasteLexerToken &front = lexer.wl_lexbuf.front();
+  bool is_text = (front.wlt_token.tok_type == TokTypeVanilla || front.wlt_token.tok_type == TokTypeLibXML);
+  if (is_text && wlr_keyed) {
+    lexer.model_key(front, wlr_key);
+    if (lexer.wl_hmm)
+      wlr_lexinfo = &lexer.model_lexinfo(wlr_key, wlr_lextext);
+  }
+
+  //-- move token out of its buffer slot, which recycles the (cleared) storage of wlr_token
+  wlr_token.swap(front.wlt_token);
+  if (is_text && !wlr_keyed) {
+    //-- set_token() reads the scanned text from the slot and assigns model text to wlr_token
+    wlr_token.tok_text.swap(front.wlt_token.tok_text);
+    lexer.set_token(wlr_token, front);
   }
 
   //lexer.wl_lexbuf.pop_front(); //-- moocow 2016-11-18: UNSAFE: crashes on kira (g++5, ubuntu-16.04)
@@ -36,6 +36,7 @@
 #define _WASTE_LEXER_H
 
 #include <mootTokenIO.h>
+#include <mootHMM.h>
 #include <wasteTypes.h>
 #include <wasteLexicon.h>
 
@@ -128,8 +129,99 @@ namespace moot
       /** Multi-dimensional vector for constant access on feature bundles */
       typedef std::vector<std::vector<std::vector<std::vector<std::vector<std::vector<std::string> > > > > > wasteTagset;
 
-      /** List of wasteLexerToken for buffering while dehyphenating */
-      typedef std::list<wasteLexerToken> wasteLexerBuffer;
+      /**
+       * \brief FIFO ring buffer of wasteLexerToken for buffering while dehyphenating
+       * \details
+       * Slots are allocated once and recycled, so that buffering a token just
+       * assigns to (or swaps with) the mootToken in a slot, re-using its storage.
+       * Tokens are addressed by absolute Index, which remains valid until the
+       * token is popped, even if the buffer grows.
+       */
+      class wasteLexerBuffer
+      {
+        public:
+          /** Type for absolute token positions */
+          typedef size_t Index;
+
+          /** Index value for "no token" */
+          static const Index npos = static_cast<Index>(-1);
+
+        public:
+          std::vector<wasteLexerToken> lb_slots;  /**< token slots (size is a power of 2) */
+          size_t                       lb_mask;   /**< lb_slots.size()-1 */
+          Index                        lb_begin;  /**< index of first buffered token */
+          Index                        lb_end;    /**< index one past the last buffered token */
+
+        public:
+          /** Constructor: create a buffer with (at least) \a size preallocated slots */
+          wasteLexerBuffer(size_t size=64);
+
+          /** True iff no tokens are buffered */
+          inline bool empty(void) const
+          { return lb_begin == lb_end; };
+
+          /** Number of buffered tokens */
+          inline size_t size(void) const
+          { return lb_end - lb_begin; };
+
+          /** Index of first buffered token */
+          inline Index begin(void) const
+          { return lb_begin; };
+
+          /** Index one past the last buffered token */
+          inline Index end(void) const
+          { return lb_end; };
+
+          /** Get buffered token by absolute index \a i (which must be in [begin(),end()) ) */
+          inline wasteLexerToken &operator[](Index i)
+          { return lb_slots[i & lb_mask]; };
+
+          /** Get first buffered token */
+          inline wasteLexerToken &front(void)
+          { return lb_slots[lb_begin & lb_mask]; };
+
+          /** Get last buffered token */
+          inline wasteLexerToken &back(void)
+          { return lb_slots[(lb_end-1) & lb_mask]; };
+
+          /**
+           * Append a slot and return it.
+           * The slot holds stale data from a previously popped token, which the caller must overwrite.
+           */
+          inline wasteLexerToken &push_back(void)
+          {
+            if (lb_end - lb_begin > lb_mask) grow();
+            return lb_slots[(lb_end++) & lb_mask];
+          };
+
+          /** Remove first buffered token (its slot is recycled) */
+          inline void pop_front(void)
+          { ++lb_begin; };
+
+          /** Remove all buffered tokens */
+          inline void clear(void)
+          { lb_begin = lb_end = 0; };
+
+        protected:
+          /** Double the number of slots, preserving buffered tokens and their indices */
+          void grow(void);
+      };
+
+      /** Lexical data for a single (feature bundle, hidden feature mask) pair, resolved against a bound model */
+      class ModelEntry
+      {
+        public:
+          bool              resolved; /**< whether \a info has been resolved */
+          mootHMM::LexInfo  info;     /**< model token-id, class-id and lexical class */
+        public:
+          ModelEntry(void) : resolved(false) {};
+      };
+
+      /** Vector of ModelEntry, indexed by model_index() */
+      typedef std::vector<ModelEntry> ModelTable;
+
+      /** Lazily resolved ModelEntry vectors for stopword model texts, indexed by hidden feature mask */
+      typedef hash_map<mootTokString,ModelTable> ModelStopTable;
       //@}
 
       //--------------------------------------------------------------------
@@ -192,6 +284,26 @@ namespace moot
       /** hidden features: s[01],S[01],w[01] (except s1,*,w0) */
       static const int n_hidden = 7;
 
+      /** number of hidden feature masks (see hidden_mask()) */
+      static const int n_hidden_masks = 8;
+
+      /** Model features of a single token, independent of any bound model (see model_key()) */
+      class ModelKey
+      {
+        public:
+          cls            tok_class;   /**< typographical class */
+          cas            tok_case;    /**< letter case */
+          binary         tok_abbr;    /**< known abbreviation? */
+          len            tok_length;  /**< text length class */
+          binary         tok_blanked; /**< preceded by whitespace? */
+          int            hmask;       /**< hidden feature mask (see hidden_mask()) */
+          mootTokString  stoptext;    /**< model text for stopwords (empty otherwise) */
+        public:
+          ModelKey(void)
+            : tok_class(other), tok_case(non), tok_abbr(uk), tok_length(le_null), tok_blanked(uk), hmask(0)
+          {};
+      };
+
       //@}
 
       /*--------------------------------------------------------------------
@@ -202,9 +314,9 @@ namespace moot
       //@{
       wasteTagset       wl_tagset;        /**< Token feature bundles */
       int               wl_state;         /**< Current state of the lexer */
-      wasteLexerBuffer  wl_lexbuf;        /**< Buffer for dehyphenation: list of wasteLexerToken */
-      wasteLexerToken  *wl_current_tok;   /**< current token under construction (NULL for none), pointer into wl_lexbuf */
-      wasteLexerToken  *wl_head_tok;      /**< head of hyphenation sequence (NULL for none), pointer into wl_lexbuf */
+      wasteLexerBuffer  wl_lexbuf;        /**< Buffer for dehyphenation: ring buffer of wasteLexerToken */
+      wasteLexerBuffer::Index wl_current_tok; /**< current token under construction (wasteLexerBuffer::npos for none), index into wl_lexbuf */
+      wasteLexerBuffer::Index wl_head_tok;    /**< head of hyphenation sequence (wasteLexerBuffer::npos for none), index into wl_lexbuf */
       bool              wl_dehyph_mode;   /**< Dehyphenation switch */
       //@}
 
@@ -216,6 +328,14 @@ namespace moot
       wasteLexicon      wl_conjunctions;  /**< List of conjunctions (for dehyphenating) */
       //@}
 
+      /*------------------------------------------------------------*/
+      /** \name Model binding (see bind_model()) */
+      //@{
+      mootHMM          *wl_hmm;           /**< bound model, or NULL for none */
+      ModelTable        wl_model;         /**< lexical data for non-stopword tokens, indexed by model_index() */
+      ModelStopTable    wl_model_stop;    /**< lexical data for stopword tokens, by model text */
+      //@}
+
       /*--------------------------------------------------------------------
        * wasteLexer: Methods
        */
@@ -253,18 +373,79 @@ namespace moot
         }
       }
 
+      /** Compute model features of lex_token */
+      void get_features(const wasteLexerToken &lex_token,
+                        cls &tok_class, cas &tok_case, binary &tok_abbr, len &tok_length, binary &tok_blanked) const;
+
+      /** Hidden feature mask for lex_token: bitwise OR of 1 (s), 2 (S), and 4 (w) */
+      inline static int hidden_mask(const wasteLexerToken &lex_token)
+      {
+        return (lex_token.s ? 1 : 0) | (lex_token.S ? 2 : 0) | (lex_token.w ? 4 : 0);
+      }
+
+      /** Whether hidden feature bundle i (1 <= i < n_hidden) is a possible analysis under hidden feature mask hmask */
+      inline static bool hidden_allowed(int i, int hmask)
+      {
+        switch (i)
+        {
+          case 1:  return (hmask & 7) == 0; //-- s0,S0,w0
+          case 2:  return (hmask & 5) == 0; //-- s0,S1,w0
+          case 3:  return (hmask & 3) == 0; //-- s0,S0,w1
+          case 4:  return (hmask & 1) == 0; //-- s0,S1,w1
+          case 5:  return (hmask & 2) == 0; //-- s1,S0,w1
+          default: return true;             //-- s1,S1,w1
+        }
+      }
+
       /** Set token features (token.tok_analyses) w.r.t. model features from source lex_token **/
       void set_token(mootToken &token, const wasteLexerToken &lex_token);
 
       /**
        * copies stok to internal buffer.
        * If wl_dehyph_mode is true, seeks and removes hyphenations.
+       * If \a lextype is NwLexerTypes (default), the lexer type of vanilla tokens
+       * is computed by waste_lexertype(), otherwise \a lextype is used as-is
+       * (see wasteTokenScanner::wts_lextype).
        */
-      void buffer_token(const mootToken& stok);
+      void buffer_token(const mootToken& stok, wasteLexerType lextype=NwLexerTypes);
 
       void reset(void);
       //@}
 
+      /*------------------------------------------------------------*/
+      /** \name Model binding: integer fast path */
+      //@{
+      /**
+       * Bind lexer to model hmm (or unbind if hmm is NULL), discarding any previously resolved data.
+       * Must be called again whenever the model or its \c use_flavors or \c use_lex_classes
+       * flags change.
+       */
+      void bind_model(mootHMM *hmm);
+
+      /** Index into wl_model for a feature bundle and hidden feature mask */
+      inline static size_t model_index(cls tok_class, cas tok_case, binary tok_abbr, len tok_length, binary tok_blanked, int hmask)
+      {
+        return ((((((size_t)tok_class*n_cas + tok_case)*n_binary + tok_abbr)*n_len + tok_length)*n_binary + tok_blanked)*n_hidden_masks + hmask);
+      }
+
+      /**
+       * Compute model features of lex_token into key without building textual analyses.
+       * Does not access the bound model, so keys may be computed and resolved in different threads.
+       */
+      void model_key(const wasteLexerToken &lex_token, ModelKey &key) const;
+
+      /**
+       * Get lexical data for key w.r.t. the bound model, as set_token() followed
+       * by mootHMM::token2lexinfo() would.
+       * On return, model_text points to the model token text (for suffix lookup).
+       * Returned data is valid until the next call to bind_model().
+       */
+      const mootHMM::LexInfo &model_lexinfo(const ModelKey &key, const mootTokString *&model_text);
+
+      /** Resolve entry e for model text model_text, tag strings tags, and hidden feature mask hmask */
+      void model_resolve(ModelEntry &e, const mootTokString &model_text, const std::vector<std::string> &tags, int hmask);
+      //@}
+
       /*------------------------------------------------------------*/
       /** \name low-level utilities */
       //@{
@@ -276,11 +457,40 @@ namespace moot
        */
       inline void lexbuf_pop_front(void)
       {
-	  wasteLexerToken *front = &(wl_lexbuf.front());
-	  if (wl_current_tok==front) wl_current_tok=NULL; 
-	  if (wl_head_tok==front)    wl_head_tok=NULL;
+	  wasteLexerBuffer::Index front = wl_lexbuf.begin();
+	  if (wl_current_tok==front) wl_current_tok=wasteLexerBuffer::npos;
+	  if (wl_head_tok==front)    wl_head_tok=wasteLexerBuffer::npos;
 	  wl_lexbuf.pop_front();
       };
+
+      /**
+       * append a copy of \a stok to wl_lexbuf with extra data (see wasteLexerToken::set_wlt_data()),
+       * re-using the storage of a recycled slot; returns its index
+       */
+      inline wasteLexerBuffer::Index lexbuf_push_back(const mootToken &stok,
+						      wasteLexerType lextype=wLexerTypeOther,
+						      bool blanked=true, bool s=true, bool S=false, bool w=true)
+      {
+	  wasteLexerToken &slot = wl_lexbuf.push_back();
+	  slot.wlt_token = stok;
+	  slot.set_wlt_data(lextype, blanked, s, S, w);
+	  return wl_lexbuf.end()-1;
+      };
+
+      /**
+       * append a copy of \a stok with type \a lextype and features from the current lexer state
+       * (which are then reset); returns its index
+       */
+      inline wasteLexerBuffer::Index lexbuf_push_state(const mootToken &stok, wasteLexerType lextype)
+      {
+	  wasteLexerBuffer::Index i = lexbuf_push_back(stok, lextype,
+						      (wl_state & ls_blanked) ? true : false,
+						      (wl_state & ls_sb_fw) ? true : false,
+						      false,
+						      (wl_state & ls_wb_fw) ? true : false);
+	  wl_state &= ~(ls_blanked|ls_sb_fw|ls_wb_fw);
+	  return i;
+      };
       //@}
   };
 
@@ -299,12 +509,27 @@ namespace moot
     /** data source */
     TokenReader *scanner;
 
+    /** lexer type of the current source token, if provided by the source (NULL otherwise); see from_reader() */
+    const wasteLexerType *wlr_scan_lextype;
+
     /** token buffer for get_token() */
     mootToken wlr_token;
 
     /** sentence/document buffer for get_sentence() */
     mootSentence wlr_sentence;
 
+    /** if true, vanilla tokens are returned with their scanned text, and their model features in wlr_key */
+    bool wlr_keyed;
+
+    /** model features for current token if wlr_keyed is true */
+    wasteLexer::ModelKey wlr_key;
+
+    /** lexical data for current token if a model is bound (NULL otherwise); see bind_model() */
+    const mootHMM::LexInfo *wlr_lexinfo;
+
+    /** model token text for current token if a model is bound (NULL otherwise) */
+    const mootTokString *wlr_lextext;
+
   public:
     //------------------------------------------------------------
     /** \name Constructors etc. */
@@ -328,8 +553,14 @@ namespace moot
      */
     /** \name Input Selection */
     //@{
-    /** Set token source (usually some wasteScanner) */
-    void from_reader(TokenReader *reader);
+    /**
+     * Set token source (usually some wasteScanner).
+     * If \a lextype is non-NULL, it points to the lexer type of the source's
+     * current token (NwLexerTypes if unknown), which saves re-scanning the token
+     * text.  If \a lextype is NULL and \a reader is a wasteTokenScanner, its
+     * wasteTokenScanner::wts_lextype is used.
+     */
+    void from_reader(TokenReader *reader, const wasteLexerType *lextype=NULL);
 
     /** Select input from a mootio::mistream pointer. */
     virtual void from_mstream(mootio::mistream *mistreamp);
@@ -345,6 +576,20 @@ namespace moot
     {
       lexer.wl_dehyph_mode = on;
     };
+
+    /**
+     * Bind to model hmm for the integer fast path (NULL to unbind).
+     * While bound, vanilla tokens are returned with their scanned text and without
+     * textual analyses, and their lexical data is available in wlr_lexinfo;
+     * tag them with mootHMM::tag_stream(this, writer, &wlr_lexinfo, &wlr_lextext).
+     * Only useful if the model tokens themselves are not needed downstream
+     * (e.g. when tagger output is passed to a wasteDecoder).
+     */
+    inline void bind_model(mootHMM *hmm)
+    {
+      lexer.bind_model(hmm);
+      wlr_keyed = (hmm != NULL);
+    };
     //@}
 
     /*------------------------------------------------------------
@@ -19,6 +19,7 @@
 */
 
 #include "wasteLexicon.h"
+#include <algorithm>
 
 moot_BEGIN_NAMESPACE
 
@@ -34,9 +35,89 @@ bool wasteLexicon::load(moot::TokenReader *reader)
     if (toktyp==TokTypeVanilla || toktyp==TokTypeLibXML)
       insert( reader->token()->text() );
   }
+  freeze();
   return true;
 }
 
+//----------------------------------------------------------------------
+/** bucket of keys for wasteLexicon::freeze() */
+struct wasteLexiconBucket {
+  size_t                           id;    /**< bucket index */
+  std::vector<const std::string *> keys;  /**< keys in this bucket */
+
+  /** sort order: larger buckets first */
+  inline bool operator<(const wasteLexiconBucket &b) const
+  { return keys.size() > b.keys.size(); };
+};
+
+//----------------------------------------------------------------------
+void wasteLexicon::freeze(void)
+{
+  thaw();
+  size_t nkeys = lex.size();
+  if (nkeys == 0) {
+    lx_offsets.push_back(0);
+    lx_frozen = true;
+    return;
+  }
+
+  //-- hash-and-displace: try to find a seed for each bucket which maps its keys to free slots,
+  //   largest buckets first; on failure, retry with more (smaller) buckets
+  std::vector<const std::string *> slots;
+  std::vector<size_t> pos;
+  const uint32_t max_seed = 16*nkeys + 1024; //-- ~nkeys tries are expected for the last slot
+  bool ok = false;
+  for (size_t nbuckets = (nkeys+3)/4, ntries=0; !ok && ntries < 4; nbuckets *= 2, ++ntries) {
+    std::vector<wasteLexiconBucket> buckets(nbuckets);
+    for (size_t b=0; b < nbuckets; ++b)
+      buckets[b].id = b;
+    for (Lexicon::const_iterator li=lex.begin(); li != lex.end(); ++li)
+      buckets[hash(li->data(),li->size(),0) % nbuckets].keys.push_back(&(*li));
+    std::stable_sort(buckets.begin(), buckets.end());
+
+    lx_seeds.assign(nbuckets, 0);
+    slots.assign(nkeys, NULL);
+    ok = true;
+    for (size_t b=0; ok && b < nbuckets && !buckets[b].keys.empty(); ++b) {
+      const std::vector<const std::string *> &keys = buckets[b].keys;
+      uint32_t seed;
+      for (seed=1; seed < max_seed; ++seed) {
+	pos.clear();
+	size_t k;
+	for (k=0; k < keys.size(); ++k) {
+	  size_t i = hash(keys[k]->data(), keys[k]->size(), seed) % nkeys;
+	  if (slots[i] || std::find(pos.begin(), pos.end(), i) != pos.end())
+	    break;
+	  pos.push_back(i);
+	}
+	if (k == keys.size())
+	  break;
+      }
+      if (seed >= max_seed) {
+	ok = false;
+	break;
+      }
+      lx_seeds[buckets[b].id] = seed;
+      for (size_t k=0; k < keys.size(); ++k)
+	slots[pos[k]] = keys[k];
+    }
+  }
+  if (!ok) {
+    //-- give up: lookup() uses the hash_set
+    thaw();
+    return;
+  }
+
+  //-- pack keys in slot order
+  lx_offsets.reserve(nkeys+1);
+  for (size_t i=0; i < nkeys; ++i) {
+    lx_offsets.push_back(lx_keys.size());
+    lx_keys.append(*slots[i]);
+  }
+  lx_offsets.push_back(lx_keys.size());
+  lx_frozen = true;
+}
+
 //----------------------------------------------------------------------
 bool wasteLexicon::load(mootio::mistream *mis)
 {
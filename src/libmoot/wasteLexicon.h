@@ -21,7 +21,7 @@
 /**
  * \file wasteLexicon.h
  *
- * \brief simple hash_set<>-based lexicon class for moot::wasteLexer
+ * \brief simple hash_set<>-based lexicon class for moot::wasteLexer, with frozen perfect-hash lookup
  *
  * \author moocow
  * 
@@ -33,24 +33,42 @@
 #define _WASTE_LEXICON_H
 
 #include <mootTokenIO.h>
+#include <wasteCase.h>
+#include <string.h>
 
 moot_BEGIN_NAMESPACE
 
 /*============================================================================
  * wasteLexicon
  */
-/** \brief simple hash_set<>-based lexicon class  */
+/**
+ * \brief simple hash_set<>-based lexicon class
+ * \details
+ * After loading, the lexicon can be frozen (see freeze()) into a read-only minimal
+ * perfect hash over packed keys, which supports lookup of byte spans without
+ * allocating a temporary string.  Any modification thaws the lexicon again;
+ * lookup() on a thawed lexicon uses the underlying hash_set.
+ */
 class wasteLexicon
 {
  public:
   typedef moot_STL_NAMESPACE::hash_set<std::string>  Lexicon;  /**< typedef for underlying lexicon data */
   Lexicon lex;  /**< underlying lexicon data */
 
+  /// \name Frozen representation (see freeze())
+  //@{
+  bool                  lx_frozen;   /**< whether the frozen representation is current */
+  std::vector<uint32_t> lx_seeds;    /**< per-bucket hash seeds (size is the number of buckets) */
+  std::vector<size_t>   lx_offsets;  /**< key i is lx_keys[lx_offsets[i] .. lx_offsets[i+1]-1] (size is lex.size()+1) */
+  std::string           lx_keys;     /**< packed key bytes, ordered by perfect-hash slot */
+  //@}
+
   //------------------------------------------------------------
   /// \name Constructors etc.
   //@{
   /** Default constructor */
   wasteLexicon()
+    : lx_frozen(false)
   {};
 
   /** destructor */
@@ -61,6 +79,7 @@ class wasteLexicon
   inline void clear()
   {
     lex.clear();
+    thaw();
   };
   //@}
 
@@ -70,20 +89,82 @@ class wasteLexicon
   /** \returns true iff \a word is present in the lexicon */
   inline bool lookup(const std::string &word) const
   {
-    return (lex.find(word) != lex.end());
+    if (!lx_frozen)
+      return (lex.find(word) != lex.end());
+    return lookup(word.data(), word.size());
+  };
+
+  /** \returns true iff the \a len bytes at \a word are present in the lexicon; allocation-free if frozen */
+  inline bool lookup(const char *word, size_t len) const
+  {
+    if (!lx_frozen)
+      return (lex.find(std::string(word,len)) != lex.end());
+    if (lx_seeds.empty())
+      return false;
+    size_t i   = hash(word, len, lx_seeds[hash(word,len,0) % lx_seeds.size()]) % (lx_offsets.size()-1);
+    size_t off = lx_offsets[i];
+    return lx_offsets[i+1]-off == len && memcmp(lx_keys.data()+off, word, len) == 0;
+  };
+
+  /**
+   * \returns true iff the lower-cased version of the \a len bytes at \a word is present in the lexicon;
+   * \a buf is used as scratch space (allocation-free if frozen and \a buf has sufficient capacity)
+   */
+  inline bool lookup_lower(const char *word, size_t len, std::string &buf) const
+  {
+    buf.clear();
+    utf8ToLower(word, len, buf);
+    return lookup(buf.data(), buf.size());
   };
 
-  /** insert \a word into the lexicon */
+  /** insert \a word into the lexicon (thaws a frozen lexicon) */
   inline void insert(const std::string &word)
   {
     lex.insert(word);
+    thaw();
+  };
+  //@}
+
+  //------------------------------------------------------------
+  /// \name Frozen representation
+  //@{
+  /**
+   * Compile current contents into a minimal perfect hash for lookup().
+   * Called automatically by load().
+   */
+  void freeze(void);
+
+  /** Discard frozen representation, reverting lookup() to the underlying hash_set */
+  inline void thaw(void)
+  {
+    lx_frozen = false;
+    lx_seeds.clear();
+    lx_offsets.clear();
+    lx_keys.clear();
+  };
+
+  /** Seeded hash function for the \a len bytes at \a s */
+  static inline uint32_t hash(const char *s, size_t len, uint32_t seed)
+  {
+    uint32_t h = 2166136261U ^ (seed * 0x9e3779b9U);
+    for (const char *end=s+len; s < end; ++s) {
+      h ^= static_cast<unsigned char>(*s);
+      h *= 16777619U;
+    }
+    //-- final avalanche (MurmurHash3 fmix32)
+    h ^= h >> 16;
+    h *= 0x85ebca6bU;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35U;
+    h ^= h >> 16;
+    return h;
   };
   //@}
 
   //------------------------------------------------------------
   /// \name I/O
   //@{
-  /** load lexicon from a moot::TokenReader: adds only mootToken::text() of moot::TokTypeVanilla tokens
+  /** load lexicon from a moot::TokenReader: adds only mootToken::text() of moot::TokTypeVanilla tokens, then calls freeze()
    *  \returns true on success, false otherwise
    */
   bool load(moot::TokenReader *reader);
@@ -0,0 +1,411 @@
+/* -*- Mode: C++; coding: utf-8; c-basic-offset: 2; -*- */
+/*
+   libmoot : moot part-of-speech tagging library
+   Copyright (C) 2013-2016 by Bryan Jurish <moocow@cpan.org> and Kay-Michael Würzner
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 3 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#include "wastePipeline.h"
+#include "wasteScanner.h"
+#include "mootUtils.h"
+
+moot_BEGIN_NAMESPACE
+
+//============================================================================
+// wasteTokenQueue
+
+//----------------------------------------------------------------------
+wasteTokenQueue::wasteTokenQueue(size_t size)
+{
+#ifdef MOOT_PTHREADS_ENABLED
+  pthread_mutex_init(&wq_mutex, NULL);
+  pthread_cond_init(&wq_cond, NULL);
+#endif
+  resize(size);
+}
+
+//----------------------------------------------------------------------
+wasteTokenQueue::~wasteTokenQueue(void)
+{
+#ifdef MOOT_PTHREADS_ENABLED
+  pthread_cond_destroy(&wq_cond);
+  pthread_mutex_destroy(&wq_mutex);
+#endif
+}
+
+//----------------------------------------------------------------------
+void wasteTokenQueue::resize(size_t size)
+{
+  size_t n;
+  for (n=2; n < size; n <<= 1) ;
+  wq_slots.resize(n);
+  wq_mask = n-1;
+  reset();
+}
+
+//----------------------------------------------------------------------
+void wasteTokenQueue::reset(void)
+{
+  wq_head   = 0;
+  wq_tail   = 0;
+  wq_closed = false;
+}
+
+//----------------------------------------------------------------------
+void wasteTokenQueue::push(Batch &batch)
+{
+#ifdef MOOT_PTHREADS_ENABLED
+  pthread_mutex_lock(&wq_mutex);
+  while (wq_tail - wq_head > wq_mask)
+    pthread_cond_wait(&wq_cond, &wq_mutex);
+#endif
+  wq_slots[wq_tail & wq_mask].swap(batch);
+  ++wq_tail;
+#ifdef MOOT_PTHREADS_ENABLED
+  pthread_cond_broadcast(&wq_cond);
+  pthread_mutex_unlock(&wq_mutex);
+#endif
+  batch.clear();
+}
+
+//----------------------------------------------------------------------
+void wasteTokenQueue::close(void)
+{
+#ifdef MOOT_PTHREADS_ENABLED
+  pthread_mutex_lock(&wq_mutex);
+#endif
+  wq_closed = true;
+#ifdef MOOT_PTHREADS_ENABLED
+  pthread_cond_broadcast(&wq_cond);
+  pthread_mutex_unlock(&wq_mutex);
+#endif
+}
+
+//----------------------------------------------------------------------
+bool wasteTokenQueue::pop(Batch &batch)
+{
+  bool rc = true;
+#ifdef MOOT_PTHREADS_ENABLED
+  pthread_mutex_lock(&wq_mutex);
+  while (wq_head == wq_tail && !wq_closed)
+    pthread_cond_wait(&wq_cond, &wq_mutex);
+#endif
+  if (wq_head == wq_tail) {
+    //-- empty and closed
+    rc = false;
+  } else {
+    wq_slots[wq_head & wq_mask].swap(batch);
+    ++wq_head;
+  }
+#ifdef MOOT_PTHREADS_ENABLED
+  pthread_cond_broadcast(&wq_cond);
+  pthread_mutex_unlock(&wq_mutex);
+#endif
+  return rc;
+}
+
+//============================================================================
+// wasteQueueReader
+
+//----------------------------------------------------------------------
+mootTokenType wasteQueueReader::get_token(void)
+{
+  wqr_lexinfo = NULL;
+  wqr_lextext = NULL;
+  wqr_lextype = NwLexerTypes;
+
+  while (wqr_pos >= wqr_batch.size()) {
+    wqr_pos = 0;
+    if (!wqr_queue || !wqr_queue->pop(wqr_batch)) {
+      wqr_batch.clear();
+      tr_token = &wqr_eof;
+      return TokTypeEOF;
+    }
+  }
+
+  wastePipelineItem &item = wqr_batch[wqr_pos++];
+  tr_token = &item.wpi_token;
+  wqr_lextype = item.wpi_lextype;
+  if (item.wpi_keyed && wqr_resolver && wqr_resolver->wl_hmm)
+    wqr_lexinfo = &wqr_resolver->model_lexinfo(item.wpi_key, wqr_lextext);
+
+  return item.wpi_token.tok_type;
+}
+
+//============================================================================
+// wasteQueueWriter
+
+//----------------------------------------------------------------------
+void wasteQueueWriter::flush_batch(void)
+{
+  if (!wqw_batch.empty() && wqw_queue)
+    wqw_queue->push(wqw_batch);
+}
+
+//----------------------------------------------------------------------
+wastePipelineItem &wasteQueueWriter::put_item(const mootToken &token, wastePipelineItem::Call call)
+{
+  if (wqw_batch.size() >= wqw_batch_size)
+    flush_batch();
+  wqw_batch.push_back(wastePipelineItem());
+  wastePipelineItem &item = wqw_batch.back();
+  item.wpi_token = token;
+  item.wpi_call  = call;
+  return item;
+}
+
+//----------------------------------------------------------------------
+void wasteQueueWriter::close(void)
+{
+  flush_batch();
+  if (wqw_queue) wqw_queue->close();
+}
+
+//----------------------------------------------------------------------
+void wasteQueueWriter::put_tokens(const mootSentence &tokens)
+{
+  for (mootSentence::const_iterator si=tokens.begin(); si != tokens.end(); ) {
+    const mootToken &tok = *si;
+    put_item(tok, (++si)==tokens.end() ? wastePipelineItem::pcTokensEnd : wastePipelineItem::pcTokens);
+  }
+}
+
+//----------------------------------------------------------------------
+void wasteQueueWriter::put_sentence(const mootSentence &sentence)
+{
+  for (mootSentence::const_iterator si=sentence.begin(); si != sentence.end(); ) {
+    const mootToken &tok = *si;
+    put_item(tok, (++si)==sentence.end() ? wastePipelineItem::pcSentenceEnd : wastePipelineItem::pcSentence);
+  }
+}
+
+//============================================================================
+// wastePipeline: Constructors etc.
+
+//----------------------------------------------------------------------
+wastePipeline::wastePipeline(void)
+  : wp_source(NULL),
+    wp_lexer(NULL),
+    wp_hmm(NULL),
+    wp_sink(NULL),
+    wp_fastpath(true),
+    wp_verbose(vlErrors),
+    wp_batch_size(256),
+    wp_queue_size(16),
+    wp_ntokens(0),
+    q_lexer(-1),
+    q_tagger(-1),
+    q_sink(-1)
+{}
+
+//============================================================================
+// wastePipeline: Stages
+
+//----------------------------------------------------------------------
+void wastePipeline::run_sequential(void)
+{
+  TokenReader *reader = wp_lexer ? static_cast<TokenReader*>(wp_lexer) : wp_source;
+  if (wp_hmm) {
+    if (wp_lexer && wp_fastpath) {
+      //-- no threads: resolve model data directly in the lexer
+      if (wp_lexer->lexer.wl_hmm != wp_hmm) wp_lexer->bind_model(wp_hmm);
+      wp_hmm->tag_stream(reader, wp_sink, &wp_lexer->wlr_lexinfo, &wp_lexer->wlr_lextext);
+    } else {
+      wp_hmm->tag_stream(reader, wp_sink);
+    }
+  } else {
+    wp_ntokens = TokenIO::pipe_tokens(reader, wp_sink);
+  }
+}
+
+//----------------------------------------------------------------------
+void wastePipeline::run_sink(void)
+{
+  wasteTokenQueue::Batch batch;
+  mootSentence sent;
+  while (wp_queues[q_sink].pop(batch)) {
+    for (wasteTokenQueue::Batch::const_iterator bi=batch.begin(); bi != batch.end(); ++bi) {
+      switch (bi->wpi_call) {
+      case wastePipelineItem::pcTokens:
+      case wastePipelineItem::pcSentence:
+	sent.push_back(bi->wpi_token);
+	break;
+      case wastePipelineItem::pcTokensEnd:
+	sent.push_back(bi->wpi_token);
+	wp_sink->put_tokens(sent);
+	sent.clear();
+	break;
+      case wastePipelineItem::pcSentenceEnd:
+	sent.push_back(bi->wpi_token);
+	wp_sink->put_sentence(sent);
+	sent.clear();
+	break;
+      case wastePipelineItem::pcToken:
+      default:
+	wp_sink->put_token(bi->wpi_token);
+	++wp_ntokens;
+	break;
+      }
+    }
+  }
+}
+
+#ifdef MOOT_PTHREADS_ENABLED
+//----------------------------------------------------------------------
+void *wastePipeline::_run_source(void *data)
+{
+  wastePipeline   *wp = reinterpret_cast<wastePipeline*>(data);
+  wasteQueueWriter &w = wp->wp_writers[0];
+  wasteTokenScanner *wts = wp->wp_lexer ? dynamic_cast<wasteTokenScanner*>(wp->wp_source) : NULL;
+  const wasteLexerType *lextype = wts ? &wts->wts_lextype : NULL;
+  while (wp->wp_source->get_token() != TokTypeEOF) {
+    wastePipelineItem &item = w.put_item(*(wp->wp_source->token()), wastePipelineItem::pcToken);
+    if (lextype) item.wpi_lextype = *lextype;
+  }
+  w.close();
+  return NULL;
+}
+
+//----------------------------------------------------------------------
+void *wastePipeline::_run_lexer(void *data)
+{
+  wastePipeline    *wp  = reinterpret_cast<wastePipeline*>(data);
+  wasteLexerReader *wlr = wp->wp_lexer;
+  wasteQueueWriter &w   = wp->wp_writers[wp->q_lexer+1];
+  mootTokenType typ;
+  while ((typ=wlr->get_token()) != TokTypeEOF) {
+    wastePipelineItem &item = w.put_item(*(wlr->token()), wastePipelineItem::pcToken);
+    if (wlr->wlr_keyed && (typ==TokTypeVanilla || typ==TokTypeLibXML)) {
+      item.wpi_keyed = true;
+      item.wpi_key   = wlr->wlr_key;
+    }
+  }
+  w.close();
+  return NULL;
+}
+
+//----------------------------------------------------------------------
+void *wastePipeline::_run_tagger(void *data)
+{
+  wastePipeline    *wp = reinterpret_cast<wastePipeline*>(data);
+  wasteQueueReader &r  = wp->wp_readers[wp->q_tagger];
+  wasteQueueWriter &w  = wp->wp_writers[wp->q_sink];
+  if (r.wqr_resolver)
+    wp->wp_hmm->tag_stream(&r, &w, &r.wqr_lexinfo, &r.wqr_lextext);
+  else
+    wp->wp_hmm->tag_stream(&r, &w);
+  w.close();
+  return NULL;
+}
+#endif /* MOOT_PTHREADS_ENABLED */
+
+//============================================================================
+// wastePipeline: Top-level
+
+//----------------------------------------------------------------------
+bool wastePipeline::run(mootio::mistream *in)
+{
+  size_t ntokens0 = wp_hmm ? wp_hmm->ntokens : 0;
+  bool   rc       = true;
+  wp_ntokens      = 0;
+
+  //-- select input (lexer passes it on to its scanner)
+  if (wp_lexer) {
+    wp_lexer->from_reader(wp_source);
+    wp_lexer->from_mstream(in);
+  } else {
+    wp_source->from_mstream(in);
+  }
+
+#ifndef MOOT_PTHREADS_ENABLED
+  run_sequential();
+
+#else /* MOOT_PTHREADS_ENABLED */
+  //-- assign queues: wp_queues[i] feeds the i-th stage after the source
+  int nq = 0;
+  q_lexer  = wp_lexer ? nq++ : -1;
+  q_tagger = wp_hmm   ? nq++ : -1;
+  q_sink   = nq++;
+  for (int i=0; i < nq; ++i) {
+    if (wp_queues[i].wq_slots.size() < wp_queue_size) wp_queues[i].resize(wp_queue_size);
+    else wp_queues[i].reset();
+    wp_readers[i].wqr_queue    = &wp_queues[i];
+    wp_readers[i].wqr_resolver = NULL;
+    wp_readers[i].wqr_pos      = 0;
+    wp_readers[i].wqr_batch.clear();
+    wp_writers[i].wqw_queue      = &wp_queues[i];
+    wp_writers[i].wqw_batch_size = wp_batch_size ? wp_batch_size : 1;
+    wp_writers[i].wqw_batch.clear();
+  }
+  wp_writers[q_sink].tw_format = wp_sink->tw_format;
+
+  //-- fast path: key tokens in the lexer thread, resolve them in the tagger thread
+  bool fast = wp_fastpath && wp_lexer && wp_hmm;
+  if (wp_lexer) {
+    if (wp_lexer->lexer.wl_hmm) wp_lexer->lexer.bind_model(NULL);
+    wp_lexer->wlr_keyed = fast;
+    wp_lexer->from_reader(&wp_readers[q_lexer], &wp_readers[q_lexer].wqr_lextype);
+  }
+  if (fast) {
+    if (wp_resolver.wl_hmm != wp_hmm) wp_resolver.bind_model(wp_hmm);
+    wp_readers[q_tagger].wqr_resolver = &wp_resolver;
+  }
+
+  //-- start stage threads from downstream to upstream, so that a failed
+  //   stage can close its output queue without blocking any running stage
+  pthread_t threads[3];
+  int nthreads = 0;
+  struct { void *(*fn)(void*); int qout; } stages[3];
+  int nstages = 0;
+  if (wp_hmm) {
+    stages[nstages].fn   = _run_tagger;
+    stages[nstages].qout = q_sink;
+    ++nstages;
+  }
+  if (wp_lexer) {
+    stages[nstages].fn   = _run_lexer;
+    stages[nstages].qout = q_lexer+1;
+    ++nstages;
+  }
+  stages[nstages].fn   = _run_source;
+  stages[nstages].qout = 0;
+  ++nstages;
+
+  for (int i=0; i < nstages; ++i) {
+    if (pthread_create(&threads[nthreads], NULL, stages[i].fn, this) != 0) {
+      moot_msg(wp_verbose, vlErrors, "wastePipeline::run(): could not create stage thread\n");
+      wp_queues[stages[i].qout].close();
+      rc = false;
+      break;
+    }
+    ++nthreads;
+  }
+
+  //-- sink stage runs here
+  run_sink();
+
+  for (int i=0; i < nthreads; ++i)
+    pthread_join(threads[i], NULL);
+
+  //-- restore lexer input
+  if (wp_lexer) wp_lexer->from_reader(wp_source);
+#endif /* MOOT_PTHREADS_ENABLED */
+
+  if (wp_hmm) wp_ntokens = wp_hmm->ntokens - ntokens0;
+  return rc;
+}
+
+moot_END_NAMESPACE
@@ -0,0 +1,269 @@
+/* -*- Mode: C++; coding: utf-8; c-basic-offset: 2; -*- */
+/*
+   libmoot : moot part-of-speech tagging library
+   Copyright (C) 2013-2016 by Bryan Jurish <moocow@cpan.org> and Kay-Michael Würzner
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 3 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+/**
+ * \file wastePipeline.h
+ *
+ * \brief multi-threaded execution of the waste tokenizer stages
+ *
+ * \author moocow
+ *
+ * \date 2026
+ *
+ */
+
+#ifndef _WASTE_PIPELINE_H
+#define _WASTE_PIPELINE_H
+
+#include <mootTokenIO.h>
+#include <mootHMM.h>
+#include <wasteLexer.h>
+
+#ifdef MOOT_PTHREADS_ENABLED
+# include <pthread.h>
+#endif
+
+moot_BEGIN_NAMESPACE
+
+/*============================================================================
+ * wastePipelineItem
+ */
+/** \brief single token passed between pipeline stages */
+class wastePipelineItem
+{
+public:
+  /** how a token was passed to a wasteQueueWriter */
+  enum Call {
+    pcToken,        /**< put_token() */
+    pcTokens,       /**< put_tokens(), not the last token */
+    pcTokensEnd,    /**< put_tokens(), last token */
+    pcSentence,     /**< put_sentence(), not the last token */
+    pcSentenceEnd   /**< put_sentence(), last token */
+  };
+
+  mootToken             wpi_token;  /**< the token itself */
+  bool                  wpi_keyed;  /**< whether wpi_key is valid (see wasteLexerReader::wlr_keyed) */
+  wasteLexer::ModelKey  wpi_key;    /**< model features for keyed tokens */
+  wasteLexerType        wpi_lextype;/**< lexer type determined by the scanner, or NwLexerTypes */
+  Call                  wpi_call;   /**< writer call which produced this item */
+
+public:
+  wastePipelineItem(void)
+    : wpi_keyed(false), wpi_lextype(NwLexerTypes), wpi_call(pcToken)
+  {};
+};
+
+/*============================================================================
+ * wasteTokenQueue
+ */
+/**
+ * \brief bounded single-producer single-consumer queue of token batches
+ * \details
+ * Ring buffer of wastePipelineItem batches guarded by a mutex: exactly one
+ * thread may call push() and close(), and exactly one other thread may call pop().
+ * Batches are exchanged by swapping, so their storage is recycled.
+ * A blocked producer or consumer waits on a condition variable until it can proceed.
+ */
+class wasteTokenQueue
+{
+public:
+  /** Type for a batch of items */
+  typedef std::vector<wastePipelineItem> Batch;
+
+public:
+  std::vector<Batch>  wq_slots;   /**< ring buffer (size is a power of 2) */
+  size_t              wq_mask;    /**< wq_slots.size()-1 */
+  size_t              wq_head;    /**< number of batches popped */
+  size_t              wq_tail;    /**< number of batches pushed */
+  bool                wq_closed;  /**< true after close() */
+#ifdef MOOT_PTHREADS_ENABLED
+  pthread_mutex_t     wq_mutex;   /**< guards \a wq_head, \a wq_tail, \a wq_closed, and slot hand-over */
+  pthread_cond_t      wq_cond;    /**< signals batch hand-over in either direction */
+#endif
+
+public:
+  /** Constructor: create a queue holding up to (at least) \a size batches */
+  wasteTokenQueue(size_t size=16);
+
+  /** Destructor */
+  ~wasteTokenQueue(void);
+
+  /** Set capacity to (at least) \a size batches and reset() (not thread-safe) */
+  void resize(size_t size);
+
+  /** Reset an empty or drained queue for re-use (not thread-safe) */
+  void reset(void);
+
+  /** Append \a batch (which is swapped with a recycled empty batch); blocks while the queue is full */
+  void push(Batch &batch);
+
+  /** Signal end of input to the consumer */
+  void close(void);
+
+  /**
+   * Remove the oldest batch into \a batch (whose old contents are recycled).
+   * Blocks while the queue is empty; returns false if the queue is empty and closed.
+   */
+  bool pop(Batch &batch);
+};
+
+/*============================================================================
+ * wasteQueueReader
+ */
+/** \brief TokenReader reading tokens from a wasteTokenQueue */
+class wasteQueueReader : public TokenReader
+{
+public:
+  wasteTokenQueue        *wqr_queue;    /**< data source */
+  wasteTokenQueue::Batch  wqr_batch;    /**< current batch */
+  size_t                  wqr_pos;      /**< position of next item in wqr_batch */
+  mootToken               wqr_eof;      /**< token returned at end of input */
+  wasteLexer             *wqr_resolver; /**< if non-NULL and bound, resolves keyed items into wqr_lexinfo */
+  const mootHMM::LexInfo *wqr_lexinfo;  /**< lexical data for current token, if resolved (NULL otherwise) */
+  const mootTokString    *wqr_lextext;  /**< model text for current token, if resolved (NULL otherwise) */
+  wasteLexerType          wqr_lextype;  /**< scanner lexer type for current token (see wastePipelineItem::wpi_lextype) */
+
+public:
+  /** Default constructor */
+  wasteQueueReader(wasteTokenQueue *queue=NULL, int fmt=tiofUnknown, const std::string &name="wasteQueueReader")
+    : TokenReader(fmt,name),
+      wqr_queue(queue),
+      wqr_pos(0),
+      wqr_eof(TokTypeEOF),
+      wqr_resolver(NULL),
+      wqr_lexinfo(NULL),
+      wqr_lextext(NULL),
+      wqr_lextype(NwLexerTypes)
+  {
+    tr_token = &wqr_eof;
+  };
+
+  /** Get next token from the queue: returns TokTypeEOF (repeatedly) once the queue is closed and drained */
+  virtual mootTokenType get_token(void);
+};
+
+/*============================================================================
+ * wasteQueueWriter
+ */
+/** \brief TokenWriter writing token batches to a wasteTokenQueue */
+class wasteQueueWriter : public TokenWriter
+{
+public:
+  wasteTokenQueue        *wqw_queue;      /**< data sink */
+  wasteTokenQueue::Batch  wqw_batch;      /**< current batch */
+  size_t                  wqw_batch_size; /**< maximum number of items per batch */
+
+public:
+  /** Default constructor */
+  wasteQueueWriter(wasteTokenQueue *queue=NULL, size_t batch_size=256, int fmt=tiofWellDone, const std::string &name="wasteQueueWriter")
+    : TokenWriter(fmt,name),
+      wqw_queue(queue),
+      wqw_batch_size(batch_size)
+  {};
+
+  /** Push current batch (if any) to the queue */
+  void flush_batch(void);
+
+  /** Append a copy of \a token to the current batch, returning the new item */
+  wastePipelineItem &put_item(const mootToken &token, wastePipelineItem::Call call);
+
+  /** Flush current batch and close the queue */
+  virtual void close(void);
+
+  virtual void put_token(const mootToken &token)
+  { put_item(token, wastePipelineItem::pcToken); };
+
+  virtual void put_tokens(const mootSentence &tokens);
+  virtual void put_sentence(const mootSentence &sentence);
+};
+
+/*============================================================================
+ * wastePipeline
+ */
+/**
+ * \brief runs the waste tokenizer stages (reader, lexer, tagger, writer) in parallel threads
+ * \details
+ * Each stage runs in its own thread, and adjacent stages are connected by a
+ * wasteTokenQueue.  Output is identical to the sequential chain
+ * \c hmm->tag_stream(lexer,sink) (resp. \c TokenIO::pipe_tokens()).
+ * If both lexer and tagger stages are present and \a wp_fastpath is true, lexical
+ * data is passed as wasteLexer::ModelKey and resolved in the tagger thread
+ * (see wasteLexerReader::bind_model()).
+ * Without POSIX threads support, run() just executes the stages sequentially.
+ */
+class wastePipeline
+{
+public:
+  //------------------------------------------------------------
+  /// \name configuration
+  //@{
+  TokenReader       *wp_source;      /**< first stage: scanner or other token source (required) */
+  wasteLexerReader  *wp_lexer;       /**< lexer stage, or NULL for none; its input is set by run() */
+  mootHMM           *wp_hmm;         /**< tagger stage, or NULL for none */
+  TokenWriter       *wp_sink;        /**< final stage: token sink (required) */
+  bool               wp_fastpath;    /**< whether to pass model keys from lexer to tagger */
+  int                wp_verbose;     /**< verbosity level for error messages */
+  size_t             wp_batch_size;  /**< number of tokens per batch */
+  size_t             wp_queue_size;  /**< number of batches per queue */
+  //@}
+
+  //------------------------------------------------------------
+  /// \name stage data
+  //@{
+  wasteTokenQueue    wp_queues[3];   /**< inter-stage queues */
+  wasteQueueReader   wp_readers[3];  /**< stage inputs: wp_readers[i] reads from wp_queues[i] */
+  wasteQueueWriter   wp_writers[3];  /**< stage outputs: wp_writers[i] writes to wp_queues[i] */
+  wasteLexer         wp_resolver;    /**< model binding for fast path (tagger thread only) */
+  size_t             wp_ntokens;     /**< number of tokens processed by the last call to run() */
+  //@}
+
+public:
+  /** Default constructor */
+  wastePipeline(void);
+
+  /**
+   * Process a single input stream \a in through all configured stages.
+   * The sink stage runs in the calling thread.
+   * Returns false if a stage thread could not be created, in which
+   * case output is truncated.
+   */
+  bool run(mootio::mistream *in);
+
+protected:
+  /** Indices of queues feeding the lexer, tagger, and sink stages (-1 for none) */
+  int q_lexer, q_tagger, q_sink;
+
+  /** Run all stages sequentially in the calling thread */
+  void run_sequential(void);
+
+  /** Sink stage: replay writer calls from queue \a q_sink to \a wp_sink */
+  void run_sink(void);
+
+#ifdef MOOT_PTHREADS_ENABLED
+  /** Thread entry points: \a data is a pointer to the wastePipeline */
+  static void *_run_source(void *data);
+  static void *_run_lexer(void *data);
+  static void *_run_tagger(void *data);
+#endif
+};
+
+moot_END_NAMESPACE
+
+#endif /* _WASTE_PIPELINE_H */
@@ -19,10 +19,27 @@
    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 */
 
+#ifdef HAVE_CONFIG_H
+# include <mootConfig.h>
+#endif
+
 #include "wasteTypes.h"
 #include "wasteScanner.h"
 #include <string.h>  //-- for memcpy()
 
+#if defined(HAVE_SYS_MMAN_H) && defined(HAVE_MMAP)
+# include <sys/types.h>
+# include <sys/stat.h>
+# include <sys/mman.h>
+# include <unistd.h>
+# if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#  define MAP_ANONYMOUS MAP_ANON
+# endif
+# ifdef MAP_ANONYMOUS
+#  define WASTE_MMAP_ENABLED 1
+# endif
+#endif
+
 namespace moot {
 
 /*==========================================================================
@@ -41,7 +58,10 @@ wasteScanner::wasteScanner(const std::string &myname,
     yylimit(NULL),
     yytoken(NULL),
     yymarker(NULL),
-    buffer_size(init_bufsize)
+    buffer_size(init_bufsize),
+    yyinput(NULL),
+    yymap(NULL),
+    yymap_size(0)
 {
   yybuffer = new char[buffer_size];
   yycursor = yylimit = yytoken = yymarker = yybuffer;
@@ -53,12 +73,17 @@ wasteScanner::~wasteScanner()
 {
   if (yybuffer)
     delete[] yybuffer;
+#ifdef WASTE_MMAP_ENABLED
+  if (yymap)
+    munmap(yymap, yymap_size);
+#endif
 }
 
 //----------------------------------------------------------------------
 bool wasteScanner::fill( size_t n )
 {
-  if ( !mglin || mglin->eof() ) {
+  if ( yyinput || !mglin || mglin->eof() ) {
+    //-- borrowed input buffers are always complete (and NUL-padded)
     return  (yycursor >= yylimit) ? false : true; //-- moo: beware of (yytoken < yycursor) -- require NUL EOF sentinel!
   }
 
@@ -108,6 +133,13 @@ bool wasteScanner::fill( size_t n )
 void wasteScanner::reset(void)
 {
   GenericLexer::reset();
+#ifdef WASTE_MMAP_ENABLED
+  if (yymap)
+    munmap(yymap, yymap_size);
+#endif
+  yyinput    = NULL;
+  yymap      = NULL;
+  yymap_size = 0;
   yycursor = yylimit = yytoken = yymarker = yybuffer;
 }
 
@@ -124,6 +156,53 @@ void wasteScanner::from_mstream (mootio::mistream *in)
     reset();
 }
 
+//----------------------------------------------------------------------
+void wasteScanner::borrow_buffer (const char *buf, size_t len)
+{
+  reset();
+  yyinput  = buf;
+  yycursor = yytoken = yymarker = const_cast<char*>(buf);
+  yylimit  = yycursor + len + 1; //-- include NUL-byte pseudo-EOF
+}
+
+//----------------------------------------------------------------------
+bool wasteScanner::map_file (FILE *file)
+{
+  reset();
+#ifdef WASTE_MMAP_ENABLED
+  struct stat st;
+  int fd = file ? fileno(file) : -1;
+  if (fd < 0 || fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+    return false;
+
+  off_t pos = ftello(file);
+  if (pos < 0 || pos >= st.st_size)
+    return false;
+
+  //-- reserve zero-filled pages for file + padding, then map the file over them
+  size_t len      = st.st_size;
+  size_t pagesize = sysconf(_SC_PAGESIZE);
+  size_t size     = ((len + BUFFER_PADDING + pagesize - 1) / pagesize) * pagesize;
+  void  *base     = mmap(NULL, size, PROT_READ, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+  if (base == MAP_FAILED)
+    return false;
+  if (mmap(base, len, PROT_READ, MAP_PRIVATE|MAP_FIXED, fd, 0) == MAP_FAILED) {
+    munmap(base, size);
+    return false;
+  }
+# ifdef MADV_SEQUENTIAL
+  madvise(base, len, MADV_SEQUENTIAL);
+# endif
+
+  borrow_buffer(static_cast<const char*>(base) + pos, len - pos);
+  yymap      = base;
+  yymap_size = size;
+  return true;
+#else
+  return false;
+#endif /* WASTE_MMAP_ENABLED */
+}
+
 /*==========================================================================
  * wasteTokenScanner
  */
@@ -131,7 +210,9 @@ void wasteScanner::from_mstream (mootio::mistream *in)
 //----------------------------------------------------------------------
 wasteTokenScanner::wasteTokenScanner(int fmt, const std::string &name)
   : TokenReader(fmt,name),
-    scanner(name)
+    scanner(name),
+    wts_lextype(NwLexerTypes),
+    wts_mmap(false)
 {
   tr_token = &wts_token;
   tr_sentence = &wts_sentence;
@@ -146,6 +227,11 @@ void wasteTokenScanner::from_mstream(mootio::mistream *mistreamp)
 {
   tr_istream         = mistreamp;
   tr_istream_created = false;
+  if (wts_mmap) {
+    mootio::mcstream *mcs = dynamic_cast<mootio::mcstream*>(mistreamp);
+    if (mcs && scanner.map_file(mcs->file))
+      return;
+  }
   scanner.from_mstream(tr_istream);
 }
 
@@ -163,6 +249,7 @@ mootTokenType wasteTokenScanner::get_token(void)
 {
   int scantyp = scanner.yylex();
   wts_token.clear();
+  wts_lextype = NwLexerTypes;
 
   //-- token type
   switch ( scantyp ) {
@@ -173,18 +260,22 @@ mootTokenType wasteTokenScanner::get_token(void)
   case wScanTypePercent:	wts_token.text("%"); break;    
   case wScanTypeComment:
     wts_token.toktype(TokTypeComment);
-    wts_token.text( scanner.yytext().substr(2, scanner.yytext().size()-4) );
+    wts_token.tok_text.assign( scanner.yytoken+2, scanner.yyleng()-4 );
     break;
   default: break;
   }
 
-  //-- token text
+  //-- token text: assigned in place from the scan buffer
   if (wts_token.text().empty())
-    wts_token.text(scanner.yytext());
+    scanner.yytext(wts_token.tok_text);
 
   //-- token location
   wts_token.location( scanner.theByte-scanner.yyleng(), scanner.yyleng() );
 
+  //-- lexer type, if the scan already determines it
+  if ( wts_token.tok_type == TokTypeVanilla )
+    wts_lextype = waste_scan_lexertype( static_cast<wasteScannerType>(scantyp), scanner.yytoken, scanner.yyleng() );
+
   //-- +Tagged: set tag text
   if ( tr_format&tiofTagged )
     wts_token.besttag( wasteScannerTypeNames[scantyp] );
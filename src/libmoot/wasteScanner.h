@@ -36,6 +36,7 @@
 #define _WASTE_SCANNER_H
 
 #include <mootTokenIO.h> //-- includes TokenLexer -> GenericLexer -> BufferIO -> Utils -> CIO -> IO
+#include <wasteTypes.h>
 
 namespace moot
 {
@@ -61,8 +62,14 @@ namespace moot
       char*       yytoken;              /**< beginning of current token */
       char*       yymarker;             /**< last matching position */
       size_t      buffer_size;          /**< current allocated length of yybuffer */
+      const char* yyinput;              /**< borrowed input buffer (see borrow_buffer()), or NULL */
+      void*       yymap;                /**< base address of mmap()ed input (see map_file()), or NULL */
+      size_t      yymap_size;           /**< length of yymap */
       //@}
 
+      /** Number of NUL bytes which must follow borrowed input buffers (see borrow_buffer()) */
+      static const size_t BUFFER_PADDING = 16;
+
       /*--------------------------------------------------------------------
        * mootWasteScanner: Methods
        */
@@ -120,6 +127,12 @@ namespace moot
 	return std::string ( yytoken, yytoken + yyleng () );
       }
 
+      /** Assigns contents of the current segment to \a text (re-using its storage). */
+      inline std::string &yytext (std::string &text)
+      {
+	return text.assign ( yytoken, yyleng () );
+      }
+
       /** Returns length of the current segment. */
       inline int yyleng ()
       {
@@ -134,6 +147,23 @@ namespace moot
 
       /** Switches input source */
       virtual void from_mstream (mootio::mistream *in);
+
+      /**
+       * Switches input source to the caller-owned buffer \a buf of length \a len,
+       * which is scanned in place without copying.
+       * The BUFFER_PADDING bytes following \a buf+len must be readable and NUL;
+       * the buffer must remain valid until the next call to reset().
+       */
+      virtual void borrow_buffer (const char *buf, size_t len);
+
+      /**
+       * Switches input source to the remainder of the regular file \a file
+       * (from its current position), which is mmap()ed and scanned in place.
+       * Returns false (leaving the scanner reset) if \a file cannot be mapped,
+       * e.g. for pipes, terminals, empty files, or if mmap() support is disabled.
+       * The position of \a file is not changed; the mapping is released by reset().
+       */
+      virtual bool map_file (FILE *file);
       //@}
   };
 
@@ -155,6 +185,19 @@ namespace moot
     /** sentence/document buffer for get_sentence() */
     mootSentence wts_sentence;
 
+    /**
+     * Lexer type of the current token as determined by the scan itself,
+     * or NwLexerTypes if unknown (see waste_scan_lexertype())
+     */
+    wasteLexerType wts_lextype;
+
+    /**
+     * Whether from_mstream() should scan regular files in place via
+     * wasteScanner::map_file() rather than reading them through the stream
+     * (default: false)
+     */
+    bool wts_mmap;
+
   public:
     //------------------------------------------------------------
     /** \name Constructors etc. */
@@ -179,7 +222,11 @@ namespace moot
     /** \name Input Selection */
     //@{
     
-    /** Select input from a mootio::mistream pointer. */
+    /**
+     * Select input from a mootio::mistream pointer.
+     * If \a wts_mmap is true and \a mistreamp is a C stream on a regular file,
+     * the file is scanned in place.
+     */
     virtual void from_mstream(mootio::mistream *mistreamp);
 
     /**
@@ -73,4 +73,89 @@ const char *wasteLexerTypeNames[NwLexerTypes] =
     "Other",
   };
 
+//----------------------------------------------------------------------
+wasteLexerTypeE waste_scan_lexertype(wasteScannerTypeE scantype, const char *text, size_t len)
+{
+  const unsigned char *s = reinterpret_cast<const unsigned char*>(text);
+  size_t i;
+  if (len == 0) return NwLexerTypes;
+
+  switch (scantype) {
+  case wScanTypeNewline:
+    return wLexerTypeNewline;
+
+  case wScanTypePercent:
+    return wLexerTypePercent;
+
+  case wScanTypeHyphen:
+    //-- HYPH segments are a single hyphen character
+    return wLexerTypeHyph;
+
+  case wScanTypeSpace:
+    if (s[0]==' ' || s[0]=='\t' || s[0]=='\r' || s[0]=='\f' || (len > 1 && s[0]==0xC2 && s[1]==0xA0))
+      return wLexerTypeSpace;
+    break;
+
+  case wScanTypePunct:
+    //-- non-ASCII SC segments are left to waste_lexertype()
+    switch (s[0]) {
+    case '?':
+    case '!':  return wLexerTypeEOS;
+    case '.':  return wLexerTypeDot;
+    case ',':  return wLexerTypeComma;
+    case '%':  return wLexerTypePercent;
+    case '$':  return wLexerTypeMonetary;
+    case '+':  return wLexerTypePlus;
+    case ':':  return wLexerTypeColon;
+    case ';':  return wLexerTypeSemicolon;
+    case '\'':
+    case '`':  return wLexerTypeApostrophe;
+    case '"':  return wLexerTypeQuote;
+    case '(':
+    case '[':
+    case '{':  return wLexerTypeLBR;
+    case ')':
+    case ']':
+    case '}':  return wLexerTypeRBR;
+    case '/':
+    case '\\': return wLexerTypeSlash;
+    default:
+      if (s[0] < 0x80) return wLexerTypePunct;
+      break;
+    }
+    break;
+
+  case wScanTypeNumber:
+    //-- ASCII digits only; other numeric characters are left to waste_lexertype()
+    for (i=0; i < len && s[i] >= '0' && s[i] <= '9'; ++i) ;
+    if (i == len) return wLexerTypeNumber;
+    break;
+
+  case wScanTypeRoman:
+    //-- ROMAN segments are pure ASCII
+    if (s[0] >= 'a') {
+      for (i=1; i < len && s[i] >= 'a'; ++i) ;
+      return i == len ? wLexerTypeRomanLower : wLexerTypeAlphaLower;
+    }
+    for (i=1; i < len && s[i] < 'a'; ++i) ;
+    return i == len ? wLexerTypeRomanCaps : wLexerTypeAlphaUpper;
+
+  case wScanTypeLatin:
+    //-- LATIN+ segments never contain hyphens or digits, so only case matters;
+    //   all-roman segments are scanned as wScanTypeRoman
+    if (s[0] >= 'a' && s[0] <= 'z')
+      return wLexerTypeAlphaLower;
+    if (s[0] >= 'A' && s[0] <= 'Z') {
+      for (i=1; i < len && s[i] >= 'A' && s[i] <= 'Z'; ++i) ;
+      if (i == len)      return wLexerTypeAlphaCaps;
+      if (s[i] < 0x80)   return wLexerTypeAlphaUpper;
+    }
+    break;
+
+  default:
+    break;
+  }
+  return NwLexerTypes;
+}
+
 }; //--/namespace moot
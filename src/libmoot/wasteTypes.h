@@ -145,6 +145,21 @@ wasteLexerTypeE waste_casetype(const std::string &tok_text);
 wasteLexerTypeE waste_lexertype(const std::string &tok_text);
 //@}
 
+//--------------------------------------------------------------------------
+///\name scanner-side lexer types, from wasteTypes.cc
+//@{
+
+/**
+ * Get waste lexer-type for a segment of \a len bytes at \a text which was
+ * returned by wasteScanner::yylex() as \a scantype, using only the scan rule
+ * and the bytes already matched by the scanner.  Returns NwLexerTypes if the
+ * type cannot be determined this way, in which case waste_lexertype() must be
+ * called on the segment text.  Where it is determined, the result is always
+ * identical to waste_lexertype().
+ */
+wasteLexerTypeE waste_scan_lexertype(wasteScannerTypeE scantype, const char *text, size_t len);
+//@}
+
 }; /*--/namespace moot --*/
 
 #endif /* _WASTE_TYPES_H */
@@ -94,6 +94,9 @@ cmdline_parser_print_help (void)
   printf("   -r        --recover                    Attempt to recover from minor errors.\n");
   printf("   -S        --stream                     Use stream-wise I/O routines instead of sentence buffers.\n");
   printf("   -oFILE    --output=FILE                Specify output file (default=stdout).\n");
+  printf("             --output-suffix=SUFFIX       Write output for each input FILE to FILE.SUFFIX.\n");
+  printf("             --jobs=N                     Tag up to N input files in parallel.\n");
+  printf("             --server=SOCKET              Run as a tagging daemon listening on SOCKET.\n");
   printf("\n");
   printf(" Format Options:\n");
   printf("   -IFORMAT  --input-format=FORMAT        Specify input file(s) format(s).\n");
@@ -121,6 +124,7 @@ cmdline_parser_print_help (void)
   printf("   -ZDOUBLE  --beam-width=DOUBLE          Specify cutoff factor for beam pruning\n");
   printf("             --save-ambiguities           Annotate tagged tokens with lexical ambiguities\n");
   printf("   -m        --mark-unknown               Mark unknown tokens.\n");
+  printf("             --suffix-guesses=FILE        Load precomputed unknown-word guesses from FILE.\n");
 }
 
 #if defined(HAVE_STRDUP) || defined(strdup)
@@ -152,6 +156,9 @@ clear_args(struct gengetopt_args_info *args_info)
   args_info->recover_flag = 0; 
   args_info->stream_flag = 0; 
   args_info->output_arg = gog_strdup("-"); 
+  args_info->output_suffix_arg = NULL; 
+  args_info->jobs_arg = 0; 
+  args_info->server_arg = NULL; 
   args_info->input_format_arg = NULL; 
   args_info->output_format_arg = NULL; 
   args_info->input_encoding_arg = NULL; 
@@ -175,6 +182,7 @@ clear_args(struct gengetopt_args_info *args_info)
   args_info->beam_width_arg = 1000; 
   args_info->save_ambiguities_flag = 0; 
   args_info->mark_unknown_flag = 0; 
+  args_info->suffix_guesses_arg = NULL; 
 }
 
 
@@ -195,6 +203,9 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
   args_info->recover_given = 0;
   args_info->stream_given = 0;
   args_info->output_given = 0;
+  args_info->output_suffix_given = 0;
+  args_info->jobs_given = 0;
+  args_info->server_given = 0;
   args_info->input_format_given = 0;
   args_info->output_format_given = 0;
   args_info->input_encoding_given = 0;
@@ -218,6 +229,7 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
   args_info->beam_width_given = 0;
   args_info->save_ambiguities_given = 0;
   args_info->mark_unknown_given = 0;
+  args_info->suffix_guesses_given = 0;
 
   clear_args(args_info);
 
@@ -246,6 +258,9 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
 	{ "recover", 0, NULL, 'r' },
 	{ "stream", 0, NULL, 'S' },
 	{ "output", 1, NULL, 'o' },
+	{ "output-suffix", 1, NULL, 0 },
+	{ "jobs", 1, NULL, 0 },
+	{ "server", 1, NULL, 0 },
 	{ "input-format", 1, NULL, 'I' },
 	{ "output-format", 1, NULL, 'O' },
 	{ "input-encoding", 1, NULL, 0 },
@@ -269,6 +284,7 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
 	{ "beam-width", 1, NULL, 'Z' },
 	{ "save-ambiguities", 0, NULL, 0 },
 	{ "mark-unknown", 0, NULL, 'm' },
+	{ "suffix-guesses", 1, NULL, 0 },
         { NULL,	0, NULL, 0 }
       };
       static char short_options[] = {
@@ -713,6 +729,35 @@ cmdline_parser_parse_option(char oshort, const char *olong, const char *val,
             args_info->output_arg = gog_strdup(val);
           }
           
+          /* Write output for each input FILE to FILE.SUFFIX. */
+          else if (strcmp(olong, "output-suffix") == 0) {
+            if (args_info->output_suffix_given) {
+              fprintf(stderr, "%s: `--output-suffix' option given more than once\n", PROGRAM);
+            }
+            args_info->output_suffix_given++;
+            if (args_info->output_suffix_arg) free(args_info->output_suffix_arg);
+            args_info->output_suffix_arg = gog_strdup(val);
+          }
+          
+          /* Tag up to N input files in parallel. */
+          else if (strcmp(olong, "jobs") == 0) {
+            if (args_info->jobs_given) {
+              fprintf(stderr, "%s: `--jobs' option given more than once\n", PROGRAM);
+            }
+            args_info->jobs_given++;
+            args_info->jobs_arg = (int)atoi(val);
+          }
+          
+          /* Run as a tagging daemon listening on SOCKET. */
+          else if (strcmp(olong, "server") == 0) {
+            if (args_info->server_given) {
+              fprintf(stderr, "%s: `--server' option given more than once\n", PROGRAM);
+            }
+            args_info->server_given++;
+            if (args_info->server_arg) free(args_info->server_arg);
+            args_info->server_arg = gog_strdup(val);
+          }
+          
           /* Specify input file(s) format(s). */
           else if (strcmp(olong, "input-format") == 0) {
             if (args_info->input_format_given) {
@@ -933,6 +978,16 @@ cmdline_parser_parse_option(char oshort, const char *olong, const char *val,
              args_info->mark_unknown_flag = !(args_info->mark_unknown_flag);
           }
           
+          /* Load precomputed unknown-word guesses from FILE. */
+          else if (strcmp(olong, "suffix-guesses") == 0) {
+            if (args_info->suffix_guesses_given) {
+              fprintf(stderr, "%s: `--suffix-guesses' option given more than once\n", PROGRAM);
+            }
+            args_info->suffix_guesses_given++;
+            if (args_info->suffix_guesses_arg) free(args_info->suffix_guesses_arg);
+            args_info->suffix_guesses_arg = gog_strdup(val);
+          }
+          
           else {
             fprintf(stderr, "%s: unknown long option '%s'.\n", PROGRAM, olong);
             return (EXIT_FAILURE);
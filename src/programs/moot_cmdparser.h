@@ -28,6 +28,9 @@ struct gengetopt_args_info {
   int recover_flag;	 /* Attempt to recover from minor errors. (default=0). */
   int stream_flag;	 /* Use stream-wise I/O routines instead of sentence buffers. (default=0). */
   char * output_arg;	 /* Specify output file (default=stdout). (default=-). */
+  char * output_suffix_arg;	 /* Write output for each input FILE to FILE.SUFFIX. (default=NULL). */
+  int jobs_arg;	 /* Tag up to N input files in parallel. (default=0). */
+  char * server_arg;	 /* Run as a tagging daemon listening on SOCKET. (default=NULL). */
   char * input_format_arg;	 /* Specify input file(s) format(s). (default=NULL). */
   char * output_format_arg;	 /* Specify output file format. (default=NULL). */
   char * input_encoding_arg;	 /* Override XML document input encoding. (default=NULL). */
@@ -51,6 +54,7 @@ struct gengetopt_args_info {
   double beam_width_arg;	 /* Specify cutoff factor for beam pruning (default=1000). */
   int save_ambiguities_flag;	 /* Annotate tagged tokens with lexical ambiguities (default=0). */
   int mark_unknown_flag;	 /* Mark unknown tokens. (default=0). */
+  char * suffix_guesses_arg;	 /* Load precomputed unknown-word guesses from FILE. (default=NULL). */
 
   int help_given;	 /* Whether help was given */
   int version_given;	 /* Whether version was given */
@@ -63,6 +67,9 @@ struct gengetopt_args_info {
   int recover_given;	 /* Whether recover was given */
   int stream_given;	 /* Whether stream was given */
   int output_given;	 /* Whether output was given */
+  int output_suffix_given;	 /* Whether output-suffix was given */
+  int jobs_given;	 /* Whether jobs was given */
+  int server_given;	 /* Whether server was given */
   int input_format_given;	 /* Whether input-format was given */
   int output_format_given;	 /* Whether output-format was given */
   int input_encoding_given;	 /* Whether input-encoding was given */
@@ -86,6 +93,7 @@ struct gengetopt_args_info {
   int beam_width_given;	 /* Whether beam-width was given */
   int save_ambiguities_given;	 /* Whether save-ambiguities was given */
   int mark_unknown_given;	 /* Whether mark-unknown was given */
+  int suffix_guesses_given;	 /* Whether suffix-guesses was given */
   
   char **inputs;         /* unnamed arguments */
   unsigned inputs_num;   /* number of unnamed arguments */
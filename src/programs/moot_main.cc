@@ -36,6 +36,9 @@
 #include <string>
 #include <mootTokenIO.h>
 #include <mootTokenExpatIO.h>
+#include <mootBufferIO.h>
+#include <mootFilePool.h>
+#include <mootServer.h>
 
 #include "computils.h"
 #include "moot_cmdparser.h"
@@ -55,6 +58,7 @@ cmdutil_file_churner churner;
 
 // -- files
 mofstream out;
+mostream *outs = &out;  //-- stream for --output: out, or a compressing wrapper for it
 size_t nfiles = 0;
 
 //-- global classes/structs (see also computils.h)
@@ -71,6 +75,9 @@ int &ofmt_default = ifmt;
 TokenReader *reader = NULL;
 TokenWriter *writer = NULL;
 
+// -- parallel processing (--jobs, --output-suffix, --server)
+int njobs = 0;
+
 // -- for verbose timing info
 double  ielapsed, aelapsed;
 
@@ -78,6 +85,11 @@ double  ielapsed, aelapsed;
  * Protos
  *--------------------------------------------------------------------------*/
 void print_summary(TokenWriter *tw);
+TokenReader *new_reader(void);
+TokenWriter *new_writer(void);
+TokenWriter *main_writer(void);
+bool clone_hmms(vector<mootHMM*> &hmms, size_t n);
+void add_counts(const vector<mootHMM*> &hmms);
 
 /*--------------------------------------------------------------------------
  * Option Processing
@@ -103,9 +115,19 @@ void GetMyOptions(int argc, char **argv)
   //-- output file
   if (!out.open(args.output_arg,"w"))
     moot_croak("%s: open failed for output-file '%s': %s\n", PROGNAME, out.name.c_str(), strerror(errno));
+#ifdef MOOT_ZLIB_ENABLED
+  //-- compress *.gz and *.mbz output files (cf. TokenWriter::to_filename())
+  const char *oext = moot_extension(out.name.c_str());
+  if (oext && (strcmp(oext,".gz")==0 || strcmp(oext,".mbz")==0)) {
+    mozbstream *zout = (strcmp(oext,".mbz")==0 ? new mozblockstream() : new mozbstream());
+    zout->to_file(out.file);
+    outs = zout;
+  }
+#endif
 
   //-- set up file-churner
   churner.progname = PROGNAME;
+  churner.verbose = vlevel;
   churner.inputs = args.inputs;
   churner.ninputs = args.inputs_num;
   churner.use_list = args.list_given;
@@ -120,40 +142,281 @@ void GetMyOptions(int argc, char **argv)
   //-- i/o format : output
   if (args.save_ambiguities_given) ofmt_implied |= tiofAnalyzed;
   ofmt = TokenIO::parse_format_request(args.output_format_arg,
-				       args.output_arg,
+				       (args.server_given ? NULL
+					: (args.output_suffix_given ? args.output_suffix_arg : args.output_arg)),
 				       ofmt_implied,
 				       ofmt_default);
 
   //-- io: new_reader, new_writer
-  reader = TokenIO::new_reader(ifmt);
-  writer = TokenIO::new_writer(ofmt);
+  reader = new_reader();
+  writer = new_writer();
+
+  //-- io: writer: sink (opened on demand by main_writer() for --server and --output-suffix)
+  if (!args.server_given && !args.output_suffix_given)
+    writer->to_mstream(outs);
+
+  //-- load model
+  spec.args = args;
+  spec.hmmp = &hmm;
+  if (!spec.load_hmm())
+    moot_croak("%s: load FAILED for model `%s'\n", PROGNAME, spec.model_arg());
+
+  //-- load unknown-word guesses
+  if (args.suffix_guesses_given) {
+#ifdef MOOT_ENABLE_SUFFIX_TRIE
+    if (!hmm.load_suffix_guesses(args.suffix_guesses_arg))
+      moot_croak("%s: load FAILED for suffix guesses `%s'\n", PROGNAME, args.suffix_guesses_arg);
+#else
+    moot_msg(vlevel,vlWarnings, "%s: Warning: suffix trie support disabled: ignoring --suffix-guesses\n", PROGNAME);
+#endif
+  }
+
+  //-- parallel processing
+  njobs = args.jobs_arg;
+  if (args.server_given) {
+    if (njobs <= 0) njobs = 4;
+  }
+  else if (njobs > 1 && (ofmt&tiofXML) && !args.output_suffix_given) {
+    moot_msg(vlevel,vlWarnings, "%s: Warning: --jobs does not support concatenated XML output: ignoring\n", PROGNAME);
+    njobs = 0;
+  }
+#ifndef MOOT_PTHREADS_ENABLED
+  if (njobs > 1) {
+    moot_msg(vlevel,vlWarnings, "%s: Warning: POSIX threads support disabled: processing %s sequentially\n",
+	     PROGNAME, (args.server_given ? "connections" : "input files"));
+    njobs = 1;
+  }
+#endif
+
+  //-- report
+  moot_msg(vlevel,vlProgress,"%s: Initialization complete\n", PROGNAME);
+
+  //-- report to output-file (per-file output gets its header from TagPool)
+  if (!args.no_header_given && !args.server_given && !args.output_suffix_given)
+    put_hmm_header(writer, hmm);
+}
 
+/*--------------------------------------------------------------------------
+ * Token I/O
+ *--------------------------------------------------------------------------*/
+TokenReader *new_reader(void)
+{
+  TokenReader *tr = TokenIO::new_reader(ifmt);
 #ifdef MOOT_EXPAT_ENABLED
   //-- io: encoding: reader
   if (ifmt&tiofXML && args.input_encoding_given) {
-    reinterpret_cast<TokenReaderExpat *>(reader)->setEncoding(static_cast<std::string>(args.input_encoding_arg));
+    reinterpret_cast<TokenReaderExpat *>(tr)->setEncoding(static_cast<std::string>(args.input_encoding_arg));
   }
+#endif
+  return tr;
+}
+
+TokenWriter *new_writer(void)
+{
+  TokenWriter *tw = TokenIO::new_writer(ofmt);
+#ifdef MOOT_EXPAT_ENABLED
   //-- io: encoding: writer
   if (ofmt&tiofXML && args.output_encoding_given) {
-    reinterpret_cast<TokenWriterExpat *>(writer)->setEncoding(static_cast<std::string>(args.output_encoding_arg));
+    reinterpret_cast<TokenWriterExpat *>(tw)->setEncoding(static_cast<std::string>(args.output_encoding_arg));
   }
 #endif
+  return tw;
+}
 
-  //-- io: writer: sink
-  writer->to_mstream(&out);
+//-- get main output writer, attaching it to --output on first use
+TokenWriter *main_writer(void)
+{
+  if (!writer->opened()) writer->to_mstream(outs);
+  return writer;
+}
 
-  //-- load model
-  spec.args = args;
-  spec.hmmp = &hmm;
-  if (!spec.load_hmm())
-    moot_croak("%s: load FAILED for model `%s'\n", PROGNAME, spec.model_arg());
+/*--------------------------------------------------------------------------
+ * Model instances for parallel processing
+ *--------------------------------------------------------------------------*/
 
-  //-- report
-  moot_msg(vlevel,vlProgress,"%s: Initialization complete\n", PROGNAME);
+//-- get n model instances: hmms[0] is the global hmm, others are copies (serialized once)
+bool clone_hmms(vector<mootHMM*> &hmms, size_t n)
+{
+  hmms.push_back(&hmm);
+  if (n <= 1) return true;
+  hmm.ndots = 0;
+
+  mcbuffer buf;
+  buf.cb_get = 1<<20;
+  if (!hmm.save(&buf, spec.model_arg())) return false;
+  for (size_t i=1; i < n; ++i) {
+    micbuffer ibuf(buf.data(), buf.size());
+    mootHMM *h = new mootHMM();
+    hmms.push_back(h);
+    if (!h->load(&ibuf, spec.model_arg())) return false;
+
+    //-- runtime options which are not part of the binary model
+    h->verbose           = hmm.verbose;
+    h->save_ambiguities  = hmm.save_ambiguities;
+    h->save_mark_unknown = hmm.save_mark_unknown;
+    h->ndots             = 0;
+#ifdef MOOT_ENABLE_SUFFIX_TRIE
+    h->sufguesses        = hmm.sufguesses;
+#endif
+  }
+  return true;
+}
 
-  //-- report to output-file
-  if (!args.no_header_given)
-    put_hmm_header(writer, hmm);
+//-- add statistics of model copies hmms[1..] to global hmm
+void add_counts(const vector<mootHMM*> &hmms)
+{
+  for (size_t i=1; i < hmms.size(); ++i) {
+    hmm.nsents      += hmms[i]->nsents;
+    hmm.ntokens     += hmms[i]->ntokens;
+    hmm.nnewtokens  += hmms[i]->nnewtokens;
+    hmm.nunclassed  += hmms[i]->nunclassed;
+    hmm.nnewclasses += hmms[i]->nnewclasses;
+    hmm.nunknown    += hmms[i]->nunknown;
+    hmm.nfallbacks  += hmms[i]->nfallbacks;
+  }
+}
+
+/*--------------------------------------------------------------------------
+ * Parallel processing (--jobs, --output-suffix)
+ *--------------------------------------------------------------------------*/
+class TagPool : public cmdutil_file_pool {
+public:
+  vector<mootHMM*>     hmms;     //-- per-worker model instances (hmms[0] is the global hmm)
+  vector<TokenReader*> readers;  //-- per-worker readers
+  vector<TokenWriter*> writers;  //-- per-worker writers
+  string               header;   //-- header comment for per-file output
+
+public:
+  TagPool(size_t n)
+    : cmdutil_file_pool(&::churner, n)
+  {
+    for (size_t i=0; i < njobs; ++i) {
+      readers.push_back(new_reader());
+      writers.push_back(new_writer());
+    }
+  };
+
+  ~TagPool(void)
+  {
+    for (size_t i=0; i < njobs; ++i) {
+      if (i > 0 && i < hmms.size()) delete hmms[i];
+      delete readers[i];
+      delete writers[i];
+    }
+  };
+
+  //-- copy global hmm for each worker
+  bool clone_models(void)
+  {
+    return clone_hmms(hmms, njobs);
+  };
+
+  //-- get header comment for per-file output
+  void get_header(void)
+  {
+    if (args.no_header_given) return;
+    mcbuffer     hbuf;
+    TokenWriter *hw = new_writer();
+    hw->to_mstream(&hbuf);
+    size_t begin = hbuf.size();  //-- skip any document prologue
+    put_hmm_header(hw, hmm);
+    header.assign(hbuf.data()+begin, hbuf.size()-begin);
+    hw->close();
+    delete hw;
+  };
+
+  virtual bool process_file(Worker &w, Job &job)
+  {
+    TokenReader *tr = readers[w.id];
+    TokenWriter *tw = writers[w.id];
+    mootHMM     *h  = hmms[w.id];
+
+    if (args.output_suffix_given && job.name != "-") {
+      //-- per-file output
+      string oname = job.name;
+      if (args.output_suffix_arg[0] != '.') oname.push_back('.');
+      oname.append(args.output_suffix_arg);
+      tw->to_filename(oname.c_str());
+      if (!tw->opened()) return false;
+      if (!header.empty()) tw->put_raw_buffer(header.data(), header.size());
+    } else {
+      //-- buffered output, written in input order by finish_file()
+      tw->to_mstream(&job.obuf);
+    }
+
+    tr->from_mstream(w.input());
+    if (args.stream_given) {
+      h->tag_stream(tr,tw);
+    } else {
+      h->tag_io(tr,tw);
+    }
+    tr->close();
+    tw->close();
+    return true;
+  };
+
+  virtual void finish_file(Job &job)
+  {
+    if (!job.ok) {
+      if (churner->paranoid)
+	moot_croak("%s: processing FAILED for input-file '%s'\n", PROGNAME, job.name.c_str());
+      return;
+    }
+    if (job.obuf.size() > 0 || !args.output_suffix_given || job.name == "-") {
+      TokenWriter *tw = main_writer();
+      if (args.output_suffix_given && !header.empty()) //-- stdin: no per-file output
+	tw->put_raw_buffer(header.data(), header.size());
+      if (vlevel >= vlProgress)
+	tw->printf_comment("\n     File: %s\n", job.name.c_str());
+      tw->put_raw_buffer(job.obuf.data(), job.obuf.size());
+    }
+    if (vlevel >= vlProgress) {
+      moot_carp("%s: analyzed file '%s'.\n", PROGNAME, job.name.c_str());
+    } else if (hmm.ndots) {
+      fputc('\n', stderr);
+    }
+  };
+};
+
+void churn_pool(void)
+{
+  TagPool pool(njobs > 1 ? njobs : 1);
+  if (!pool.clone_models())
+    moot_croak("%s: could not copy model `%s' for %d jobs\n", PROGNAME, spec.model_arg(), njobs);
+  if (args.output_suffix_given)
+    pool.get_header();
+  pool.run();
+  add_counts(pool.hmms);
+  nfiles = pool.nfiles;
+}
+
+/*--------------------------------------------------------------------------
+ * Tagging daemon (--server)
+ *--------------------------------------------------------------------------*/
+void run_server(void)
+{
+  vector<mootHMM*> hmms;
+  if (!clone_hmms(hmms, njobs))
+    moot_croak("%s: could not copy model `%s' for %d sessions\n", PROGNAME, spec.model_arg(), njobs);
+
+  mootServer server(args.server_arg);
+  server.verbose = vlevel;
+  for (size_t i=0; i < hmms.size(); ++i)
+    server.add_session(hmms[i], new_reader(), new_writer());
+
+  if (!server.open())
+    moot_croak("%s: could not create socket '%s'\n", PROGNAME, args.server_arg);
+  server.run();
+
+  //-- cleanup & statistics
+  for (size_t i=0; i < server.sessions.size(); ++i) {
+    mootServer::Session *s = server.sessions[i];
+    nfiles += s->nrequests;
+    delete s->reader;
+    delete s->writer;
+    if (i > 0) delete s->hmm;
+  }
+  add_counts(hmms);
 }
 
 /*--------------------------------------------------------------------------
@@ -225,26 +488,32 @@ int main (int argc, char **argv)
     ielapsed = static_cast<double>(clock()) / static_cast<double>(CLOCKS_PER_SEC);
 
   // -- the guts
-  for (churner.first_input_file(); churner.in.file; churner.next_input_file()) {
-    ++nfiles;
-    if (vlevel >= vlProgress) {
-      writer->printf_comment("\n     File: %s\n", churner.in.name.c_str());
-      moot_carp("%s: analyzing file '%s'...", PROGNAME, churner.in.name.c_str());
-    }
-
-    //hmm.tag_file(churner.in.file, out.file, churner.in.name);
-
-    reader->from_mstream(&churner.in);
-    if (args.stream_given) {
-      hmm.tag_stream(reader,writer);
-    } else {
-      hmm.tag_io(reader, writer);
-    }
+  if (args.server_given) {
+    run_server();
+  } else if (njobs > 1 || args.output_suffix_given) {
+    churn_pool();
+  } else {
+    for (churner.first_input_file(); churner.in.file; churner.next_input_file()) {
+      ++nfiles;
+      if (vlevel >= vlProgress) {
+	writer->printf_comment("\n     File: %s\n", churner.in.name.c_str());
+	moot_carp("%s: analyzing file '%s'...", PROGNAME, churner.in.name.c_str());
+      }
+
+      //hmm.tag_file(churner.in.file, out.file, churner.in.name);
+
+      reader->from_mstream(churner.input());
+      if (args.stream_given) {
+	hmm.tag_stream(reader,writer);
+      } else {
+	hmm.tag_io(reader, writer);
+      }
     
-    if (vlevel >= vlProgress) {
-      moot_carp(" done.\n");
-    } else if (hmm.ndots) {
-      fputc('\n', stderr);
+      if (vlevel >= vlProgress) {
+	moot_carp(" done.\n");
+      } else if (hmm.ndots) {
+	fputc('\n', stderr);
+      }
     }
   }
 
@@ -253,11 +522,12 @@ int main (int argc, char **argv)
     // -- timing
     aelapsed  = static_cast<double>(clock()) / static_cast<double>(CLOCKS_PER_SEC) - ielapsed; 
 
-    if (out.file != stdout) print_summary(writer);
+    if (out.file != stdout) print_summary(main_writer());
     print_summary_to_file(stderr);
   }
   writer->close();
+  if (outs != &out) delete outs; //-- flushes compressed output; does not close out
   out.close();
 
-  return 0;
+  return churner.nerrors > 0 ? 1 : 0;
 }
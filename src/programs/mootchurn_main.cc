@@ -61,6 +61,10 @@ const char *PROGNAME = "mootchurn";
 // files
 mifstream in;
 mofstream out;
+mostream *outp = &out;
+#ifdef MOOT_ZLIB_ENABLED
+mozbstream *zout = NULL; //-- compressing wrapper for out (*.gz, *.mbz)
+#endif
 
 // options & file-churning
 gengetopt_args_info args;
@@ -108,9 +112,19 @@ void GetMyOptions(int argc, char **argv)
   //-- options: output file
   if (!out.open(args.output_arg,"wb"))
     moot_croak("%s: open failed for output-file \"%s\": %s\n", PROGNAME, out.name.c_str(), strerror(errno));
+#ifdef MOOT_ZLIB_ENABLED
+  const char *oext = moot_extension(out.name.c_str());
+  if (oext && strcmp(oext,".gz")==0)       zout = new mozbstream();
+  else if (oext && strcmp(oext,".mbz")==0) zout = new mozblockstream();
+  if (zout) {
+    zout->to_file(out.file);
+    outp = zout;
+  }
+#endif
 
   //-- set up file-churner
   churner.progname = PROGNAME;
+  churner.verbose = vlevel;
   churner.inputs = args.inputs;
   churner.ninputs = args.inputs_num;
   churner.use_list = args.list_given;
@@ -143,7 +157,7 @@ void GetMyOptions(int argc, char **argv)
 #endif // MOOT_EXPAT_ENABLED
 
   //-- io: writer sink
-  writer->to_mstream(&out);
+  writer->to_mstream(outp);
 
   //-- dot printing
   ndots = args.dots_arg;
@@ -193,7 +207,7 @@ int main (int argc, char **argv)
       moot_msg(vlevel,vlProgress,"%s: churning file '%s'...", PROGNAME, churner.in.name.c_str());
       ++nfiles;
 
-      reader->from_mstream(&churner.in);
+      reader->from_mstream(churner.input());
 
       int lxtok;
       mootSentence *sent;
@@ -253,9 +267,15 @@ int main (int argc, char **argv)
 
   //-- cleanup
   writer->close();
+#ifdef MOOT_ZLIB_ENABLED
+  if (zout) {
+    zout->close();
+    delete zout;
+  }
+#endif
   out.close();
   if (reader) delete reader;
   if (writer) delete writer;
 
-  return 0;
+  return churner.nerrors > 0 ? 1 : 0;
 }
@@ -94,6 +94,10 @@ cmdline_parser_print_help (void)
   printf("   -C       --class             Enable lexical-class probability dump\n");
   printf("   -s       --suffix            Enable suffix-trie dump\n");
   printf("   -n       --ngrams            Enable tag n-gram probability dump\n");
+  printf("   -S       --sparse            Omit dense n-gram entries equal to their backoff value\n");
+  printf("   -wTOKEN  --token=TOKEN       Restrict lexical and suffix dumps to TOKEN\n");
+  printf("   -tLIST   --tags=LIST         Restrict dumps to entries for the tag(s) in LIST\n");
+  printf("   -qFILE   --query=FILE        Look up the probabilities listed in FILE instead of dumping\n");
   printf("   -oFILE   --output=FILE       Specify output file (default=stdout).\n");
 }
 
@@ -126,6 +130,10 @@ clear_args(struct gengetopt_args_info *args_info)
   args_info->class_flag = 0; 
   args_info->suffix_flag = 0; 
   args_info->ngrams_flag = 0; 
+  args_info->sparse_flag = 0; 
+  args_info->token_arg = NULL; 
+  args_info->tags_arg = NULL; 
+  args_info->query_arg = NULL; 
   args_info->output_arg = gog_strdup("-"); 
 }
 
@@ -147,6 +155,10 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
   args_info->class_given = 0;
   args_info->suffix_given = 0;
   args_info->ngrams_given = 0;
+  args_info->sparse_given = 0;
+  args_info->token_given = 0;
+  args_info->tags_given = 0;
+  args_info->query_given = 0;
   args_info->output_given = 0;
 
   clear_args(args_info);
@@ -176,6 +188,10 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
 	{ "class", 0, NULL, 'C' },
 	{ "suffix", 0, NULL, 's' },
 	{ "ngrams", 0, NULL, 'n' },
+	{ "sparse", 0, NULL, 'S' },
+	{ "token", 1, NULL, 'w' },
+	{ "tags", 1, NULL, 't' },
+	{ "query", 1, NULL, 'q' },
 	{ "output", 1, NULL, 'o' },
         { NULL,	0, NULL, 0 }
       };
@@ -191,6 +207,10 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
 	'C',
 	's',
 	'n',
+	'S',
+	'w', ':',
+	't', ':',
+	'q', ':',
 	'o', ':',
 	'\0'
       };
@@ -332,6 +352,42 @@ cmdline_parser_parse_option(char oshort, const char *olong, const char *val,
            args_info->ngrams_flag = !(args_info->ngrams_flag);
           break;
         
+        case 'S':	 /* Omit dense n-gram entries equal to their backoff value */
+          if (args_info->sparse_given) {
+            fprintf(stderr, "%s: `--sparse' (`-S') option given more than once\n", PROGRAM);
+          }
+          args_info->sparse_given++;
+         if (args_info->sparse_given <= 1)
+           args_info->sparse_flag = !(args_info->sparse_flag);
+          break;
+        
+        case 'w':	 /* Restrict lexical and suffix dumps to TOKEN */
+          if (args_info->token_given) {
+            fprintf(stderr, "%s: `--token' (`-w') option given more than once\n", PROGRAM);
+          }
+          args_info->token_given++;
+          if (args_info->token_arg) free(args_info->token_arg);
+          args_info->token_arg = gog_strdup(val);
+          break;
+        
+        case 't':	 /* Restrict dumps to entries for the tag(s) in LIST */
+          if (args_info->tags_given) {
+            fprintf(stderr, "%s: `--tags' (`-t') option given more than once\n", PROGRAM);
+          }
+          args_info->tags_given++;
+          if (args_info->tags_arg) free(args_info->tags_arg);
+          args_info->tags_arg = gog_strdup(val);
+          break;
+        
+        case 'q':	 /* Look up the probabilities listed in FILE instead of dumping */
+          if (args_info->query_given) {
+            fprintf(stderr, "%s: `--query' (`-q') option given more than once\n", PROGRAM);
+          }
+          args_info->query_given++;
+          if (args_info->query_arg) free(args_info->query_arg);
+          args_info->query_arg = gog_strdup(val);
+          break;
+        
         case 'o':	 /* Specify output file (default=stdout). */
           if (args_info->output_given) {
             fprintf(stderr, "%s: `--output' (`-o') option given more than once\n", PROGRAM);
@@ -450,6 +506,46 @@ cmdline_parser_parse_option(char oshort, const char *olong, const char *val,
              args_info->ngrams_flag = !(args_info->ngrams_flag);
           }
           
+          /* Omit dense n-gram entries equal to their backoff value */
+          else if (strcmp(olong, "sparse") == 0) {
+            if (args_info->sparse_given) {
+              fprintf(stderr, "%s: `--sparse' (`-S') option given more than once\n", PROGRAM);
+            }
+            args_info->sparse_given++;
+           if (args_info->sparse_given <= 1)
+             args_info->sparse_flag = !(args_info->sparse_flag);
+          }
+          
+          /* Restrict lexical and suffix dumps to TOKEN */
+          else if (strcmp(olong, "token") == 0) {
+            if (args_info->token_given) {
+              fprintf(stderr, "%s: `--token' (`-w') option given more than once\n", PROGRAM);
+            }
+            args_info->token_given++;
+            if (args_info->token_arg) free(args_info->token_arg);
+            args_info->token_arg = gog_strdup(val);
+          }
+          
+          /* Restrict dumps to entries for the tag(s) in LIST */
+          else if (strcmp(olong, "tags") == 0) {
+            if (args_info->tags_given) {
+              fprintf(stderr, "%s: `--tags' (`-t') option given more than once\n", PROGRAM);
+            }
+            args_info->tags_given++;
+            if (args_info->tags_arg) free(args_info->tags_arg);
+            args_info->tags_arg = gog_strdup(val);
+          }
+          
+          /* Look up the probabilities listed in FILE instead of dumping */
+          else if (strcmp(olong, "query") == 0) {
+            if (args_info->query_given) {
+              fprintf(stderr, "%s: `--query' (`-q') option given more than once\n", PROGRAM);
+            }
+            args_info->query_given++;
+            if (args_info->query_arg) free(args_info->query_arg);
+            args_info->query_arg = gog_strdup(val);
+          }
+          
           /* Specify output file (default=stdout). */
           else if (strcmp(olong, "output") == 0) {
             if (args_info->output_given) {
@@ -28,6 +28,10 @@ struct gengetopt_args_info {
   int class_flag;	 /* Enable lexical-class probability dump (default=0). */
   int suffix_flag;	 /* Enable suffix-trie dump (default=0). */
   int ngrams_flag;	 /* Enable tag n-gram probability dump (default=0). */
+  int sparse_flag;	 /* Omit dense n-gram entries equal to their backoff value (default=0). */
+  char * token_arg;	 /* Restrict lexical and suffix dumps to TOKEN (default=NULL). */
+  char * tags_arg;	 /* Restrict dumps to entries for the tag(s) in LIST (default=NULL). */
+  char * query_arg;	 /* Look up the probabilities listed in FILE instead of dumping (default=NULL). */
   char * output_arg;	 /* Specify output file (default=stdout). (default=-). */
 
   int help_given;	 /* Whether help was given */
@@ -41,6 +45,10 @@ struct gengetopt_args_info {
   int class_given;	 /* Whether class was given */
   int suffix_given;	 /* Whether suffix was given */
   int ngrams_given;	 /* Whether ngrams was given */
+  int sparse_given;	 /* Whether sparse was given */
+  int token_given;	 /* Whether token was given */
+  int tags_given;	 /* Whether tags was given */
+  int query_given;	 /* Whether query was given */
   int output_given;	 /* Whether output was given */
   
   char **inputs;         /* unnamed arguments */
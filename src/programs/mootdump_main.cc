@@ -33,6 +33,8 @@
 #include <string.h>
 
 #include <string>
+#include <vector>
+#include <list>
 
 #include <mootHMM.h>
 #include <mootLexfreqs.h>
@@ -63,11 +65,7 @@ mofstream out;
 mootHMM        hmm;
 
 //-- dump options
-bool dump_constants = true;
-bool dump_lexprobs = true;
-bool dump_classprobs = true;
-bool dump_suftrie = true;
-bool dump_ngprobs = true;
+mootHMM::TxtDumpOptions dumpopts;
 
 /*--------------------------------------------------------------------------
  * Option Processing
@@ -108,20 +106,145 @@ void GetMyOptions(int argc, char **argv)
 
   //-- assign dump options
   if (args.const_given || args.lex_given || args.class_given || args.suffix_given || args.ngrams_given) {
-    dump_constants = args.const_flag;
-    dump_lexprobs = args.lex_flag;
-    dump_classprobs = args.class_flag;
-    dump_suftrie = args.suffix_flag;
-    dump_ngprobs = args.ngrams_flag;
-  } else {
-    dump_constants = true;
-    dump_lexprobs = true;
-    dump_classprobs = true;
-    dump_suftrie = true;
-    dump_ngprobs = true;
+    dumpopts.dump_constants = args.const_flag;
+    dumpopts.dump_lexprobs = args.lex_flag;
+    dumpopts.dump_classprobs = args.class_flag;
+    dumpopts.dump_suftrie = args.suffix_flag;
+    dumpopts.dump_ngprobs = args.ngrams_flag;
+  } else if (args.token_given) {
+    //-- token filter only: default to the tables it applies to
+    dumpopts.dump_constants = false;
+    dumpopts.dump_lexprobs = true;
+    dumpopts.dump_classprobs = false;
+    dumpopts.dump_suftrie = true;
+    dumpopts.dump_ngprobs = false;
+  }
+
+  //-- assign dump filters
+  dumpopts.sparse = args.sparse_flag;
+  if (args.token_given)
+    dumpopts.tokens.insert(args.token_arg);
+  if (args.tags_given) {
+    list<string> tags = moot_strtok(args.tags_arg, " \t");
+    dumpopts.tags.insert(tags.begin(), tags.end());
   }
 
   hmm.hash_ngrams = args.hash_ngrams_arg;
+  hmm.defer_sections = mootHMM::bsAll; //-- decode only the binary model sections we dump
+}
+
+/*--------------------------------------------------------------------------
+ * Queries
+ *--------------------------------------------------------------------------*/
+/** Write TAB and ID("NAME") for tag \a tagid to \a file */
+void put_tag(FILE *file, mootHMM::TagID tagid)
+{
+  fprintf(file, "\t%u(\"%s\")", tagid, hmm.tagids.id2name(tagid).c_str());
+}
+
+/** Write log-probability \a prob to \a file, as for mootHMM::txtdump() */
+void put_prob(FILE *file, ProbT prob)
+{
+  fprintf(file, "\t%e\t%e\n", prob, exp(prob));
+}
+
+/** Answer a single TAB-separated query \a fields; returns false on error */
+bool query1(FILE *file, const vector<string> &fields)
+{
+  const string &qtype = fields[0];
+  if (qtype == "lex" && fields.size() == 3) {
+    hmm.require_sections(mootHMM::bsLexProbs);
+    mootHMM::TokID tokid = hmm.token2id(fields[1]);
+    mootHMM::TagID tagid = hmm.tagids.name2id(fields[2]);
+    fprintf(file, "lex\t%u(\"%s\")", tokid, hmm.tokids.id2name(tokid).c_str());
+    put_tag(file, tagid);
+    put_prob(file, hmm.wordp(tokid, tagid));
+    return true;
+  }
+  else if (qtype == "class" && fields.size() == 3) {
+    hmm.require_sections(mootHMM::bsClassProbs);
+    list<string> tags = moot_strtok(fields[1], " ");
+    mootHMM::LexClass lclass;
+    for (list<string>::const_iterator ti = tags.begin(); ti != tags.end(); ++ti)
+      lclass.insert(hmm.tagids.name2id(*ti));
+    mootHMM::ClassID classid = hmm.classids.name2id(lclass);
+    mootHMM::TagID   tagid   = hmm.tagids.name2id(fields[2]);
+    string classname;
+    const mootHMM::LexClass &idclass = hmm.classids.id2name(classid);
+    for (mootHMM::LexClass::const_iterator lci = idclass.begin(); lci != idclass.end(); ++lci) {
+      if (lci != idclass.begin()) classname.push_back(' ');
+      classname.append(hmm.tagids.id2name(*lci));
+    }
+    fprintf(file, "class\t%u(\"%s\")", classid, classname.c_str());
+    put_tag(file, tagid);
+    put_prob(file, hmm.classp(classid, tagid));
+    return true;
+  }
+  else if (qtype == "suffix" && fields.size() == 3) {
+#ifdef MOOT_ENABLE_SUFFIX_TRIE
+    hmm.require_sections(mootHMM::bsSuffixTrie);
+    if (hmm.suftrie.maxlen() == 0)
+      hmm.suftrie.maxlen() = SuffixTrie::NoMaxLen; //-- depth is not stored in binary models: match as deep as the trie goes
+    //-- models compiled without a suffix trie have no root node: answer from default data
+    SuffixTrie::const_iterator sti = (hmm.suftrie.empty()
+				      ? hmm.suftrie.end()
+				      : hmm.suftrie.rfind_longest_nonempty(fields[1]));
+    const SuffixTrieDataT &sufdata = (sti == hmm.suftrie.end() ? hmm.suftrie.default_data() : sti->data);
+    mootHMM::TagID tagid = hmm.tagids.name2id(fields[2]);
+    SuffixTrieDataT::const_iterator sdi = sufdata.find(tagid);
+    fprintf(file, "suffix\t\"%s\"", (sti == hmm.suftrie.end() ? "" : hmm.suftrie.node_string(*sti).c_str()));
+    put_tag(file, tagid);
+    put_prob(file, sdi != sufdata.end() ? sdi->second : MOOT_PROB_ZERO);
+    return true;
+#else
+    moot_msg(args.verbose_arg, vlErrors, "%s: suffix queries DISABLED (re-compile with MOOT_ENABLE_SUFFIX_TRIE defined to enable)\n", PROGNAME);
+    return false;
+#endif
+  }
+  else if (qtype == "ngram" && fields.size() >= 2 && fields.size() <= 4) {
+    hmm.require_sections(mootHMM::bsNgramProbs);
+    mootHMM::TagID ng[3] = {0,0,0};
+    for (size_t i=1; i < fields.size(); ++i)
+      ng[i+3-fields.size()] = hmm.tagids.name2id(fields[i]);
+    fputs("ngram", file);
+    put_tag(file, ng[0]);
+    put_tag(file, ng[1]);
+    put_tag(file, ng[2]);
+    put_prob(file, hmm.tagp(ng[0], ng[1], ng[2]));
+    return true;
+  }
+  return false;
+}
+
+/** Answer all queries in file \a filename; returns false on error */
+bool query(FILE *file, const char *filename)
+{
+  mifstream qin;
+  if (!qin.open(filename,"r")) {
+    moot_msg(args.verbose_arg, vlErrors, "%s: open failed for query file '%s': %s\n", PROGNAME, qin.name.c_str(), strerror(errno));
+    return false;
+  }
+
+  string line;
+  vector<string> fields;
+  size_t lineno = 0;
+  bool rc = true;
+  while (qin.valid() && !qin.eof()) {
+    qin.getline(line);
+    ++lineno;
+    while (!line.empty() && (line[line.size()-1]=='\n' || line[line.size()-1]=='\r'))
+      line.erase(line.size()-1);
+    if (line.empty() || line.find("%%")==0) continue;
+
+    fields.clear();
+    moot_strsplit(line, "\t", fields);
+    if (!query1(file, fields)) {
+      moot_msg(args.verbose_arg, vlErrors, "%s: %s:%zu: malformed query '%s'\n", PROGNAME, qin.name.c_str(), lineno, line.c_str());
+      rc = false;
+    }
+  }
+  qin.close();
+  return rc;
 }
 
 /*--------------------------------------------------------------------------
@@ -137,11 +260,16 @@ int main (int argc, char **argv)
     exit(1);
   }
 
+  //-- answer queries
+  if (args.query_given) {
+    return query(out.file, args.query_arg) ? 0 : 1;
+  }
+
   //-- produce text dump
   if (args.verbose_arg > 1)
     fprintf(stderr, "%s: writing HMM text dump to '%s' ...", PROGNAME, out.name.c_str());
 
-  hmm.txtdump(out.file, dump_constants, dump_lexprobs, dump_classprobs, dump_suftrie, dump_ngprobs);
+  hmm.txtdump(out.file, dumpopts);
 
   if (args.verbose_arg > 1)
     fprintf(stderr," dumped.\n");
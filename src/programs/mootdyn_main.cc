@@ -118,6 +118,7 @@ void GetMyOptions(int argc, char **argv)
 
   //-- set up file-churner
   churner.progname = PROGNAME;
+  churner.verbose = vlevel;
   churner.inputs = args.inputs;
   churner.ninputs = args.inputs_num;
   churner.use_list = args.list_given;
@@ -264,7 +265,7 @@ int main (int argc, char **argv)
 
     //hmmp->tag_file(churner.in.file, out.file, churner.in.name);
 
-    reader->from_mstream(&churner.in);
+    reader->from_mstream(churner.input());
     hmmp->tag_io(reader, writer);
     
     if (vlevel >= vlProgress) {
@@ -286,6 +287,6 @@ int main (int argc, char **argv)
   writer->close();
   out.close();
 
-  return 0;
+  return churner.nerrors > 0 ? 1 : 0;
 }
 
@@ -92,6 +92,10 @@ cmdline_parser_print_help (void)
   printf("   -oFILE    --output=FILE              Write output to FILE.\n");
   printf("   -IFORMAT  --input-format=FORMAT      Specify input file formats.\n");
   printf("             --input-encoding=ENCODING  Override XML document input encoding.\n");
+  printf("             --lexicon=LEXFILE          Report accuracy for tokens known/unknown to LEXFILE.\n");
+  printf("             --flavors=FILE             Report accuracy by token flavor using heuristics in FILE.\n");
+  printf("             --stats=FILE               Write machine-readable statistics to FILE.\n");
+  printf("             --no-threads               Read input files sequentially.\n");
 }
 
 #if defined(HAVE_STRDUP) || defined(strdup)
@@ -121,6 +125,10 @@ clear_args(struct gengetopt_args_info *args_info)
   args_info->output_arg = gog_strdup("-"); 
   args_info->input_format_arg = NULL; 
   args_info->input_encoding_arg = NULL; 
+  args_info->lexicon_arg = NULL; 
+  args_info->flavors_arg = NULL; 
+  args_info->stats_arg = NULL; 
+  args_info->no_threads_flag = 0; 
 }
 
 
@@ -139,6 +147,10 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
   args_info->output_given = 0;
   args_info->input_format_given = 0;
   args_info->input_encoding_given = 0;
+  args_info->lexicon_given = 0;
+  args_info->flavors_given = 0;
+  args_info->stats_given = 0;
+  args_info->no_threads_given = 0;
 
   clear_args(args_info);
 
@@ -164,6 +176,10 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
 	{ "output", 1, NULL, 'o' },
 	{ "input-format", 1, NULL, 'I' },
 	{ "input-encoding", 1, NULL, 0 },
+	{ "lexicon", 1, NULL, 0 },
+	{ "flavors", 1, NULL, 0 },
+	{ "stats", 1, NULL, 0 },
+	{ "no-threads", 0, NULL, 0 },
         { NULL,	0, NULL, 0 }
       };
       static char short_options[] = {
@@ -379,6 +395,46 @@ cmdline_parser_parse_option(char oshort, const char *olong, const char *val,
             args_info->input_encoding_arg = gog_strdup(val);
           }
           
+          /* Report accuracy for tokens known/unknown to LEXFILE. */
+          else if (strcmp(olong, "lexicon") == 0) {
+            if (args_info->lexicon_given) {
+              fprintf(stderr, "%s: `--lexicon' option given more than once\n", PROGRAM);
+            }
+            args_info->lexicon_given++;
+            if (args_info->lexicon_arg) free(args_info->lexicon_arg);
+            args_info->lexicon_arg = gog_strdup(val);
+          }
+          
+          /* Report accuracy by token flavor using heuristics in FILE. */
+          else if (strcmp(olong, "flavors") == 0) {
+            if (args_info->flavors_given) {
+              fprintf(stderr, "%s: `--flavors' option given more than once\n", PROGRAM);
+            }
+            args_info->flavors_given++;
+            if (args_info->flavors_arg) free(args_info->flavors_arg);
+            args_info->flavors_arg = gog_strdup(val);
+          }
+          
+          /* Write machine-readable statistics to FILE. */
+          else if (strcmp(olong, "stats") == 0) {
+            if (args_info->stats_given) {
+              fprintf(stderr, "%s: `--stats' option given more than once\n", PROGRAM);
+            }
+            args_info->stats_given++;
+            if (args_info->stats_arg) free(args_info->stats_arg);
+            args_info->stats_arg = gog_strdup(val);
+          }
+          
+          /* Read input files sequentially. */
+          else if (strcmp(olong, "no-threads") == 0) {
+            if (args_info->no_threads_given) {
+              fprintf(stderr, "%s: `--no-threads' option given more than once\n", PROGRAM);
+            }
+            args_info->no_threads_given++;
+           if (args_info->no_threads_given <= 1)
+             args_info->no_threads_flag = !(args_info->no_threads_flag);
+          }
+          
           else {
             fprintf(stderr, "%s: unknown long option '%s'.\n", PROGRAM, olong);
             return (EXIT_FAILURE);
@@ -26,6 +26,10 @@ struct gengetopt_args_info {
   char * output_arg;	 /* Write output to FILE. (default=-). */
   char * input_format_arg;	 /* Specify input file formats. (default=NULL). */
   char * input_encoding_arg;	 /* Override XML document input encoding. (default=NULL). */
+  char * lexicon_arg;	 /* Report accuracy for tokens known/unknown to LEXFILE. (default=NULL). */
+  char * flavors_arg;	 /* Report accuracy by token flavor using heuristics in FILE. (default=NULL). */
+  char * stats_arg;	 /* Write machine-readable statistics to FILE. (default=NULL). */
+  int no_threads_flag;	 /* Read input files sequentially. (default=0). */
 
   int help_given;	 /* Whether help was given */
   int version_given;	 /* Whether version was given */
@@ -36,6 +40,10 @@ struct gengetopt_args_info {
   int output_given;	 /* Whether output was given */
   int input_format_given;	 /* Whether input-format was given */
   int input_encoding_given;	 /* Whether input-encoding was given */
+  int lexicon_given;	 /* Whether lexicon was given */
+  int flavors_given;	 /* Whether flavors was given */
+  int stats_given;	 /* Whether stats was given */
+  int no_threads_given;	 /* Whether no-threads was given */
   
   char **inputs;         /* unnamed arguments */
   unsigned inputs_num;   /* number of unnamed arguments */
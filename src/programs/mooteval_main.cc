@@ -55,6 +55,12 @@ const char *PROGNAME = "mooteval";
 // files
 mifstream file1;
 mifstream file2;
+#ifdef MOOT_ZLIB_ENABLED
+mizbstream zfile1;  //-- decompressing wrapper for file1 (*.gz, *.mbz)
+mizbstream zfile2;  //-- decompressing wrapper for file2 (*.gz, *.mbz)
+#endif
+mistream *input1s = &file1; //-- input stream for file1: file1 or zfile1
+mistream *input2s = &file2; //-- input stream for file2: file2 or zfile2
 mofstream out;
 
 // options & file-churning
@@ -75,32 +81,19 @@ TokenWriterNative *twriter2 = new TokenWriterNative(ofmt);
 //mootSentence s1, s2;
 mootTokenType tt1, tt2, tt1prev, tt2prev;
 
+//-- threaded input (--no-threads)
+mootEvalPrefetch input1;
+mootEvalPrefetch input2;
+
 //-- comparison
 mootEval eval;
 //int status;
 
-//-- information
-size_t ntokens = 0;     //-- total number of tokens
-size_t nsents = 0;      //-- total number of sentences
-size_t ntokmisses = 0;  //-- number of token-text mismatches
-size_t nbestmisses = 0; //-- number of best-tag mismatches
-
-//-- information: file specific
-size_t nempties1 = 0;   //-- number of empty analyses in file1
-size_t nempties2 = 0;   //-- number of empty analyses in file2
-size_t nimps1 = 0;      //-- number of impossible analyses in file1
-size_t nimps2 = 0;      //-- number of impossible analyses in file2
-size_t nximps1 = 0;     //-- number of x-impossible analyses in file1
-size_t nximps2 = 0;     //-- number of x-impossible analyses in file2
-
-unsigned long nans1 = 0; //-- total number of analyses in file1
-unsigned long nans2 = 0; //-- total number of analyses in file2
-
-size_t nsaves1 = 0;   //-- saves (empty class & x-best match) in file 1 vs. 2
-size_t nsaves2 = 0;   //-- saves (empty class & x-best match) in file 2 vs. 1
-
-size_t nfumbles1 = 0; //-- fumbles (+x-class-cover, -best-match) in file 1 vs. 2
-size_t nfumbles2 = 0; //-- fumbles (+x-class-cover, -best-match) in file 2 vs. 1
+//-- information (see mootEvalStats for the counts)
+mootEvalStats stats;
+mootLexfreqs  lexicon;  //-- for known/unknown accuracy (--lexicon)
+mootTaster    taster;   //-- for accuracy by flavor (--flavors, --stats)
+mofstream     statsout; //-- machine-readable statistics (--stats)
 
 size_t nharderrors =0;       //-- number of 'hard' (EOS/EOF) errors
 size_t nharderrors_max =100; //-- maximum number of 'hard' errors
@@ -121,6 +114,29 @@ typedef enum {
 
 int vlevel = 10; //-- our verbosity level
 
+/*--------------------------------------------------------------------------
+ * Input streams
+ *--------------------------------------------------------------------------*/
+#ifdef MOOT_ZLIB_ENABLED
+//-- decompress *.gz and *.mbz input files (cf. cmdutil_file_churner::next_input_file())
+mistream *input_stream(mifstream &file, mizbstream &zfile)
+{
+  const char *ext = moot_extension(file.name.c_str());
+  if (!ext || (strcmp(ext,".gz")!=0 && strcmp(ext,".mbz")!=0)) return &file;
+  zfile.from_file(file.file);
+  return &zfile;
+}
+#endif
+
+//-- check a fully read input stream for read errors (e.g. truncated gzip data)
+bool check_input(mistream *mis, const std::string &name)
+{
+  if (mis->valid()) return true;
+  moot_msg(vlevel, evlBasic, "%s: error reading file \"%s\": %s\n",
+	   PROGNAME, name.c_str(), mis->errmsg().c_str());
+  return false;
+}
+
 /*--------------------------------------------------------------------------
  * Option Processing
  *--------------------------------------------------------------------------*/
@@ -190,7 +206,10 @@ void GetMyOptions(int argc, char **argv)
 	    PROGNAME, file1.name.c_str(), strerror(errno));
     exit(2);
   }
-  treader1->from_mstream(&file1);
+#ifdef MOOT_ZLIB_ENABLED
+  input1s = input_stream(file1, zfile1);
+#endif
+  treader1->from_mstream(input1s);
 
   //-- open: file2
   if (!file2.open(args.inputs[1],"r")) {
@@ -198,10 +217,43 @@ void GetMyOptions(int argc, char **argv)
 	    PROGNAME, file2.name.c_str(), strerror(errno));
     exit(2);
   }
-  treader2->from_mstream(&file2);
+#ifdef MOOT_ZLIB_ENABLED
+  input2s = input_stream(file2, zfile2);
+#endif
+  treader2->from_mstream(input2s);
+
+  //-- breakdowns: known/unknown tokens
+  if (args.lexicon_given) {
+    if (!lexicon.load(args.lexicon_arg)) {
+      fprintf(stderr, "%s: load failed for lexicon file \"%s\"\n", PROGNAME, args.lexicon_arg);
+      exit(2);
+    }
+    stats.lexicon = &lexicon;
+  }
+
+  //-- breakdowns: flavors
+  if (args.flavors_given) {
+    taster.clear();
+    if (!taster.load(args.flavors_arg)) {
+      fprintf(stderr, "%s: load failed for flavor file \"%s\"\n", PROGNAME, args.flavors_arg);
+      exit(2);
+    }
+  }
+  if (args.flavors_given || args.stats_given)
+    stats.taster = &taster;
+
+  //-- machine-readable statistics
+  if (args.stats_given && !statsout.open(args.stats_arg,"w")) {
+    fprintf(stderr, "%s: open failed for statistics file \"%s\": %s\n",
+	    PROGNAME, statsout.name.c_str(), strerror(errno));
+    exit(2);
+  }
 
-  //-- process options
-  //(none)
+  //-- threaded input
+  input1.reader = treader1;
+  input2.reader = treader2;
+  input1.start(!args.no_threads_flag);
+  input2.start(!args.no_threads_flag);
 }
 
 /*--------------------------------------------------------------------------
@@ -219,6 +271,9 @@ void print_summary_for_file(TokenWriter *tw,
 			    size_t nempties, size_t nimps, size_t nximps,
 			    size_t nsaves, size_t nfumbles);
 
+void print_summary_accuracy(TokenWriter *tw, const char *label,
+			    const mootEvalStats::Accuracy &acc, size_t ntokens);
+
 void print_summary_to_file(FILE *file);
 
 
@@ -227,6 +282,7 @@ void print_summary_to_file(FILE *file);
  *--------------------------------------------------------------------------*/
 int main (int argc, char **argv)
 {
+  int rc = 0;
   try{
     GetMyOptions(argc,argv);
 
@@ -247,21 +303,21 @@ int main (int argc, char **argv)
     //-- compare files
     tt1prev = TokTypeEOS;
     tt2prev = TokTypeEOS;
-    for (tt1  = treader1->get_token()  ,  tt2  = treader2->get_token();
+    for (tt1  = input1.get_token()  ,  tt2  = input2.get_token();
 	 tt1 != TokTypeEOF             || tt2 != TokTypeEOF;
-	 /*treader1->get_token(), treader2->get_token()*/ )
+	 /*input1.get_token(), input2.get_token()*/ )
       {
 	//-- assign token aliases
 	const mootToken *tok1 = (tt1 == TokTypeEOS
 				 ? &tokEOS
-				 : (tt1 == TokTypeEOF || !treader1->token()
+				 : (tt1 == TokTypeEOF || !input1.token()
 				    ? &tokEOF
-				    : treader1->token()));
+				    : input1.token()));
 	const mootToken *tok2 = (tt2 == TokTypeEOS
 				 ? &tokEOS
-				 : (tt2 == TokTypeEOF || !treader2->token()
+				 : (tt2 == TokTypeEOF || !input2.token()
 				    ? &tokEOF
-				    : treader2->token()));
+				    : input2.token()));
 
 	//-- check for too many 'hard' errors
 	if (nharderrors > nharderrors_max) {
@@ -280,19 +336,19 @@ int main (int argc, char **argv)
 	    put_tok_results(out.file, *tok1, *tok2);
 	    //tt1prev = tt1;
 	    //tt2prev = tt2;
-	    tt1 = treader1->get_token();
-	    tt2 = treader2->get_token();
+	    tt1 = input1.get_token();
+	    tt2 = input2.get_token();
 	  }
 	  else if (tt1==TokTypeComment) {
 	    //-- comment in file1 only
 	    put_tok_results(out.file, *tok1, *tok2);
 	    //tt1prev = tt1;
-	    tt1 = treader1->get_token();
+	    tt1 = input1.get_token();
 	  }
 	  else if (tt2==TokTypeComment) {
 	    put_tok_results(out.file, *tok1, *tok2);
 	    //tt2prev = tt2;
-	    tt2 = treader2->get_token();
+	    tt2 = input2.get_token();
 	  }
 	  continue;
 	}
@@ -301,40 +357,40 @@ int main (int argc, char **argv)
 	else if (tt1 == TokTypeEOS || tt2 == TokTypeEOS) {
 	  if (tt1==tt2) {
 	    //-- eos: match
-	    nsents++;
+	    stats.nsents++;
 	    if (vlevel >= evlEverything) fputc('\n', out.file);
 	    tt1prev = tt1;
-	    tt1 = treader1->get_token();
+	    tt1 = input1.get_token();
 	    tt2prev = tt2;
-	    tt2 = treader2->get_token();
+	    tt2 = input2.get_token();
 	    continue;
 	  }
 	  else if (tt1prev==TokTypeEOS || tt2prev==TokTypeEOS) {
 	    //-- ignore consecutive EOS tokens
 	    if (tt1 == TokTypeEOS) {
 	      tt1prev = tt1;
-	      tt1 = treader1->get_token();
+	      tt1 = input1.get_token();
 	    }
 	    if (tt2 == TokTypeEOS) {
 	      tt2prev = tt2;
-	      tt2 = treader2->get_token();
+	      tt2 = input2.get_token();
 	    }
 	    continue;
 	  }
 	  //-- report real eos mismatch
 	  fprintf(stderr, "%s: sentence lengths differ at lines %u/%u!\n",
 		  PROGNAME,
-		  static_cast<unsigned int>(treader1->line_number()),
-		  static_cast<unsigned int>(treader2->line_number()));
+		  static_cast<unsigned int>(input1.line_number()),
+		  static_cast<unsigned int>(input2.line_number()));
 	  nharderrors++;
 
 	  if (tt1 == TokTypeEOS) {
 	    tt1prev = tt1;
-	    tt1 = treader1->get_token();
+	    tt1 = input1.get_token();
 	  }
 	  if (tt2 == TokTypeEOS) {
 	    tt2prev = tt2;
-	    tt2 = treader2->get_token();
+	    tt2 = input2.get_token();
 	  }
 	  continue;
 	}
@@ -346,81 +402,66 @@ int main (int argc, char **argv)
 	  else if (tt1 != TokTypeEOF) {
 	    put_tok_results(out.file, *tok1, *tok2);
 	    tt1prev = tt1;
-	    tt1 = treader1->get_token();
+	    tt1 = input1.get_token();
 	    if (tt1prev == TokTypeEOS) continue; //-- skip eof/eos mismatch
 	  }
 	  else if (tt2 != TokTypeEOF) {
 	    put_tok_results(out.file, *tok1, *tok2);
 	    tt2prev = tt2;
-	    tt2 = treader2->get_token();
+	    tt2 = input2.get_token();
 	    if (tt2prev == TokTypeEOS) continue; //-- skip eof/eos mismatch
 	  }
 
 	  //-- report real eof mismatch
 	  fprintf(stderr, "%s: file lengths differ at lines %u/%u!\n",
 		  PROGNAME,
-		  static_cast<unsigned int>(treader1->line_number()),
-		  static_cast<unsigned int>(treader2->line_number()));
+		  static_cast<unsigned int>(input1.line_number()),
+		  static_cast<unsigned int>(input2.line_number()));
 	  nharderrors++;
 	  continue;
 	}
 
 	//--------------------------------------------------------
 	//-- "plain" tokens: compare
-	ntokens++;
-	nans1 += tok1->analyses().size();
-	nans2 += tok2->analyses().size();
+	stats.add(eval, *tok1, *tok2);
 
-	eval.compareTokens(*tok1,*tok2);
-	if (eval.isTokenMismatch()) ntokmisses++;
-	if (eval.isBestMismatch()) nbestmisses++;
-
-	if (eval.isEmptyClass1()) {
-	  nempties1++;
-	  if (!eval.isBestMismatch()) nsaves1++;
-	}
-	else if (eval.isBestMismatch()) {
-	  nfumbles1++;
-	}
-      
-	if (eval.isEmptyClass2()) {
-	  nempties2++;
-	  if (!eval.isBestMismatch()) nsaves2++;
-	}
-	else if (eval.isBestMismatch()) {
-	  nfumbles2++;
-	}
-      
-	if (eval.isImpClass1()) nimps1++;
-	if (eval.isImpClass2()) nimps2++;
-      
-	if (eval.isXImpClass1()) nximps1++;
-	if (eval.isXImpClass2()) nximps2++;
-      
 	//-- output evaluation results
 	put_tok_results(out.file, *tok1, *tok2);
       
 	//-- get next token in each file
 	tt1prev = tt1;
 	tt2prev = tt2;
-	tt1 = treader1->get_token();
-	tt2 = treader2->get_token();
+	tt1 = input1.get_token();
+	tt2 = input2.get_token();
       }
 
     //-- summary
     print_summary(twriter2);
+    if (args.stats_given) {
+      if (!stats.write_tsv(&statsout))
+	fprintf(stderr, "%s: error writing statistics to \"%s\"\n", PROGNAME, statsout.name.c_str());
+      statsout.close();
+    }
 
     if (vlevel >= evlBasic && out.file != stdout) {
       print_summary_to_file(stderr);
     }
 
     //-- cleanup
+    input1.stop();
+    input2.stop();
+    if (!check_input(input1s, file1.name)) rc = 1;
+    if (!check_input(input2s, file2.name)) rc = 1;
     treader1->close();
     treader2->close();
 
     twriter1->close();
     twriter2->close();
 
+#ifdef MOOT_ZLIB_ENABLED
+    zfile1.close();
+    zfile2.close();
+#endif
     file1.close();
     file2.close();
     out.close();
@@ -429,7 +470,7 @@ int main (int argc, char **argv)
     fprintf(stderr, "%s: Exception: %s\n", PROGNAME, e.what());
     abort();
   }
-  return 0;
+  return rc;
 }
 
 
@@ -449,7 +490,9 @@ void print_summary_to_file(FILE *file)
  *--------------------------------------------------------------------------*/
 void print_summary(TokenWriter *tw)
 {
-  if (ntokens==0) ntokens = 1;
+  size_t ntokens     = stats.ntokens ? stats.ntokens : 1;
+  size_t ntokmisses  = stats.ntokmisses;
+  size_t nbestmisses = stats.nbestmisses;
   tw->put_comment_block_begin();
   tw->printf_raw("===================================================================\n");
   tw->printf_raw(" %s Summary:\n", PROGNAME);
@@ -457,7 +500,7 @@ void print_summary(TokenWriter *tw)
   //----------------------------------------------------
   // General
   tw->printf_raw("  + NTokens             : %9u\n", ntokens);
-  tw->printf_raw("  + NSentences          : %9u\n", nsents);
+  tw->printf_raw("  + NSentences          : %9u\n", stats.nsents);
 
   //----------------------------------------------------
   // File-1
@@ -466,8 +509,8 @@ void print_summary(TokenWriter *tw)
 		 TokenIO::format_canonical_string(treader1->tr_format).c_str());
   if (vlevel >= evlExtended && eval_file1)
     print_summary_for_file(tw,
-			   ntokens, nans1, nempties1,
-			   nimps1, nximps1, nsaves1, nfumbles1);
+			   ntokens, stats.file1.nanls, stats.file1.nempties,
+			   stats.file1.nimps, stats.file1.nximps, stats.file1.nsaves, stats.file1.nfumbles);
 
   //----------------------------------------------------
   // File-2
@@ -476,8 +519,8 @@ void print_summary(TokenWriter *tw)
 		 TokenIO::format_canonical_string(treader2->tr_format).c_str());
   if (vlevel >= evlExtended && eval_file2)
     print_summary_for_file(tw,
-			   ntokens, nans2, nempties2,
-			   nimps2, nximps2, nsaves2, nfumbles2);
+			   ntokens, stats.file2.nanls, stats.file2.nempties,
+			   stats.file2.nimps, stats.file2.nximps, stats.file2.nsaves, stats.file2.nfumbles);
 
   //----------------------------------------------------
   // Accuracy
@@ -489,6 +532,19 @@ void print_summary(TokenWriter *tw)
 		 ntokens-nbestmisses, 100.0*static_cast<double>(ntokens-nbestmisses)/static_cast<double>(ntokens),
 		 nbestmisses, 100.0*static_cast<double>(nbestmisses)/static_cast<double>(ntokens));
 
+  //----------------------------------------------------
+  // Breakdowns
+  if (vlevel >= evlExtended && stats.lexicon) {
+    print_summary_accuracy(tw, "Known Tokens", stats.known, ntokens);
+    print_summary_accuracy(tw, "Unknown Tokens", stats.unknown, ntokens);
+  }
+  if (vlevel >= evlExtended && args.flavors_given) {
+    for (mootEvalStats::FlavorMap::const_iterator fi = stats.flavors.begin(); fi != stats.flavors.end(); ++fi) {
+      string label = "Flavor " + (fi->first.empty() ? string("-") : fi->first);
+      print_summary_accuracy(tw, label.c_str(), fi->second, ntokens);
+    }
+  }
+
   tw->printf_raw("===================================================================\n");
   tw->put_comment_block_end();
 }
@@ -496,6 +552,22 @@ void print_summary(TokenWriter *tw)
 
 
 
+/*--------------------------------------------------------------------------
+ * summary (for token subset)
+ *--------------------------------------------------------------------------*/
+void print_summary_accuracy(TokenWriter *tw, const char *label,
+			    const mootEvalStats::Accuracy &acc, size_t ntokens)
+{
+  size_t n = acc.ntokens ? acc.ntokens : 1;
+  tw->printf_raw("  + %-19s : %9u (%6.2f%%)\n",
+		 label, acc.ntokens, 100.0*static_cast<double>(acc.ntokens)/static_cast<double>(ntokens));
+  tw->printf_raw("    - Tags Equal  (+/-) : %9u (%6.2f%%) / %9u (%6.2f%%)\n",
+		 acc.ncorrect, 100.0*static_cast<double>(acc.ncorrect)/static_cast<double>(n),
+		 acc.ntokens-acc.ncorrect, 100.0*static_cast<double>(acc.ntokens-acc.ncorrect)/static_cast<double>(n));
+}
+
+
+
 /*--------------------------------------------------------------------------
  * summary (for file)
  *--------------------------------------------------------------------------*/
@@ -91,6 +91,7 @@ void GetMyOptions(int argc, char **argv)
 
   // -- set up file-churner
   churner.progname = PROGNAME;
+  churner.verbose = vlevel;
   churner.inputs = args.inputs;
   churner.ninputs = args.inputs_num;
   churner.use_list = args.list_given;
@@ -124,7 +125,7 @@ int main (int argc, char **argv)
     moot_msg(vlevel, vlProgress,  "%s: processing file '%s'... ", PROGNAME, churner.in.name.c_str());
     writer->printf_comment("\n    File: %s\n", churner.in.name.c_str());
 
-    lexer->from_mstream(&churner.in);
+    lexer->from_mstream(churner.input());
     lexer->to_mstream(&out);
 
     int lxtok;
@@ -174,6 +175,6 @@ int main (int argc, char **argv)
     fprintf(stderr, "-----------------------------------------------------\n");
   }
   
-  return 0;
+  return churner.nerrors > 0 ? 1 : 0;
 }
 
@@ -115,6 +115,7 @@ void GetMyOptions(int argc, char **argv)
 
   // -- set up file-churner
   churner.progname = PROGNAME;
+  churner.verbose = vlevel;
   churner.inputs = args.inputs;
   churner.ninputs = args.inputs_num;
   churner.use_list = 0;
@@ -255,7 +256,7 @@ int main (int argc, char **argv)
     if (lcout.valid())
       lcout.printf("%s  Corpus        : %s\n", cmts, churner.in.name.c_str());
 
-    reader->from_mstream(&churner.in);
+    reader->from_mstream(churner.input());
     reader->reader_name(churner.in.name);
     hmmt.train_from_reader(reader);
     reader->close();
@@ -362,5 +363,5 @@ int main (int argc, char **argv)
     flout.close();
   }
 
-  return 0;
+  return churner.nerrors > 0 ? 1 : 0;
 }
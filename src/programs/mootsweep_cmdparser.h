@@ -0,0 +1,107 @@
+/* -*- Mode: C -*-
+ *
+ * File: mootsweep_cmdparser.h
+ * Description: Headers for command-line parser struct gengetopt_args_info.
+ *
+ * File autogenerated by optgen.perl version 0.07.
+ *
+ */
+
+#ifndef mootsweep_cmdparser_h
+#define mootsweep_cmdparser_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*
+ * moocow: Never set PACKAGE and VERSION here.
+ */
+
+struct gengetopt_args_info {
+  char * rcfile_arg;	 /* Read an alternate configuration file. (default=NULL). */
+  int verbose_arg;	 /* Verbosity level. (default=2). */
+  int no_banner_flag;	 /* Suppress initial banner message (implied at verbosity levels <= 2) (default=0). */
+  char * output_arg;	 /* Specify output file (default=stdout). (default=-). */
+  char * input_format_arg;	 /* Specify input file(s) format(s). (default=NULL). */
+  char * input_encoding_arg;	 /* Override document encoding for XML input. (default=NULL). */
+  int folds_arg;	 /* Number of cross-validation folds. (default=10). */
+  int jobs_arg;	 /* Number of folds to process in parallel. (default=1). */
+  int per_fold_flag;	 /* Also output results for each fold. (default=0). */
+  int hash_ngrams_arg;	 /* Whether to hash stored n-grams (default=no) (default=0). */
+  int trie_depth_arg;	 /* Maximum depth of suffix trie. (default=0). */
+  int trie_threshhold_arg;	 /* Frequency upper bound for trie inclusion. (default=10). */
+  float trie_theta_arg;	 /* Suffix backoff coefficient. (default=0). */
+  int use_classes_arg;	 /* Whether to use lexical class-probabilities. (default=1). */
+  int use_flavors_arg;	 /* Whether to use token 'flavor' heuristics (default=1 (true)) (default=1). */
+  char * flavors_from_arg;	 /* Use flavor heuristics from FILE (default=built-in). (default=NULL). */
+  int relax_arg;	 /* Whether to relax token-tag associability (default=1 (true)) (default=1). */
+  char * eos_tag_arg;	 /* Specify boundary tag (default=__$) (default=__$). */
+  char * nlambdas_arg;	 /* N-Gram smoothing constant settings (default=estimate) (default=NULL). */
+  char * wlambdas_arg;	 /* Lexical smoothing constant settings (default=estimate) (default=NULL). */
+  char * clambdas_arg;	 /* Lexical-class smoothing constant settings (default=estimate) (default=NULL). */
+  char * unknown_threshhold_arg;	 /* Freq. threshhold(s) for 'unknown' lexical probabilities (default=1). */
+  char * class_threshhold_arg;	 /* Freq. threshhold(s) for 'unknown' class probabilities (default=1). */
+  char * beam_width_arg;	 /* Cutoff factor(s) for beam pruning (default=1000). */
+
+  int help_given;	 /* Whether help was given */
+  int version_given;	 /* Whether version was given */
+  int rcfile_given;	 /* Whether rcfile was given */
+  int verbose_given;	 /* Whether verbose was given */
+  int no_banner_given;	 /* Whether no-banner was given */
+  int output_given;	 /* Whether output was given */
+  int input_format_given;	 /* Whether input-format was given */
+  int input_encoding_given;	 /* Whether input-encoding was given */
+  int folds_given;	 /* Whether folds was given */
+  int jobs_given;	 /* Whether jobs was given */
+  int per_fold_given;	 /* Whether per-fold was given */
+  int hash_ngrams_given;	 /* Whether hash-ngrams was given */
+  int trie_depth_given;	 /* Whether trie-depth was given */
+  int trie_threshhold_given;	 /* Whether trie-threshhold was given */
+  int trie_theta_given;	 /* Whether trie-theta was given */
+  int use_classes_given;	 /* Whether use-classes was given */
+  int use_flavors_given;	 /* Whether use-flavors was given */
+  int flavors_from_given;	 /* Whether flavors-from was given */
+  int relax_given;	 /* Whether relax was given */
+  int eos_tag_given;	 /* Whether eos-tag was given */
+  int nlambdas_given;	 /* Whether nlambdas was given */
+  int wlambdas_given;	 /* Whether wlambdas was given */
+  int clambdas_given;	 /* Whether clambdas was given */
+  int unknown_threshhold_given;	 /* Whether unknown-threshhold was given */
+  int class_threshhold_given;	 /* Whether class-threshhold was given */
+  int beam_width_given;	 /* Whether beam-width was given */
+  
+  char **inputs;         /* unnamed arguments */
+  unsigned inputs_num;   /* number of unnamed arguments */
+};
+
+/* read rc files (if any) and parse all command-line options in one swell foop */
+int  cmdline_parser (int argc, char *const *argv, struct gengetopt_args_info *args_info);
+
+/* instantiate defaults from environment variables: you must call this yourself! */
+void cmdline_parser_envdefaults (struct gengetopt_args_info *args_info);
+
+/* read a single rc-file */
+void cmdline_parser_read_rcfile (const char *filename,
+				    struct gengetopt_args_info *args_info,
+				    int user_specified);
+
+/* read a single rc-file (stream) */
+void cmdline_parser_read_rc_stream (FILE *rcfile,
+				       const char *filename,
+				       struct gengetopt_args_info *args_info);
+
+/* parse a single option */
+int cmdline_parser_parse_option (char oshort, const char *olong, const char *val,
+				    struct gengetopt_args_info *args_info);
+
+/* print help message */
+void cmdline_parser_print_help(void);
+
+/* print version */
+void cmdline_parser_print_version(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif /* mootsweep_cmdparser_h */
@@ -0,0 +1,386 @@
+/*
+   moot-utils : moocow's part-of-speech tagger
+   Copyright (C) 2002-2014 by Bryan Jurish <moocow@cpan.org>
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 3 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+/*--------------------------------------------------------------------------
+ * File: mootsweep_main.cc
+ * Author: Bryan Jurish <moocow@cpan.org>
+ * Description:
+ *   + moot PoS tagger : cross-validation and smoothing-parameter sweeps : main()
+ *--------------------------------------------------------------------------*/
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include <mootHMMSweep.h>
+#include <mootTokenIO.h>
+#include <mootTokenExpatIO.h>
+#include <mootCIO.h>
+#include <mootUtils.h>
+
+#include "mootsweep_cmdparser.h"
+
+using namespace std;
+using namespace moot;
+using namespace mootio;
+
+/*--------------------------------------------------------------------------
+ * Globals
+ *--------------------------------------------------------------------------*/
+const char *PROGNAME = "mootsweep";
+
+// options & file-churning
+gengetopt_args_info  args;
+cmdutil_file_churner churner;
+
+// -- files
+mofstream out;
+
+//-- token i/o
+int ifmt         = tiofNone;
+int ifmt_implied = tiofTagged;
+int ifmt_default = tiofWellDone;
+
+TokenReader *reader = NULL;
+
+//-- verbosity level
+int vlevel = vlEverything;
+
+//-- flavor source (for reporting)
+const char *flavor_src = "???";
+
+/*--------------------------------------------------------------------------
+ * Sweep: per-fold model options from the command line
+ *--------------------------------------------------------------------------*/
+class mootSweepMain : public mootHMMSweep {
+public:
+  mootSweepMain(void) : mootHMMSweep() {};
+
+  virtual mootHMM *new_hmm(void) const
+  {
+    mootHMM *hmmp = new mootHMM();
+    hmmp->verbose         = (vlevel < vlWarnings ? vlevel : vlWarnings);
+    hmmp->hash_ngrams     = args.hash_ngrams_arg;
+    hmmp->use_lex_classes = args.use_classes_arg;
+    hmmp->use_flavors     = args.use_flavors_arg;
+    hmmp->relax           = args.relax_arg;
+#ifdef MOOT_ENABLE_SUFFIX_TRIE
+    hmmp->suftrie.maxlen() = args.trie_depth_arg;
+    hmmp->suftrie.maxcount = args.trie_threshhold_arg;
+    hmmp->suftrie.theta    = args.trie_theta_arg;
+#endif
+    return hmmp;
+  };
+};
+
+mootSweepMain sweep;
+
+/*--------------------------------------------------------------------------
+ * Option Processing: grid lists
+ *--------------------------------------------------------------------------*/
+
+//-- split semicolon-separated option value \a arg into non-empty items
+vector<string> split_list(const char *arg)
+{
+  vector<string> items, out;
+  if (arg) moot_strsplit(arg, ";", items);
+  for (vector<string>::iterator ii = items.begin(); ii != items.end(); ++ii) {
+    string item;
+    moot_normalize_ws(ii->data(), ii->size(), item, true, true);
+    if (!item.empty()) out.push_back(item);
+  }
+  return out;
+}
+
+//-- parse comma-separated constants; returns false for 'estimate'
+bool parse_lambdas(const char *optname, const string &item, double *dbls, size_t n)
+{
+  if (item == "estimate") return false;
+  if (!moot_parse_doubles(item.c_str(), dbls, n))
+    moot_croak("%s: could not parse %s '%s'\n", PROGNAME, optname, item.c_str());
+  double sum = 0;
+  for (size_t i=0; i < n; i++) sum += dbls[i];
+  if (sum != 1)
+    moot_msg(vlevel,vlWarnings,"%s: Warning: %s do not sum to one: %s\n", PROGNAME, optname, item.c_str());
+  return true;
+}
+
+//-- parse a single numeric constant
+double parse_double(const char *optname, const string &item)
+{
+  char *tail = NULL;
+  double d = strtod(item.c_str(), &tail);
+  if (tail == item.c_str() || *tail != '\0')
+    moot_croak("%s: could not parse %s '%s'\n", PROGNAME, optname, item.c_str());
+  return d;
+}
+
+void parse_grid(void)
+{
+  vector<mootHMMSweep::Params> ngv, wv, cv, tv, bv;
+  vector<string> items;
+
+  //-- n-gram smoothing constants
+  items = split_list(args.nlambdas_arg);
+  for (vector<string>::iterator ii = items.begin(); ii != items.end(); ++ii) {
+    mootHMMSweep::Params p;
+    double nlambdas_[3] = {0,1,0};
+    if ( (p.est_nglambdas = !parse_lambdas("n-gram smoothing constants", *ii, nlambdas_, 3)) ) {
+      ngv.push_back(p);
+      continue;
+    }
+#ifndef MOOT_USE_TRIGRAMS
+    if (nlambdas_[2] != 0)
+      moot_msg(vlevel,vlWarnings,"%s: Warning: use of trigrams disabled.\n", PROGNAME);
+    nlambdas_[2] = 0;
+#endif
+    p.nglambda1 = nlambdas_[0];
+    p.nglambda2 = nlambdas_[1];
+    p.nglambda3 = nlambdas_[2];
+    ngv.push_back(p);
+  }
+
+  //-- lexical smoothing constants
+  items = split_list(args.wlambdas_arg);
+  for (vector<string>::iterator ii = items.begin(); ii != items.end(); ++ii) {
+    mootHMMSweep::Params p;
+    double wlambdas_[2] = {1,0};
+    if (!(p.est_wlambdas = !parse_lambdas("lexical smoothing constants", *ii, wlambdas_, 2))) {
+      p.wlambda0 = wlambdas_[0];
+      p.wlambda1 = wlambdas_[1];
+    }
+    wv.push_back(p);
+  }
+
+  //-- lexical-class smoothing constants
+  items = split_list(args.clambdas_arg);
+  for (vector<string>::iterator ii = items.begin(); ii != items.end(); ++ii) {
+    mootHMMSweep::Params p;
+    double clambdas_[2] = {1,0};
+    if (!(p.est_clambdas = !parse_lambdas("lexical-class smoothing constants", *ii, clambdas_, 2))) {
+      p.clambda0 = clambdas_[0];
+      p.clambda1 = clambdas_[1];
+    }
+    cv.push_back(p);
+  }
+
+  //-- thresholds: cross product of lexical and class thresholds
+  vector<string> utv = split_list(args.unknown_threshhold_arg);
+  vector<string> ctv = split_list(args.class_threshhold_arg);
+  if (utv.empty()) utv.push_back("1");
+  if (ctv.empty()) ctv.push_back("1");
+  for (vector<string>::iterator ui = utv.begin(); ui != utv.end(); ++ui) {
+    for (vector<string>::iterator ci = ctv.begin(); ci != ctv.end(); ++ci) {
+      mootHMMSweep::Params p;
+      p.unknown_lex_threshhold   = parse_double("unknown lexical threshhold", *ui);
+      p.unknown_class_threshhold = parse_double("unknown class threshhold", *ci);
+      tv.push_back(p);
+    }
+  }
+
+  //-- beam widths
+  items = split_list(args.beam_width_arg);
+  for (vector<string>::iterator ii = items.begin(); ii != items.end(); ++ii) {
+    mootHMMSweep::Params p;
+    p.beamwd = parse_double("beam width", *ii);
+    bv.push_back(p);
+  }
+
+  sweep.add_grid(ngv, wv, cv, tv, bv);
+}
+
+/*--------------------------------------------------------------------------
+ * Option Processing
+ *--------------------------------------------------------------------------*/
+void GetMyOptions(int argc, char **argv)
+{
+  if (cmdline_parser(argc, argv, &args) != 0)
+    exit(1);
+
+  //-- locale
+  moot_setlocale();
+
+  // -- load environmental defaults
+  cmdline_parser_envdefaults(&args);
+
+  // -- verbosity
+  vlevel = args.verbose_arg;
+
+  // -- show banner
+  if (!args.no_banner_given)
+    moot_msg(vlevel, vlInfo,  moot_program_banner(PROGNAME, PACKAGE_VERSION, "Bryan Jurish <moocow@cpan.org>").c_str());
+
+  // -- set up file-churner
+  churner.progname = PROGNAME;
+  churner.verbose = vlevel;
+  churner.inputs = args.inputs;
+  churner.ninputs = args.inputs_num;
+  churner.use_list = 0;
+  churner.paranoid = true;
+
+  // -- open output file
+  if (!out.open(args.output_arg, "w"))
+    moot_croak("%s: open failed for output file '%s': %s\n", PROGNAME, out.name.c_str(), strerror(errno));
+
+  //-- i/o format : input
+  ifmt = TokenIO::parse_format_request(args.input_format_arg,
+				       (args.inputs_num>0 ? args.inputs[0] : NULL),
+				       ifmt_implied,
+				       ifmt_default);
+
+  //-- io: new_reader
+  reader = TokenIO::new_reader(ifmt);
+  if (!reader)
+    moot_croak("%s: Error: could not set up TokenReader!\n", PROGNAME);
+
+#ifdef MOOT_EXPAT_ENABLED
+  //-- io: encoding: reader
+  if (ifmt&tiofXML && args.input_encoding_given) {
+    reinterpret_cast<TokenReaderExpat *>(reader)->setEncoding(static_cast<std::string>(args.input_encoding_arg));
+  }
+#endif
+
+#ifndef MOOT_ENABLE_SUFFIX_TRIE
+  if (args.trie_depth_given || args.trie_threshhold_given || args.trie_theta_given) {
+    moot_msg(vlevel,vlWarnings, "%s: Warning: suffix trie support disabled: ignoring trie-related option(s)\n", PROGNAME);
+  }
+#endif
+#ifndef MOOT_PTHREADS_ENABLED
+  if (args.jobs_arg > 1) {
+    moot_msg(vlevel,vlWarnings, "%s: Warning: thread support disabled: ignoring --jobs=%d\n", PROGNAME, args.jobs_arg);
+  }
+#endif
+
+  //-- sweep: basic options
+  if (args.folds_arg < 2)
+    moot_croak("%s: number of folds must be at least 2 (got %d)\n", PROGNAME, args.folds_arg);
+  sweep.nfolds        = args.folds_arg;
+  sweep.njobs         = args.jobs_arg > 0 ? args.jobs_arg : 1;
+  sweep.verbose       = vlevel;
+  sweep.start_tag_str = args.eos_tag_arg;
+
+  //-- flavors
+  if (!args.flavors_from_given) {
+    //-- flavor file unspecified: use backwards-compatible built-in rules
+    flavor_src = "(built-in)";
+  }
+  else if (args.flavors_from_arg[0]) {
+    //-- flavor file specified and non-empty: load file
+    mifstream tin;
+    if (!tin.open(args.flavors_from_arg,"r"))
+      moot_croak("%s: open failed for input flavor file '%s': %s\n", PROGNAME, tin.name.c_str(), strerror(errno));
+    sweep.taster.clear();
+    sweep.taster.load(&tin);
+    flavor_src = args.flavors_from_arg;
+  }
+  else {
+    //-- flavor file specified as empty string: no flavors at all
+    sweep.taster.clear();
+    flavor_src = "(none)";
+  }
+
+  //-- sweep: parameter grid
+  parse_grid();
+
+  //-- report
+  if (vlevel >= vlInfo) {
+    fprintf(stderr, "%s: EOS tag            : %s\n", PROGNAME, sweep.start_tag_str.c_str());
+    fprintf(stderr, "%s: Flavors            : %s : %zu rules\n", PROGNAME, flavor_src, sweep.taster.size());
+    fprintf(stderr, "%s: Folds              : %zu\n", PROGNAME, sweep.nfolds);
+    fprintf(stderr, "%s: Jobs               : %zu\n", PROGNAME, sweep.njobs);
+    fprintf(stderr, "%s: Settings           : %zu\n", PROGNAME, sweep.settings.size());
+  }
+}
+
+/*--------------------------------------------------------------------------
+ * Output
+ *--------------------------------------------------------------------------*/
+
+//-- format accuracy as percentage
+inline double pct(const mootEvalStats::Accuracy &a)
+{ return a.ntokens ? (100.0 * a.ncorrect / a.ntokens) : 0.0; }
+
+void put_result(size_t i, const char *fold, const mootHMMSweep::Result &r)
+{
+  const mootHMMSweep::Params &p = sweep.settings[i];
+  out.printf("%zu\t%s", i, fold);
+
+  if (p.est_nglambdas) out.printf("\testimate");
+  else out.printf("\t%g,%g,%g", p.nglambda1, p.nglambda2, p.nglambda3);
+  if (p.est_wlambdas) out.printf("\testimate");
+  else out.printf("\t%g,%g", p.wlambda0, p.wlambda1);
+  if (p.est_clambdas) out.printf("\testimate");
+  else out.printf("\t%g,%g", p.clambda0, p.clambda1);
+
+  out.printf("\t%g\t%g\t%g", p.unknown_lex_threshhold, p.unknown_class_threshhold, p.beamwd);
+  out.printf("\t%zu\t%zu\t%.2f\t%zu\t%.2f\t%zu\t%.2f\n",
+	     r.all.ntokens, r.all.ncorrect, pct(r.all),
+	     r.known.ntokens, pct(r.known),
+	     r.unknown.ntokens, pct(r.unknown));
+}
+
+/*--------------------------------------------------------------------------
+ * main
+ *--------------------------------------------------------------------------*/
+int main (int argc, char **argv)
+{
+  GetMyOptions(argc,argv);
+
+  //-- load corpus
+  for (churner.first_input_file(); churner.in.file; churner.next_input_file()) {
+    moot_msg(vlevel, vlProgress, "%s: loading corpus file '%s'...", PROGNAME, churner.in.name.c_str());
+    reader->from_mstream(churner.input());
+    reader->reader_name(churner.in.name);
+    sweep.load_corpus(reader);
+    reader->close();
+    moot_msg(vlevel, vlProgress, " loaded.\n");
+  }
+  if (sweep.sentences.size() < sweep.nfolds)
+    moot_croak("%s: corpus has only %zu sentence(s) for %zu folds\n", PROGNAME, sweep.sentences.size(), sweep.nfolds);
+
+  //-- the guts
+  moot_msg(vlevel, vlProgress, "%s: evaluating %zu setting(s) on %zu fold(s) of %zu sentences\n",
+	   PROGNAME, sweep.settings.size(), sweep.nfolds, sweep.sentences.size());
+  if (!sweep.run())
+    moot_croak("%s: sweep FAILED\n", PROGNAME);
+
+  //-- output
+  out.printf("%%%% setting\tfold\tnlambdas\twlambdas\tclambdas\tunknown_threshhold\tclass_threshhold\tbeam_width"
+	     "\tntokens\tncorrect\taccuracy\tnknown\tknown_accuracy\tnunknown\tunknown_accuracy\n");
+  for (size_t i=0; i < sweep.settings.size(); i++) {
+    put_result(i, "*", sweep.total(i));
+    if (!args.per_fold_flag) continue;
+    for (size_t f=0; f < sweep.nfolds; f++) {
+      char fold[32];
+      sprintf(fold, "%zu", f);
+      put_result(i, fold, sweep.results[i][f]);
+    }
+  }
+  out.close();
+
+  return churner.nerrors > 0 ? 1 : 0;
+}
@@ -104,6 +104,7 @@ void GetMyOptions(int argc, char **argv)
 
   //-- set up file-churner
   churner.progname = PROGNAME;
+  churner.verbose = vlevel;
   churner.inputs = args.inputs;
   churner.ninputs = args.inputs_num;
   churner.use_list = args.list_given;
@@ -195,7 +196,7 @@ int main (int argc, char **argv)
 
     //hmm.tag_file(churner.in.file, out.file, churner.in.name);
 
-    reader->from_mstream(&churner.in);
+    reader->from_mstream(churner.input());
     int rtok;
     while (reader && (rtok = reader->get_sentence()) != TokTypeEOF) {
       mootSentence *sent = reader->sentence();
@@ -214,6 +215,6 @@ int main (int argc, char **argv)
 
   writer->close();
   out.close();
-  return 0;
+  return churner.nerrors > 0 ? 1 : 0;
 }
 
@@ -105,6 +105,10 @@ cmdline_parser_print_help (void)
   printf("   -D        --no-decode             Disable post-Viterbi decoding stage.\n");
   printf("   -n        --annotate              Enable text-based annotation stage.\n");
   printf("   -N        --no-annotate           Disable text-based annotation stage.\n");
+  printf("             --pipeline              Run processing stages in parallel threads.\n");
+  printf("             --jobs=N                Process up to N input chunks in parallel.\n");
+  printf("             --chunk-size=BYTES      Target chunk size for --jobs (in bytes).\n");
+  printf("             --mmap                  Scan regular input files in place via mmap().\n");
   printf("\n");
   printf(" Lexer Options:\n");
   printf("   -aFILE    --abbrevs=FILE          Load abbreviation lexicon from FILE (1 word/line)\n");
@@ -159,6 +163,10 @@ clear_args(struct gengetopt_args_info *args_info)
   args_info->no_decode_flag = 0; 
   args_info->annotate_flag = 0; 
   args_info->no_annotate_flag = 0; 
+  args_info->pipeline_flag = 0; 
+  args_info->jobs_arg = 0; 
+  args_info->chunk_size_arg = 1048576; 
+  args_info->mmap_flag = 0; 
   args_info->abbrevs_arg = NULL; 
   args_info->conjunctions_arg = NULL; 
   args_info->stopwords_arg = NULL; 
@@ -196,6 +204,10 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
   args_info->no_decode_given = 0;
   args_info->annotate_given = 0;
   args_info->no_annotate_given = 0;
+  args_info->pipeline_given = 0;
+  args_info->jobs_given = 0;
+  args_info->chunk_size_given = 0;
+  args_info->mmap_given = 0;
   args_info->abbrevs_given = 0;
   args_info->conjunctions_given = 0;
   args_info->stopwords_given = 0;
@@ -240,6 +252,10 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
 	{ "no-decode", 0, NULL, 'D' },
 	{ "annotate", 0, NULL, 'n' },
 	{ "no-annotate", 0, NULL, 'N' },
+	{ "pipeline", 0, NULL, 0 },
+	{ "jobs", 1, NULL, 0 },
+	{ "chunk-size", 1, NULL, 0 },
+	{ "mmap", 0, NULL, 0 },
 	{ "abbrevs", 1, NULL, 'a' },
 	{ "conjunctions", 1, NULL, 'j' },
 	{ "stopwords", 1, NULL, 'w' },
@@ -821,6 +837,44 @@ cmdline_parser_parse_option(char oshort, const char *olong, const char *val,
             args_info->annotate_flag=0;
           }
           
+          /* Run processing stages in parallel threads. */
+          else if (strcmp(olong, "pipeline") == 0) {
+            if (args_info->pipeline_given) {
+              fprintf(stderr, "%s: `--pipeline' option given more than once\n", PROGRAM);
+            }
+            args_info->pipeline_given++;
+           if (args_info->pipeline_given <= 1)
+             args_info->pipeline_flag = !(args_info->pipeline_flag);
+          }
+          
+          /* Process up to N input chunks in parallel. */
+          else if (strcmp(olong, "jobs") == 0) {
+            if (args_info->jobs_given) {
+              fprintf(stderr, "%s: `--jobs' option given more than once\n", PROGRAM);
+            }
+            args_info->jobs_given++;
+            args_info->jobs_arg = (int)atoi(val);
+          }
+          
+          /* Target chunk size for --jobs (in bytes). */
+          else if (strcmp(olong, "chunk-size") == 0) {
+            if (args_info->chunk_size_given) {
+              fprintf(stderr, "%s: `--chunk-size' option given more than once\n", PROGRAM);
+            }
+            args_info->chunk_size_given++;
+            args_info->chunk_size_arg = (int)atoi(val);
+          }
+          
+          /* Scan regular input files in place via mmap(). */
+          else if (strcmp(olong, "mmap") == 0) {
+            if (args_info->mmap_given) {
+              fprintf(stderr, "%s: `--mmap' option given more than once\n", PROGRAM);
+            }
+            args_info->mmap_given++;
+           if (args_info->mmap_given <= 1)
+             args_info->mmap_flag = !(args_info->mmap_flag);
+          }
+          
           /* Load abbreviation lexicon from FILE (1 word/line) */
           else if (strcmp(olong, "abbrevs") == 0) {
             if (args_info->abbrevs_given) {
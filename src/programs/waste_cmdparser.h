@@ -37,6 +37,10 @@ struct gengetopt_args_info {
   int no_decode_flag;	 /* Disable post-Viterbi decoding stage. (default=0). */
   int annotate_flag;	 /* Enable text-based annotation stage. (default=0). */
   int no_annotate_flag;	 /* Disable text-based annotation stage. (default=0). */
+  int pipeline_flag;	 /* Run processing stages in parallel threads. (default=0). */
+  int jobs_arg;	 /* Process up to N input chunks in parallel. (default=0). */
+  int chunk_size_arg;	 /* Target chunk size for --jobs (in bytes). (default=1048576). */
+  int mmap_flag;	 /* Scan regular input files in place via mmap(). (default=0). */
   char * abbrevs_arg;	 /* Load abbreviation lexicon from FILE (1 word/line) (default=NULL). */
   char * conjunctions_arg;	 /* Load conjunction lexicon from FILE (1 word/line) (default=NULL). */
   char * stopwords_arg;	 /* Load stopword lexicon from FILE (1 word/line) (default=NULL). */
@@ -66,6 +70,10 @@ struct gengetopt_args_info {
   int no_decode_given;	 /* Whether no-decode was given */
   int annotate_given;	 /* Whether annotate was given */
   int no_annotate_given;	 /* Whether no-annotate was given */
+  int pipeline_given;	 /* Whether pipeline was given */
+  int jobs_given;	 /* Whether jobs was given */
+  int chunk_size_given;	 /* Whether chunk-size was given */
+  int mmap_given;	 /* Whether mmap was given */
   int abbrevs_given;	 /* Whether abbrevs was given */
   int conjunctions_given;	 /* Whether conjunctions was given */
   int stopwords_given;	 /* Whether stopwords was given */
@@ -46,12 +46,16 @@
 #include <wasteDecoder.h>
 #include <wasteAnnotator.h>
 #include <wasteTrainWriter.h>
+#include <wastePipeline.h>
+#include <wasteChunker.h>
 
 #include <mootUtils.h>
 #include <mootCIO.h>
 #include <mootToken.h>
 #include <mootTokenIO.h>
 #include <mootHMM.h>
+#include <mootHMMHandle.h>
+#include <mootBufferIO.h>
 
 #include "waste_cmdparser.h"
 
@@ -76,6 +80,7 @@ mootHMM      *tagger=NULL;
 wasteDecoder *decoder=NULL;
 wasteAnnotatorWriter *annoter=NULL;
 wasteTrainWriter *trainwriter=NULL;
+wastePipeline *pipeline=NULL;
 
 //-- Token I/O: reader; see GetMyOptions() for mode-dependent hacks
 int ifmt = tiofNone;
@@ -214,6 +219,7 @@ void GetMyOptions(int argc, char **argv)
 
   //-- set up file-churner
   churner.progname = PROGNAME;
+  churner.verbose = vlevel;
   churner.inputs = args.inputs;
   churner.ninputs = args.inputs_num;
   churner.use_list = args.list_given;
@@ -271,13 +277,22 @@ void churn_io(TokenReader *reader, TokenWriter *writer=main_writer, mootHMM *hmm
       writer->printf_comment(" %s:File: %s\n", PROGNAME, churner.in.name.c_str());
     }
 
-    reader->from_mstream(&churner.in);
-    if (hmm) {
+    if (pipeline) {
+      if (!pipeline->run(churner.input()))
+	moot_croak("%s: ERROR: pipeline failed for file '%s'\n", PROGNAME, churner.in.name.c_str());
+      ntokens += pipeline->wp_ntokens;
+    }
+    else if (hmm) {
+      reader->from_mstream(churner.input());
       hmm->ntokens = 0;
-      hmm->tag_stream(reader,writer);
+      if (reader==lexer && lexer->lexer.wl_hmm==hmm)
+	hmm->tag_stream(reader,writer,&lexer->wlr_lexinfo,&lexer->wlr_lextext);
+      else
+	hmm->tag_stream(reader,writer);
       ntokens += hmm->ntokens;
     }
     else {
+      reader->from_mstream(churner.input());
       ntokens += TokenIO::pipe_tokens( reader, writer );
     }
     if (vlevel >= vlInfo)
@@ -312,6 +327,239 @@ wasteLexerReader *get_lexer(int lexfmt=tiofUnknown, TokenReader *reader=NULL)
   return lexer;
 }
 
+/*--------------------------------------------------------------------------
+ * guts: document-parallel processing (--jobs)
+ */
+
+//-- writer discarding output for the lead-in of a chunk (see wasteChunker)
+class ChunkFilter : public TokenWriter {
+public:
+  TokenWriter *sink;         //-- underlying writer
+  ByteOffset   start;        //-- input offset of first token to keep
+  bool         discarding;   //-- true while in lead-in
+  bool         pending_eos;  //-- true if an EOS was discarded since the last located token
+
+public:
+  ChunkFilter(TokenWriter *writer=NULL)
+    : TokenWriter(writer ? writer->tw_format : tiofWellDone, "ChunkFilter"),
+      sink(writer),
+      start(0),
+      discarding(false),
+      pending_eos(false)
+  {};
+
+  void reset(ByteOffset offset)
+  {
+    start       = offset;
+    discarding  = offset > 0;
+    pending_eos = false;
+  };
+
+  virtual void put_token(const mootToken &token)
+  {
+    if (discarding) {
+      switch (token.tok_type) {
+      case TokTypeVanilla:
+      case TokTypeLibXML:
+      case TokTypeWB:
+      case TokTypeSB:
+	if (token.tok_location.offset < start) {
+	  pending_eos = false;
+	  return;
+	}
+	//-- first token of the chunk proper: keep any EOS preceding it
+	discarding = false;
+	if (pending_eos) sink->put_token(mootToken(TokTypeEOS));
+	break;
+      case TokTypeEOS:
+	pending_eos = true;
+	return;
+      default:
+	return;
+      }
+    }
+    sink->put_token(token);
+  };
+
+  virtual void put_tokens(const mootSentence &tokens)
+  {
+    if (!discarding) {
+      sink->put_tokens(tokens);
+      return;
+    }
+    for (mootSentence::const_iterator si=tokens.begin(); si != tokens.end(); ++si)
+      put_token(*si);
+  };
+
+  virtual void put_sentence(const mootSentence &sentence)
+  {
+    put_tokens(sentence);
+    put_token(mootToken(TokTypeEOS));
+  };
+};
+
+//-- per-thread processing chain for --jobs
+class ChunkWorker {
+public:
+  wasteTokenScanner     scanner;  //-- chunk scanner
+  wasteLexerReader     *lexer;    //-- chunk lexer (may be NULL)
+  mootHMM              *hmm;      //-- model instance (owned by the mootHMMHandle; may be NULL)
+  wasteDecoder         *decoder;  //-- may be NULL
+  wasteAnnotatorWriter *annoter;  //-- may be NULL
+  TokenWriter          *writer;   //-- final writer (to obuf)
+  ChunkFilter           filter;   //-- discards lead-in output
+  TokenWriter          *sink;     //-- head of writer chain
+  std::string           chunk;    //-- current input chunk (including lead-in)
+  ByteOffset            offset;   //-- input offset of current chunk (including lead-in)
+  size_t                lead;     //-- length of lead-in
+  mcbuffer              obuf;     //-- output for current chunk
+  size_t                ntokens;  //-- number of tokens in current chunk
+#ifdef MOOT_PTHREADS_ENABLED
+  pthread_t             thread;
+#endif
+
+public:
+  ChunkWorker(mootHMM *model)
+    : scanner( ifmt|(ofmt&tiofLocation) ),
+      lexer(NULL),
+      hmm(model),
+      decoder(NULL),
+      annoter(NULL),
+      offset(0),
+      lead(0),
+      ntokens(0)
+  {
+    if (modeLast(mode)==wmScan)
+      scanner.tr_format |= ofmt;
+    if (mode&wmLex)
+      lexer = get_lexer( ofmt, &scanner );
+    writer = TokenIO::new_writer(ofmt);
+    writer->to_mstream(&obuf);
+    filter.sink      = writer;
+    filter.tw_format = writer->tw_format;
+    sink = &filter;
+    if (mode&wmAnnot) {
+      annoter = new wasteAnnotatorWriter( ofmt );
+      annoter->to_writer(sink);
+      sink = annoter;
+    }
+    if (mode&wmDecode) {
+      decoder = new wasteDecoder();
+      decoder->to_writer(sink);
+      sink = decoder;
+    }
+    if (lexer && hmm && decoder)
+      lexer->bind_model(hmm);
+  };
+
+  ~ChunkWorker(void)
+  {
+    if (decoder) delete decoder;
+    if (annoter) delete annoter;
+    if (lexer)   delete lexer;
+    delete writer;
+  };
+
+  //-- process current chunk as a separate document
+  void process(void)
+  {
+    //-- scan chunk in place: borrowed buffers require NUL padding
+    size_t len = chunk.size();
+    chunk.append(wasteScanner::BUFFER_PADDING, '\0');
+    scanner.scanner.borrow_buffer(chunk.data(), len);
+    if (lexer)
+      lexer->lexer.reset();
+    obuf.clear();
+    scanner.byte_number(offset);
+    filter.reset(offset+lead);
+
+    TokenReader *reader = lexer ? static_cast<TokenReader*>(lexer) : static_cast<TokenReader*>(&scanner);
+    if (hmm) {
+      hmm->ntokens = 0;
+      if (lexer && lexer->lexer.wl_hmm==hmm)
+	hmm->tag_stream(reader,sink,&lexer->wlr_lexinfo,&lexer->wlr_lextext);
+      else
+	hmm->tag_stream(reader,sink);
+      ntokens = hmm->ntokens; //-- including lead-in
+    } else {
+      ntokens = TokenIO::pipe_tokens(reader, sink);
+    }
+
+    //-- flush decoder
+    if (decoder) decoder->to_writer(decoder->wd_sink);
+  };
+
+  static void *process_thread(void *data)
+  {
+    reinterpret_cast<ChunkWorker*>(data)->process();
+    return NULL;
+  };
+};
+
+//--------------------------------------------------------------------------
+void churn_chunks(int njobs, TokenWriter *writer=main_writer)
+{
+  //-- setup: model instances
+  mootHMMHandle *models = NULL;
+  if (mode&wmTag) {
+    models = new mootHMMHandle(njobs);
+    models->verbose = vlevel;
+    if (!models->load(args.model_arg))
+      moot_croak("%s: ERROR: failed to load model from `%s'\n", PROGNAME, args.model_arg);
+  }
+
+  //-- setup: workers
+  vector<ChunkWorker*> workers(njobs, NULL);
+  for (int i=0; i < njobs; ++i) {
+    mootHMM *hmm = models ? models->sync(i) : NULL;
+    if (hmm) hmm->verbose = args.verbose_arg;
+    workers[i] = new ChunkWorker(hmm);
+  }
+
+  wasteChunker chunker(NULL, args.chunk_size_arg > 0 ? args.chunk_size_arg : 1);
+  chunker.wc_lead_size = 4096;
+  for (churner.first_input_file(); churner.in.file; churner.next_input_file()) {
+    ++nfiles;
+    if (vlevel >= vlInfo) {
+      moot_msg(vlevel, vlProgress,  "%s: processing file '%s'... ", PROGNAME, churner.in.name.c_str());
+      writer->printf_comment(" %s:File: %s\n", PROGNAME, churner.in.name.c_str());
+    }
+
+    chunker.from_mstream(churner.input());
+    for (bool more=true; more; ) {
+      //-- read next round of chunks
+      int n;
+      for (n=0; n < njobs && (more=chunker.get_chunk(workers[n]->chunk, workers[n]->offset, &workers[n]->lead)); ++n) ;
+
+      //-- process chunks in parallel
+      vector<bool> started(n, false);
+      for (int i=0; i < n; ++i) {
+#ifdef MOOT_PTHREADS_ENABLED
+	started[i] = pthread_create(&workers[i]->thread, NULL, ChunkWorker::process_thread, workers[i]) == 0;
+#endif
+	if (!started[i]) workers[i]->process();
+      }
+
+      //-- write output in input order
+      for (int i=0; i < n; ++i) {
+#ifdef MOOT_PTHREADS_ENABLED
+	if (started[i]) pthread_join(workers[i]->thread, NULL);
+#endif
+	main_writer->put_raw_buffer(workers[i]->obuf.data(), workers[i]->obuf.size());
+	ntokens += workers[i]->ntokens;
+      }
+    }
+
+    if (vlevel >= vlInfo)
+      writer->printf_comment("$EOF\t%lu 0\tEOF\n", chunker.wc_offset);
+  }
+
+  //-- cleanup
+  for (int i=0; i < njobs; ++i)
+    delete workers[i];
+  if (models) delete models;
+}
+
 /*--------------------------------------------------------------------------
  * main
  *--------------------------------------------------------------------------*/
@@ -320,24 +568,57 @@ int main (int argc, char **argv)
   GetMyOptions(argc,argv);
   TokenReader *churn_reader = NULL;
   TokenWriter *churn_writer = main_writer;
+  TokenReader *source = NULL;
+
+  //-- setup: threaded pipeline?
+  bool use_pipeline = args.pipeline_flag && !(mode&wmTrain);
+#ifndef MOOT_PTHREADS_ENABLED
+  if (use_pipeline) {
+    moot_msg(vlevel, vlWarnings, "%s: Warning: POSIX threads support disabled: ignoring --pipeline\n", PROGNAME);
+    use_pipeline = false;
+  }
+#endif
+
+  //-- setup: document-parallel processing?
+  int njobs = args.jobs_arg;
+  if (njobs > 1 && !(mode&wmScan)) {
+    moot_msg(vlevel, vlWarnings, "%s: Warning: --jobs requires --scan: ignoring\n", PROGNAME);
+    njobs = 0;
+  }
+  else if (njobs > 1 && (ofmt&tiofXML)) {
+    moot_msg(vlevel, vlWarnings, "%s: Warning: --jobs does not support XML output: ignoring\n", PROGNAME);
+    njobs = 0;
+  }
+#ifndef MOOT_PTHREADS_ENABLED
+  if (njobs > 1)
+    moot_msg(vlevel, vlWarnings, "%s: Warning: POSIX threads support disabled: processing --jobs chunks sequentially\n", PROGNAME);
+#endif
+  if (njobs > 1)
+    use_pipeline = false;
 
   //-- setup: globals
   if (mode&wmScan) {
     churn_reader = scanner = new wasteTokenScanner( ifmt|(ofmt&tiofLocation) );
     if (modeLast(mode)==wmScan)
       scanner->tr_format |= ofmt;
+    scanner->wts_mmap = args.mmap_flag;
   } else {
     churn_reader = reader = TokenIO::new_reader(ifmt);
   }
+  source = churn_reader;
   if (mode&wmLex) {
     lexer = get_lexer( ofmt, churn_reader );
     churn_reader = lexer;
   }
-  if (mode&wmTag) {
+  if ((mode&wmTag) && njobs <= 1) {
     tagger = new mootHMM();
     tagger->verbose = args.verbose_arg;
     if (!tagger->load_model(args.model_arg))
       moot_croak("%s: ERROR: failed to load model from `%s'\n", PROGNAME, args.model_arg);
+    if (lexer && (mode&wmDecode) && !use_pipeline) {
+      //-- model tokens are consumed by the decoder: let the lexer resolve them directly
+      lexer->bind_model(tagger);
+    }
   }
   if (mode&wmAnnot) {
     annoter = new wasteAnnotatorWriter( ofmt );
@@ -356,10 +637,24 @@ int main (int argc, char **argv)
     churn_writer = trainwriter;
   }
 
+  if (use_pipeline) {
+    pipeline = new wastePipeline();
+    pipeline->wp_source   = source;
+    pipeline->wp_lexer    = lexer;
+    pipeline->wp_hmm      = tagger;
+    pipeline->wp_sink     = churn_writer;
+    pipeline->wp_fastpath = lexer && (mode&wmDecode);
+    pipeline->wp_verbose  = vlevel;
+  }
+
   //-- churn
-  churn_io(churn_reader, churn_writer, tagger);
+  if (njobs > 1)
+    churn_chunks(njobs, churn_writer);
+  else
+    churn_io(churn_reader, churn_writer, tagger);
 
   //-- cleanup
+  if (pipeline) delete pipeline;
   if (trainwriter) delete trainwriter;
   if (decoder) delete decoder;
   if (annoter) delete annoter;
@@ -392,6 +687,6 @@ int main (int argc, char **argv)
     fprintf(stderr, "-----------------------------------------------------\n");
   }
   
-  return 0;
+  return churner.nerrors > 0 ? 1 : 0;
 }
 